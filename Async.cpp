@@ -0,0 +1,421 @@
+/**
+ * @file Async.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the EventLoop class and the coroutine functions defined in Async.h
+ */
+
+#include "Async.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(_WIN32)
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <curl/curl.h>
+#include <json.hpp>
+
+#include "Config.h"
+#include "Enums.h"
+#include "Utils.h"
+#include "GitLog.h"
+#include "GitObjects.h"
+#include "Subprocess.h"
+#include "Pipeline.h"
+#include "Generator.h"
+#include "RunContext.h"
+#include "ReleaseNotes.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @param maxConcurrentRequests Maximum number of requests running at the same time, the others wait in order until one finishes
+ */
+EventLoop::EventLoop(int maxConcurrentRequests)
+    : multi(curl_multi_init()), githubApiClient(getGithubApiClient()), maxConcurrentRequests(max(maxConcurrentRequests, 1)) {
+    if (!multi) {
+        throw runtime_error("Unable to initialize the libcurl multi handle of the event loop");
+    }
+}
+
+EventLoop::~EventLoop() {
+    curl_multi_cleanup(multi);
+}
+
+void EventLoop::addRequest(RequestAwaiter* request) {
+    queuedRequests.push_back(request);
+    startQueuedRequests();
+}
+
+void EventLoop::startQueuedRequests() {
+    while (!queuedRequests.empty() && runningRequests < maxConcurrentRequests) {
+        RequestAwaiter* request = queuedRequests.front();
+        queuedRequests.pop_front();
+
+        CURL* curl = githubApiClient.beginRequest(request->request, request->response, request->headers);
+        if (!curl) {
+            // The response is already complete (an error or a replayed response), the coroutine is resumed with it on the next events
+            readyCoroutines.push_back(request->waitingCoroutine);
+            continue;
+        }
+
+        // The awaiter is kept in the handle to know which coroutine to resume when the request finishes
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)request);
+        curl_multi_add_handle(multi, curl);
+        runningRequests++;
+    }
+}
+
+/**
+ * @brief Waits for the next finished requests or readable outputs, then resumes the coroutines that were waiting for them
+ */
+void EventLoop::processEvents() {
+    if (readyCoroutines.empty() && runningRequests == 0 && queuedRequests.empty() && waitingForOutput.empty()) {
+        throw logic_error("The event loop has nothing to wait for but the task it runs isn't finished");
+    }
+
+    int stillRunning;
+    curl_multi_perform(multi, &stillRunning);
+
+    CURLMsg* message;
+    int messagesLeft;
+    while ((message = curl_multi_info_read(multi, &messagesLeft)) != NULL) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        CURL* curl = message->easy_handle;
+        CURLcode resultCode = message->data.result;
+        char* privateData;
+        curl_easy_getinfo(curl, CURLINFO_PRIVATE, &privateData);
+        RequestAwaiter* request = (RequestAwaiter*)privateData;
+
+        curl_multi_remove_handle(multi, curl);
+        githubApiClient.endRequest(curl, resultCode, request->request, request->response, request->headers);
+        runningRequests--;
+        readyCoroutines.push_back(request->waitingCoroutine);
+    }
+    startQueuedRequests();
+
+    if (readyCoroutines.empty()) {
+        vector<curl_waitfd> outputs;
+        for (OutputAwaiter* output : waitingForOutput) {
+            outputs.push_back({output->fileDescriptor, CURL_WAIT_POLLIN, 0});
+        }
+        curl_multi_wait(multi, outputs.data(), (unsigned int)outputs.size(), 1000, NULL);
+
+        // Checked again with poll() since libcurl doesn't report outputs that were closed without any data left (POLLHUP only)
+        vector<pollfd> outputsEvents;
+        for (OutputAwaiter* output : waitingForOutput) {
+            outputsEvents.push_back({output->fileDescriptor, POLLIN, 0});
+        }
+        poll(outputsEvents.data(), outputsEvents.size(), 0);
+
+        vector<OutputAwaiter*> stillWaitingForOutput;
+        for (size_t i = 0; i < waitingForOutput.size(); i++) {
+            if (outputsEvents[i].revents != 0) {
+                readyCoroutines.push_back(waitingForOutput[i]->waitingCoroutine);
+            }
+            else {
+                stillWaitingForOutput.push_back(waitingForOutput[i]);
+            }
+        }
+        waitingForOutput = move(stillWaitingForOutput);
+    }
+
+    // Resumed coroutines can add requests and outputs, so the ready ones are taken out first
+    vector<coroutine_handle<>> coroutinesToResume = move(readyCoroutines);
+    readyCoroutines.clear();
+    for (coroutine_handle<> coroutine : coroutinesToResume) {
+        coroutine.resume();
+    }
+}
+
+/**
+ * @brief Makes reading the file descriptor (e.g., the output of a Subprocess) return immediately when it has no data yet,
+ * so that the coroutine reading it can wait for it with EventLoop::waitForOutput() instead of blocking the thread
+ * @param fileDescriptor The file descriptor to read from
+ */
+void setOutputNonBlocking(int fileDescriptor) {
+    fcntl(fileDescriptor, F_SETFL, fcntl(fileDescriptor, F_GETFL) | O_NONBLOCK);
+}
+
+/**
+ * @brief A git log reader for a non-blocking output, whose nextRecord() returns false when no complete record is available yet
+ * and isWaitingForOutput() tells that more records may come later, once the event loop reports that the output can be read
+ */
+class NonBlockingGitLogReader : public GitLogReader {
+public:
+    explicit NonBlockingGitLogReader(Subprocess& gitLog) : GitLogReader(gitLog.outputFileDescriptor()), gitLog(gitLog) {
+        setOutputNonBlocking(gitLog.outputFileDescriptor());
+    }
+
+    bool isWaitingForOutput() const { return waitingForOutput; }
+
+protected:
+    long readOutput(char* buffer, size_t size) override {
+        long bytesRead = gitLog.readOutput(buffer, size);
+        waitingForOutput = bytesRead < 0;
+        return bytesRead;
+    }
+
+private:
+    Subprocess& gitLog;
+    bool waitingForOutput = false;
+};
+
+/**
+ * @brief Retrieves pull request info from the GitHub API without blocking the thread
+ * @param pullRequestNumber The number of the pull request (e.g., 13, 144, 3722, etc.)
+ * @param timeoutMilliseconds Maximum time the whole request can take, GithubApiTimeoutError is thrown when it is reached
+ * @param loop The event loop that runs the request
+ * @param context The context of the generation, which contains the GitHub repository and token
+ * @return A task producing the pull request info in JSON
+ */
+AsyncTask<string> getPullRequestInfoAsync(string pullRequestNumber, long timeoutMilliseconds, EventLoop& loop, const RunContext& context) {
+    // Phases are only timed between the awaits, since other coroutines run on this thread while a request is waited for
+    HttpRequest request;
+    {
+        ProfileScope requestTimer(ProfilePhases::PullRequestRequest);
+        requestTimer.addTraceArgument("pullRequest", pullRequestNumber);
+        request = createPullRequestInfoRequest(pullRequestNumber, timeoutMilliseconds, context);
+    }
+
+    HttpResponse response = co_await loop.perform(request);
+
+    ProfileScope responseTimer(ProfilePhases::PullRequestRequest);
+    responseTimer.addTraceArgument("pullRequest", pullRequestNumber);
+    co_return checkPullRequestInfoResponse(response, request.url, context.config);
+}
+
+/**
+ * @brief Converts markdown text to HTML using the GitHub API without blocking the thread, reusing the HTML of the same markdown text
+ * if it was already converted by this process
+ * @param markdownText The markdown text to be converted to HTML
+ * @param timeoutMilliseconds Maximum time the whole request can take, GithubApiTimeoutError is thrown when it is reached
+ * @param loop The event loop that runs the request
+ * @param context The context of the generation, which contains the GitHub token
+ * @return A task producing the HTML text
+ */
+AsyncTask<string> convertMarkdownToHtmlAsync(string markdownText, long timeoutMilliseconds, EventLoop& loop, const RunContext& context) {
+    const Config& config = context.config;
+    string cachedEtag, htmlText;
+    HttpRequest request;
+    {
+        ProfileScope conversionTimer(ProfilePhases::MarkdownToHtml);
+        bool isCacheHit = getGithubApiCache(config).find(config.githubMarkdownApiUrl + "\n" + markdownText, cachedEtag, htmlText);
+        conversionTimer.addTraceArgument("cacheHit", isCacheHit);
+        if (isCacheHit) {
+            co_return htmlText;
+        }
+        request = createMarkdownToHtmlRequest(markdownText, timeoutMilliseconds, context);
+    }
+
+    HttpResponse response = co_await loop.perform(move(request));
+
+    ProfileScope conversionTimer(ProfilePhases::MarkdownToHtml);
+    htmlText = checkMarkdownToHtmlResponse(response, config);
+    getGithubApiCache(config).store(config.githubMarkdownApiUrl + "\n" + markdownText, "", htmlText);
+    co_return htmlText;
+}
+
+/**
+ * @brief Retrieves pull request info like getPullRequestInfoAsync(), but produces an empty string instead if the time budget
+ * of the context is exhausted or the request times out, so that the note is generated from the commit subject
+ */
+AsyncTask<string> getPullRequestInfoWithinDeadline(string pullRequestNumber, EventLoop& loop, const RunContext& context) {
+    const Deadline& deadline = context.deadline;
+    if (deadline.isExpired()) {
+        co_return "";
+    }
+
+    try {
+        co_return co_await getPullRequestInfoAsync(pullRequestNumber,
+                                                   deadline.remainingMilliseconds(context.config.githubApiRequestTimeoutSeconds * 1000L),
+                                                   loop, context);
+    }
+    catch (const GithubApiTimeoutError&) {
+    }
+    co_return "";
+}
+
+/**
+ * @brief Builds release notes like buildReleaseNotes() without blocking the thread while git log runs
+ * and while the pull requests are fetched, the notes are the same as the ones generated by the pipeline
+ * Git log outputs are read as they come, then all the pull requests are fetched at the same time through the event loop
+ * (limited by the event loop, by the time budget of the context and by the request budget of the context or of the config)
+ * @param releaseNoteSource The source to generate release notes from (commit messages or pull requests)
+ * @param releaseStartRef The git reference (commit SHA or tag name) that references the commit directly before the
+ * commit that starts the commit messages of the release, for example, the tag name of the previous release
+ * @param releaseEndRef The git reference (commit SHA or tag name) that references the end of the commit messages of the release
+ * @param releaseNoteMode The release notes mode when the source is pull requests
+ * @param loop The event loop that runs the git commands and the requests
+ * @param context The context of the generation (GitHub repository and token, local git repository), it must outlive the task
+ * @return A task producing the release notes
+ */
+AsyncTask<ReleaseNotes> buildReleaseNotesAsync(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                                    ReleaseNoteModes releaseNoteMode, EventLoop& loop, const RunContext& context) {
+    const Config& config = context.config;
+
+    // Phases are only timed between the awaits, since other coroutines run on this thread (and allocate in their own phases)
+    // while this one waits, so the generation is timed in the parts that run before, between and after its awaits
+    {
+        ProfileScope generationTimer(ProfilePhases::Generation);
+
+        // Validating both references with a single short lookup, which isn't worth suspending for
+        checkGitReferencesExist({releaseStartRef, releaseEndRef}, context);
+    }
+
+    vector<PipelineItem> items;
+    for (int commitTypeIndex = 0; commitTypeIndex < config.commitTypesCount; commitTypeIndex++) {
+        Subprocess gitLog(createGitCommand(createGitLogArguments(releaseNoteSource, releaseStartRef, releaseEndRef, commitTypeIndex, config),
+                                           context.repositoryDirectory));
+        NonBlockingGitLogReader gitLogReader(gitLog);
+        CommitRecord commitRecord;
+
+        bool commitTypeContainsReleaseNotes = false;
+        bool isWaitingForOutput = true;
+
+        while (isWaitingForOutput) {
+            {
+                ProfileScope gitLogTimer(ProfilePhases::GitLog);
+                gitLogTimer.addTraceArgument("commitType", config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::ConventionalName]);
+
+                while (gitLogReader.nextRecord(commitRecord)) {
+                    // The title of this commit type section is only added in the release notes if it contains any commits
+                    if (!commitTypeContainsReleaseNotes) {
+                        commitTypeContainsReleaseNotes = true;
+
+                        PipelineItem sectionTitle;
+                        sectionTitle.commitTypeIndex = commitTypeIndex;
+                        sectionTitle.isSectionTitle = true;
+                        items.push_back(move(sectionTitle));
+                    }
+
+                    PipelineItem commit;
+                    commit.commitTypeIndex = commitTypeIndex;
+                    commit.sha = commitRecord.sha;
+                    commit.subject = commitRecord.subject;
+                    // Only the first line of the body may be needed (the pull request title of merge commits)
+                    commit.body = commitRecord.body.substr(0, commitRecord.body.find('\n'));
+                    items.push_back(move(commit));
+                }
+                isWaitingForOutput = gitLogReader.isWaitingForOutput();
+            }
+
+            if (isWaitingForOutput) {
+                co_await loop.waitForOutput(gitLog.outputFileDescriptor());
+            }
+        }
+
+        if (gitLog.wait() != 0) {
+            throw runtime_error(config.gitLogError);
+        }
+    }
+
+    GithubApiBudget ownGithubApiBudget(config.githubApiConcurrentRequests, config.githubApiRequestBudget);
+    GithubApiBudget& githubApiBudget = context.githubApiBudget ? *context.githubApiBudget : ownGithubApiBudget;
+    bool usedCommitSubjects = false;
+    bool exceededRequestBudget = false;
+
+    vector<size_t> fetchedItemsIndexes;
+    vector<AsyncTask<string>> pullRequestInfoTasks;
+    {
+        ProfileScope generationTimer(ProfilePhases::Generation);
+        for (size_t i = 0; i < items.size(); i++) {
+            PipelineItem& item = items[i];
+            if (item.isSectionTitle) {
+                continue;
+            }
+
+            CommitNextStages nextStage = classifyCommit(item, releaseNoteSource, releaseNoteMode, config);
+            if (nextStage == CommitNextStages::Formatter) {
+                item.note = formatCommitNote(item, releaseNoteSource, releaseNoteMode, context);
+                item.hasNote = true;
+            }
+            else if (nextStage == CommitNextStages::PullRequestFetcher) {
+                // The event loop limits the requests that run at the same time, so the budget only counts the requests
+                // and never waits for a running request to finish, which would block the thread of the event loop
+                if (githubApiBudget.tryAcquire()) {
+                    fetchedItemsIndexes.push_back(i);
+                    pullRequestInfoTasks.push_back(getPullRequestInfoWithinDeadline(item.pullRequestNumber, loop, context));
+                }
+                else {
+                    item.note = formatCommitSubjectNote(item, config);
+                    item.hasNote = true;
+                    exceededRequestBudget = true;
+                }
+            }
+        }
+    }
+
+    vector<string> pullRequestsInfo = co_await whenAll(move(pullRequestInfoTasks));
+
+    ProfileScope generationTimer(ProfilePhases::Generation);
+    for (size_t i = 0; i < fetchedItemsIndexes.size(); i++) {
+        PipelineItem& item = items[fetchedItemsIndexes[i]];
+        if (pullRequestsInfo[i].empty()) {
+            item.note = formatCommitSubjectNote(item, config);
+            usedCommitSubjects = true;
+        }
+        else {
+            item.pullRequestInfo = move(pullRequestsInfo[i]);
+            item.note = formatCommitNote(item, releaseNoteSource, releaseNoteMode, context);
+        }
+        item.hasNote = true;
+    }
+
+    ReleaseNotes releaseNotes;
+    for (PipelineItem& item : items) {
+        if (item.isSectionTitle) {
+            releaseNotes.sections.push_back(createReleaseNotesSection(item.commitTypeIndex, config));
+        }
+        else if (item.hasNote) {
+            releaseNotes.sections.back().notes.push_back(move(item.note));
+            if (context.notesStream) {
+                context.notesStream->write(releaseNotes.sections.back(), releaseNotes.sections.back().notes.back());
+            }
+        }
+    }
+    releaseNotes.usedCommitSubjects = usedCommitSubjects;
+    releaseNotes.exceededRequestBudget = exceededRequestBudget;
+
+    co_return releaseNotes;
+}
+
+/**
+ * @brief Generates markdown release notes like generateMarkdownReleaseNotes() without blocking the thread
+ * @param releaseNoteSource The source to generate release notes from (commit messages or pull requests)
+ * @param releaseStartRef The git reference of the commit directly before the release
+ * @param releaseEndRef The git reference of the end of the release
+ * @param releaseNoteMode The release notes mode when the source is pull requests
+ * @param loop The event loop that runs the git commands and the requests
+ * @param context The context of the generation, it must outlive the task
+ * @return A task producing the markdown release notes
+ */
+AsyncTask<string> generateMarkdownReleaseNotesAsync(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                                    ReleaseNoteModes releaseNoteMode, EventLoop& loop, const RunContext& context) {
+    ReleaseNotes releaseNotes = co_await buildReleaseNotesAsync(releaseNoteSource, releaseStartRef, releaseEndRef, releaseNoteMode,
+                                                                loop, context);
+    co_return renderMarkdownReleaseNotes(releaseNotes, context.config, context.workers);
+}
+
+/**
+ * @brief Generates the markdown change note of a single pull request like generateMarkdownPullRequestChangeNote() without blocking the thread
+ * @param pullRequestNumber The number of the pull request (e.g., 13, 144, 3722, etc.)
+ * @param loop The event loop that runs the request
+ * @param context The context of the generation (GitHub repository and token), it must outlive the task
+ * @return A task producing the change note, or an empty string if the pull request title doesn't use any of the commit types
+ */
+AsyncTask<string> generateMarkdownPullRequestChangeNoteAsync(string pullRequestNumber, EventLoop& loop, const RunContext& context) {
+    string jsonResponse = co_await getPullRequestInfoAsync(pullRequestNumber, context.config.githubApiRequestTimeoutSeconds * 1000L,
+                                                           loop, context);
+    co_return createPullRequestChangeNote(parsePullRequestInfo(jsonResponse), context);
+}
+
+#endif
@@ -0,0 +1,238 @@
+/**
+ * @file Async.h
+ * @author Ahmed Khaled
+ * @brief This file defines the C++20 coroutine versions of the release notes library entry points, the AsyncTask type that they return
+ * and the EventLoop that runs their GitHub API requests and git commands from a single thread
+ *
+ * Usage: create an EventLoop, create the tasks of any number of generations (each with its own RunContext), then run them all with
+ * loop.run(whenAll(move(tasks))), while a generation waits for a GitHub API response or for git output the loop runs the others,
+ * so one thread drives all of them instead of one blocked thread for each
+ * Only available when compiling with coroutines support (e.g., -std=c++20) on Unix-like systems, the rest of the library doesn't need it
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && !defined(_WIN32)
+
+#include <coroutine>
+#include <optional>
+#include <exception>
+#include <string>
+#include <vector>
+#include <deque>
+#include <utility>
+
+#include <curl/curl.h>
+
+#include "Enums.h"
+#include "Http.h"
+#include "RunContext.h"
+#include "ReleaseNotes.h"
+
+using namespace std;
+
+/**
+ * @brief A coroutine that produces a value of type T, it starts when it is awaited (or started) and resumes its awaiter when it finishes
+ * Exceptions thrown inside the coroutine are thrown again to its awaiter
+ */
+template<typename T>
+class AsyncTask {
+public:
+    struct promise_type {
+        optional<T> value;
+        exception_ptr error;
+        coroutine_handle<> continuation; /**< The coroutine awaiting this task, resumed when it finishes*/
+
+        AsyncTask get_return_object() { return AsyncTask(coroutine_handle<promise_type>::from_promise(*this)); }
+        suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct ContinuationResumer {
+                bool await_ready() noexcept { return false; }
+                coroutine_handle<> await_suspend(coroutine_handle<promise_type> finishedCoroutine) noexcept {
+                    coroutine_handle<> continuation = finishedCoroutine.promise().continuation;
+                    return continuation ? continuation : noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return ContinuationResumer{};
+        }
+
+        void return_value(T result) { value = move(result); }
+        void unhandled_exception() { error = current_exception(); }
+    };
+
+    AsyncTask(AsyncTask&& other) noexcept : coroutine(exchange(other.coroutine, {})), started(other.started) {}
+    AsyncTask& operator=(AsyncTask&&) = delete;
+    AsyncTask(const AsyncTask&) = delete;
+    AsyncTask& operator=(const AsyncTask&) = delete;
+
+    /**
+     * @brief A task must not be destroyed while it is waiting for the event loop, so it must be awaited or run until it is done
+     */
+    ~AsyncTask() {
+        if (coroutine) {
+            coroutine.destroy();
+        }
+    }
+
+    /**
+     * @brief Runs the task until it first waits, so that it makes progress before it is awaited
+     */
+    void start() {
+        if (!started) {
+            started = true;
+            coroutine.resume();
+        }
+    }
+
+    bool isDone() const { return coroutine.done(); }
+
+    /**
+     * @brief The value of a finished task, or its exception thrown again
+     */
+    T result() {
+        if (coroutine.promise().error) {
+            rethrow_exception(coroutine.promise().error);
+        }
+        return move(*coroutine.promise().value);
+    }
+
+    bool await_ready() const noexcept { return coroutine.done(); }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> awaitingCoroutine) noexcept {
+        coroutine.promise().continuation = awaitingCoroutine;
+        if (started) {
+            return noop_coroutine();
+        }
+        started = true;
+        return coroutine;
+    }
+
+    T await_resume() { return result(); }
+
+private:
+    explicit AsyncTask(coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+    coroutine_handle<promise_type> coroutine;
+    bool started = false;
+};
+
+/**
+ * @brief Starts all the given tasks so that they run at the same time, then waits for all of them
+ * @param tasks The tasks
+ * @return A task producing the values of the tasks in the same order, it throws the exception of the first failed task
+ * after all the tasks finish
+ */
+template<typename T>
+AsyncTask<vector<T>> whenAll(vector<AsyncTask<T>> tasks) {
+    for (AsyncTask<T>& task : tasks) {
+        task.start();
+    }
+
+    vector<T> results;
+    exception_ptr firstError;
+    for (AsyncTask<T>& task : tasks) {
+        try {
+            results.push_back(co_await task);
+        }
+        catch (...) {
+            if (!firstError) {
+                firstError = current_exception();
+            }
+        }
+    }
+
+    if (firstError) {
+        rethrow_exception(firstError);
+    }
+    co_return results;
+}
+
+/**
+ * @brief Runs coroutines from a single thread, resuming each one when the GitHub API request or the git output it waits for is ready
+ * Requests are run over the connections of the shared GitHub API client, with up to the given number of requests running at the same time
+ */
+class EventLoop {
+public:
+    explicit EventLoop(int maxConcurrentRequests);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    struct RequestAwaiter {
+        EventLoop& loop;
+        HttpRequest request;
+        HttpResponse response;
+        coroutine_handle<> waitingCoroutine;
+        struct curl_slist* headers = NULL;
+
+        bool await_ready() noexcept { return false; }
+        void await_suspend(coroutine_handle<> awaitingCoroutine) {
+            waitingCoroutine = awaitingCoroutine;
+            loop.addRequest(this);
+        }
+        HttpResponse await_resume() { return move(response); }
+    };
+
+    struct OutputAwaiter {
+        EventLoop& loop;
+        int fileDescriptor;
+        coroutine_handle<> waitingCoroutine;
+
+        bool await_ready() noexcept { return false; }
+        void await_suspend(coroutine_handle<> awaitingCoroutine) {
+            waitingCoroutine = awaitingCoroutine;
+            loop.waitingForOutput.push_back(this);
+        }
+        void await_resume() noexcept {}
+    };
+
+    /**
+     * @brief Makes a request without blocking the thread, co_await it to get the response
+     */
+    RequestAwaiter perform(HttpRequest request) { return RequestAwaiter{*this, move(request), {}, {}}; }
+
+    /**
+     * @brief Waits without blocking the thread until the file descriptor (e.g., the output of git) can be read or is closed
+     */
+    OutputAwaiter waitForOutput(int fileDescriptor) { return OutputAwaiter{*this, fileDescriptor, {}}; }
+
+    /**
+     * @brief Runs the given task and all the coroutines it starts until it finishes
+     * @return The value of the task
+     */
+    template<typename T>
+    T run(AsyncTask<T> task) {
+        task.start();
+        while (!task.isDone()) {
+            processEvents();
+        }
+        return task.result();
+    }
+
+private:
+    CURLM* multi;
+    HttpClient& githubApiClient;
+    int maxConcurrentRequests;
+    int runningRequests = 0;
+    deque<RequestAwaiter*> queuedRequests;
+    vector<OutputAwaiter*> waitingForOutput;
+    vector<coroutine_handle<>> readyCoroutines;
+
+    void addRequest(RequestAwaiter* request);
+    void startQueuedRequests();
+    void processEvents();
+};
+
+void setOutputNonBlocking(int fileDescriptor);
+AsyncTask<string> getPullRequestInfoAsync(string pullRequestNumber, long timeoutMilliseconds, EventLoop& loop, const RunContext& context);
+AsyncTask<string> convertMarkdownToHtmlAsync(string markdownText, long timeoutMilliseconds, EventLoop& loop, const RunContext& context);
+AsyncTask<ReleaseNotes> buildReleaseNotesAsync(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                               ReleaseNoteModes releaseNoteMode, EventLoop& loop, const RunContext& context);
+AsyncTask<string> generateMarkdownReleaseNotesAsync(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                                    ReleaseNoteModes releaseNoteMode, EventLoop& loop, const RunContext& context);
+AsyncTask<string> generateMarkdownPullRequestChangeNoteAsync(string pullRequestNumber, EventLoop& loop, const RunContext& context);
+
+#endif
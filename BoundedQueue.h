@@ -0,0 +1,87 @@
+/**
+ * @file BoundedQueue.h
+ * @author Ahmed Khaled
+ * @brief This file defines the BoundedQueue class template which is used for passing items between threads
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+/**
+ * @brief A thread-safe first in first out queue with a maximum size, used to connect the stages of the generation pipeline
+ * Pushing to a full queue blocks until an item is popped, so a fast stage can't run too far ahead of a slow one,
+ * and closing the queue wakes all the waiting threads so that stages can finish (or stop early after an error)
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+    /**
+     * @brief Adds an item at the end of the queue, waiting while the queue is full
+     * @return False if the queue was closed (the item is dropped), true otherwise
+     */
+    bool push(T item) {
+        unique_lock<mutex> lock(queueMutex);
+        notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+
+        items.push_back(move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Removes the item at the front of the queue, waiting while the queue is empty
+     * @return False if the queue is closed and has no items left, true otherwise
+     */
+    bool pop(T& item) {
+        unique_lock<mutex> lock(queueMutex);
+        notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+
+        item = move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Marks that no more items will be pushed, items already in the queue can still be popped
+     */
+    void close() {
+        lock_guard<mutex> lock(queueMutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    /**
+     * @brief Closes the queue and drops the items that weren't popped yet, used to stop the stages after an error
+     * so that they don't keep working on items whose results would be thrown away
+     */
+    void cancel() {
+        lock_guard<mutex> lock(queueMutex);
+        closed = true;
+        items.clear();
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+private:
+    size_t capacity;
+    deque<T> items;
+    bool closed = false;
+    mutex queueMutex;
+    condition_variable notEmpty;
+    condition_variable notFull;
+};
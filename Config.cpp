@@ -6,10 +6,14 @@
 
 #include <string>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <cstdlib>
 
 #include <json.hpp>
 
 #include "Config.h"
+#include "Template.h"
 
 using namespace std;
 using namespace nlohmann;
@@ -52,6 +56,53 @@ void Config::load(const string& configFileName) {
         throw runtime_error("Key 'htmlOutputFileName' not found in " + configFileName);
     }
 
+    if (externalConfigData.contains("jsonOutputFileName")) {
+        jsonOutputFileName = externalConfigData["jsonOutputFileName"];
+
+        if (jsonOutputFileName.find(".json") == string::npos) {
+            throw invalid_argument("Key 'jsonOutputFileName' doesn't contain a correct value, enter a correct file name that ends in .json in "
+                + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'jsonOutputFileName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("textOutputFileName")) {
+        textOutputFileName = externalConfigData["textOutputFileName"];
+
+        if (textOutputFileName.find(".txt") == string::npos) {
+            throw invalid_argument("Key 'textOutputFileName' doesn't contain a correct value, enter a correct file name that ends in .txt in "
+                + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'textOutputFileName' not found in " + configFileName);
+    }
+
+    if (!externalConfigData.contains("outputFormats") || !externalConfigData["outputFormats"].is_array()) {
+        throw runtime_error("Key 'outputFormats' not found or is not an array in " + configFileName);
+    }
+
+    outputFormats.clear();
+    for (auto& outputFormat : externalConfigData["outputFormats"]) {
+        if (!outputFormat.is_string() || (outputFormat != "markdown" && outputFormat != "html" && outputFormat != "json" && outputFormat != "text")) {
+            throw invalid_argument("Key 'outputFormats' must only contain \"markdown\", \"html\", \"json\" or \"text\" in " + configFileName);
+        }
+        outputFormats.push_back(outputFormat);
+    }
+
+    if (externalConfigData.contains("htmlRenderer")) {
+        htmlRenderer = externalConfigData["htmlRenderer"];
+
+        if (htmlRenderer != "github" && htmlRenderer != "local") {
+            throw invalid_argument("Key 'htmlRenderer' must contain \"github\" or \"local\" in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'htmlRenderer' not found in " + configFileName);
+    }
+
     if (externalConfigData.contains("githubReposApiUrl")) {
         githubReposApiUrl = externalConfigData["githubReposApiUrl"];
     }
@@ -66,6 +117,14 @@ void Config::load(const string& configFileName) {
         throw runtime_error("Key 'githubMarkdownApiUrl' not found in " + configFileName);
     }
 
+    // The GitHub API can be replaced without editing the config (e.g., by a local mock of it in tests and benchmarks)
+    if (const char* reposApiUrl = getenv("RELEASE_NOTES_GITHUB_REPOS_API_URL")) {
+        githubReposApiUrl = reposApiUrl;
+    }
+    if (const char* markdownApiUrl = getenv("RELEASE_NOTES_GITHUB_MARKDOWN_API_URL")) {
+        githubMarkdownApiUrl = markdownApiUrl;
+    }
+
     if (externalConfigData.contains("githubUrl")) {
         githubUrl = externalConfigData["githubUrl"];
     }
@@ -84,6 +143,105 @@ void Config::load(const string& configFileName) {
         throw runtime_error("Key 'commitTypesCount' not found in " + configFileName);
     }
 
+    if (externalConfigData.contains("githubApiConcurrentRequests")) {
+        githubApiConcurrentRequests = externalConfigData["githubApiConcurrentRequests"];
+
+        if (githubApiConcurrentRequests < 1) {
+            throw invalid_argument("Key 'githubApiConcurrentRequests' must contain a value bigger than 0 in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'githubApiConcurrentRequests' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("githubApiRequestTimeoutSeconds")) {
+        githubApiRequestTimeoutSeconds = externalConfigData["githubApiRequestTimeoutSeconds"];
+
+        if (githubApiRequestTimeoutSeconds < 1) {
+            throw invalid_argument("Key 'githubApiRequestTimeoutSeconds' must contain a value bigger than 0 in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'githubApiRequestTimeoutSeconds' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("generationTimeBudgetSeconds")) {
+        generationTimeBudgetSeconds = externalConfigData["generationTimeBudgetSeconds"];
+
+        if (generationTimeBudgetSeconds < 0) {
+            throw invalid_argument("Key 'generationTimeBudgetSeconds' must contain a value that is 0 (no limit) or bigger in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'generationTimeBudgetSeconds' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("githubApiCacheMaxEntries")) {
+        githubApiCacheMaxEntries = externalConfigData["githubApiCacheMaxEntries"];
+
+        if (githubApiCacheMaxEntries < 1) {
+            throw invalid_argument("Key 'githubApiCacheMaxEntries' must contain a value bigger than 0 in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'githubApiCacheMaxEntries' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("githubApiRequestBudget")) {
+        githubApiRequestBudget = externalConfigData["githubApiRequestBudget"];
+
+        if (githubApiRequestBudget < 0) {
+            throw invalid_argument("Key 'githubApiRequestBudget' must contain a value that is 0 (no limit) or bigger in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'githubApiRequestBudget' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("serverMaxConnections")) {
+        serverMaxConnections = externalConfigData["serverMaxConnections"];
+
+        if (serverMaxConnections < 1) {
+            throw invalid_argument("Key 'serverMaxConnections' must contain a value bigger than 0 in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'serverMaxConnections' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("serverMaxRequestBytes")) {
+        serverMaxRequestBytes = externalConfigData["serverMaxRequestBytes"];
+
+        if (serverMaxRequestBytes < 1) {
+            throw invalid_argument("Key 'serverMaxRequestBytes' must contain a value bigger than 0 in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'serverMaxRequestBytes' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("serverIdleTimeoutSeconds")) {
+        serverIdleTimeoutSeconds = externalConfigData["serverIdleTimeoutSeconds"];
+
+        if (serverIdleTimeoutSeconds < 1) {
+            throw invalid_argument("Key 'serverIdleTimeoutSeconds' must contain a value bigger than 0 in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'serverIdleTimeoutSeconds' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("gitProcessesMaxRepositories")) {
+        gitProcessesMaxRepositories = externalConfigData["gitProcessesMaxRepositories"];
+
+        if (gitProcessesMaxRepositories < 1) {
+            throw invalid_argument("Key 'gitProcessesMaxRepositories' must contain a value bigger than 0 in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'gitProcessesMaxRepositories' not found in " + configFileName);
+    }
+
     if (externalConfigData.contains("commitMessagesSourceCliInputName")) {
         commitMessagesSourceCliInputName = externalConfigData["commitMessagesSourceCliInputName"];
     }
@@ -147,6 +305,101 @@ void Config::load(const string& configFileName) {
         throw runtime_error("Key 'singlePullRequestSourceCliInputName' not found in " + configFileName);
     }
 
+    if (externalConfigData.contains("serveCliInputName")) {
+        serveCliInputName = externalConfigData["serveCliInputName"];
+    }
+    else {
+        throw runtime_error("Key 'serveCliInputName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("clientCliInputName")) {
+        clientCliInputName = externalConfigData["clientCliInputName"];
+    }
+    else {
+        throw runtime_error("Key 'clientCliInputName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("manifestCliInputName")) {
+        manifestCliInputName = externalConfigData["manifestCliInputName"];
+    }
+    else {
+        throw runtime_error("Key 'manifestCliInputName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("threadsCliOptionName")) {
+        threadsCliOptionName = externalConfigData["threadsCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'threadsCliOptionName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("notesStreamCliOptionName")) {
+        notesStreamCliOptionName = externalConfigData["notesStreamCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'notesStreamCliOptionName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("profileCliOptionName")) {
+        profileCliOptionName = externalConfigData["profileCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'profileCliOptionName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("profileReportFormat")) {
+        profileReportFormat = externalConfigData["profileReportFormat"];
+
+        if (profileReportFormat != "table" && profileReportFormat != "json") {
+            throw invalid_argument("Key 'profileReportFormat' must contain \"table\" or \"json\" in " + configFileName);
+        }
+    }
+    else {
+        throw runtime_error("Key 'profileReportFormat' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("memoryCliOptionName")) {
+        memoryCliOptionName = externalConfigData["memoryCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'memoryCliOptionName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("traceCliOptionName")) {
+        traceCliOptionName = externalConfigData["traceCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'traceCliOptionName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("networkStatsCliOptionName")) {
+        networkStatsCliOptionName = externalConfigData["networkStatsCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'networkStatsCliOptionName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("recordCliOptionName")) {
+        recordCliOptionName = externalConfigData["recordCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'recordCliOptionName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("replayCliOptionName")) {
+        replayCliOptionName = externalConfigData["replayCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'replayCliOptionName' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("replayInstantCliOptionName")) {
+        replayInstantCliOptionName = externalConfigData["replayInstantCliOptionName"];
+    }
+    else {
+        throw runtime_error("Key 'replayInstantCliOptionName' not found in " + configFileName);
+    }
+
     if (!externalConfigData.contains("commitTypes") || !externalConfigData["commitTypes"].is_array()) {
         throw runtime_error("Key 'commitTypes' not found or is not an array in " + configFileName);
     }
@@ -184,6 +437,28 @@ void Config::load(const string& configFileName) {
         throw runtime_error("Key 'markdownFullModeReleaseNotePrefix' not found in " + configFileName);
     }
 
+    if (externalConfigData.contains("markdownTemplateFile")) {
+        markdownTemplateFile = externalConfigData["markdownTemplateFile"];
+
+        if (!markdownTemplateFile.empty()) {
+            markdownTemplate = loadTemplate(markdownTemplateFile, TemplateEscapes::None);
+        }
+    }
+    else {
+        throw runtime_error("Key 'markdownTemplateFile' not found in " + configFileName);
+    }
+
+    if (externalConfigData.contains("htmlTemplateFile")) {
+        htmlTemplateFile = externalConfigData["htmlTemplateFile"];
+
+        if (!htmlTemplateFile.empty()) {
+            htmlTemplate = loadTemplate(htmlTemplateFile, TemplateEscapes::Html);
+        }
+    }
+    else {
+        throw runtime_error("Key 'htmlTemplateFile' not found in " + configFileName);
+    }
+
     if (externalConfigData.contains("outputMessages")) {
         auto& outputMessages = externalConfigData["outputMessages"];
 
@@ -250,6 +525,104 @@ void Config::load(const string& configFileName) {
             throw runtime_error("Key 'noGithubRepositoryError' not found in the 'outputMessages' category in " + configFileName);
         }
 
+        if (outputMessages.contains("noSocketPathError")) {
+            noSocketPathError = outputMessages["noSocketPathError"];
+        }
+        else {
+            throw runtime_error("Key 'noSocketPathError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("noManifestError")) {
+            noManifestError = outputMessages["noManifestError"];
+        }
+        else {
+            throw runtime_error("Key 'noManifestError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("incorrectThreadsError")) {
+            incorrectThreadsError = outputMessages["incorrectThreadsError"];
+        }
+        else {
+            throw runtime_error("Key 'incorrectThreadsError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("noNotesStreamPathError")) {
+            noNotesStreamPathError = outputMessages["noNotesStreamPathError"];
+        }
+        else {
+            throw runtime_error("Key 'noNotesStreamPathError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("notesStreamFileError")) {
+            notesStreamFileError = outputMessages["notesStreamFileError"];
+        }
+        else {
+            throw runtime_error("Key 'notesStreamFileError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("noTracePathError")) {
+            noTracePathError = outputMessages["noTracePathError"];
+        }
+        else {
+            throw runtime_error("Key 'noTracePathError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("traceFileError")) {
+            traceFileError = outputMessages["traceFileError"];
+        }
+        else {
+            throw runtime_error("Key 'traceFileError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("noNetworkStatsPathError")) {
+            noNetworkStatsPathError = outputMessages["noNetworkStatsPathError"];
+        }
+        else {
+            throw runtime_error("Key 'noNetworkStatsPathError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("networkStatsFileError")) {
+            networkStatsFileError = outputMessages["networkStatsFileError"];
+        }
+        else {
+            throw runtime_error("Key 'networkStatsFileError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("noRecordPathError")) {
+            noRecordPathError = outputMessages["noRecordPathError"];
+        }
+        else {
+            throw runtime_error("Key 'noRecordPathError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("noReplayPathError")) {
+            noReplayPathError = outputMessages["noReplayPathError"];
+        }
+        else {
+            throw runtime_error("Key 'noReplayPathError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("recordAndReplayError")) {
+            recordAndReplayError = outputMessages["recordAndReplayError"];
+        }
+        else {
+            throw runtime_error("Key 'recordAndReplayError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("recordingError")) {
+            recordingError = outputMessages["recordingError"];
+        }
+        else {
+            throw runtime_error("Key 'recordingError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("replayingError")) {
+            replayingError = outputMessages["replayingError"];
+        }
+        else {
+            throw runtime_error("Key 'replayingError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
         if (outputMessages.contains("expectedSyntaxMessage")) {
             expectedSyntaxMessage = outputMessages["expectedSyntaxMessage"];
         }
@@ -292,6 +665,13 @@ void Config::load(const string& configFileName) {
             throw runtime_error("Key 'githubApiLibcurlError' not found in the 'outputMessages' category in " + configFileName);
         }
 
+        if (outputMessages.contains("githubApiTimeoutError")) {
+            githubApiTimeoutError = outputMessages["githubApiTimeoutError"];
+        }
+        else {
+            throw runtime_error("Key 'githubApiTimeoutError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
         if (outputMessages.contains("gitLogError")) {
             gitLogError = outputMessages["gitLogError"];
         }
@@ -299,6 +679,48 @@ void Config::load(const string& configFileName) {
             throw runtime_error("Key 'gitLogError' not found in the 'outputMessages' category in " + configFileName);
         }
 
+        if (outputMessages.contains("gitReferenceNotFoundError")) {
+            gitReferenceNotFoundError = outputMessages["gitReferenceNotFoundError"];
+        }
+        else {
+            throw runtime_error("Key 'gitReferenceNotFoundError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("serverConnectionError")) {
+            serverConnectionError = outputMessages["serverConnectionError"];
+        }
+        else {
+            throw runtime_error("Key 'serverConnectionError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("serverClosedConnectionError")) {
+            serverClosedConnectionError = outputMessages["serverClosedConnectionError"];
+        }
+        else {
+            throw runtime_error("Key 'serverClosedConnectionError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("serverAlreadyRunningError")) {
+            serverAlreadyRunningError = outputMessages["serverAlreadyRunningError"];
+        }
+        else {
+            throw runtime_error("Key 'serverAlreadyRunningError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("serverSocketPathError")) {
+            serverSocketPathError = outputMessages["serverSocketPathError"];
+        }
+        else {
+            throw runtime_error("Key 'serverSocketPathError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("serverRequestTooLongError")) {
+            serverRequestTooLongError = outputMessages["serverRequestTooLongError"];
+        }
+        else {
+            throw runtime_error("Key 'serverRequestTooLongError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
         if (outputMessages.contains("generatingReleaseNotesMessage")) {
             generatingReleaseNotesMessage = outputMessages["generatingReleaseNotesMessage"];
         }
@@ -327,14 +749,63 @@ void Config::load(const string& configFileName) {
             throw runtime_error("Key 'htmlFileError' not found in the 'outputMessages' category in " + configFileName);
         }
 
+        if (outputMessages.contains("jsonFileError")) {
+            jsonFileError = outputMessages["jsonFileError"];
+        }
+        else {
+            throw runtime_error("Key 'jsonFileError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("textFileError")) {
+            textFileError = outputMessages["textFileError"];
+        }
+        else {
+            throw runtime_error("Key 'textFileError' not found in the 'outputMessages' category in " + configFileName);
+        }
+
         if (outputMessages.contains("emptyReleaseNotesMessage")) {
             emptyReleaseNotesMessage = outputMessages["emptyReleaseNotesMessage"];
         }
         else {
             throw runtime_error("Key 'emptyReleaseNotesMessage' not found in the 'outputMessages' category in " + configFileName);
         }
+
+        if (outputMessages.contains("timeBudgetExceededNote")) {
+            timeBudgetExceededNote = outputMessages["timeBudgetExceededNote"];
+        }
+        else {
+            throw runtime_error("Key 'timeBudgetExceededNote' not found in the 'outputMessages' category in " + configFileName);
+        }
+
+        if (outputMessages.contains("requestBudgetExceededNote")) {
+            requestBudgetExceededNote = outputMessages["requestBudgetExceededNote"];
+        }
+        else {
+            throw runtime_error("Key 'requestBudgetExceededNote' not found in the 'outputMessages' category in " + configFileName);
+        }
     }
     else {
         throw runtime_error("Category 'outputMessages' not found in " + configFileName);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Reads and compiles a template file of the config, templates are compiled once when the config is loaded
+ * @param templateFileName The name of the template file
+ * @param escapeMode How the values written by the template are escaped
+ * @return The compiled template
+ */
+shared_ptr<const OutputTemplate> Config::loadTemplate(const string& templateFileName, TemplateEscapes escapeMode) {
+    ifstream templateFile(templateFileName);
+    if (!templateFile.is_open()) {
+        throw runtime_error("Unable to open the template file " + templateFileName);
+    }
+    string templateText((istreambuf_iterator<char>(templateFile)), istreambuf_iterator<char>());
+
+    try {
+        return make_shared<OutputTemplate>(templateText, escapeMode);
+    }
+    catch (const runtime_error& e) {
+        throw runtime_error(string(e.what()) + " in " + templateFileName);
+    }
+}
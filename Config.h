@@ -6,9 +6,15 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <memory>
+
+#include "Enums.h"
 
 using namespace std;
 
+class OutputTemplate;
+
 /**
  * @brief A class for loading and validating the JSON external configuration values
  * This class allows the script to be easily customizable without opening any source code files
@@ -17,13 +23,52 @@ class Config {
 public:
     string markdownOutputFileName;
     string htmlOutputFileName;
+    string jsonOutputFileName;
+    string textOutputFileName;
+    vector<string> outputFormats; /**< Formats of the files written by the CLI (markdown, html, json, text)*/
+    string htmlRenderer; /**< "github" to render HTML with the GitHub markdown API, "local" to render it without any request*/
     string githubUrl;
     string githubReposApiUrl;
     string githubMarkdownApiUrl;
-    string repoIssuesUrl;
-    string repoCommitsUrl;
-    string repoPullRequestsApiUrl;
     int commitTypesCount;
+    /**
+     * @brief Maximum number of pull requests that are fetched from the GitHub API at the same time
+     */
+    int githubApiConcurrentRequests;
+    /**
+     * @brief Maximum number of seconds a single GitHub API request can take
+     */
+    int githubApiRequestTimeoutSeconds;
+    /**
+     * @brief Maximum number of seconds for generating the release notes (0 means no limit), when it is reached the remaining
+     * notes are generated from commit subjects instead of pull requests
+     */
+    int generationTimeBudgetSeconds;
+    /**
+     * @brief Maximum number of GitHub API responses kept in memory to be reused by later generations of the same process
+     */
+    int githubApiCacheMaxEntries;
+    /**
+     * @brief Maximum number of pull requests retrieved from the GitHub API by a single run (0 means no limit), in manifest mode the limit is shared by all the repositories, when it is reached the remaining notes are generated from commit subjects instead of pull requests
+     */
+    int githubApiRequestBudget;
+    /**
+     * @brief Maximum number of connections that the release notes server handles at the same time, the others wait to be accepted
+     */
+    int serverMaxConnections;
+    /**
+     * @brief Maximum number of bytes of a single request sent to the release notes server, a longer request fails and closes its connection
+     */
+    int serverMaxRequestBytes;
+    /**
+     * @brief Seconds that the release notes server waits for the next request of a connection before closing it
+     */
+    int serverIdleTimeoutSeconds;
+    /**
+     * @brief Maximum number of repositories whose git process is kept alive by the release notes server and by manifest runs,
+     * the process of the least recently used repository is closed when another repository is used
+     */
+    int gitProcessesMaxRepositories;
     /**
      * @brief 2d array storing conventional commit types and their corresponding markdown titles
      * The first dimension is 50 to give it enough space to store as many types as the user enters in the release_config.json
@@ -44,10 +89,33 @@ public:
     string fullModeCliInputName;
     string fullModeGithubActionsInputName;
     string singlePullRequestSourceCliInputName;
+    string serveCliInputName;
+    string clientCliInputName;
+    string manifestCliInputName;
+    string threadsCliOptionName;
+    string notesStreamCliOptionName;
+    string profileCliOptionName;
+    string profileReportFormat; /**< "table" or "json", the format of the reports printed by --profile and --memory*/
+    string memoryCliOptionName;
+    string traceCliOptionName;
+    string networkStatsCliOptionName;
+    string recordCliOptionName;
+    string replayCliOptionName;
+    string replayInstantCliOptionName;
 
     // Variables that determine the looks of the release notes
     string markdownReleaseNotePrefix;
     string markdownFullModeReleaseNotePrefix;
+    /**
+     * @brief Template file that lays out the markdown release notes instead of the prefixes above (see Template.h), empty for the default layout
+     */
+    string markdownTemplateFile;
+    /**
+     * @brief Template file that lays out the HTML release notes without using the GitHub API (see Template.h), empty for the default HTML
+     */
+    string htmlTemplateFile;
+    shared_ptr<const OutputTemplate> markdownTemplate; /**< Compiled from markdownTemplateFile when the config is loaded, null if it is empty*/
+    shared_ptr<const OutputTemplate> htmlTemplate; /**< Compiled from htmlTemplateFile when the config is loaded, null if it is empty*/
 
     // Variables that control the output messages that are shown to the user
     string noReleaseNotesSourceError;
@@ -59,18 +127,46 @@ public:
     string noReleaseEndReferenceError;
     string noPullRequestNumberError;
     string noGithubRepositoryError;
+    string noSocketPathError;
+    string noManifestError;
+    string incorrectThreadsError;
+    string noNotesStreamPathError;
+    string notesStreamFileError;
+    string noTracePathError;
+    string traceFileError;
+    string noNetworkStatsPathError;
+    string networkStatsFileError;
+    string noRecordPathError;
+    string noReplayPathError;
+    string recordAndReplayError;
+    string recordingError;
+    string replayingError;
     string githubApiRateLimitExceededError;
     string githubApiUnauthorizedAccessError;
     string githubApiBadRequestError;
     string githubApiUnableToMakeRequestError;
     string githubApiLibcurlError;
+    string githubApiTimeoutError;
     string gitLogError;
+    string gitReferenceNotFoundError;
+    string serverConnectionError;
+    string serverClosedConnectionError;
+    string serverAlreadyRunningError;
+    string serverSocketPathError;
+    string serverRequestTooLongError;
     string markdownFileError;
     string htmlFileError;
+    string jsonFileError;
+    string textFileError;
     string expectedSyntaxMessage;
     string generatingReleaseNotesMessage;
     string failedToGenerateReleaseNotesMessage;
     string emptyReleaseNotesMessage;
+    string timeBudgetExceededNote;
+    string requestBudgetExceededNote;
 
     void load(const string& configFileName);
+
+private:
+    static shared_ptr<const OutputTemplate> loadTemplate(const string& templateFileName, TemplateEscapes escapeMode);
 };
\ No newline at end of file
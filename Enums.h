@@ -25,7 +25,16 @@ enum class InputErrors {
     NoReleaseStartReference,
     NoReleaseEndReference,
     NoPullRequestNumber,
-    NoGithubRepository
+    NoGithubRepository,
+    NoSocketPath,
+    NoManifest,
+    IncorrectThreads,
+    NoNotesStreamPath,
+    NoTracePath,
+    NoNetworkStatsPath,
+    NoRecordPath,
+    NoReplayPath,
+    RecordAndReplay
 };
 
 /**
@@ -43,4 +52,81 @@ enum class CommitTypeMatchResults {
     MatchWithoutSubCategory, /**< when for example "fix:" is matched against "fix", they match and "fix:" doesn't have a subcategory "()"*/
     MatchWithSubCategory, /**< when for example "fix(GUI):" is matched against "fix", they match and "fix(GUI):" has a subcategory which is "GUI"*/
     NoMatch /**< when for example "fix:" or "fix(GUI):" is matched against "feat", they don't match*/
+};
+
+/**
+ * @brief Enumeration for the stage that a commit goes to after it is classified in the release notes pipeline
+ */
+enum class CommitNextStages {
+    Writer, /**< The commit doesn't have a release note (no commit type match or no pull request number)*/
+    PullRequestFetcher, /**< The info of the pull request of the commit must be fetched from the GitHub API first*/
+    Formatter /**< The release note can be formatted from the commit message directly*/
+};
+
+/**
+ * @brief Enumeration for how the values inserted by an output template are escaped
+ */
+enum class TemplateEscapes {
+    None, /**< Values are inserted as they are (e.g., markdown templates)*/
+    Html /**< Values are HTML escaped unless they are inserted with {{{name}}} or {{&name}}*/
+};
+
+/**
+ * @brief Enumeration for the instructions that an output template is compiled to
+ */
+enum class TemplateInstructionTypes {
+    Text, /**< Writes a text of the template as it is*/
+    Value, /**< Writes the value of a field, escaped like the template*/
+    RawValue, /**< Writes the value of a field without escaping it*/
+    Section, /**< Renders the instructions until its end for each item of a list field, or once if the field is true or not empty*/
+    InvertedSection, /**< Renders the instructions until its end once if the field is false or empty*/
+    SectionEnd
+};
+
+/**
+ * @brief Enumeration for the fields that output templates can use, each one belongs to the release notes, a section, a note or a commit
+ */
+enum class TemplateFields {
+    Sections,
+    UsedCommitSubjects,
+    ExceededRequestBudget,
+    TimeBudgetExceededNote,
+    RequestBudgetExceededNote,
+    SectionType,
+    SectionTitle,
+    SectionHeading,
+    Notes,
+    NoteType,
+    Scope,
+    NoteTitle,
+    FullTitle,
+    Prefix,
+    Body,
+    IndentedBody,
+    BodyHtml,
+    PullRequest,
+    Commits,
+    Breaking,
+    Detailed,
+    Source,
+    Sha
+};
+
+/**
+ * @brief Enumeration for the phases and the per item operations timed by the profiler (--profile) and the trace (--trace)
+ */
+enum class ProfilePhases {
+    Generation, /**< A whole generation of release notes, from reading the commits to the last note*/
+    GitReferencesLookup, /**< Checking that the start and end references exist*/
+    GitLog, /**< Reading the commits of one commit type from git log*/
+    PullRequestRequest, /**< Retrieving the info of one pull request from the GitHub API*/
+    JsonParse, /**< Parsing the info of one pull request*/
+    FormatPullRequestBody, /**< Adding the links of one pull request body and removing its extra new lines*/
+    FormatNote, /**< Creating the release note of one commit or pull request*/
+    MarkdownToHtml, /**< Converting markdown to HTML with the GitHub API*/
+    RenderNotes, /**< Rendering the release notes in one output format*/
+    FileWrite, /**< Writing one output file*/
+    GitProcess, /**< Running one git process, from starting it to its exit*/
+    HttpRequest, /**< One HTTP request, timed by libcurl from the start of the request to the end of the response*/
+    PhasesCount
 };
\ No newline at end of file
@@ -8,14 +8,13 @@
 #include <regex>
 
 #include "Format.h"
-#include "Config.h"
 #include "Enums.h"
 #include "Utils.h"
+#include "RunContext.h"
+#include "Profiler.h"
 
 using namespace std;
 
-extern Config config;
-
 /**
  * @brief Indents (puts 4 spaces) before all lines in a string
  * @param s The input string
@@ -39,9 +38,10 @@ string indentAllLinesInString(string s) {
 /**
  * @brief Replaces all plain text hash ids (issue ids and pull request ids (#2777)) with links to these issues/pull requests on GitHub
  * @param pullRequestBody The original body/description of the pull request to do the replacements on
+ * @param context The context of the generation, which contains the repository URLs that the links point to
  * @return Pull request body/description after performing the replacements
  */
-string replaceHashIdsWithLinks(string pullRequestBody) {
+string replaceHashIdsWithLinks(string pullRequestBody, const RunContext& context) {
     // The first brackets are not considered a capture group, they are a must when adding "R" to define this as a *raw string literal*
     // We add this "R" to write regex patterns easier and increase readability by not needing to escape back slashes
     regex hashIdPattern(R"(#(\d+))");
@@ -58,10 +58,10 @@ string replaceHashIdsWithLinks(string pullRequestBody) {
         string currentNumericId = currentHashIdMatch.str(1);
         // I remove the old hash id and create a new markdown link using it and insert the new link in its place
         result.erase(currentHashIdMatch.position() + numberOfNewCharactersAdded, currentHashIdMatch.length());
-        result.insert(currentHashIdMatch.position() + numberOfNewCharactersAdded, "[#" + currentNumericId + "](" + config.repoIssuesUrl + currentNumericId + ")");
+        result.insert(currentHashIdMatch.position() + numberOfNewCharactersAdded, "[#" + currentNumericId + "](" + context.repoIssuesUrl + currentNumericId + ")");
         // Regex smatch.position() was assigned before we replaced hash ids with urls
         // So we must account for that by counting number of new characters we have added, "4" is for the characters "[]()"
-        numberOfNewCharactersAdded += 4 + config.repoIssuesUrl.length() + currentNumericId.length();
+        numberOfNewCharactersAdded += 4 + context.repoIssuesUrl.length() + currentNumericId.length();
     }
 
     return result;
@@ -70,9 +70,10 @@ string replaceHashIdsWithLinks(string pullRequestBody) {
 /**
  * @brief Replaces all plain text commit SHAs (e.g., 219c2149) with links to these commits on GitHub
  * @param pullRequestBody The original body/description of the pull request to do the replacements on
+ * @param context The context of the generation, which contains the repository URLs that the links point to
  * @return Pull request body/description after performing the replacements
  */
-string replaceCommitShasWithLinks(string pullRequestBody) {
+string replaceCommitShasWithLinks(string pullRequestBody, const RunContext& context) {
     // Here I match any commit SHA that starts at the beginning of a line or with a space or "(" before it
     // and ends with either anything other than a number or a letter or the end of the pull request body
     // the "?=" is a regex lookahead which detects this pattern but doesn't include it in the match
@@ -91,8 +92,8 @@ string replaceCommitShasWithLinks(string pullRequestBody) {
         // meaning the second "()" in the regex pattern which is the commit SHA itself
         string currentSha = currentShaMatch.str(2);
         result.erase(currentShaMatch.position(2) + numberOfNewCharactersAdded, currentShaMatch.length(2));
-        result.insert(currentShaMatch.position(2) + numberOfNewCharactersAdded, "[" + currentSha.substr(0, 6) + "](" + config.repoCommitsUrl + currentSha + ")");
-        numberOfNewCharactersAdded += 4 + config.repoCommitsUrl.length() + 6;
+        result.insert(currentShaMatch.position(2) + numberOfNewCharactersAdded, "[" + currentSha.substr(0, 6) + "](" + context.repoCommitsUrl + currentSha + ")");
+        numberOfNewCharactersAdded += 4 + context.repoCommitsUrl.length() + 6;
     }
 
     return result;
@@ -118,16 +119,58 @@ string removeExtraNewLines(string pullRequestBody) {
 /**
  * @brief Makes the formatting of the retrieved PR body look like the PR on GitHub
  * @param pullRequestBody The original body/description of the retrieved PR
+ * @param context The context of the generation, which contains the repository URLs that the links point to
  * @return PR body/description after formatting it
  */
-string formatPullRequestBody(string pullRequestBody) {
-    pullRequestBody = replaceHashIdsWithLinks(pullRequestBody);
-    pullRequestBody = replaceCommitShasWithLinks(pullRequestBody);
+string formatPullRequestBody(string pullRequestBody, const RunContext& context) {
+    ProfileScope formatTimer(ProfilePhases::FormatPullRequestBody);
+    formatTimer.addTraceArgument("bytes", pullRequestBody.size());
+    pullRequestBody = replaceHashIdsWithLinks(pullRequestBody, context);
+    pullRequestBody = replaceCommitShasWithLinks(pullRequestBody, context);
     pullRequestBody = removeExtraNewLines(pullRequestBody);
 
     return pullRequestBody;
 }
 
+/**
+ * @brief Splits the given conventional commit title into its scope (subcategory) and its description
+ * Example: "fix(GUI): fixed bug X" is split into "GUI" and "Fixed bug X"
+ * @param conventionalCommitTitle The conventional commit title
+ * @param matchResult CommitTypeMatchResult that this title got with it's conventional commit type (has subcategory or no)
+ * @param scope Gets the subcategory between the parentheses, or an empty string if the title doesn't have one
+ * @param description Gets the title without the commit type, with its first letter capitalized
+ */
+void splitConventionalCommitTitle(string conventionalCommitTitle, CommitTypeMatchResults matchResult, string& scope, string& description) {
+    scope = "";
+    if (matchResult == CommitTypeMatchResults::MatchWithSubCategory) {
+        size_t startPos = conventionalCommitTitle.find("(") + 1;
+        scope = conventionalCommitTitle.substr(startPos, conventionalCommitTitle.find(")") - startPos);
+    }
+
+    description = "";
+
+    // Removing the commit type from the conventional commit title and capitalizing the first letter
+    size_t colonPosition = conventionalCommitTitle.find(":");
+    // Subjects that end right after the colon (e.g., "fix:") have no description
+    if (colonPosition != string::npos && colonPosition + 2 <= conventionalCommitTitle.size()) {
+        description = conventionalCommitTitle.substr(colonPosition + 2);
+    }
+    description[0] = toupper(description[0]);
+}
+
+/**
+ * @brief Creates the text shown before a release note title for its subcategory
+ * Example: "GUI" becomes "(GUI Related) "
+ * @param scope The subcategory of the commit type
+ * @return The subcategory text
+ */
+string formatReleaseNoteScope(string scope) {
+    string subCategoryText = "(" + scope + " Related) ";
+    // Capitalizing the first letter in the subcategory
+    subCategoryText[1] = toupper(subCategoryText[1]);
+    return subCategoryText;
+}
+
 /**
  * @brief Converts the given conventional commit title to a better markdown title that could be used in the release notes
  * Example: "fix: fixed bug X" gets converted to "### Fixed bug X"
@@ -138,30 +181,63 @@ string formatPullRequestBody(string pullRequestBody) {
  */
 string convertConventionalCommitTitleToReleaseNoteTitle(string conventionalCommitTitle, CommitTypeMatchResults matchResult, 
                                                         string markdownPrefix) {
-    string subCategoryText = "";
+    string scope, releaseNoteTitle;
+    splitConventionalCommitTitle(conventionalCommitTitle, matchResult, scope, releaseNoteTitle);
 
+    // Inserting the commit type subcategory
     if (matchResult == CommitTypeMatchResults::MatchWithSubCategory) {
-        size_t startPos = conventionalCommitTitle.find("(") + 1;
-        // Adding the subcategory title
-        subCategoryText = "(" + conventionalCommitTitle.substr(startPos, conventionalCommitTitle.find(")") - startPos) + " Related) ";
-        // Capitalizing the first letter in the subcategory
-        subCategoryText[1] = toupper(subCategoryText[1]);
+        releaseNoteTitle.insert(0, formatReleaseNoteScope(scope));
     }
 
-    string releaseNoteTitle = "";
+    // Adding the markdown prefix
+    releaseNoteTitle = markdownPrefix + releaseNoteTitle + "\n";
 
-    // Removing the commit type from the conventional commit title and capitalizing the first letter
-    size_t colonPosition = conventionalCommitTitle.find(":");
-    if (colonPosition != string::npos) {
-        releaseNoteTitle = conventionalCommitTitle.substr(colonPosition + 2);
+    return releaseNoteTitle;
+}
+
+/**
+ * @brief Gets the title and number of the pull request that a commit came from, using only the commit message
+ * This works for squash merges, where the subject is the pull request title followed by " (#number)",
+ * and for merge commits, where the subject is "Merge pull request #number from ..." and the body starts with the pull request title
+ * @param commitSubject The subject (first line) of the commit message
+ * @param commitBody The body of the commit message (after the subject and the blank line)
+ * @param pullRequestTitle Gets the pull request title if it was found
+ * @param pullRequestNumber Gets the pull request number if it was found (even if the title wasn't found)
+ * @return True if the pull request title was found in the commit message, false otherwise
+ */
+bool extractLocalPullRequestTitle(const string& commitSubject, const string& commitBody, string& pullRequestTitle,
+                                  string& pullRequestNumber) {
+    const string mergeCommitPrefix = "Merge pull request #";
+
+    if (commitSubject.compare(0, mergeCommitPrefix.size(), mergeCommitPrefix) == 0) {
+        size_t numberEnd = commitSubject.find_first_not_of("0123456789", mergeCommitPrefix.size());
+        if (numberEnd == mergeCommitPrefix.size()) {
+            return false;
+        }
+        pullRequestNumber = commitSubject.substr(mergeCommitPrefix.size(), numberEnd - mergeCommitPrefix.size());
+
+        pullRequestTitle = commitBody.substr(0, commitBody.find('\n'));
+        // Removing "\r" and spaces at the end of the title
+        pullRequestTitle.erase(pullRequestTitle.find_last_not_of(" \r") + 1);
+        return !pullRequestTitle.empty();
     }
-    releaseNoteTitle[0] = toupper(releaseNoteTitle[0]);
 
-    // Inserting the commit type subcategory (will be empty if there is no subcategory)
-    releaseNoteTitle.insert(0, subCategoryText);
+    // Squash merges end with " (#number)"
+    if (commitSubject.size() < 5 || commitSubject.back() != ')') {
+        return false;
+    }
 
-    // Adding the markdown prefix
-    releaseNoteTitle = markdownPrefix + releaseNoteTitle + "\n";
+    size_t suffixStart = commitSubject.rfind(" (#");
+    if (suffixStart == string::npos || suffixStart == 0) {
+        return false;
+    }
 
-    return releaseNoteTitle;
+    string number = commitSubject.substr(suffixStart + 3, commitSubject.size() - suffixStart - 4);
+    if (number.empty() || number.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+
+    pullRequestNumber = number;
+    pullRequestTitle = commitSubject.substr(0, suffixStart);
+    return true;
 }
@@ -8,13 +8,18 @@
 
 #include <string>
 #include "Enums.h"
+#include "RunContext.h"
 
 using namespace std;
 
 string indentAllLinesInString(string s);
-string replaceHashIdsWithLinks(string pullRequestBody);
-string replaceCommitShasWithLinks(string pullRequestBody);
+string replaceHashIdsWithLinks(string pullRequestBody, const RunContext& context);
+string replaceCommitShasWithLinks(string pullRequestBody, const RunContext& context);
 string removeExtraNewLines(string pullRequestBody);
-string formatPullRequestBody(string pullRequestBody);
+string formatPullRequestBody(string pullRequestBody, const RunContext& context);
+void splitConventionalCommitTitle(string conventionalCommitTitle, CommitTypeMatchResults matchResult, string& scope, string& description);
+string formatReleaseNoteScope(string scope);
 string convertConventionalCommitTitleToReleaseNoteTitle(string conventionalCommitTitle, CommitTypeMatchResults matchResult, 
                                                         string markdownPrefix);
+bool extractLocalPullRequestTitle(const string& commitSubject, const string& commitBody, string& pullRequestTitle,
+                                  string& pullRequestNumber);
\ No newline at end of file
@@ -0,0 +1,174 @@
+/**
+ * @file Generator.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements functions in Generator.h
+ */
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <json.hpp>
+
+#include "Generator.h"
+#include "Config.h"
+#include "Enums.h"
+#include "Utils.h"
+#include "GitObjects.h"
+#include "Pipeline.h"
+#include "RunContext.h"
+#include "ReleaseNotes.h"
+#include "Profiler.h"
+#include "Http.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Checks that the given git references exist in the repository of the context with a single lookup, through the git process
+ * of the repository kept by the context, or through a git process started for this lookup if the context doesn't keep any
+ * @param references The git references (commit SHAs, tag names, etc.)
+ * @param context The context of the generation (local git repository)
+ * @throws runtime_error gitReferenceNotFoundError followed by the first reference that doesn't exist
+ */
+void checkGitReferencesExist(const vector<string>& references, const RunContext& context) {
+    ProfileScope lookupTimer(ProfilePhases::GitReferencesLookup);
+
+    vector<GitObjectInfo> objects;
+    if (context.gitObjects) {
+        objects = context.gitObjects->lookup(context.repositoryDirectory, references);
+    }
+    else {
+        GitCatFile gitObjects(false, context.repositoryDirectory);
+        objects = gitObjects.lookup(references);
+    }
+
+    for (const GitObjectInfo& reference : objects) {
+        if (!reference.exists) {
+            throw runtime_error(context.config.gitReferenceNotFoundError + reference.name);
+        }
+    }
+}
+
+/**
+ * @brief Generates release notes using commit messages between the start reference and the end reference
+ * using the given release notes source and if the source is pull requests then generates them based on the release note mode
+ * and using the given GitHub token
+ * @param releaseNoteSource The source to generate release notes from (commit messages or pull requests)
+ * @param releaseStartRef The git reference (commit SHA or tag name) that references the commit directly before the
+ * commit that starts the commit messages of the release, for example, the tag name of the previous release
+ * @param releaseEndRef The git reference (commit SHA or tag name) that references the end of the commit messages of the release
+ * @param releaseNoteMode The release notes mode when the source is pull requests
+ * @param context The context of the generation (GitHub repository and token, local git repository)
+ * @return The release notes, which can be rendered in any output format
+ */
+ReleaseNotes buildReleaseNotes(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                               ReleaseNoteModes releaseNoteMode, const RunContext& context) {
+    ProfileScope generationTimer(ProfilePhases::Generation);
+
+    // Validating both references before running any git log command, so that a wrong reference is reported clearly
+    // instead of failing the first git log command
+    checkGitReferencesExist({releaseStartRef, releaseEndRef}, context);
+
+    ReleaseNotesPipeline pipeline(releaseNoteSource, releaseStartRef, releaseEndRef, releaseNoteMode, context);
+    return pipeline.run();
+}
+
+/**
+ * @brief Generates markdown release notes, see buildReleaseNotes()
+ * @return The markdown release notes
+ */
+string generateMarkdownReleaseNotes(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                    ReleaseNoteModes releaseNoteMode, const RunContext& context) {
+    return renderMarkdownReleaseNotes(buildReleaseNotes(releaseNoteSource, releaseStartRef, releaseEndRef, releaseNoteMode, context),
+                                      context.config, context.workers);
+}
+
+/**
+ * @brief Generates the change note of a single pull request using the GitHub API (Not using commit messages at all)
+ * @param pullRequestNumber The number of the pull request (e.g., 13, 144, 3722, etc.)
+ * @param context The context of the generation (GitHub repository and token)
+ * @return The change note as release notes with a single section, or without any section if the pull request title
+ * doesn't use any of the commit types
+ */
+ReleaseNotes fetchPullRequestChangeNote(string pullRequestNumber, const RunContext& context) {
+    string jsonResponse = getPullRequestInfo(pullRequestNumber, context.config.githubApiRequestTimeoutSeconds * 1000L, context);
+    return buildPullRequestChangeNote(parsePullRequestInfo(jsonResponse), context);
+}
+
+/**
+ * @brief Generates the change notes of many pull requests, the pull requests are all fetched at the same time
+ * over the same GitHub API connections, a pull request that can't be fetched doesn't stop the others
+ * @param pullRequestNumbers The numbers of the pull requests
+ * @param errors Set to the error of each pull request, empty for the pull requests whose change note was generated
+ * @param context The context of the generation (GitHub repository and token)
+ * @return The change note of each pull request, see fetchPullRequestChangeNote()
+ */
+vector<ReleaseNotes> fetchPullRequestsChangeNotes(const vector<string>& pullRequestNumbers, vector<string>& errors,
+                                                  const RunContext& context) {
+    const Config& config = context.config;
+
+    vector<HttpRequest> pullRequestInfoRequests;
+    for (const string& pullRequestNumber : pullRequestNumbers) {
+        pullRequestInfoRequests.push_back(createPullRequestInfoRequest(pullRequestNumber, config.githubApiRequestTimeoutSeconds * 1000L,
+                                                                       context));
+    }
+    vector<HttpResponse> pullRequestInfoResponses = getGithubApiClient().performAll(pullRequestInfoRequests,
+                                                                                    config.githubApiConcurrentRequests);
+
+    vector<ReleaseNotes> pullRequestsChangeNotes(pullRequestNumbers.size());
+    errors.assign(pullRequestNumbers.size(), "");
+    for (size_t i = 0; i < pullRequestNumbers.size(); i++) {
+        try {
+            string jsonResponse = checkPullRequestInfoResponse(pullRequestInfoResponses[i], pullRequestInfoRequests[i].url, config);
+            pullRequestsChangeNotes[i] = buildPullRequestChangeNote(parsePullRequestInfo(jsonResponse), context);
+        }
+        catch (const exception& e) {
+            errors[i] = e.what();
+        }
+    }
+
+    return pullRequestsChangeNotes;
+}
+
+/**
+ * @brief Generates the markdown change note of a single pull request, see fetchPullRequestChangeNote()
+ * @return The change note, or an empty string if the pull request title doesn't use any of the commit types
+ */
+string generateMarkdownPullRequestChangeNote(string pullRequestNumber, const RunContext& context) {
+    return renderMarkdownReleaseNotes(fetchPullRequestChangeNote(pullRequestNumber, context), context.config);
+}
+
+/**
+ * @brief Creates the change note of a single pull request in the section of its conventional commit type category
+ * @param pullRequestInfo JSON object containing raw pull request information
+ * @param context The context of the generation, which contains the config and the repository URLs that the note links to
+ * @return The change note as release notes with a single section, or without any section if the pull request title
+ * doesn't use any of the commit types
+ */
+ReleaseNotes buildPullRequestChangeNote(json pullRequestInfo, const RunContext& context) {
+    const Config& config = context.config;
+    ReleaseNotes pullRequestChangeNote;
+    for (int commitTypeIndex = 0; commitTypeIndex < config.commitTypesCount; commitTypeIndex++)
+    {
+        if (checkCommitTypeMatch(pullRequestInfo["title"], commitTypeIndex, config) != CommitTypeMatchResults::NoMatch) {
+            pullRequestChangeNote.sections.push_back(createReleaseNotesSection(commitTypeIndex, config));
+            pullRequestChangeNote.sections.back().notes.push_back(
+                createPullRequestReleaseNote(pullRequestInfo, ReleaseNoteModes::Full, commitTypeIndex, context));
+            if (context.notesStream) {
+                context.notesStream->write(pullRequestChangeNote.sections.back(), pullRequestChangeNote.sections.back().notes.back());
+            }
+            break;
+        }
+    }
+
+    return pullRequestChangeNote;
+}
+
+/**
+ * @brief Creates the markdown change note of a single pull request, see buildPullRequestChangeNote()
+ * @return The change note, or an empty string if the pull request title doesn't use any of the commit types
+ */
+string createPullRequestChangeNote(json pullRequestInfo, const RunContext& context) {
+    return renderMarkdownReleaseNotes(buildPullRequestChangeNote(pullRequestInfo, context), context.config);
+}
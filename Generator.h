@@ -0,0 +1,36 @@
+/**
+ * @file Generator.h
+ * @author Ahmed Khaled
+ * @brief This file defines the functions that generate release notes and change notes without writing them anywhere,
+ * either as ReleaseNotes (rendered in any format with the renderers of ReleaseNotes.h) or directly as markdown,
+ * they are the entry points of the release notes library, which is used by the CLI, the release notes server and any program embedding it
+ *
+ * Usage: load a Config once, call curl_global_init() once, then create a RunContext for each generation,
+ * generations with different contexts can run at the same time from different threads
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include "Enums.h"
+#include "RunContext.h"
+#include "ReleaseNotes.h"
+
+using namespace std;
+using namespace nlohmann;
+
+void checkGitReferencesExist(const vector<string>& references, const RunContext& context);
+ReleaseNotes buildReleaseNotes(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                               ReleaseNoteModes releaseNoteMode, const RunContext& context);
+string generateMarkdownReleaseNotes(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                    ReleaseNoteModes releaseNoteMode, const RunContext& context);
+ReleaseNotes fetchPullRequestChangeNote(string pullRequestNumber, const RunContext& context);
+vector<ReleaseNotes> fetchPullRequestsChangeNotes(const vector<string>& pullRequestNumbers, vector<string>& errors,
+                                                  const RunContext& context);
+string generateMarkdownPullRequestChangeNote(string pullRequestNumber, const RunContext& context);
+ReleaseNotes buildPullRequestChangeNote(json pullRequestInfo, const RunContext& context);
+string createPullRequestChangeNote(json pullRequestInfo, const RunContext& context);
@@ -0,0 +1,138 @@
+/**
+ * @file GitLog.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the GitLogReader class defined in GitLog.h
+ */
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+// To allow for code compatibility between different compilers/OS (Microsoft's Visual C++ compiler and GCC)
+#ifdef _WIN32
+#include <io.h>
+#define read _read
+#else
+#include <unistd.h>
+#endif
+
+#include "GitLog.h"
+#include "Probes.h"
+
+using namespace std;
+
+GitLogReader::GitLogReader(int fileDescriptor, size_t blockSize) : fileDescriptor(fileDescriptor), block(blockSize) {}
+
+/**
+ * @brief Reads the available output of git log, waiting for it if there is none yet
+ * @param buffer The buffer to read the output into
+ * @param size Size of the buffer
+ * @return Number of bytes read, or 0 when git log closed its output
+ */
+long GitLogReader::readOutput(char* buffer, size_t size) {
+    long bytesRead;
+    do {
+        bytesRead = read(fileDescriptor, buffer, (unsigned int)size);
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead < 0) {
+        throw runtime_error("Unable to read git log output: " + string(strerror(errno)));
+    }
+    return bytesRead;
+}
+
+/**
+ * @brief Reads the next block of git log output after the data already in the buffer
+ * Data of the record that is still being read is moved to the start of the buffer first, and if the record
+ * fills the whole buffer, the buffer is doubled so that records of any length can be read
+ * @return False if the end of the output was reached or no output is available yet, true otherwise
+ */
+bool GitLogReader::readNextBlock() {
+    if (recordStart > 0) {
+        memmove(block.data(), block.data() + recordStart, dataEnd - recordStart);
+        dataEnd -= recordStart;
+        scannedEnd -= recordStart;
+        recordStart = 0;
+    }
+
+    if (dataEnd == block.size()) {
+        block.resize(block.size() * 2);
+    }
+
+    long bytesRead = readOutput(block.data() + dataEnd, block.size() - dataEnd);
+    if (bytesRead < 0) {
+        return false;
+    }
+    if (bytesRead == 0) {
+        endOfStream = true;
+        return false;
+    }
+
+    dataEnd += bytesRead;
+    return true;
+}
+
+/**
+ * @brief Reads the next commit record from the git log output
+ * @param record The record to fill, its views stay valid until the next call to this function
+ * @return False if there are no more commit records (or none is available yet, see readOutput()), true otherwise
+ */
+bool GitLogReader::nextRecord(CommitRecord& record) {
+    while (true) {
+        const char* terminator = (const char*)memchr(block.data() + scannedEnd, '\0', dataEnd - scannedEnd);
+
+        if (terminator != nullptr) {
+            size_t terminatorPosition = terminator - block.data();
+            record = parseCommitRecord(string_view(block.data() + recordStart, terminatorPosition - recordStart));
+            recordStart = scannedEnd = terminatorPosition + 1;
+            PROBE_COMMIT_READ(record.sha.data(), record.sha.size(), record.subject.size(), record.body.size());
+            return true;
+        }
+
+        scannedEnd = dataEnd;
+
+        if (endOfStream || !readNextBlock()) {
+            // No output is available yet, so the rest of the record is read by the next call
+            if (!endOfStream) {
+                return false;
+            }
+
+            // The last record may not be terminated if the output was cut, so it is returned as it is
+            if (dataEnd > recordStart) {
+                record = parseCommitRecord(string_view(block.data() + recordStart, dataEnd - recordStart));
+                recordStart = scannedEnd = dataEnd;
+                PROBE_COMMIT_READ(record.sha.data(), record.sha.size(), record.subject.size(), record.body.size());
+                return true;
+            }
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Splits a raw commit record (SHA, new line, raw message) into its SHA, subject and body
+ * @param rawRecord A single record from the output of git log with the format in gitLogRecordFormat
+ * @return The commit record, with views into the given raw record
+ */
+CommitRecord parseCommitRecord(string_view rawRecord) {
+    CommitRecord record;
+
+    size_t shaEnd = rawRecord.find('\n');
+    record.sha = rawRecord.substr(0, shaEnd);
+    string_view message = (shaEnd == string_view::npos) ? string_view() : rawRecord.substr(shaEnd + 1);
+
+    size_t subjectEnd = message.find('\n');
+    record.subject = message.substr(0, subjectEnd);
+
+    if (subjectEnd != string_view::npos) {
+        string_view body = message.substr(subjectEnd + 1);
+        // Skipping the blank line(s) between the subject and the body and the new lines git adds at the end of the message
+        body.remove_prefix(min(body.find_first_not_of('\n'), body.size()));
+        size_t bodyEnd = body.find_last_not_of('\n');
+        record.body = (bodyEnd == string_view::npos) ? string_view() : body.substr(0, bodyEnd + 1);
+    }
+
+    return record;
+}
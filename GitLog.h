@@ -0,0 +1,58 @@
+/**
+ * @file GitLog.h
+ * @author Ahmed Khaled
+ * @brief This file defines the GitLogReader class which is used for reading commit records from the output of "git log -z"
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The format passed to "git log" so that its output can be read by GitLogReader
+ * Each commit is printed as its full SHA, a new line, then its raw message (subject + body), and with "-z" every commit ends in a NUL
+ */
+const string gitLogRecordFormat = "--format=%H%n%B";
+
+/**
+ * @brief A single commit read from the output of "git log -z"
+ * All the views point inside the block buffer of the reader that produced them
+ * so they are only valid until the next call to GitLogReader::nextRecord()
+ */
+struct CommitRecord {
+    string_view sha;
+    string_view subject; /**< First line of the commit message, with no length limit and without the new line*/
+    string_view body; /**< Rest of the commit message after the blank line that follows the subject (may be empty)*/
+};
+
+/**
+ * @brief A class for reading NUL-delimited commit records from a file descriptor in large blocks
+ * Records are sliced directly from the block buffer without copying, records bigger than a block make the buffer grow
+ * Reading blocks until the output is available, a subclass whose readOutput() returns -1 when no output is available yet
+ * makes nextRecord() return false until more output comes, before the end of the output is reached
+ */
+class GitLogReader {
+public:
+    explicit GitLogReader(int fileDescriptor, size_t blockSize = 64 * 1024);
+    virtual ~GitLogReader() = default;
+    bool nextRecord(CommitRecord& record);
+
+protected:
+    virtual long readOutput(char* buffer, size_t size);
+
+private:
+    int fileDescriptor;
+    vector<char> block;
+    size_t recordStart = 0; /**< Position in the block of the first byte that wasn't returned yet in a record*/
+    size_t dataEnd = 0; /**< Position in the block right after the last byte read from the file descriptor*/
+    size_t scannedEnd = 0; /**< Position in the block up to which no NUL terminator was found*/
+    bool endOfStream = false;
+
+    bool readNextBlock();
+};
+
+CommitRecord parseCommitRecord(string_view rawRecord);
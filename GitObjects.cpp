@@ -0,0 +1,323 @@
+/**
+ * @file GitObjects.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the GitCatFile class defined in GitObjects.h
+ */
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "GitObjects.h"
+#include "Subprocess.h"
+
+using namespace std;
+
+/**
+ * @brief Starts the background git process
+ * @param withContents Whether lookups should also return the raw contents of the objects (--batch) or only their info (--batch-check)
+ * @param repositoryDirectory Directory of the git repository, empty means the current working directory
+ */
+GitCatFile::GitCatFile(bool withContents, string repositoryDirectory)
+    : withContents(withContents), repositoryDirectory(repositoryDirectory), buffer(64 * 1024) {
+#ifdef _WIN32
+    if (withContents) {
+        throw runtime_error("Looking up the contents of git objects is not supported on Windows");
+    }
+#else
+    catFile = make_unique<Subprocess>(createGitCommand({"cat-file", withContents ? "--batch" : "--batch-check"}, repositoryDirectory), true);
+#endif
+}
+
+GitCatFile::~GitCatFile() {
+    // Closing the input of git tells it that there are no more lookups, so it exits
+    if (catFile) {
+        catFile->closeInput();
+    }
+}
+
+/**
+ * @brief Reads more output of the git process into the buffer after the data that wasn't used yet
+ * @return False if git closed its output, true otherwise
+ */
+bool GitCatFile::fillBuffer() {
+    if (bufferStart > 0) {
+        memmove(buffer.data(), buffer.data() + bufferStart, bufferEnd - bufferStart);
+        bufferEnd -= bufferStart;
+        bufferStart = 0;
+    }
+
+    if (bufferEnd == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    long bytesRead = catFile->readOutput(buffer.data() + bufferEnd, buffer.size() - bufferEnd);
+    if (bytesRead <= 0) {
+        return false;
+    }
+
+    bufferEnd += bytesRead;
+    return true;
+}
+
+/**
+ * @brief Reads a single response header line from the git process (without its new line)
+ */
+string GitCatFile::readLine() {
+    size_t scannedLength = 0;
+    while (true) {
+        const char* lineStart = buffer.data() + bufferStart;
+        const char* newLine = (const char*)memchr(lineStart + scannedLength, '\n', bufferEnd - bufferStart - scannedLength);
+        if (newLine != nullptr) {
+            string line(lineStart, newLine);
+            bufferStart = newLine - buffer.data() + 1;
+            return line;
+        }
+
+        scannedLength = bufferEnd - bufferStart;
+        if (!fillBuffer()) {
+            throw runtime_error("git cat-file exited before answering all lookups");
+        }
+    }
+}
+
+/**
+ * @brief Reads exactly the given number of bytes of object contents from the git process
+ */
+string GitCatFile::readBytes(size_t count) {
+    string bytes;
+    bytes.reserve(count);
+
+    while (bytes.size() < count) {
+        if (bufferStart == bufferEnd && !fillBuffer()) {
+            throw runtime_error("git cat-file exited before answering all lookups");
+        }
+
+        size_t bytesToCopy = min(count - bytes.size(), bufferEnd - bufferStart);
+        bytes.append(buffer.data() + bufferStart, bytesToCopy);
+        bufferStart += bytesToCopy;
+    }
+
+    return bytes;
+}
+
+/**
+ * @brief Parses the response header of a lookup, "<sha> <type> <size>", or "<name> missing" (or "ambiguous") when the object
+ * doesn't exist, the header is parsed from its end since the name of a missing object can contain spaces
+ * @param header The response header, without its new line
+ * @param object Filled with the SHA, the type and the size of the object
+ */
+static void parseLookupHeader(const string& header, GitObjectInfo& object) {
+    static const string notFoundSuffixes[] = {" missing", " ambiguous"};
+    for (const string& notFound : notFoundSuffixes) {
+        if (header.size() >= notFound.size() && header.compare(header.size() - notFound.size(), notFound.size(), notFound) == 0) {
+            return;
+        }
+    }
+
+    size_t sizeStart = header.rfind(' ');
+    size_t typeStart = (sizeStart == string::npos || sizeStart == 0) ? string::npos : header.rfind(' ', sizeStart - 1);
+    if (typeStart == string::npos || sizeStart + 1 == header.size()
+        || header.find_first_not_of("0123456789", sizeStart + 1) != string::npos) {
+        throw runtime_error("Unexpected response of git cat-file: " + header);
+    }
+
+    object.exists = true;
+    object.sha = header.substr(0, typeStart);
+    object.type = header.substr(typeStart + 1, sizeStart - typeStart - 1);
+    object.size = stoul(header.substr(sizeStart + 1));
+}
+
+/**
+ * @brief Looks up the given git objects
+ * The names are written to git in chunks that fit in the input pipe, and the responses of a chunk are read before writing the next one,
+ * so git never waits for the next name within a chunk, and writing never blocks while git is blocked on a full output pipe
+ * @param objectNames Names of the objects (SHAs, tag names, branch names or any git revision expression)
+ * @return Info about each object in the same order as the given names
+ */
+vector<GitObjectInfo> GitCatFile::lookup(const vector<string>& objectNames) {
+    // Smaller than the capacity of a pipe on every platform (at least 4 KB), a longer name is written in a chunk of its own
+    const size_t maxChunkBytes = 4096;
+
+    for (const string& objectName : objectNames) {
+        if (objectName.find('\n') != string::npos) {
+            throw invalid_argument("Git object names can't contain new lines: " + objectName);
+        }
+    }
+
+    lock_guard<mutex> lock(lookupMutex);
+
+    vector<GitObjectInfo> objects;
+    objects.reserve(objectNames.size());
+
+    if (!catFile) {
+        for (const string& objectName : objectNames) {
+            objects.push_back(lookupWithRevParse(objectName));
+        }
+        return objects;
+    }
+
+    size_t chunkStart = 0;
+    while (chunkStart < objectNames.size()) {
+        string requests;
+        size_t chunkEnd = chunkStart;
+        while (chunkEnd < objectNames.size() && (chunkEnd == chunkStart || requests.size() + objectNames[chunkEnd].size() < maxChunkBytes)) {
+            requests += objectNames[chunkEnd++] + "\n";
+        }
+        catFile->writeInput(requests);
+
+        for (size_t i = chunkStart; i < chunkEnd; i++) {
+            GitObjectInfo object;
+            object.name = objectNames[i];
+            parseLookupHeader(readLine(), object);
+
+            if (object.exists && withContents) {
+                object.contents = readBytes(object.size);
+                // Each object's contents are followed by a new line
+                readBytes(1);
+            }
+
+            objects.push_back(move(object));
+        }
+        chunkStart = chunkEnd;
+    }
+
+    return objects;
+}
+
+/**
+ * @brief Looks up a single git object
+ * @param objectName Name of the object (SHA, tag name, branch name or any git revision expression)
+ * @return Info about the object
+ */
+GitObjectInfo GitCatFile::lookup(const string& objectName) {
+    return lookup(vector<string>{objectName})[0];
+}
+
+/**
+ * @brief Looks up a single git object with its own "git rev-parse --verify", used where git cat-file can't be given its input
+ * @param objectName Name of the object (SHA, tag name, branch name or any git revision expression)
+ * @return Whether the object exists and its SHA, without its type and size
+ */
+GitObjectInfo GitCatFile::lookupWithRevParse(const string& objectName) {
+    GitObjectInfo object;
+    object.name = objectName;
+
+    // A name starting with a dash would be read by git as an option, and like git cat-file, an empty name doesn't exist
+    if (objectName.empty() || objectName[0] == '-') {
+        return object;
+    }
+
+    Subprocess revParse(createGitCommand({"rev-parse", "--verify", "--quiet", objectName + "^{object}"}, repositoryDirectory));
+    string sha;
+    char output[128];
+    long bytesRead;
+    while ((bytesRead = revParse.readOutput(output, sizeof(output))) > 0) {
+        sha.append(output, bytesRead);
+    }
+    while (!sha.empty() && (sha.back() == '\n' || sha.back() == '\r')) {
+        sha.pop_back();
+    }
+
+    if (revParse.wait() == 0 && !sha.empty()) {
+        object.exists = true;
+        object.sha = sha;
+    }
+    return object;
+}
+
+/**
+ * @brief Looks up git objects through the git process of the given repository, which is started by the first lookup in it
+ * A running git process sees the references and the objects added to its repository after it started, but not a repository
+ * that replaced its directory (e.g., cloned again), so when an object isn't found, or the process fails, it is replaced
+ * by a new process and the lookup is made again
+ * @param repositoryDirectory Directory of the git repository, empty means the current working directory
+ * @param objectNames Names of the objects (SHAs, tag names, branch names or any git revision expression)
+ * @return Info about each object in the same order as the given names, see GitCatFile::lookup()
+ */
+vector<GitObjectInfo> GitCatFilePool::lookup(const string& repositoryDirectory, const vector<string>& objectNames) {
+    for (int attempt = 0; ; attempt++) {
+        bool isNewProcess = false;
+        shared_ptr<GitCatFile> catFile = getCatFile(repositoryDirectory, attempt > 0, isNewProcess);
+
+        try {
+            vector<GitObjectInfo> objects = catFile->lookup(objectNames);
+            bool isEveryObjectFound = all_of(objects.begin(), objects.end(), [](const GitObjectInfo& object) { return object.exists; });
+            if (isEveryObjectFound || isNewProcess) {
+                return objects;
+            }
+        }
+        catch (const runtime_error&) {
+            if (isNewProcess) {
+                lock_guard<mutex> lock(poolMutex);
+                auto pooledCatFile = catFiles.find(repositoryDirectory);
+                if (pooledCatFile != catFiles.end() && pooledCatFile->second.catFile == catFile) {
+                    repositoriesUseOrder.erase(pooledCatFile->second.useOrderPosition);
+                    catFiles.erase(pooledCatFile);
+                }
+                throw;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the git process of the given repository, starting it if the pool doesn't have one, and marks the repository
+ * as the most recently used, the processes of the least recently used repositories beyond the maximum are closed
+ * (once the lookups that are still using them finish)
+ * @param repositoryDirectory Directory of the git repository, empty means the current working directory
+ * @param isReplacing Whether the process of the repository must be replaced by a new one
+ * @param isNewProcess Set to whether the returned process was started by this call
+ * @return The git process of the repository
+ */
+shared_ptr<GitCatFile> GitCatFilePool::getCatFile(const string& repositoryDirectory, bool isReplacing, bool& isNewProcess) {
+    lock_guard<mutex> lock(poolMutex);
+    auto pooledCatFile = catFiles.find(repositoryDirectory);
+    if (pooledCatFile == catFiles.end()) {
+        repositoriesUseOrder.push_back(repositoryDirectory);
+        pooledCatFile = catFiles.emplace(repositoryDirectory, PooledCatFile{nullptr, prev(repositoriesUseOrder.end())}).first;
+    }
+    else {
+        repositoriesUseOrder.splice(repositoriesUseOrder.end(), repositoriesUseOrder, pooledCatFile->second.useOrderPosition);
+    }
+
+    isNewProcess = !pooledCatFile->second.catFile || isReplacing;
+    if (isNewProcess) {
+        pooledCatFile->second.catFile = make_shared<GitCatFile>(false, repositoryDirectory);
+    }
+    shared_ptr<GitCatFile> catFile = pooledCatFile->second.catFile;
+
+    while (repositoriesUseOrder.size() > maxRepositories) {
+        catFiles.erase(repositoriesUseOrder.front());
+        repositoriesUseOrder.pop_front();
+    }
+    return catFile;
+}
+
+/**
+ * @brief Gets the number of repositories whose git process is kept by the pool
+ */
+size_t GitCatFilePool::getRepositoriesCount() {
+    lock_guard<mutex> lock(poolMutex);
+    return catFiles.size();
+}
+
+/**
+ * @brief Creates the command line of a git command that runs in the given repository, instead of changing the working directory
+ * of the whole process, so that commands for different repositories can run at the same time
+ * @param gitArguments The arguments of the git command (e.g., {"log", "--oneline"})
+ * @param repositoryDirectory Directory of the git repository, empty means the current working directory
+ * @return The command line starting with git
+ */
+vector<string> createGitCommand(vector<string> gitArguments, string repositoryDirectory) {
+    vector<string> gitCommand = {"git"};
+    if (!repositoryDirectory.empty()) {
+        gitCommand.push_back("-C");
+        gitCommand.push_back(repositoryDirectory);
+    }
+    gitCommand.insert(gitCommand.end(), gitArguments.begin(), gitArguments.end());
+    return gitCommand;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file GitObjects.h
+ * @author Ahmed Khaled
+ * @brief This file defines the GitCatFile class which is used for looking up git objects (commits, tags, etc.) through one long running git process
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "Subprocess.h"
+
+using namespace std;
+
+/**
+ * @brief Information about a single git object returned by GitCatFile
+ */
+struct GitObjectInfo {
+    string name; /**< The name (SHA, tag name, branch name, etc.) that was looked up*/
+    bool exists = false;
+    string sha; /**< Full SHA of the object (empty if it doesn't exist)*/
+    string type; /**< Type of the object: commit, tree, blob or tag (empty if it doesn't exist)*/
+    size_t size = 0;
+    string contents; /**< Raw contents of the object, only filled when the lookup includes contents*/
+};
+
+/**
+ * @brief A class for looking up git objects through "git cat-file --batch" or "git cat-file --batch-check" running in the background
+ * The git process is started once and kept alive, and the names of a lookup are written to it in chunks without waiting
+ * for each response, so thousands of objects can be looked up without starting a new process for each one
+ * On Windows, where programs can't be given an input pipe (see Subprocess), each object is looked up with its own "git rev-parse --verify",
+ * which only fills whether it exists and its SHA, and the contents can't be looked up
+ */
+class GitCatFile {
+public:
+    explicit GitCatFile(bool withContents, string repositoryDirectory = "");
+    ~GitCatFile();
+
+    vector<GitObjectInfo> lookup(const vector<string>& objectNames);
+    GitObjectInfo lookup(const string& objectName);
+
+private:
+    bool withContents;
+    string repositoryDirectory;
+    unique_ptr<Subprocess> catFile; /**< Null on Windows*/
+    mutex lookupMutex;
+    vector<char> buffer;
+    size_t bufferStart = 0;
+    size_t bufferEnd = 0;
+
+    bool fillBuffer();
+    string readLine();
+    string readBytes(size_t count);
+    GitObjectInfo lookupWithRevParse(const string& objectName);
+};
+
+/**
+ * @brief Keeps one GitCatFile (without contents) per repository directory for the whole life of a long running process,
+ * like the release notes server or a manifest run, so that the lookups of all its generations are answered by git processes
+ * that are started once per repository instead of once per generation
+ * Only the processes of the most recently used repositories are kept, the process of the least recently used one is closed
+ * when a repository beyond the maximum is looked up in (e.g., a server receiving requests for many directories)
+ */
+class GitCatFilePool {
+public:
+    explicit GitCatFilePool(size_t maxRepositories) : maxRepositories(maxRepositories) {}
+
+    vector<GitObjectInfo> lookup(const string& repositoryDirectory, const vector<string>& objectNames);
+    size_t getRepositoriesCount();
+
+private:
+    struct PooledCatFile {
+        shared_ptr<GitCatFile> catFile;
+        list<string>::iterator useOrderPosition;
+    };
+
+    size_t maxRepositories;
+    mutex poolMutex;
+    map<string, PooledCatFile> catFiles; /**< Repository directory -> its git process*/
+    list<string> repositoriesUseOrder; /**< Repository directories from the least to the most recently used*/
+
+    shared_ptr<GitCatFile> getCatFile(const string& repositoryDirectory, bool isReplacing, bool& isNewProcess);
+};
+
+vector<string> createGitCommand(vector<string> gitArguments, string repositoryDirectory);
@@ -0,0 +1,713 @@
+/**
+ * @file Http.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the HttpClient, HttpTelemetry and HttpRecording classes defined in Http.h
+ */
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <stdexcept>
+#include <cctype>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <map>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <fstream>
+#include <filesystem>
+
+#include <curl/curl.h>
+
+#include "Http.h"
+#include "Utils.h"
+#include "Profiler.h"
+
+using namespace std;
+
+HttpClient::HttpClient() {
+    share = curl_share_init();
+    if (!share) {
+        throw runtime_error("Unable to initialize libcurl shared connections");
+    }
+
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShare);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+HttpClient::~HttpClient() {
+    for (CURL* curl : idleHandles) {
+        curl_easy_cleanup(curl);
+    }
+    curl_share_cleanup(share);
+}
+
+void HttpClient::lockShare(CURL*, curl_lock_data data, curl_lock_access, void* client) {
+    ((HttpClient*)client)->shareMutexes[data].lock();
+}
+
+void HttpClient::unlockShare(CURL*, curl_lock_data data, void* client) {
+    ((HttpClient*)client)->shareMutexes[data].unlock();
+}
+
+/**
+ * @brief Callback function that libcurl calls for each response header, used to keep the ETag header of the response
+ * and the number of GitHub API requests left before the rate limit is reached
+ */
+size_t HttpClient::handleHeaderCallBack(char* data, size_t size, size_t numOfBytes, HttpResponse* response) {
+    size_t totalSize = size * numOfBytes;
+    string header(data, totalSize);
+
+    size_t nameEnd = header.find(':');
+    if (nameEnd == string::npos) {
+        return totalSize;
+    }
+    string headerName = header.substr(0, nameEnd);
+    for (char& c : headerName) {
+        c = (char)tolower((unsigned char)c);
+    }
+
+    size_t valueStart = header.find_first_not_of(" \t", nameEnd + 1);
+    size_t valueEnd = header.find_last_not_of(" \t\r\n");
+    string headerValue = (valueStart == string::npos || valueEnd < valueStart) ? "" : header.substr(valueStart, valueEnd - valueStart + 1);
+
+    if (headerName == "etag") {
+        response->etag = headerValue;
+    }
+    else if (headerName == "x-ratelimit-remaining") {
+        response->rateLimitRemaining = strtol(headerValue.c_str(), NULL, 10);
+    }
+
+    return totalSize;
+}
+
+/**
+ * @brief Gets a libcurl handle for a new request, reusing the handle of a finished request if there is one
+ * @return The handle, or NULL if libcurl couldn't create a new one
+ */
+CURL* HttpClient::acquireHandle() {
+    {
+        lock_guard<mutex> lock(idleHandlesMutex);
+        if (!idleHandles.empty()) {
+            CURL* curl = idleHandles.back();
+            idleHandles.pop_back();
+            return curl;
+        }
+    }
+
+    return curl_easy_init();
+}
+
+void HttpClient::releaseHandle(CURL* curl) {
+    lock_guard<mutex> lock(idleHandlesMutex);
+    idleHandles.push_back(curl);
+}
+
+/**
+ * @brief Sets all the options of the given request on a libcurl handle
+ * @return The list of request headers, which must be freed after the request finishes
+ */
+struct curl_slist* HttpClient::prepareHandle(CURL* curl, const HttpRequest& request, HttpResponse& response) {
+    curl_easy_reset(curl);
+
+    struct curl_slist* headers = NULL;
+    for (const string& header : request.headers) {
+        headers = curl_slist_append(headers, header.c_str());
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, handleApiCallBack);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, handleHeaderCallBack);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, "Ahmed-Khaled-dev");
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_SHARE, share);
+    // Requests are made from several threads at the same time, and libcurl can't use signals in that case
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, request.timeoutMilliseconds);
+
+    if (!request.postData.empty()) {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)request.postData.size());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.postData.c_str());
+    }
+
+    return headers;
+}
+
+/**
+ * @brief Records a finished request in the network metrics, the profile, the trace and the recording of the run
+ * (--network-stats, --profile, --trace, --record)
+ * @param curl The handle of the request, before it is reused
+ * @param request The request
+ * @param response The response of the request
+ * @param isOverlapping Whether other requests of the same thread may have run at the same time (requests of a curl multi handle)
+ */
+static void recordRequest(CURL* curl, const HttpRequest& request, const HttpResponse& response, bool isOverlapping) {
+    if (getHttpTelemetry().isEnabled()) {
+        getHttpTelemetry().record(curl, response);
+    }
+
+    Profiler& profiler = getProfiler();
+    if (!profiler.isActive() && !getHttpRecording().isRecording()) {
+        return;
+    }
+
+    curl_off_t totalMicroseconds = 0;
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalMicroseconds);
+    if (getHttpRecording().isRecording()) {
+        getHttpRecording().record(request, response, totalMicroseconds / 1000.0);
+    }
+    if (!profiler.isActive()) {
+        return;
+    }
+
+    chrono::nanoseconds duration = chrono::microseconds(totalMicroseconds);
+
+    json traceArguments;
+    if (profiler.isTracing()) {
+        char* url = NULL;
+        curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &url);
+        traceArguments["url"] = url ? url : "";
+        traceArguments["status"] = response.httpCode;
+        traceArguments["bytes"] = response.body.size();
+        // Conditional requests (If-None-Match) are answered with 304 when the cached response is still valid
+        traceArguments["cacheHit"] = response.httpCode == 304;
+        if (response.resultCode != CURLE_OK) {
+            traceArguments["error"] = curl_easy_strerror(response.resultCode);
+        }
+    }
+
+    profiler.recordOccurrence(ProfilePhases::HttpRequest, chrono::steady_clock::now() - duration, duration, move(traceArguments), isOverlapping);
+}
+
+/**
+ * @brief Makes a single request and waits for its response, can be called from several threads at the same time
+ * @param request The request to make
+ * @return The response of the request
+ */
+HttpResponse HttpClient::perform(const HttpRequest& request) {
+    HttpResponse response;
+    if (getHttpRecording().isReplaying()) {
+        getHttpRecording().waitLikeRecording(getHttpRecording().replay(request, response));
+        return response;
+    }
+
+    CURL* curl = acquireHandle();
+    if (!curl) {
+        response.resultCode = CURLE_FAILED_INIT;
+        return response;
+    }
+
+    struct curl_slist* headers = prepareHandle(curl, request, response);
+
+    response.resultCode = curl_easy_perform(curl);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.httpCode);
+    recordRequest(curl, request, response, false);
+
+    curl_slist_free_all(headers);
+    releaseHandle(curl);
+    return response;
+}
+
+/**
+ * @brief Makes all the given requests from the current thread, with up to the given number of requests running at the same time
+ * @param requests The requests to make
+ * @param maxConcurrentRequests Maximum number of requests running at the same time
+ * @return The responses of the requests, in the same order as the requests
+ */
+vector<HttpResponse> HttpClient::performAll(const vector<HttpRequest>& requests, int maxConcurrentRequests) {
+    vector<HttpResponse> responses(requests.size());
+    vector<struct curl_slist*> requestsHeaders(requests.size(), NULL);
+
+    if (getHttpRecording().isReplaying()) {
+        // The recorded requests are spread over the same number of concurrent requests to wait as long as they took together
+        vector<double> concurrentRequestsMilliseconds(max(maxConcurrentRequests, 1), 0);
+        for (size_t i = 0; i < requests.size(); i++) {
+            *min_element(concurrentRequestsMilliseconds.begin(), concurrentRequestsMilliseconds.end())
+                += getHttpRecording().replay(requests[i], responses[i]);
+        }
+        getHttpRecording().waitLikeRecording(*max_element(concurrentRequestsMilliseconds.begin(), concurrentRequestsMilliseconds.end()));
+        return responses;
+    }
+
+    CURLM* multi = curl_multi_init();
+    if (!multi) {
+        for (HttpResponse& response : responses) {
+            response.resultCode = CURLE_FAILED_INIT;
+        }
+        return responses;
+    }
+
+    size_t nextRequest = 0;
+    int runningRequests = 0;
+
+    auto startNextRequest = [&]() {
+        CURL* curl = beginRequest(requests[nextRequest], responses[nextRequest], requestsHeaders[nextRequest]);
+        if (!curl) {
+            nextRequest++;
+            return;
+        }
+
+        // The index of the request is kept in the handle to know which response it belongs to when it finishes
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)nextRequest);
+        curl_multi_add_handle(multi, curl);
+        nextRequest++;
+        runningRequests++;
+    };
+
+    while (nextRequest < requests.size() && runningRequests < maxConcurrentRequests) {
+        startNextRequest();
+    }
+
+    while (runningRequests > 0) {
+        int stillRunning;
+        curl_multi_perform(multi, &stillRunning);
+
+        CURLMsg* message;
+        int messagesLeft;
+        while ((message = curl_multi_info_read(multi, &messagesLeft)) != NULL) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+
+            CURL* curl = message->easy_handle;
+            CURLcode resultCode = message->data.result;
+            void* requestIndex;
+            curl_easy_getinfo(curl, CURLINFO_PRIVATE, &requestIndex);
+
+            curl_multi_remove_handle(multi, curl);
+            endRequest(curl, resultCode, requests[(size_t)requestIndex], responses[(size_t)requestIndex], requestsHeaders[(size_t)requestIndex]);
+            runningRequests--;
+
+            while (nextRequest < requests.size() && runningRequests < maxConcurrentRequests) {
+                startNextRequest();
+            }
+        }
+
+        if (runningRequests > 0) {
+            curl_multi_wait(multi, NULL, 0, 1000, NULL);
+        }
+    }
+
+    curl_multi_cleanup(multi);
+    return responses;
+}
+
+/**
+ * @brief Creates the handle of a request that is run by the caller's curl multi handle
+ * @param request The request to make
+ * @param response The response that is filled while the request runs, it must stay valid until endRequest() is called
+ * @param headers Set to the list of request headers, which must be given to endRequest()
+ * @return The handle, or NULL if the response is already complete: when libcurl couldn't create a new handle (the result code
+ * of the response is set) or when the request is replayed (--replay, replayed requests of a curl multi handle don't wait)
+ */
+CURL* HttpClient::beginRequest(const HttpRequest& request, HttpResponse& response, struct curl_slist*& headers) {
+    if (getHttpRecording().isReplaying()) {
+        getHttpRecording().replay(request, response);
+        headers = NULL;
+        return NULL;
+    }
+
+    CURL* curl = acquireHandle();
+    if (!curl) {
+        response.resultCode = CURLE_FAILED_INIT;
+        headers = NULL;
+        return NULL;
+    }
+
+    headers = prepareHandle(curl, request, response);
+    return curl;
+}
+
+/**
+ * @brief Completes the response of a request started with beginRequest() after it finishes, then keeps its handle for later requests
+ * @param curl The handle of the request, already removed from the caller's curl multi handle
+ * @param resultCode The result of the request reported by the curl multi handle
+ * @param request The request given to beginRequest()
+ * @param response The response of the request
+ * @param headers The list of request headers set by beginRequest()
+ */
+void HttpClient::endRequest(CURL* curl, CURLcode resultCode, const HttpRequest& request, HttpResponse& response, struct curl_slist* headers) {
+    response.resultCode = resultCode;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.httpCode);
+    recordRequest(curl, request, response, true);
+
+    curl_slist_free_all(headers);
+    releaseHandle(curl);
+}
+
+/**
+ * @brief Gets the network metrics of all the requests made by the process
+ */
+HttpTelemetry& getHttpTelemetry() {
+    static HttpTelemetry httpTelemetry;
+    return httpTelemetry;
+}
+
+/**
+ * @brief Records the metrics of a finished request from its libcurl handle
+ * @param curl The handle of the request, before it is reused
+ * @param response The response of the request
+ */
+void HttpTelemetry::record(CURL* curl, const HttpResponse& response) {
+    HttpRequestMetrics metrics;
+    char* url = NULL;
+    curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &url);
+    metrics.url = url ? url : "";
+    metrics.httpCode = response.httpCode;
+    metrics.rateLimitRemaining = response.rateLimitRemaining;
+
+    long httpVersion = CURL_HTTP_VERSION_NONE;
+    curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &httpVersion);
+    if (httpVersion == CURL_HTTP_VERSION_1_0) {
+        metrics.httpVersion = "1.0";
+    }
+    else if (httpVersion == CURL_HTTP_VERSION_1_1) {
+        metrics.httpVersion = "1.1";
+    }
+    else if (httpVersion == CURL_HTTP_VERSION_2_0) {
+        metrics.httpVersion = "2";
+    }
+    else if (httpVersion == CURL_HTTP_VERSION_3) {
+        metrics.httpVersion = "3";
+    }
+
+    long newConnections = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &newConnections);
+    metrics.isConnectionReused = (response.resultCode == CURLE_OK && newConnections == 0);
+
+    // libcurl gives the time from the start of the request to the end of each step, the steps are the differences between them
+    curl_off_t nameLookupTime = 0, connectTime = 0, tlsTime = 0, startTransferTime = 0, totalTime = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &nameLookupTime);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connectTime);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &tlsTime);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &startTransferTime);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalTime);
+    metrics.dnsMilliseconds = nameLookupTime / 1e3;
+    metrics.connectMilliseconds = max<curl_off_t>(connectTime - nameLookupTime, 0) / 1e3;
+    metrics.tlsMilliseconds = (tlsTime > 0) ? max<curl_off_t>(tlsTime - connectTime, 0) / 1e3 : 0;
+    metrics.timeToFirstByteMilliseconds = startTransferTime / 1e3;
+    metrics.totalMilliseconds = totalTime / 1e3;
+
+    curl_off_t bodyBytes = 0;
+    long headerBytes = 0;
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &bodyBytes);
+    curl_easy_getinfo(curl, CURLINFO_HEADER_SIZE, &headerBytes);
+    metrics.responseBytes = bodyBytes + headerBytes;
+
+    record(metrics);
+}
+
+/**
+ * @brief Records the metrics of a finished request
+ */
+void HttpTelemetry::record(const HttpRequestMetrics& metrics) {
+    lock_guard<mutex> lock(requestsMutex);
+    requests.push_back(metrics);
+}
+
+vector<HttpRequestMetrics> HttpTelemetry::getRequests() {
+    lock_guard<mutex> lock(requestsMutex);
+    return requests;
+}
+
+/**
+ * @brief Computes the nearest rank percentile of a list of durations
+ * @param milliseconds The durations, sorted
+ * @param percent The percentile (e.g., 95)
+ */
+static double getPercentile(const vector<double>& milliseconds, size_t percent) {
+    if (milliseconds.empty()) {
+        return 0;
+    }
+    size_t rank = (milliseconds.size() * percent + 99) / 100;
+    return milliseconds[max<size_t>(rank, 1) - 1];
+}
+
+/**
+ * @brief The summary of the metrics of many requests
+ */
+struct HttpTelemetrySummary {
+    size_t reusedConnections = 0;
+    size_t cacheHits = 0; /**< Conditional requests answered with 304 because the cached response was still valid*/
+    long long responseBytes = 0;
+    long lowestRateLimitRemaining = -1;
+    map<string, size_t> httpVersions;
+    map<long, size_t> httpCodes;
+    vector<pair<string, vector<double>>> timings; /**< Name and sorted durations of each step of the requests*/
+};
+
+static HttpTelemetrySummary summarizeRequests(const vector<HttpRequestMetrics>& requests) {
+    HttpTelemetrySummary summary;
+    summary.timings = {{"dns", {}}, {"connect", {}}, {"tls", {}}, {"ttfb", {}}, {"total", {}}};
+
+    for (const HttpRequestMetrics& metrics : requests) {
+        summary.reusedConnections += metrics.isConnectionReused;
+        summary.cacheHits += (metrics.httpCode == 304);
+        summary.responseBytes += metrics.responseBytes;
+        if (metrics.rateLimitRemaining >= 0 &&
+            (summary.lowestRateLimitRemaining < 0 || metrics.rateLimitRemaining < summary.lowestRateLimitRemaining)) {
+            summary.lowestRateLimitRemaining = metrics.rateLimitRemaining;
+        }
+        summary.httpVersions[metrics.httpVersion.empty() ? "none" : metrics.httpVersion]++;
+        summary.httpCodes[metrics.httpCode]++;
+
+        summary.timings[0].second.push_back(metrics.dnsMilliseconds);
+        summary.timings[1].second.push_back(metrics.connectMilliseconds);
+        summary.timings[2].second.push_back(metrics.tlsMilliseconds);
+        summary.timings[3].second.push_back(metrics.timeToFirstByteMilliseconds);
+        summary.timings[4].second.push_back(metrics.totalMilliseconds);
+    }
+
+    for (auto& timing : summary.timings) {
+        sort(timing.second.begin(), timing.second.end());
+    }
+    return summary;
+}
+
+/**
+ * @brief Creates a summary of the metrics of all the requests for people to read
+ * @return The summary, with a table of the median (p50), 95th percentile (p95) and maximum of each step of the requests in milliseconds
+ */
+string HttpTelemetry::createSummary() {
+    vector<HttpRequestMetrics> requests = getRequests();
+    HttpTelemetrySummary summary = summarizeRequests(requests);
+    string report;
+    char row[160];
+
+    snprintf(row, sizeof(row), "%zu requests, %zu on reused connections, %zu answered from the cache (304), %lld bytes received\n",
+             requests.size(), summary.reusedConnections, summary.cacheHits, summary.responseBytes);
+    report += row;
+
+    if (!requests.empty()) {
+        snprintf(row, sizeof(row), "%-10s %10s %10s %10s\n", "step", "p50 ms", "p95 ms", "max ms");
+        report += row;
+        for (const auto& timing : summary.timings) {
+            snprintf(row, sizeof(row), "%-10s %10.3f %10.3f %10.3f\n", timing.first.c_str(), getPercentile(timing.second, 50),
+                     getPercentile(timing.second, 95), timing.second.back());
+            report += row;
+        }
+    }
+
+    string httpVersions;
+    for (const auto& httpVersion : summary.httpVersions) {
+        httpVersions += (httpVersions.empty() ? "" : ", ") + httpVersion.first + " (" + to_string(httpVersion.second) + ")";
+    }
+    string httpCodes;
+    for (const auto& httpCode : summary.httpCodes) {
+        httpCodes += (httpCodes.empty() ? "" : ", ") + to_string(httpCode.first) + " (" + to_string(httpCode.second) + ")";
+    }
+    if (!requests.empty()) {
+        report += "HTTP versions: " + httpVersions + "\nStatuses: " + httpCodes + "\n";
+    }
+    if (summary.lowestRateLimitRemaining >= 0) {
+        report += "Lowest rate limit remaining: " + to_string(summary.lowestRateLimitRemaining) + "\n";
+    }
+
+    return report;
+}
+
+/**
+ * @brief Creates the stats of all the requests in JSON, for other programs to use
+ * @return A JSON object with a "summary" object and a "requests" array that has the metrics of each request, with the times in milliseconds
+ */
+string HttpTelemetry::createJsonStats() {
+    vector<HttpRequestMetrics> requests = getRequests();
+    HttpTelemetrySummary summary = summarizeRequests(requests);
+    json stats;
+
+    stats["summary"]["requests"] = requests.size();
+    stats["summary"]["reusedConnections"] = summary.reusedConnections;
+    stats["summary"]["cacheHits"] = summary.cacheHits;
+    stats["summary"]["responseBytes"] = summary.responseBytes;
+    stats["summary"]["lowestRateLimitRemaining"] = (summary.lowestRateLimitRemaining >= 0) ? json(summary.lowestRateLimitRemaining) : json();
+    stats["summary"]["httpVersions"] = json::object();
+    for (const auto& httpVersion : summary.httpVersions) {
+        stats["summary"]["httpVersions"][httpVersion.first] = httpVersion.second;
+    }
+    stats["summary"]["statuses"] = json::object();
+    for (const auto& httpCode : summary.httpCodes) {
+        stats["summary"]["statuses"][to_string(httpCode.first)] = httpCode.second;
+    }
+    stats["summary"]["timings"] = json::object();
+    for (const auto& timing : summary.timings) {
+        json& timingStats = stats["summary"]["timings"][timing.first + "Ms"];
+        timingStats["p50"] = getPercentile(timing.second, 50);
+        timingStats["p95"] = getPercentile(timing.second, 95);
+        timingStats["max"] = timing.second.empty() ? 0 : timing.second.back();
+    }
+
+    stats["requests"] = json::array();
+    for (const HttpRequestMetrics& metrics : requests) {
+        json request;
+        request["url"] = metrics.url;
+        request["status"] = metrics.httpCode;
+        request["httpVersion"] = metrics.httpVersion;
+        request["connectionReused"] = metrics.isConnectionReused;
+        request["dnsMs"] = metrics.dnsMilliseconds;
+        request["connectMs"] = metrics.connectMilliseconds;
+        request["tlsMs"] = metrics.tlsMilliseconds;
+        request["ttfbMs"] = metrics.timeToFirstByteMilliseconds;
+        request["totalMs"] = metrics.totalMilliseconds;
+        request["responseBytes"] = metrics.responseBytes;
+        request["rateLimitRemaining"] = (metrics.rateLimitRemaining >= 0) ? json(metrics.rateLimitRemaining) : json();
+        stats["requests"].push_back(request);
+    }
+
+    return stats.dump(4) + "\n";
+}
+
+/**
+ * @brief Gets the recording of the HTTP traffic of the process
+ */
+HttpRecording& getHttpRecording() {
+    static HttpRecording httpRecording;
+    return httpRecording;
+}
+
+/**
+ * @brief Starts saving every finished request and its response in the directory, one JSON file per request
+ * @param directory The directory of the recording, it is created if needed and the requests of an earlier recording in it are removed
+ */
+void HttpRecording::startRecording(const string& directory) {
+    filesystem::create_directories(directory);
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(directory)) {
+        if (entry.path().filename().string().compare(0, 8, "request_") == 0 && entry.path().extension() == ".json") {
+            filesystem::remove(entry.path());
+        }
+    }
+
+    this->directory = directory;
+    recording.store(true, memory_order_relaxed);
+}
+
+/**
+ * @brief Loads the requests saved in the directory by startRecording(), then answers the requests of the run with them
+ * @param directory The directory of the recording
+ * @param isInstant Whether replayed requests are answered right away instead of waiting as long as the recorded requests took
+ */
+void HttpRecording::startReplaying(const string& directory, bool isInstant) {
+    vector<filesystem::path> exchangeFiles;
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(directory)) {
+        if (entry.path().filename().string().compare(0, 8, "request_") == 0 && entry.path().extension() == ".json") {
+            exchangeFiles.push_back(entry.path());
+        }
+    }
+    // The files are numbered in the order that the requests finished in
+    sort(exchangeFiles.begin(), exchangeFiles.end());
+
+    for (const filesystem::path& exchangeFile : exchangeFiles) {
+        ifstream file(exchangeFile);
+        json exchangeJson = json::parse(file);
+
+        HttpExchange exchange;
+        exchange.method = exchangeJson["method"];
+        exchange.url = exchangeJson["url"];
+        exchange.postData = exchangeJson["postData"];
+        exchange.response.resultCode = (CURLcode)exchangeJson["resultCode"].get<int>();
+        exchange.response.httpCode = exchangeJson["httpCode"];
+        exchange.response.etag = exchangeJson["etag"];
+        exchange.response.rateLimitRemaining = exchangeJson["rateLimitRemaining"];
+        exchange.response.body = exchangeJson["body"];
+        exchange.totalMilliseconds = exchangeJson["totalMilliseconds"];
+        exchanges[createRequestKey(exchange.method, exchange.url, exchange.postData)].push_back(move(exchange));
+    }
+
+    this->directory = directory;
+    this->isInstant = isInstant;
+    replaying.store(true, memory_order_relaxed);
+}
+
+/**
+ * @brief Stops recording or replaying, later requests are sent normally
+ */
+void HttpRecording::stop() {
+    recording.store(false, memory_order_relaxed);
+    replaying.store(false, memory_order_relaxed);
+
+    lock_guard<mutex> lock(exchangesMutex);
+    exchanges.clear();
+    recordedCount = 0;
+    failedWritesCount = 0;
+}
+
+string HttpRecording::createRequestKey(const string& method, const string& url, const string& postData) {
+    return method + " " + url + "\n" + postData;
+}
+
+/**
+ * @brief Saves a finished request and its response, a request that can't be saved is counted and the run goes on
+ * @param totalMilliseconds How long the request took
+ */
+void HttpRecording::record(const HttpRequest& request, const HttpResponse& response, double totalMilliseconds) {
+    json exchangeJson;
+    exchangeJson["method"] = request.postData.empty() ? "GET" : "POST";
+    exchangeJson["url"] = request.url;
+    exchangeJson["postData"] = request.postData;
+    exchangeJson["resultCode"] = (int)response.resultCode;
+    exchangeJson["httpCode"] = response.httpCode;
+    exchangeJson["etag"] = response.etag;
+    exchangeJson["rateLimitRemaining"] = response.rateLimitRemaining;
+    exchangeJson["totalMilliseconds"] = totalMilliseconds;
+    exchangeJson["body"] = response.body;
+    // Bodies that aren't valid UTF-8 are saved with replacement characters instead of failing the whole request
+    string exchangeText = exchangeJson.dump(4, ' ', false, json::error_handler_t::replace) + "\n";
+
+    lock_guard<mutex> lock(exchangesMutex);
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "request_%06zu.json", ++recordedCount);
+    ofstream file(filesystem::path(directory) / fileName);
+    file << exchangeText;
+    if (!file) {
+        failedWritesCount++;
+    }
+}
+
+/**
+ * @brief Answers a request with its next recorded response
+ * @param request The request
+ * @param response Set to the recorded response
+ * @return How long the request took when it was recorded
+ */
+double HttpRecording::replay(const HttpRequest& request, HttpResponse& response) {
+    string method = request.postData.empty() ? "GET" : "POST";
+    lock_guard<mutex> lock(exchangesMutex);
+
+    auto requestExchanges = exchanges.find(createRequestKey(method, request.url, request.postData));
+    if (requestExchanges == exchanges.end()) {
+        throw runtime_error("No recorded response for " + method + " " + request.url + " in " + directory
+            + ", the request wasn't made while recording");
+    }
+
+    const HttpExchange& exchange = requestExchanges->second.front();
+    response = exchange.response;
+    double totalMilliseconds = exchange.totalMilliseconds;
+    if (requestExchanges->second.size() > 1) {
+        requestExchanges->second.pop_front();
+    }
+    return totalMilliseconds;
+}
+
+/**
+ * @brief Waits as long as replayed requests took when they were recorded, unless the replay is instant
+ */
+void HttpRecording::waitLikeRecording(double totalMilliseconds) const {
+    if (!isInstant && totalMilliseconds > 0) {
+        this_thread::sleep_for(chrono::microseconds((long long)(totalMilliseconds * 1000)));
+    }
+}
+
+/**
+ * @brief Gets the number of requests that couldn't be saved by the recording
+ */
+size_t HttpRecording::getFailedWritesCount() {
+    lock_guard<mutex> lock(exchangesMutex);
+    return failedWritesCount;
+}
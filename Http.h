@@ -0,0 +1,178 @@
+/**
+ * @file Http.h
+ * @author Ahmed Khaled
+ * @brief This file defines the HttpClient class which is used for making HTTP requests (to the GitHub API) over shared connections,
+ * the HttpTelemetry class which collects the network metrics of these requests (--network-stats) and the HttpRecording class
+ * which saves these requests and their responses to give them back later without any network access (--record, --replay)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <deque>
+
+#include <curl/curl.h>
+
+using namespace std;
+
+/**
+ * @brief A single HTTP request, it is a GET request if postData is empty and a POST request otherwise
+ */
+struct HttpRequest {
+    string url;
+    vector<string> headers;
+    string postData;
+    long timeoutMilliseconds = 0; /**< 0 means no timeout*/
+};
+
+/**
+ * @brief The response of a single HTTP request
+ */
+struct HttpResponse {
+    CURLcode resultCode = CURLE_OK; /**< libcurl result, the other fields are only valid if it is CURLE_OK*/
+    long httpCode = 0;
+    string body;
+    string etag; /**< ETag header of the response, used to make conditional requests for the same URL later*/
+    long rateLimitRemaining = -1; /**< X-RateLimit-Remaining header of the response, -1 if the response doesn't have it*/
+};
+
+/**
+ * @brief A class for making HTTP requests that share one pool of connections, DNS results and TLS sessions
+ * Requests can be made one at a time from any number of threads with perform(), or many at a time from one thread
+ * with performAll(), in both cases requests to the same host reuse the already open connections instead of doing
+ * new TCP and TLS handshakes
+ */
+class HttpClient {
+public:
+    HttpClient();
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    HttpResponse perform(const HttpRequest& request);
+    vector<HttpResponse> performAll(const vector<HttpRequest>& requests, int maxConcurrentRequests);
+
+    /**
+     * @brief Used to run requests from another curl multi handle (like the one of an event loop), beginRequest() creates
+     * the handle of a request to be added to the multi handle, and endRequest() must be called after the request finishes
+     * and is removed from the multi handle, the response is filled while the request runs
+     */
+    CURL* beginRequest(const HttpRequest& request, HttpResponse& response, struct curl_slist*& headers);
+    void endRequest(CURL* curl, CURLcode resultCode, const HttpRequest& request, HttpResponse& response, struct curl_slist* headers);
+
+private:
+    CURLSH* share;
+    /**
+     * @brief One mutex for each kind of data shared between the requests (connections, DNS, TLS sessions, etc.)
+     */
+    mutex shareMutexes[CURL_LOCK_DATA_LAST];
+    /**
+     * @brief libcurl handles of finished requests, reused by later requests so that their buffers are reused too
+     */
+    vector<CURL*> idleHandles;
+    mutex idleHandlesMutex;
+
+    CURL* acquireHandle();
+    void releaseHandle(CURL* curl);
+    struct curl_slist* prepareHandle(CURL* curl, const HttpRequest& request, HttpResponse& response);
+
+    static size_t handleHeaderCallBack(char* data, size_t size, size_t numOfBytes, HttpResponse* response);
+    static void lockShare(CURL* curl, curl_lock_data data, curl_lock_access access, void* client);
+    static void unlockShare(CURL* curl, curl_lock_data data, void* client);
+};
+
+/**
+ * @brief The network metrics of a single finished request, measured by libcurl
+ */
+struct HttpRequestMetrics {
+    string url;
+    long httpCode = 0;
+    string httpVersion; /**< "1.0", "1.1", "2" or "3", empty if no response was received*/
+    bool isConnectionReused = false; /**< Whether the request was sent on an already open connection (no DNS, TCP or TLS)*/
+    double dnsMilliseconds = 0;
+    double connectMilliseconds = 0; /**< TCP handshake*/
+    double tlsMilliseconds = 0; /**< TLS handshake, 0 for plain HTTP and reused connections*/
+    double timeToFirstByteMilliseconds = 0; /**< From the start of the request to the first byte of the response*/
+    double totalMilliseconds = 0;
+    long long responseBytes = 0; /**< Headers and body*/
+    long rateLimitRemaining = -1; /**< GitHub API requests left before the rate limit is reached, -1 if unknown*/
+};
+
+/**
+ * @brief Collects the network metrics of all the requests made by the process, then summarizes them to size the number of concurrent
+ * requests and to see how much the shared connections and the cache save
+ * It is disabled by default, and while it is disabled finished requests only check a flag
+ */
+class HttpTelemetry {
+public:
+    void enable() { enabled.store(true, memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+    void record(CURL* curl, const HttpResponse& response);
+    void record(const HttpRequestMetrics& metrics);
+    string createSummary();
+    string createJsonStats();
+
+private:
+    atomic<bool> enabled{false};
+    mutex requestsMutex;
+    vector<HttpRequestMetrics> requests;
+
+    vector<HttpRequestMetrics> getRequests();
+};
+
+HttpTelemetry& getHttpTelemetry();
+
+/**
+ * @brief A request and its response saved by the recording of the HTTP traffic of a run
+ * Request headers aren't saved, so recordings never contain the GitHub token
+ */
+struct HttpExchange {
+    string method;
+    string url;
+    string postData;
+    HttpResponse response;
+    double totalMilliseconds = 0; /**< How long the request took when it was recorded*/
+};
+
+/**
+ * @brief Saves every request of the run with its response in a directory (--record), or answers the requests of the run with
+ * the responses saved by an earlier run without sending them (--replay), for offline reruns and reproducible investigations
+ * of real releases
+ * A replayed request waits as long as the recorded request took, unless the replay is instant, so timings can be compared
+ * between runs; requests made several times are answered with their recorded responses in the same order
+ */
+class HttpRecording {
+public:
+    void startRecording(const string& directory);
+    void startReplaying(const string& directory, bool isInstant);
+    void stop();
+    bool isRecording() const { return recording.load(memory_order_relaxed); }
+    bool isReplaying() const { return replaying.load(memory_order_relaxed); }
+    void record(const HttpRequest& request, const HttpResponse& response, double totalMilliseconds);
+    double replay(const HttpRequest& request, HttpResponse& response);
+    void waitLikeRecording(double totalMilliseconds) const;
+    size_t getFailedWritesCount();
+
+private:
+    atomic<bool> recording{false};
+    atomic<bool> replaying{false};
+    bool isInstant = false;
+    string directory;
+    mutex exchangesMutex;
+    size_t recordedCount = 0;
+    size_t failedWritesCount = 0;
+    /**
+     * @brief Recorded exchanges that weren't replayed yet by request (method, URL and posted data), the last one of each request
+     * is kept to answer the requests that are made more times than they were recorded
+     */
+    map<string, deque<HttpExchange>> exchanges;
+
+    static string createRequestKey(const string& method, const string& url, const string& postData);
+};
+
+HttpRecording& getHttpRecording();
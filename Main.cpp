@@ -8,7 +8,14 @@
 #include <fstream>
 #include <string>
 #include <cstring>
-#include <regex>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include <cstdlib>
+#include <cctype>
+#include <memory>
 
 #include <curl/curl.h> // Used to make API requests
 #include <json.hpp>
@@ -17,32 +24,45 @@
 #include "Enums.h"
 #include "Utils.h"
 #include "Format.h"
-
-// To allow for code compatibility between different compilers/OS (Microsoft's Visual C++ compiler and GCC)
-#ifdef _WIN32
-#define popen _popen
-#define pclose _pclose
-#endif
+#include "Pipeline.h"
+#include "Generator.h"
+#include "Server.h"
+#include "RunContext.h"
+#include "Manifest.h"
+#include "ReleaseNotes.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "Memory.h"
+#include "Http.h"
 
 using namespace std;
 using namespace nlohmann;
 
-void addPullRequestInfoInNotes(json pullRequestInfo, string &pullRequestsReleaseNotes, ReleaseNoteModes releaseNotesMode, 
-                            int commitTypeIndex);
-string getPullRequestInfo(string pullRequestUrl, string githubToken);
-string getCommitsNotesFromPullRequests(int commitTypeIndex, string releaseStartRef, string releaseEndRef,
-                                       string githubToken, ReleaseNoteModes releaseNotesMode);
-string getCommitsNotesFromCommitMessages(int commitTypeIndex, string releaseStartRef, string releaseEndRef);
 void generateReleaseNotes(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef, 
-                          string githubToken, ReleaseNoteModes releaseNoteMode = ReleaseNoteModes::Short);
-void generatePullRequestChangeNote(string pullRequestNumber, string githubToken);
-
-Config config;
+                          ReleaseNoteModes releaseNoteMode, const RunContext& context);
+vector<string> readPullRequestNumbers(string pullRequestNumbersInput);
+void generatePullRequestChangeNote(string pullRequestNumber, const RunContext& context);
+bool generatePullRequestsChangeNotes(vector<string> pullRequestNumbers, const RunContext& context);
+vector<string> writeServerResponseInFiles(const json& response, string fileNameSuffix, const Config& config);
+bool generateNotesUsingServer(string socketPath, vector<string> arguments, const Config& config);
+size_t readThreadsOption(vector<char*>& arguments, const Config& config);
+bool readPathOption(vector<char*>& arguments, const string& optionName, string& path);
+bool readFlagOption(vector<char*>& arguments, const string& optionName);
+void printProfileReport(const Config& config);
+void printMemoryReport(const Config& config);
+bool writeTraceFile(const string& tracePath, const Config& config);
+bool writeNetworkStats(const string& networkStatsPath, const Config& config);
+bool startHttpRecording(const string& recordPath, const string& replayPath, bool isReplayInstant, const Config& config);
+bool checkHttpRecording(const string& recordPath, const Config& config);
 
 int main(int argc, char* argv[]){
 
+    // libcurl must be initialized once before any thread makes requests to the GitHub API
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
     // Reading values from the external configuration file
     const string releaseNotesConfigFileName = "release_notes_config.json";
+    Config config;
     try {
         config.load(releaseNotesConfigFileName);
     }
@@ -51,80 +71,204 @@ int main(int argc, char* argv[]){
         return 1;
     }
 
+    vector<char*> arguments(argv, argv + argc);
+    size_t threadCount = readThreadsOption(arguments, config);
+    if (threadCount == 0) {
+        printInputError(InputErrors::IncorrectThreads, config);
+        return 1;
+    }
+    string notesStreamPath;
+    if (!readPathOption(arguments, config.notesStreamCliOptionName, notesStreamPath)) {
+        printInputError(InputErrors::NoNotesStreamPath, config);
+        return 1;
+    }
+    if (readFlagOption(arguments, config.profileCliOptionName)) {
+        getProfiler().enable();
+    }
+    if (readFlagOption(arguments, config.memoryCliOptionName)) {
+        getMemoryAccounting().enable();
+    }
+    string tracePath;
+    if (!readPathOption(arguments, config.traceCliOptionName, tracePath)) {
+        printInputError(InputErrors::NoTracePath, config);
+        return 1;
+    }
+    if (!tracePath.empty()) {
+        getProfiler().enableTracing();
+    }
+    string networkStatsPath;
+    if (!readPathOption(arguments, config.networkStatsCliOptionName, networkStatsPath)) {
+        printInputError(InputErrors::NoNetworkStatsPath, config);
+        return 1;
+    }
+    if (!networkStatsPath.empty()) {
+        getHttpTelemetry().enable();
+    }
+    string recordPath, replayPath;
+    if (!readPathOption(arguments, config.recordCliOptionName, recordPath)) {
+        printInputError(InputErrors::NoRecordPath, config);
+        return 1;
+    }
+    if (!readPathOption(arguments, config.replayCliOptionName, replayPath)) {
+        printInputError(InputErrors::NoReplayPath, config);
+        return 1;
+    }
+    bool isReplayInstant = readFlagOption(arguments, config.replayInstantCliOptionName);
+    if (!recordPath.empty() && !replayPath.empty()) {
+        printInputError(InputErrors::RecordAndReplay, config);
+        return 1;
+    }
+    if (!startHttpRecording(recordPath, replayPath, isReplayInstant, config)) {
+        return 1;
+    }
+    argc = (int)arguments.size();
+    argv = arguments.data();
+
     if (argc <= 1) {
-        printInputError(InputErrors::NoReleaseNotesSource);
+        printInputError(InputErrors::NoReleaseNotesSource, config);
         return 1;
     }
 
     try {
-        if (strcmp(argv[1], config.singlePullRequestSourceCliInputName.c_str()) == 0) {
+        // Formats the notes of all the generations of this run, tasks are stolen between the threads so that
+        // a few huge pull request bodies don't leave the other threads waiting, the client mode only forwards its
+        // request to the server so it doesn't start them
+        unique_ptr<ThreadPool> workers;
+        if (strcmp(argv[1], config.clientCliInputName.c_str()) != 0) {
+            workers = make_unique<ThreadPool>(threadCount);
+        }
+
+        // Notes streamed to the standard output must not be mixed with the progress messages, so these are moved to the standard error
+        ostream standardOutput(cout.rdbuf());
+        ofstream notesStreamFile;
+        unique_ptr<ReleaseNotesStream> notesStream;
+        if (notesStreamPath == "-") {
+            cout.rdbuf(cerr.rdbuf());
+            notesStream = make_unique<ReleaseNotesStream>(standardOutput);
+        }
+        else if (!notesStreamPath.empty()) {
+            notesStreamFile.open(notesStreamPath);
+            if (!notesStreamFile.is_open()) {
+                throw runtime_error(config.notesStreamFileError + notesStreamPath);
+            }
+            notesStream = make_unique<ReleaseNotesStream>(notesStreamFile);
+        }
+
+        if (strcmp(argv[1], config.serveCliInputName.c_str()) == 0) {
+            if (argc <= 2) {
+                printInputError(InputErrors::NoSocketPath, config);
+                return 1;
+            }
+
+            ReleaseNotesServer server(argv[2], *workers, config);
+            server.run();
+        }
+        else if (strcmp(argv[1], config.clientCliInputName.c_str()) == 0) {
+            if (argc <= 2) {
+                printInputError(InputErrors::NoSocketPath, config);
+                return 1;
+            }
+
+            if (!generateNotesUsingServer(argv[2], vector<string>(argv + 3, argv + argc), config)) {
+                return 1;
+            }
+        }
+        else if (strcmp(argv[1], config.manifestCliInputName.c_str()) == 0) {
+            if (argc <= 2) {
+                printInputError(InputErrors::NoManifest, config);
+                return 1;
+            }
+            else if (argc <= 3) {
+                printInputError(InputErrors::NoGithubToken, config);
+                return 1;
+            }
+
+            cout << config.generatingReleaseNotesMessage << endl;
+            if (!generateManifestReleaseNotes(loadManifest(argv[2], config), argv[3], *workers, config)) {
+                return 1;
+            }
+        }
+        else if (strcmp(argv[1], config.singlePullRequestSourceCliInputName.c_str()) == 0) {
             if (argc <= 2) {
-                printInputError(InputErrors::NoPullRequestNumber);
+                printInputError(InputErrors::NoPullRequestNumber, config);
                 return 1;
             }
             else if (argc <= 3) {
-                printInputError(InputErrors::NoGithubToken);
+                printInputError(InputErrors::NoGithubToken, config);
                 return 1;
             }
             else if (argc <= 4) {
-                printInputError(InputErrors::NoGithubRepository);
+                printInputError(InputErrors::NoGithubRepository, config);
                 return 1;
             }
 
-            config.repoCommitsUrl = config.githubUrl + argv[4] + "/commit/";
-            config.repoIssuesUrl = config.githubUrl + argv[4] + "/issues/";
-            config.repoPullRequestsApiUrl = config.githubReposApiUrl + argv[4] + "/pulls/";
+            RunContext context(config, argv[4], argv[3]);
+            context.workers = workers.get();
+            context.notesStream = notesStream.get();
 
-            generatePullRequestChangeNote(argv[2], argv[3]);
+            vector<string> pullRequestNumbers = readPullRequestNumbers(argv[2]);
+            if (pullRequestNumbers.empty()) {
+                printInputError(InputErrors::NoPullRequestNumber, config);
+                return 1;
+            }
+            else if (pullRequestNumbers.size() == 1) {
+                generatePullRequestChangeNote(pullRequestNumbers[0], context);
+            }
+            else if (!generatePullRequestsChangeNotes(pullRequestNumbers, context)) {
+                return 1;
+            }
         }
         else {
             if (argc <= 2) {
-                printInputError(InputErrors::NoReleaseStartReference);
+                printInputError(InputErrors::NoReleaseStartReference, config);
                 return 1;
             }
             else if (argc <= 3) {
-                printInputError(InputErrors::NoReleaseEndReference);
+                printInputError(InputErrors::NoReleaseEndReference, config);
                 return 1;
             }
             else if (argc <= 4) {
-                printInputError(InputErrors::NoGithubToken);
+                printInputError(InputErrors::NoGithubToken, config);
                 return 1;
             }
 
             if (strcmp(argv[1], config.commitMessagesSourceCliInputName.c_str()) == 0
                 || strcmp(argv[1], config.commitMessagesSourceGithubActionsInputName.c_str()) == 0) {
-                generateReleaseNotes(ReleaseNoteSources::CommitMessages, argv[2], argv[3], argv[4]);
+                RunContext context(config, "", argv[4]);
+                context.workers = workers.get();
+                context.notesStream = notesStream.get();
+                generateReleaseNotes(ReleaseNoteSources::CommitMessages, argv[2], argv[3], ReleaseNoteModes::Short, context);
             }
             else if (strcmp(argv[1], config.pullRequestsSourceCliInputName.c_str()) == 0
                 || strcmp(argv[1], config.pullRequestsSourceGithubActionsInputName.c_str()) == 0) {
                 if (argc <= 5) {
-                    printInputError(InputErrors::NoReleaseNotesMode);
+                    printInputError(InputErrors::NoReleaseNotesMode, config);
                     return 1;
                 }
                 else if(argc <= 6) {
-                    printInputError(InputErrors::NoGithubRepository);
+                    printInputError(InputErrors::NoGithubRepository, config);
                     return 1;
                 }
 
-                config.repoCommitsUrl = config.githubUrl + argv[6] + "/commit/";
-                config.repoIssuesUrl = config.githubUrl + argv[6] + "/issues/";
-                config.repoPullRequestsApiUrl = config.githubReposApiUrl + argv[6] + "/pulls/";
+                RunContext context(config, argv[6], argv[4]);
+                context.workers = workers.get();
+                context.notesStream = notesStream.get();
 
                 if (strcmp(argv[5], config.fullModeCliInputName.c_str()) == 0
                     || strcmp(argv[5], config.fullModeGithubActionsInputName.c_str()) == 0) {
-                    generateReleaseNotes(ReleaseNoteSources::PullRequests, argv[2], argv[3], argv[4], ReleaseNoteModes::Full);
+                    generateReleaseNotes(ReleaseNoteSources::PullRequests, argv[2], argv[3], ReleaseNoteModes::Full, context);
                 }
                 else if (strcmp(argv[5], config.shortModeCliInputName.c_str()) == 0
                     || strcmp(argv[5], config.shortModeGithubActionsInputName.c_str()) == 0) {
-                    generateReleaseNotes(ReleaseNoteSources::PullRequests, argv[2], argv[3], argv[4], ReleaseNoteModes::Short);
+                    generateReleaseNotes(ReleaseNoteSources::PullRequests, argv[2], argv[3], ReleaseNoteModes::Short, context);
                 }
                 else {
-                    printInputError(InputErrors::IncorrectReleaseNotesMode);
+                    printInputError(InputErrors::IncorrectReleaseNotesMode, config);
                     return 1;
                 }
             }
             else {
-                printInputError(InputErrors::IncorrectReleaseNotesSource);
+                printInputError(InputErrors::IncorrectReleaseNotesSource, config);
                 return 1;
             }
         }
@@ -132,277 +276,440 @@ int main(int argc, char* argv[]){
     catch (const exception& e) {
         cerr << config.failedToGenerateReleaseNotesMessage << endl;
         cerr << e.what() << endl;
+        // The profile, the trace and the network stats of a failed run can show where it got stuck
+        printProfileReport(config);
+        printMemoryReport(config);
+        writeTraceFile(tracePath, config);
+        writeNetworkStats(networkStatsPath, config);
+        checkHttpRecording(recordPath, config);
         return 1;
     }
 
+    printProfileReport(config);
+    printMemoryReport(config);
+    if (!writeTraceFile(tracePath, config) || !writeNetworkStats(networkStatsPath, config) || !checkHttpRecording(recordPath, config)) {
+        return 1;
+    }
     return 0;
 }
 
 /**
- * @brief Formats given pull request information (title, body) into a nice looking markdown format,
- * then adds them in the given current release notes, based on the release notes mode
- * @param pullRequestInfo JSON object containing raw pull request information
- * @param pullRequestsReleaseNotes Existing release notes generated from pull requests
- * @param releaseNotesMode The release notes mode that will decide if the pull request body will be included or not
- * @param commitTypeIndex Index of the commit type in the commit types 2d array that this pull request belongs to
+ * @brief Generates release notes using commit messages between the start reference and the end reference
+ * using the given release notes source and if the source is pull requests then generates them based on the release note mode 
+ * and using the given GitHub token
+ * @param releaseNoteSource The source to generate release notes from (commit messages or pull requests)
+ * @param releaseStartRef The git reference (commit SHA or tag name) that references the commit directly before the 
+ * commit that starts the commit messages of the release, for example, the tag name of the previous release
+ * @param releaseEndRef The git reference (commit SHA or tag name) that references the end of the commit messages of the release
+ * @param releaseNoteMode The release notes mode when the source is pull requests
+ * @param context The context of the generation, which contains the config, the GitHub repository and the GitHub token
  */
-void addPullRequestInfoInNotes(json pullRequestInfo, string &pullRequestsReleaseNotes, ReleaseNoteModes releaseNotesMode,
-                                int commitTypeIndex) {
-    if (!pullRequestInfo["title"].is_null()) {
-        string title = pullRequestInfo["title"];
+void generateReleaseNotes(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef, 
+                          ReleaseNoteModes releaseNoteMode, const RunContext& context) {
+    const Config& config = context.config;
+    cout << config.generatingReleaseNotesMessage << endl;
 
-        CommitTypeMatchResults matchResult = checkCommitTypeMatch(title, commitTypeIndex);
+    ReleaseNotes releaseNotes = buildReleaseNotes(releaseNoteSource, releaseStartRef, releaseEndRef, releaseNoteMode, context);
 
-        if(releaseNotesMode == ReleaseNoteModes::Full)
-            pullRequestsReleaseNotes += convertConventionalCommitTitleToReleaseNoteTitle(title, matchResult, 
-            config.markdownFullModeReleaseNotePrefix);
-        else
-            pullRequestsReleaseNotes += convertConventionalCommitTitleToReleaseNoteTitle(title, matchResult, 
-            config.markdownReleaseNotePrefix);
-    }
+    // All the output formats are rendered from the same release notes
+    vector<string> fileNames = writeReleaseNotesInFiles(releaseNotes, "", "", context);
 
-    if (releaseNotesMode == ReleaseNoteModes::Full && !pullRequestInfo["body"].is_null()) {
-        string body = pullRequestInfo["body"];
+    cout << "Release notes generated successfully, check " + joinFileNames(fileNames) + " in the current directory" << endl;
+}
 
-        // Capitalizing the first letter of the body
-        body[0] = toupper(body[0]);
-        body = formatPullRequestBody(body);
+/**
+ * @brief Reads the pull request numbers given in the CLI, which can be a single number (e.g., 13),
+ * a list of numbers separated by commas or spaces (e.g., 13,144,3722), a file containing such a list (e.g., @numbers.txt),
+ * or "-" to read such a list from the standard input
+ * @param pullRequestNumbersInput The pull request numbers CLI input
+ * @return The pull request numbers
+ */
+vector<string> readPullRequestNumbers(string pullRequestNumbersInput) {
+    string pullRequestNumbersList = pullRequestNumbersInput;
+
+    if (pullRequestNumbersInput == "-") {
+        pullRequestNumbersList.assign(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+    }
+    else if (!pullRequestNumbersInput.empty() && pullRequestNumbersInput[0] == '@') {
+        ifstream pullRequestNumbersFile(pullRequestNumbersInput.substr(1));
+        if (!pullRequestNumbersFile.is_open()) {
+            throw runtime_error("Unable to open pull request numbers file " + pullRequestNumbersInput.substr(1));
+        }
+        pullRequestNumbersList.assign(istreambuf_iterator<char>(pullRequestNumbersFile), istreambuf_iterator<char>());
+    }
 
-        pullRequestsReleaseNotes += indentAllLinesInString(body) + "\n";
+    // Treating commas as spaces so that the list can be split on any white space
+    for (char& c : pullRequestNumbersList) {
+        if (c == ',') {
+            c = ' ';
+        }
+    }
+
+    vector<string> pullRequestNumbers;
+    istringstream pullRequestNumbersStream(pullRequestNumbersList);
+    string pullRequestNumber;
+    while (pullRequestNumbersStream >> pullRequestNumber) {
+        // Also accepting numbers written as hash ids (e.g., #13)
+        if (pullRequestNumber[0] == '#') {
+            pullRequestNumber.erase(0, 1);
+        }
+        if (pullRequestNumber.empty() || pullRequestNumber.find_first_not_of("0123456789") != string::npos) {
+            throw invalid_argument("Invalid pull request number: " + pullRequestNumber);
+        }
+        pullRequestNumbers.push_back(pullRequestNumber);
     }
 
-    pullRequestsReleaseNotes += "\n";
+    return pullRequestNumbers;
 }
 
 /**
- * @brief Retrieves pull request info from the GitHub API using libcurl
- * @param pullRequestUrl The GitHub API URL of the pull request
- * @param githubToken The GitHub token used to make authenticated requests to the GitHub API
- * @return The pull request info in JSON 
+ * @brief Generates a single change note with it's conventional commit type category
+ * for a single pull request using the GitHub API (Not using commit messages at all)
+ * @param pullRequestNumber The number of the pull request to generate change note for (e.g., 13, 144, 3722, etc.)
+ * @param context The context of the generation, which contains the config, the GitHub repository and the GitHub token
  */
-string getPullRequestInfo(string pullRequestUrl, string githubToken) {
-    // Initializing libcurl
-    CURL* curl = curl_easy_init();
-    CURLcode resultCode;
-    string jsonResponse;
-    struct curl_slist* headers = NULL;
-    headers = curl_slist_append(headers, ("Authorization: token " + githubToken).c_str());
-
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, pullRequestUrl.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, handleApiCallBack);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &jsonResponse);
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, "Ahmed-Khaled-dev");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        resultCode = curl_easy_perform(curl);
-
-        if (resultCode == CURLE_OK) {
-            // Get the HTTP response code
-            long httpCode;
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-
-            // All info obtained from https://docs.github.com/en/rest/using-the-rest-api/troubleshooting-the-rest-api?apiVersion=2022-11-28
-            // and https://docs.github.com/en/rest/pulls/pulls?apiVersion=2022-11-28#get-a-pull-request
-            if (httpCode == 200) {
-                return jsonResponse;
-            }
-            else if (httpCode == 503 || httpCode == 500 || httpCode == 422 || httpCode == 406) {
-                throw runtime_error("GitHub API request could not be processed to retrieve pull request " + pullRequestUrl
-                    + " Additional information : " + jsonResponse);
-            }
-            else if (httpCode == 404) {
-                throw runtime_error("Pull request " + pullRequestUrl + " not found "
-                    + "or you are accessing a private repository and the GitHub token used doesn't have permissions to access pull requests info. "
-                    +  "Additional information : " + jsonResponse);
+void generatePullRequestChangeNote(string pullRequestNumber, const RunContext& context) {
+    const Config& config = context.config;
+    cout << config.generatingReleaseNotesMessage << endl;
+
+    ReleaseNotes pullRequestChangeNote = fetchPullRequestChangeNote(pullRequestNumber, context);
+
+    vector<string> fileNames = writeReleaseNotesInFiles(pullRequestChangeNote, "", "", context);
+
+    cout << "Pull request change note generated successfully, check " + joinFileNames(fileNames) + " in the current directory" << endl;
+}
+
+/**
+ * @brief Generates the change notes of many pull requests in one run, the pull requests are all fetched at the same time
+ * over the same GitHub API connections, then the notes of each pull request are written in each of the output formats
+ * of the config, in their own files named like the output files in the config with the pull request number added
+ * (e.g., release_notes_13.md and release_notes_13.html)
+ * A pull request that can't be fetched doesn't stop the notes of the others from being written
+ * @param pullRequestNumbers The numbers of the pull requests to generate change notes for
+ * @param context The context of the generation, which contains the config, the GitHub repository and the GitHub token
+ * @return Whether the notes of all the pull requests were generated
+ */
+bool generatePullRequestsChangeNotes(vector<string> pullRequestNumbers, const RunContext& context) {
+    const Config& config = context.config;
+    cout << config.generatingReleaseNotesMessage << endl;
+
+    vector<string> errors;
+    vector<ReleaseNotes> pullRequestsChangeNotes = fetchPullRequestsChangeNotes(pullRequestNumbers, errors, context);
+
+    vector<string> fileNames;
+    size_t failedPullRequests = 0;
+    for (size_t i = 0; i < pullRequestNumbers.size(); i++) {
+        try {
+            if (!errors[i].empty()) {
+                throw runtime_error(errors[i]);
             }
-            else {
-                handleGithubApiErrorCodes(httpCode, jsonResponse);
+
+            // Pull requests without change notes don't stop the others from being generated
+            if (pullRequestsChangeNotes[i].sections.empty()) {
+                cerr << "#" + pullRequestNumbers[i] + ": " + config.emptyReleaseNotesMessage << endl;
+                continue;
             }
+
+            vector<string> pullRequestFileNames = writeReleaseNotesInFiles(pullRequestsChangeNotes[i], "", "_" + pullRequestNumbers[i],
+                                                                           context);
+            fileNames.insert(fileNames.end(), pullRequestFileNames.begin(), pullRequestFileNames.end());
         }
-        else {
-            throw runtime_error(config.githubApiUnableToMakeRequestError);
+        catch (const exception& e) {
+            failedPullRequests++;
+            cerr << "#" + pullRequestNumbers[i] + ": " + config.failedToGenerateReleaseNotesMessage << endl;
+            cerr << e.what() << endl;
         }
+    }
 
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
+    if (fileNames.empty() && failedPullRequests == 0) {
+        throw runtime_error(config.emptyReleaseNotesMessage);
     }
-    else {
-        throw runtime_error(config.githubApiLibcurlError);
+    if (!fileNames.empty()) {
+        cout << "Pull requests change notes generated successfully, check " + joinFileNames(fileNames) + " in the current directory" << endl;
     }
-
-    return jsonResponse;
+    return failedPullRequests == 0;
 }
 
 /**
- * @brief Retrieves release notes from each commit's *pull request* between the start reference and the end reference
- * based on the given conventional commit type, release notes mode, and using the given GitHub token
- * @param commitTypeIndex Index of the commit type in the commit types 2d array, to only generate release notes from the given commit type (fix, feat, etc.)
- * @param releaseStartRef The git reference (commit SHA or tag name) that references the commit directly before the 
- * commit that starts the commit messages of the release, for example, the tag name of the previous release
- * @param releaseEndRef The git reference (commit SHA or tag name) that references the end of the commit messages of the release
- * @param releaseNotesMode The release notes mode
- * @param githubToken The GitHub token used to make authenticated requests to the GitHub API
- * @return The generated release notes
+ * @brief Writes the notes of a server response in the output files of the formats that it has
+ * @param response The response of the server, with a field for each output format
+ * @param fileNameSuffix Added to the output file names of the config, can be empty
+ * @param config The loaded config
+ * @return The names of the written files
  */
-string getCommitsNotesFromPullRequests(int commitTypeIndex, string releaseStartRef, string releaseEndRef, 
-                                       string githubToken, ReleaseNoteModes releaseNotesMode) {
-    string commandToRetrieveCommitsMessages = "git log " + releaseStartRef + ".." + releaseEndRef +
-            " --oneline --format=\"%s\" --grep=\"^" + config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::ConventionalName] + "[:(]\"" +
-            " --grep=\"#[0-9]\" --all-match";
+vector<string> writeServerResponseInFiles(const json& response, string fileNameSuffix, const Config& config) {
+    vector<string> fileNames;
+    for (const auto& notes : response.items()) {
+        string fileName, fileError;
+        if (getOutputFile(notes.key(), config, fileName, fileError)) {
+            writeNotesInFile(notes.value(), addSuffixToFileName(fileName, fileNameSuffix), fileError, config);
+            fileNames.push_back(addSuffixToFileName(fileName, fileNameSuffix));
+        }
+    }
+    return fileNames;
+}
 
-    FILE* pipe = popen(commandToRetrieveCommitsMessages.c_str(), "r");
-    if (!pipe) {
-        throw runtime_error(config.gitLogError);
+/**
+ * @brief Generates notes using a running release notes server (release_notes_generator serve socket_path) instead of this process,
+ * so that the warm connections and caches of the server are used, the notes are written in the same files as without the server
+ * Many pull request numbers are sent in a single request, so that the server fetches them at the same time
+ * @param socketPath The path of the socket that the server listens on
+ * @param arguments The same CLI arguments used without the server, starting from the release notes source
+ * @param config The loaded config
+ * @return Whether the notes of all the pull requests were generated
+ */
+bool generateNotesUsingServer(string socketPath, vector<string> arguments, const Config& config) {
+    if (arguments.empty()) {
+        throw invalid_argument(config.noReleaseNotesSourceError);
     }
 
-    char buffer[150];
-    string commitMessage, commitPullRequestNumber, releaseNotesFromPullRequests = "";
+    cout << config.generatingReleaseNotesMessage << endl;
 
-    // Add the title of this commit type section in the release notes
-    releaseNotesFromPullRequests += "\n" + config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::MarkdownTitle] + "\n";
+    json request;
+    request["source"] = arguments[0];
+    // Notes are generated from the git repository that the client runs in, not the one that the server was started in
+    request["directory"] = filesystem::current_path().string();
+    auto addArgument = [&](string key, size_t argumentIndex) {
+        if (argumentIndex < arguments.size()) {
+            request[key] = arguments[argumentIndex];
+        }
+    };
 
-    bool commitTypeContainsReleaseNotes = 0;
+    vector<string> pullRequestNumbers;
+    if (arguments[0] == config.singlePullRequestSourceCliInputName) {
+        if (arguments.size() > 1) {
+            pullRequestNumbers = readPullRequestNumbers(arguments[1]);
+        }
+        if (pullRequestNumbers.size() == 1) {
+            request["pullRequest"] = pullRequestNumbers[0];
+        }
+        else if (pullRequestNumbers.size() > 1) {
+            request["pullRequests"] = pullRequestNumbers;
+        }
+        addArgument("token", 2);
+        addArgument("repo", 3);
+    }
+    else {
+        addArgument("start", 1);
+        addArgument("end", 2);
+        addArgument("token", 3);
+        addArgument("mode", 4);
+        addArgument("repo", 5);
+    }
 
-    // Reading commit messages line-by-line from the output of the git log command
-    while (fgets(buffer, sizeof(buffer), pipe) != NULL) {
-        commitTypeContainsReleaseNotes = 1;
-        commitMessage = buffer;
+    json response = sendRequestToServer(socketPath, request, config);
+    if (response.contains("error")) {
+        throw runtime_error(response["error"].get<string>());
+    }
 
-        CommitTypeMatchResults matchResult = checkCommitTypeMatch(commitMessage, commitTypeIndex);
+    vector<string> fileNames;
+    size_t failedPullRequests = 0;
+    if (!response.contains("pullRequests")) {
+        fileNames = writeServerResponseInFiles(response, "", config);
+    }
+    for (const json& pullRequestResponse : response.value("pullRequests", json::array())) {
+        string pullRequestNumber = pullRequestResponse["pullRequest"];
+        if (pullRequestResponse.contains("error")) {
+            failedPullRequests++;
+            cerr << "#" + pullRequestNumber + ": " + config.failedToGenerateReleaseNotesMessage << endl;
+            cerr << pullRequestResponse["error"].get<string>() << endl;
+            continue;
+        }
 
-        if (matchResult != CommitTypeMatchResults::NoMatch) {
-            // Regular expression to match # followed by one or more digits
-            regex prRegex(R"(#(\d+))");
-            smatch match;
+        vector<string> pullRequestFileNames = writeServerResponseInFiles(pullRequestResponse, "_" + pullRequestNumber, config);
+        fileNames.insert(fileNames.end(), pullRequestFileNames.begin(), pullRequestFileNames.end());
+    }
 
-            // Validating that a hashtag exists
-            if (regex_search(commitMessage, match, prRegex))
-            {
-                // Extracting the PR number associated with the commit from the first capture group
-                commitPullRequestNumber = match.str(1);
+    if (!fileNames.empty()) {
+        cout << "Notes generated successfully, check " + joinFileNames(fileNames) + " in the current directory" << endl;
+    }
+    return failedPullRequests == 0;
+}
 
-                string jsonResponse = getPullRequestInfo(config.repoPullRequestsApiUrl + commitPullRequestNumber, githubToken);
-                json pullRequestInfo = json::parse(jsonResponse);
+/**
+ * @brief Reads and removes the number of threads option (e.g., -j 32) from the CLI arguments, it can be given anywhere after the program name
+ * @param arguments The CLI arguments, the option and its value are removed from them
+ * @param config The loaded config
+ * @return The number of threads that format the notes, the number of CPU cores if the option isn't given,
+ * or 0 if the option isn't followed by a number from 1 to maxThreads
+ */
+size_t readThreadsOption(vector<char*>& arguments, const Config& config) {
+    // Every thread is started up front, so a typo like -j 10000000 would exhaust the memory or the process limits
+    const unsigned long maxThreads = 1024;
+    size_t threadCount = max<size_t>(thread::hardware_concurrency(), 1);
+
+    for (size_t i = 1; i < arguments.size();) {
+        if (config.threadsCliOptionName != arguments[i]) {
+            i++;
+            continue;
+        }
+        if (i + 1 >= arguments.size()) {
+            return 0;
+        }
 
-                addPullRequestInfoInNotes(pullRequestInfo, releaseNotesFromPullRequests, releaseNotesMode, commitTypeIndex);
-            }
+        char* threadsEnd;
+        unsigned long threads = strtoul(arguments[i + 1], &threadsEnd, 10);
+        if (!isdigit((unsigned char)arguments[i + 1][0]) || *threadsEnd != '\0' || threads > maxThreads) {
+            return 0;
         }
+        threadCount = threads;
+        arguments.erase(arguments.begin() + i, arguments.begin() + i + 2);
     }
 
-    // Remove the title of this commit type section if it doesn't contain any release notes
-    if (!commitTypeContainsReleaseNotes) {
-        releaseNotesFromPullRequests = "";
+    return threadCount;
+}
+
+/**
+ * @brief Reads and removes an option followed by a path (e.g., --trace trace.json) from the CLI arguments, it can be given anywhere
+ * after the program name
+ * @param arguments The CLI arguments, the option and its value are removed from them
+ * @param optionName The name of the option (e.g., the traceCliOptionName of the config)
+ * @param path Set to the path that follows the option, left empty if the option isn't given
+ * @return False if the option isn't followed by a path
+ */
+bool readPathOption(vector<char*>& arguments, const string& optionName, string& path) {
+    for (size_t i = 1; i < arguments.size();) {
+        if (optionName != arguments[i]) {
+            i++;
+            continue;
+        }
+        if (i + 1 >= arguments.size() || arguments[i + 1][0] == '\0') {
+            return false;
+        }
+
+        path = arguments[i + 1];
+        arguments.erase(arguments.begin() + i, arguments.begin() + i + 2);
     }
 
-    pclose(pipe);
-    return releaseNotesFromPullRequests;
+    return true;
 }
 
 /**
- * @brief Retrieves release notes from each commit's *message* between the start reference and the end reference
- * based on the given conventional commit type
- * @param commitTypeIndex Index of the commit type in the commit types 2d array, to only generate release notes from the given commit type (fix, feat, etc.)
- * @param releaseStartRef The git reference (commit SHA or tag name) that references the commit directly before the 
- * commit that starts the commit messages of the release, for example, the tag name of the previous release
- * @param releaseEndRef The git reference (commit SHA or tag name) that references the end of the commit messages of the release
- * @return The generated release notes
+ * @brief Reads and removes an option without a value (e.g., --profile) from the CLI arguments, it can be given anywhere after the program name
+ * @param arguments The CLI arguments, the option is removed from them
+ * @param optionName The name of the option (e.g., the profileCliOptionName of the config)
+ * @return Whether the option was given
  */
-string getCommitsNotesFromCommitMessages(int commitTypeIndex, string releaseStartRef, string releaseEndRef) {
-    string commandToRetrieveCommitsMessages = "git log " + releaseStartRef + ".." + releaseEndRef +
-        " --oneline --format=\"%s\" --grep=\"^" + config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::ConventionalName] + "[:(]\"";
-
-    FILE* pipe = popen(commandToRetrieveCommitsMessages.c_str(), "r");
-    if (!pipe) {
-        throw runtime_error(config.gitLogError);
+bool readFlagOption(vector<char*>& arguments, const string& optionName) {
+    auto option = find(arguments.begin() + 1, arguments.end(), optionName);
+    if (option == arguments.end()) {
+        return false;
     }
 
-    char buffer[150];
-    string commitMessage, releaseNotesFromCommitMessages, subCategoryText;
+    arguments.erase(option);
+    return true;
+}
 
-    // Add the title of this commit type section in the release notes
-    releaseNotesFromCommitMessages += "\n" + config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::MarkdownTitle] + "\n";
+/**
+ * @brief Prints the time spent in each phase of the run in the standard error (so that it isn't mixed with notes streamed
+ * to the standard output), in the format chosen in the config, if the run is profiled
+ * @param config The loaded config
+ */
+void printProfileReport(const Config& config) {
+    if (!getProfiler().isEnabled()) {
+        return;
+    }
 
-    bool commitTypeContainsReleaseNotes = 0;
+    cerr << (config.profileReportFormat == "json" ? getProfiler().createJsonReport() : getProfiler().createTableReport()) << flush;
+}
 
-    // Reading commit messages line-by-line from the output of the git log command
-    while (fgets(buffer, sizeof(buffer), pipe) != NULL) {
-        commitTypeContainsReleaseNotes = 1;
-        commitMessage = buffer;
+/**
+ * @brief Prints the allocations of each phase of the run and its peak memory usage in the standard error, in the format
+ * chosen in the config, if the memory of the run is accounted
+ * @param config The loaded config
+ */
+void printMemoryReport(const Config& config) {
+    if (!getMemoryAccounting().isEnabled()) {
+        return;
+    }
 
-        CommitTypeMatchResults matchResult = checkCommitTypeMatch(commitMessage, commitTypeIndex);
+    MemoryAccounting& memoryAccounting = getMemoryAccounting();
+    cerr << (config.profileReportFormat == "json" ? memoryAccounting.createJsonReport() : memoryAccounting.createTableReport()) << flush;
+}
 
-        if (matchResult != CommitTypeMatchResults::NoMatch) {
-            releaseNotesFromCommitMessages += convertConventionalCommitTitleToReleaseNoteTitle(commitMessage, matchResult, 
-            config.markdownReleaseNotePrefix);
-        }
+/**
+ * @brief Writes the trace of the run (every git process, HTTP request, JSON parse, format and file write with the thread it ran on)
+ * in the Chrome trace event format, if the run is traced
+ * @param tracePath The file that the trace is written to, empty if the run isn't traced
+ * @param config The loaded config, which contains the error messages
+ * @return False if the trace file couldn't be created/opened
+ */
+bool writeTraceFile(const string& tracePath, const Config& config) {
+    if (tracePath.empty()) {
+        return true;
     }
 
-    // Remove the title of this commit type section if it doesn't contain any release notes
-    if (!commitTypeContainsReleaseNotes) {
-        releaseNotesFromCommitMessages = "";
+    ofstream traceFile(tracePath);
+    if (!traceFile.is_open()) {
+        cerr << config.traceFileError << tracePath << endl;
+        return false;
     }
 
-    pclose(pipe);
-    return releaseNotesFromCommitMessages;
+    traceFile << getProfiler().createTrace();
+    return true;
 }
 
 /**
- * @brief Generates release notes using commit messages between the start reference and the end reference
- * using the given release notes source and if the source is pull requests then generates them based on the release note mode 
- * and using the given GitHub token
- * @param releaseNoteSource The source to generate release notes from (commit messages or pull requests)
- * @param releaseStartRef The git reference (commit SHA or tag name) that references the commit directly before the 
- * commit that starts the commit messages of the release, for example, the tag name of the previous release
- * @param releaseEndRef The git reference (commit SHA or tag name) that references the end of the commit messages of the release
- * @param releaseNoteMode The release notes mode when the source is pull requests
- * @param githubToken The GitHub token used to make authenticated requests to the GitHub API when source is pull requests
+ * @brief Prints a summary of the network metrics of the HTTP requests of the run in the standard error and writes the metrics
+ * of each request in JSON in the stats file, if the option is given
+ * @param networkStatsPath The file that the stats are written to, empty if the option isn't given
+ * @param config The loaded config, which contains the error messages
+ * @return False if the stats file couldn't be created/opened
  */
-void generateReleaseNotes(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef, 
-                          string githubToken, ReleaseNoteModes releaseNoteMode) {
-    cout << config.generatingReleaseNotesMessage << endl;
-
-    string commandToRetrieveCommitsMessages;
-    string currentCommitMessage;
-    string markdownReleaseNotes = "";
-    for (int i = 0; i < config.commitTypesCount; i++)
-    {
-        if (releaseNoteSource == ReleaseNoteSources::CommitMessages) {
-            markdownReleaseNotes += getCommitsNotesFromCommitMessages(i, releaseStartRef, releaseEndRef);
-        }
-        else if (releaseNoteSource == ReleaseNoteSources::PullRequests) {
-            markdownReleaseNotes += getCommitsNotesFromPullRequests(i, releaseStartRef, releaseEndRef, githubToken, releaseNoteMode);
-        }
+bool writeNetworkStats(const string& networkStatsPath, const Config& config) {
+    if (networkStatsPath.empty()) {
+        return true;
     }
 
-    writeGeneratedNotesInFiles(markdownReleaseNotes, githubToken);
+    cerr << getHttpTelemetry().createSummary() << flush;
+
+    ofstream networkStatsFile(networkStatsPath);
+    if (!networkStatsFile.is_open()) {
+        cerr << config.networkStatsFileError << networkStatsPath << endl;
+        return false;
+    }
 
-    cout << "Release notes generated successfully, check " + config.markdownOutputFileName + " and " + config.htmlOutputFileName + " in the current directory" << endl;
+    networkStatsFile << getHttpTelemetry().createJsonStats();
+    return true;
 }
 
 /**
- * @brief Generates a single change note with it's conventional commit type category
- * for a single pull request using the GitHub API (Not using commit messages at all)
- * @param pullRequestNumber The number of the pull request to generate change note for (e.g., 13, 144, 3722, etc.)
- * @param githubToken The GitHub token used to make authenticated requests to the GitHub API
+ * @brief Starts recording or replaying the GitHub API requests of the run, if one of the options is given
+ * @param recordPath The directory that the requests are saved in, empty if the record option isn't given
+ * @param replayPath The directory that the requests are replayed from, empty if the replay option isn't given
+ * @param isReplayInstant Whether replayed requests are answered right away instead of taking as long as when they were recorded
+ * @param config The loaded config, which contains the error messages
+ * @return False if the directory couldn't be created or read
  */
-void generatePullRequestChangeNote(string pullRequestNumber, string githubToken) {
-    cout << config.generatingReleaseNotesMessage << endl;
-
-    string jsonResponse = getPullRequestInfo(config.repoPullRequestsApiUrl + pullRequestNumber, githubToken);
-    json pullRequestInfo = json::parse(jsonResponse);
-
-    string pullRequestChangeNote = "";
-    for (int commitTypeIndex = 0; commitTypeIndex < config.commitTypesCount; commitTypeIndex++)
-    {
-        if (checkCommitTypeMatch(pullRequestInfo["title"], commitTypeIndex) != CommitTypeMatchResults::NoMatch) {
-            pullRequestChangeNote += "\n" + config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::MarkdownTitle] + "\n";
-            addPullRequestInfoInNotes(pullRequestInfo, pullRequestChangeNote, ReleaseNoteModes::Full, commitTypeIndex);
-            break;
+bool startHttpRecording(const string& recordPath, const string& replayPath, bool isReplayInstant, const Config& config) {
+    try {
+        if (!recordPath.empty()) {
+            getHttpRecording().startRecording(recordPath);
+        }
+        else if (!replayPath.empty()) {
+            getHttpRecording().startReplaying(replayPath, isReplayInstant);
         }
     }
+    catch (const exception& e) {
+        cerr << (recordPath.empty() ? config.replayingError + replayPath : config.recordingError + recordPath) << endl;
+        cerr << e.what() << endl;
+        return false;
+    }
 
-    writeGeneratedNotesInFiles(pullRequestChangeNote, githubToken);
+    return true;
+}
 
-    cout << "Pull request change note generated successfully, check " + config.markdownOutputFileName + " and " + config.htmlOutputFileName + " in the current directory" << endl;
-}
\ No newline at end of file
+/**
+ * @brief Checks that all the requests of the run were saved, if the record option is given
+ * @param recordPath The directory that the requests are saved in, empty if the record option isn't given
+ * @param config The loaded config, which contains the error messages
+ * @return False if some requests couldn't be saved
+ */
+bool checkHttpRecording(const string& recordPath, const Config& config) {
+    if (recordPath.empty() || getHttpRecording().getFailedWritesCount() == 0) {
+        return true;
+    }
+
+    cerr << config.recordingError << recordPath << endl;
+    return false;
+}
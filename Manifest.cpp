@@ -0,0 +1,165 @@
+/**
+ * @file Manifest.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements functions in Manifest.h
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <filesystem>
+#include <stdexcept>
+
+#include <json.hpp>
+
+#include "Manifest.h"
+#include "Config.h"
+#include "Enums.h"
+#include "Utils.h"
+#include "ThreadPool.h"
+#include "GitObjects.h"
+#include "RunContext.h"
+#include "Generator.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Reads and validates a manifest file
+ * @param manifestFileName Path of the manifest file
+ * @param config The loaded config, which contains the names of the release notes sources and modes
+ * @return The manifest
+ */
+Manifest loadManifest(const string& manifestFileName, const Config& config) {
+    ifstream manifestFile(manifestFileName);
+    if (!manifestFile.is_open()) {
+        throw runtime_error("Unable to open manifest file " + manifestFileName);
+    }
+
+    json manifestData;
+    try {
+        manifestFile >> manifestData;
+    }
+    catch (json::parse_error& e) {
+        throw runtime_error("JSON parsing error: " + string(e.what()));
+    }
+
+    Manifest manifest;
+
+    if (manifestData.contains("concurrentRepositories")) {
+        manifest.concurrentRepositories = manifestData["concurrentRepositories"];
+
+        if (manifest.concurrentRepositories < 1) {
+            throw invalid_argument("Key 'concurrentRepositories' must contain a value bigger than 0 in " + manifestFileName);
+        }
+    }
+
+    if (!manifestData.contains("repositories") || !manifestData["repositories"].is_array()) {
+        throw runtime_error("Key 'repositories' not found or is not an array in " + manifestFileName);
+    }
+
+    for (size_t i = 0; i < manifestData["repositories"].size(); i++) {
+        const json& repository = manifestData["repositories"][i];
+        string repositoryName = "repository " + to_string(i + 1) + " of " + manifestFileName;
+
+        for (const char* key : {"directory", "start", "end", "source"}) {
+            if (!repository.contains(key)) {
+                throw runtime_error("Key '" + string(key) + "' not found in " + repositoryName);
+            }
+        }
+
+        ManifestEntry entry;
+        entry.directory = repository["directory"];
+        entry.releaseStartRef = repository["start"];
+        entry.releaseEndRef = repository["end"];
+        entry.githubRepository = repository.value("repo", "");
+        entry.outputDirectory = repository.value("outputDirectory", entry.directory);
+
+        string source = repository["source"];
+        if (source == config.commitMessagesSourceCliInputName || source == config.commitMessagesSourceGithubActionsInputName) {
+            entry.releaseNoteSource = ReleaseNoteSources::CommitMessages;
+        }
+        else if (source == config.pullRequestsSourceCliInputName || source == config.pullRequestsSourceGithubActionsInputName) {
+            entry.releaseNoteSource = ReleaseNoteSources::PullRequests;
+
+            if (!repository.contains("mode")) {
+                throw runtime_error("Key 'mode' not found in " + repositoryName);
+            }
+            if (entry.githubRepository.empty()) {
+                throw runtime_error("Key 'repo' not found in " + repositoryName);
+            }
+
+            string mode = repository["mode"];
+            if (mode == config.fullModeCliInputName || mode == config.fullModeGithubActionsInputName) {
+                entry.releaseNoteMode = ReleaseNoteModes::Full;
+            }
+            else if (mode == config.shortModeCliInputName || mode == config.shortModeGithubActionsInputName) {
+                entry.releaseNoteMode = ReleaseNoteModes::Short;
+            }
+            else {
+                throw invalid_argument(config.incorrectReleaseNotesModeError + " in " + repositoryName);
+            }
+        }
+        else {
+            throw invalid_argument(config.incorrectReleaseNotesSourceError + " in " + repositoryName);
+        }
+
+        manifest.entries.push_back(entry);
+    }
+
+    return manifest;
+}
+
+/**
+ * @brief Generates the release notes of all the repositories of a manifest at the same time, each in its own output directory
+ * All the generations share one pool of formatting threads, the GitHub API connections and one GitHub API request budget
+ * (githubApiConcurrentRequests and githubApiRequestBudget in the config apply to all the repositories together), and the generations
+ * of the same repository directory look up their references through the same git process
+ * A repository that fails is reported and doesn't stop the others
+ * @param manifest The manifest listing the repositories
+ * @param githubToken The GitHub token used to make authenticated requests to the GitHub API
+ * @param workers The thread pool that formats the notes of all the repositories
+ * @param config The loaded config
+ * @return Whether the release notes of all the repositories were generated
+ */
+bool generateManifestReleaseNotes(const Manifest& manifest, string githubToken, ThreadPool& workers, const Config& config) {
+    GithubApiBudget githubApiBudget(config.githubApiConcurrentRequests, config.githubApiRequestBudget);
+    GitCatFilePool gitObjects(config.gitProcessesMaxRepositories);
+    ThreadPool repositories(manifest.concurrentRepositories);
+
+    atomic<int> failedRepositories{0};
+    mutex outputMutex;
+
+    for (const ManifestEntry& entry : manifest.entries) {
+        repositories.submit([&, entry]() {
+            string repositoryName = entry.githubRepository.empty() ? entry.directory : entry.githubRepository;
+
+            try {
+                RunContext context(config, entry.githubRepository, githubToken, entry.directory);
+                context.workers = &workers;
+                context.githubApiBudget = &githubApiBudget;
+                context.gitObjects = &gitObjects;
+
+                ReleaseNotes releaseNotes = buildReleaseNotes(entry.releaseNoteSource, entry.releaseStartRef, entry.releaseEndRef,
+                                                              entry.releaseNoteMode, context);
+                vector<string> fileNames = writeReleaseNotesInFiles(releaseNotes, entry.outputDirectory, "", context);
+
+                lock_guard<mutex> lock(outputMutex);
+                cout << repositoryName + ": release notes generated successfully, check " + joinFileNames(fileNames) << endl;
+            }
+            catch (const exception& e) {
+                failedRepositories++;
+
+                lock_guard<mutex> lock(outputMutex);
+                cerr << repositoryName + ": " + config.failedToGenerateReleaseNotesMessage << endl;
+                cerr << e.what() << endl;
+            }
+        });
+    }
+
+    repositories.waitUntilIdle();
+    return failedRepositories == 0;
+}
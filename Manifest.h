@@ -0,0 +1,47 @@
+/**
+ * @file Manifest.h
+ * @author Ahmed Khaled
+ * @brief This file defines the manifest mode, which generates the release notes of many repositories at the same time
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "Enums.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * @brief A single repository to generate release notes for, as listed in the manifest file
+ */
+struct ManifestEntry {
+    string directory; /**< Directory of the local git repository*/
+    string githubRepository; /**< GitHub repository in the form owner/repository (e.g., synfig/synfig)*/
+    string releaseStartRef;
+    string releaseEndRef;
+    ReleaseNoteSources releaseNoteSource = ReleaseNoteSources::CommitMessages;
+    ReleaseNoteModes releaseNoteMode = ReleaseNoteModes::Short;
+    string outputDirectory; /**< Directory that the notes files are written in, the repository directory by default*/
+};
+
+/**
+ * @brief A manifest file listing the repositories of a coordinated release, e.g.
+ * {
+ *     "concurrentRepositories": 8,
+ *     "repositories": [
+ *         {"directory": "../synfig", "repo": "synfig/synfig", "start": "v1.4.0", "end": "v1.4.1",
+ *          "source": "prs", "mode": "full", "outputDirectory": "notes/synfig"}
+ *     ]
+ * }
+ */
+struct Manifest {
+    int concurrentRepositories = 8; /**< Maximum number of repositories generated at the same time*/
+    vector<ManifestEntry> entries;
+};
+
+Manifest loadManifest(const string& manifestFileName, const Config& config);
+bool generateManifestReleaseNotes(const Manifest& manifest, string githubToken, ThreadPool& workers, const Config& config);
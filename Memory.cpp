@@ -0,0 +1,215 @@
+/**
+ * @file Memory.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the MemoryAccounting class defined in Memory.h, which is fed by the operators of MemoryHooks.cpp
+ */
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+
+// Windows gives the peak resident set size with GetProcessMemoryInfo() instead of getrusage(), NOMINMAX keeps windows.h
+// from defining the min and max macros which would replace std::min and std::max
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+#include <json.hpp>
+
+#include "Memory.h"
+#include "Profiler.h"
+#include "Enums.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief The memory accounting of the process, shared by all the generations and threads
+ * When the operators of MemoryHooks.cpp are linked, it is constructed by the first allocation of the process, which is why it mustn't allocate itself
+ */
+MemoryAccounting& getMemoryAccounting() {
+    static MemoryAccounting memoryAccounting;
+    return memoryAccounting;
+}
+
+/**
+ * @brief Counts an allocation in the phase of the current thread and updates the peak of the live bytes
+ * @param bytes Size of the allocated block
+ */
+void MemoryAccounting::recordAllocation(size_t bytes) {
+    PhaseCounters& phaseCounters = phasesCounters[currentPhase];
+    phaseCounters.allocations.fetch_add(1, memory_order_relaxed);
+    phaseCounters.allocatedBytes.fetch_add(bytes, memory_order_relaxed);
+
+    long long live = liveBytes.fetch_add((long long)bytes, memory_order_relaxed) + (long long)bytes;
+    long long peak = peakLiveBytes.load(memory_order_relaxed);
+    while (live > peak) {
+        if (peakLiveBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+            peakLivePhase.store(currentPhase, memory_order_relaxed);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Counts a deallocation in the phase of the current thread, which isn't always the phase that allocated the memory
+ * (e.g., the notes formatted by the workers are freed after rendering them)
+ * @param bytes Size of the freed block
+ */
+void MemoryAccounting::recordDeallocation(size_t bytes) {
+    phasesCounters[currentPhase].freedBytes.fetch_add(bytes, memory_order_relaxed);
+    liveBytes.fetch_sub((long long)bytes, memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the counters of a phase
+ * @param phase The phase index, or outsidePhases
+ */
+MemoryCounters MemoryAccounting::getPhaseCounters(int phase) const {
+    const PhaseCounters& phaseCounters = phasesCounters[phase];
+    MemoryCounters counters;
+    counters.allocations = phaseCounters.allocations.load(memory_order_relaxed);
+    counters.allocatedBytes = phaseCounters.allocatedBytes.load(memory_order_relaxed);
+    counters.freedBytes = phaseCounters.freedBytes.load(memory_order_relaxed);
+    return counters;
+}
+
+/**
+ * @brief Gets the counters of the whole process since the accounting was enabled
+ */
+MemoryCounters MemoryAccounting::getCounters() const {
+    MemoryCounters total;
+    for (int phase = 0; phase <= outsidePhases; phase++) {
+        MemoryCounters counters = getPhaseCounters(phase);
+        total.allocations += counters.allocations;
+        total.allocatedBytes += counters.allocatedBytes;
+        total.freedBytes += counters.freedBytes;
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the peak resident set size of the process, which the kernel keeps so that no peak between two samples is missed
+ * @return The peak in bytes
+ */
+size_t MemoryAccounting::getPeakResidentBytes() {
+#ifdef _WIN32
+    // The peak working set is the resident set size of Windows
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return (size_t)counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;
+#else
+    // Linux gives it in kilobytes
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+/**
+ * @brief Gets the name of a phase index in the reports
+ */
+static string getMemoryPhaseName(int phase) {
+    return phase == MemoryAccounting::outsidePhases ? "outside of the phases" : Profiler::getPhaseName((ProfilePhases)phase);
+}
+
+/**
+ * @brief Computes the statistics of the phases that allocated at least once, the phases that allocated the most bytes first
+ */
+vector<MemoryAccounting::PhaseSummary> MemoryAccounting::summarizePhases() const {
+    MemoryCounters total = getCounters();
+    vector<PhaseSummary> summaries;
+
+    for (int phase = 0; phase <= outsidePhases; phase++) {
+        MemoryCounters counters = getPhaseCounters(phase);
+        if (counters.allocations == 0 && counters.freedBytes == 0) {
+            continue;
+        }
+
+        summaries.push_back({getMemoryPhaseName(phase), counters,
+                             total.allocations ? counters.allocations * 100.0 / total.allocations : 0,
+                             total.allocatedBytes ? counters.allocatedBytes * 100.0 / total.allocatedBytes : 0});
+    }
+
+    sort(summaries.begin(), summaries.end(), [](const PhaseSummary& a, const PhaseSummary& b) {
+        return a.counters.allocatedBytes > b.counters.allocatedBytes;
+    });
+    return summaries;
+}
+
+/**
+ * @brief Creates a report of the allocations as a table, one row for each phase that allocated, followed by the peaks of the process
+ * The net bytes of a phase are the bytes it allocated minus the bytes it freed, what it added to the heap
+ * @return The table, with the sizes in megabytes
+ */
+string MemoryAccounting::createTableReport() {
+    string report;
+    char row[192];
+
+    snprintf(row, sizeof(row), "%-26s %12s %9s %14s %9s %12s\n", "phase", "allocations", "allocs %", "allocated MB", "bytes %", "net MB");
+    report += row;
+    for (const PhaseSummary& summary : summarizePhases()) {
+        snprintf(row, sizeof(row), "%-26s %12zu %9.1f %14.3f %9.1f %12.3f\n", summary.name.c_str(), summary.counters.allocations,
+                 summary.allocationsShare, summary.counters.allocatedBytes / 1e6, summary.bytesShare,
+                 ((double)summary.counters.allocatedBytes - (double)summary.counters.freedBytes) / 1e6);
+        report += row;
+    }
+
+    MemoryCounters total = getCounters();
+    snprintf(row, sizeof(row), "%-26s %12zu %9.1f %14.3f %9.1f %12.3f\n", "total", total.allocations, 100.0, total.allocatedBytes / 1e6,
+             100.0, ((double)total.allocatedBytes - (double)total.freedBytes) / 1e6);
+    report += row;
+
+    snprintf(row, sizeof(row), "peak heap: %.3f MB (reached in %s), peak resident set: %.3f MB\n", getPeakLiveBytes() / 1e6,
+             getMemoryPhaseName(peakLivePhase.load(memory_order_relaxed)).c_str(), getPeakResidentBytes() / 1e6);
+    report += row;
+
+    return report;
+}
+
+/**
+ * @brief Creates a report of the allocations in JSON, for other programs to use
+ * @return A JSON object with a "phases" array and the totals and peaks of the process, with the sizes in bytes
+ */
+string MemoryAccounting::createJsonReport() {
+    json report;
+    report["phases"] = json::array();
+
+    for (const PhaseSummary& summary : summarizePhases()) {
+        json phase;
+        phase["phase"] = summary.name;
+        phase["allocations"] = summary.counters.allocations;
+        phase["allocatedBytes"] = summary.counters.allocatedBytes;
+        phase["freedBytes"] = summary.counters.freedBytes;
+        phase["allocationsPercent"] = summary.allocationsShare;
+        phase["allocatedBytesPercent"] = summary.bytesShare;
+        report["phases"].push_back(phase);
+    }
+
+    MemoryCounters total = getCounters();
+    report["allocations"] = total.allocations;
+    report["allocatedBytes"] = total.allocatedBytes;
+    report["freedBytes"] = total.freedBytes;
+    report["peakHeapBytes"] = getPeakLiveBytes();
+    report["peakHeapPhase"] = getMemoryPhaseName(peakLivePhase.load(memory_order_relaxed));
+    report["peakResidentBytes"] = getPeakResidentBytes();
+
+    return report.dump(4) + "\n";
+}
@@ -0,0 +1,101 @@
+/**
+ * @file Memory.h
+ * @author Ahmed Khaled
+ * @brief This file defines the MemoryAccounting class which counts the memory allocations of the phases of a run (--memory)
+ * through the replaced global operator new and delete of MemoryHooks.cpp, and measures the peak memory usage of the process
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+#include "Enums.h"
+
+using namespace std;
+
+/**
+ * @brief The allocations counted in one phase (or in the whole process)
+ */
+struct MemoryCounters {
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+    size_t freedBytes = 0;
+};
+
+/**
+ * @brief Counts every allocation made with operator new (strings, vectors, JSON DOMs, regex states...) and the bytes allocated and
+ * freed, in total and for the phase of the profiler that the allocating thread is in, so that the report shows which phases churn
+ * the heap and how much of it each one keeps
+ * Allocations of nested phases are only counted in the innermost one (e.g., the JSON parse of a pull request isn't counted
+ * in the formatting of its note), and the allocations outside of all phases are counted apart
+ * Memory allocated with malloc() directly (like the buffers of libcurl) isn't counted, it only shows in the peak resident set size
+ * It is disabled by default, and while it is disabled operator new and delete only check one flag
+ */
+class MemoryAccounting {
+public:
+    void enable() { enabled.store(true, memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+    void recordAllocation(size_t bytes);
+    void recordDeallocation(size_t bytes);
+    MemoryCounters getCounters() const;
+    MemoryCounters getPhaseCounters(int phase) const;
+    long long getLiveBytes() const { return liveBytes.load(memory_order_relaxed); }
+    long long getPeakLiveBytes() const { return peakLiveBytes.load(memory_order_relaxed); }
+    static size_t getPeakResidentBytes();
+    string createTableReport();
+    string createJsonReport();
+
+    /**
+     * @brief Index of the counters of the allocations made outside of all phases
+     */
+    static constexpr int outsidePhases = (int)ProfilePhases::PhasesCount;
+
+    /**
+     * @brief Sets the phase that the allocations of the current thread are counted in
+     * @param phase The phase index, or outsidePhases
+     * @return The previous phase of the thread, to restore it when the phase ends
+     */
+    static int exchangeCurrentPhase(int phase) {
+        int previousPhase = currentPhase;
+        currentPhase = phase;
+        return previousPhase;
+    }
+
+private:
+    /**
+     * @brief The counters of one phase, updated by every thread that allocates in it
+     */
+    struct PhaseCounters {
+        atomic<size_t> allocations{0};
+        atomic<size_t> allocatedBytes{0};
+        atomic<size_t> freedBytes{0};
+    };
+
+    /**
+     * @brief The statistics of a single phase for the reports
+     */
+    struct PhaseSummary {
+        string name;
+        MemoryCounters counters;
+        double allocationsShare; /**< Percentage of all the allocations of the run*/
+        double bytesShare; /**< Percentage of all the bytes allocated in the run*/
+    };
+
+    atomic<bool> enabled{false};
+    PhaseCounters phasesCounters[outsidePhases + 1];
+    /**
+     * @brief Bytes allocated and not freed yet since the accounting was enabled, memory allocated before it and freed after it
+     * is subtracted too, so it is relative to the heap when it was enabled
+     */
+    atomic<long long> liveBytes{0};
+    atomic<long long> peakLiveBytes{0};
+    atomic<int> peakLivePhase{outsidePhases}; /**< Phase of the thread whose allocation reached the peak*/
+    inline static thread_local int currentPhase = outsidePhases;
+
+    vector<PhaseSummary> summarizePhases() const;
+};
+
+MemoryAccounting& getMemoryAccounting();
@@ -0,0 +1,97 @@
+/**
+ * @file MemoryHooks.cpp
+ * @author Ahmed Khaled
+ * @brief This file replaces the global operator new and delete to feed the MemoryAccounting of Memory.h
+ *
+ * It isn't part of the library, since replacing the allocator of a program that embeds it (or clashing with its own replacement)
+ * isn't the library's call, only the generator, the benchmarks and the performance gate link it
+ * Without it, --memory reports no allocations
+ * The sizes are the usable sizes of the blocks given by malloc() (at least the requested sizes), since operator delete
+ * isn't always given the size of the memory it frees
+ */
+
+#include <new>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+#include "Memory.h"
+
+using namespace std;
+
+// GCC sees malloc() in the replaced operator new and free() in the replaced operator delete, and wrongly warns that they don't match
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+/**
+ * @brief Gets the size of a block allocated with malloc()
+ */
+static size_t getBlockSize(void* memory) {
+#if defined(_WIN32)
+    return _msize(memory);
+#elif defined(__APPLE__)
+    return malloc_size(memory);
+#else
+    return malloc_usable_size(memory);
+#endif
+}
+
+/**
+ * @brief Every allocation of the program goes through these replacements of the global operator new, which allocate with malloc()
+ * and count the allocation if the memory accounting is enabled
+ */
+void* operator new(size_t size) {
+    void* memory = malloc(size == 0 ? 1 : size);
+    if (!memory) {
+        throw bad_alloc();
+    }
+    MemoryAccounting& memoryAccounting = getMemoryAccounting();
+    if (memoryAccounting.isEnabled()) {
+        memoryAccounting.recordAllocation(getBlockSize(memory));
+    }
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    void* memory = malloc(size == 0 ? 1 : size);
+    MemoryAccounting& memoryAccounting = getMemoryAccounting();
+    if (memory && memoryAccounting.isEnabled()) {
+        memoryAccounting.recordAllocation(getBlockSize(memory));
+    }
+    return memory;
+}
+
+void* operator new[](size_t size, const nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+    MemoryAccounting& memoryAccounting = getMemoryAccounting();
+    if (memory && memoryAccounting.isEnabled()) {
+        memoryAccounting.recordDeallocation(getBlockSize(memory));
+    }
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    operator delete(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    operator delete(memory);
+}
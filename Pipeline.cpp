@@ -0,0 +1,483 @@
+/**
+ * @file Pipeline.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the ReleaseNotesPipeline class defined in Pipeline.h
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+#include <regex>
+#include <thread>
+#include <stdexcept>
+
+#include <json.hpp>
+
+#include "Pipeline.h"
+#include "Config.h"
+#include "Enums.h"
+#include "Utils.h"
+#include "Format.h"
+#include "GitLog.h"
+#include "GitObjects.h"
+#include "Subprocess.h"
+#include "RunContext.h"
+#include "Profiler.h"
+#include "Probes.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Creates the pipeline, nothing runs until run() is called
+ * @param releaseNoteSource The source to generate release notes from (commit messages or pull requests)
+ * @param releaseStartRef The git reference (commit SHA or tag name) that references the commit directly before the
+ * commit that starts the commit messages of the release, for example, the tag name of the previous release
+ * @param releaseEndRef The git reference (commit SHA or tag name) that references the end of the commit messages of the release
+ * @param releaseNoteMode The release notes mode when the source is pull requests
+ * @param context The context of the generation (GitHub repository and token, local git repository), it must outlive the pipeline
+ */
+ReleaseNotesPipeline::ReleaseNotesPipeline(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                           ReleaseNoteModes releaseNoteMode, const RunContext& context)
+    : releaseNoteSource(releaseNoteSource), releaseStartRef(releaseStartRef), releaseEndRef(releaseEndRef),
+      releaseNoteMode(releaseNoteMode), context(context), config(context.config),
+      commitsQueue(1024), pullRequestsQueue(1024), notesQueue(1024),
+      ownFormatters(context.workers ? nullptr : make_unique<ThreadPool>()),
+      formatters(context.workers ? *context.workers : *ownFormatters),
+      ownGithubApiBudget(context.githubApiBudget ? nullptr
+          : make_unique<GithubApiBudget>(context.config.githubApiConcurrentRequests, context.config.githubApiRequestBudget)),
+      githubApiBudget(context.githubApiBudget ? *context.githubApiBudget : *ownGithubApiBudget) {}
+
+/**
+ * @brief Runs all the stages and waits for them to finish
+ * @return The generated release notes
+ */
+ReleaseNotes ReleaseNotesPipeline::run() {
+    thread gitReader(&ReleaseNotesPipeline::readCommits, this);
+    thread classifier(&ReleaseNotesPipeline::classifyCommits, this);
+
+    vector<thread> fetchers;
+    if (releaseNoteSource == ReleaseNoteSources::PullRequests) {
+        for (int i = 0; i < config.githubApiConcurrentRequests; i++) {
+            fetchers.emplace_back(&ReleaseNotesPipeline::fetchPullRequests, this);
+        }
+    }
+
+    ReleaseNotes releaseNotes;
+    thread writer([this, &releaseNotes]() {
+        try {
+            releaseNotes = writeNotes();
+        }
+        catch (...) {
+            stopWithError(current_exception());
+
+            // The stages before the writer mustn't wait for room in the notes queue, canceling it already drops its items
+            // and makes the pushes fail, and it is drained until it is closed in case anything is still pushed
+            PipelineItem item;
+            while (notesQueue.pop(item)) {
+            }
+        }
+    });
+
+    // Each stage closes the queue after it when it finishes, the notes queue is closed here since
+    // notes are pushed to it from the classifier and from the formatters
+    gitReader.join();
+    classifier.join();
+    for (thread& fetcher : fetchers) {
+        fetcher.join();
+    }
+    formattingTasks.wait();
+    notesQueue.close();
+    writer.join();
+
+    if (failed) {
+        rethrow_exception(firstError);
+    }
+
+    return releaseNotes;
+}
+
+/**
+ * @brief Stops all the stages after the first error, the error is thrown again from run()
+ * @param error The error that happened in one of the stages
+ */
+void ReleaseNotesPipeline::stopWithError(exception_ptr error) {
+    {
+        lock_guard<mutex> lock(firstErrorMutex);
+        if (!failed) {
+            firstError = error;
+            failed = true;
+        }
+    }
+
+    // The queued items are dropped so that the fetchers don't keep sending requests whose responses would be thrown away
+    commitsQueue.cancel();
+    pullRequestsQueue.cancel();
+    notesQueue.cancel();
+}
+
+/**
+ * @brief Stage 1: Reads the commits of each conventional commit type (in the order of the commit types in the config)
+ * between the start reference and the end reference from git log
+ */
+void ReleaseNotesPipeline::readCommits() {
+    try {
+        size_t sequenceNumber = 0;
+
+        for (int commitTypeIndex = 0; commitTypeIndex < config.commitTypesCount && !failed; commitTypeIndex++) {
+            ProfileScope gitLogTimer(ProfilePhases::GitLog);
+            gitLogTimer.addTraceArgument("commitType", config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::ConventionalName]);
+            Subprocess gitLog(createGitCommand(createGitLogArguments(releaseNoteSource, releaseStartRef, releaseEndRef, commitTypeIndex, config),
+                                               context.repositoryDirectory));
+            GitLogReader gitLogReader(gitLog.outputFileDescriptor());
+            CommitRecord commitRecord;
+
+            bool commitTypeContainsReleaseNotes = 0;
+
+            while (gitLogReader.nextRecord(commitRecord)) {
+                // The title of this commit type section is only added in the release notes if it contains any commits
+                if (!commitTypeContainsReleaseNotes) {
+                    commitTypeContainsReleaseNotes = 1;
+
+                    PipelineItem sectionTitle;
+                    sectionTitle.sequenceNumber = sequenceNumber++;
+                    sectionTitle.commitTypeIndex = commitTypeIndex;
+                    sectionTitle.isSectionTitle = true;
+                    commitsQueue.push(move(sectionTitle));
+                }
+
+                PipelineItem commit;
+                commit.sequenceNumber = sequenceNumber++;
+                commit.commitTypeIndex = commitTypeIndex;
+                commit.sha = commitRecord.sha;
+                commit.subject = commitRecord.subject;
+                // Only the first line of the body may be needed (the pull request title of merge commits)
+                commit.body = commitRecord.body.substr(0, commitRecord.body.find('\n'));
+
+                if (!commitsQueue.push(move(commit))) {
+                    break;
+                }
+            }
+
+            if (gitLog.wait() != 0 && !failed) {
+                throw runtime_error(config.gitLogError);
+            }
+        }
+    }
+    catch (...) {
+        stopWithError(current_exception());
+    }
+
+    commitsQueue.close();
+}
+
+/**
+ * @brief Stage 2: Matches each commit subject against its commit type, then sends the commit to be formatted directly
+ * (commit messages source) or to have its pull request fetched first (pull requests source)
+ */
+void ReleaseNotesPipeline::classifyCommits() {
+    try {
+        PipelineItem item;
+        while (!failed && commitsQueue.pop(item)) {
+            if (item.isSectionTitle) {
+                notesQueue.push(move(item));
+                continue;
+            }
+
+            CommitNextStages nextStage = classifyCommit(item, releaseNoteSource, releaseNoteMode, config);
+            if (nextStage == CommitNextStages::Formatter) {
+                submitFormatting(move(item));
+            }
+            else if (nextStage == CommitNextStages::PullRequestFetcher) {
+                pullRequestsQueue.push(move(item));
+            }
+            else {
+                // Commits that are not added to the notes still reach the writer, so that it doesn't wait for them
+                notesQueue.push(move(item));
+            }
+        }
+    }
+    catch (...) {
+        stopWithError(current_exception());
+    }
+
+    pullRequestsQueue.close();
+}
+
+/**
+ * @brief Stage 3: Fetches the info of the pull request of each commit from the GitHub API
+ * Several of these stages run at the same time (githubApiConcurrentRequests in the config), so requests overlap each other
+ * If the time budget or the request budget is exhausted or the request times out, the note is generated from the commit subject instead
+ */
+void ReleaseNotesPipeline::fetchPullRequests() {
+    const long requestTimeoutMilliseconds = config.githubApiRequestTimeoutSeconds * 1000L;
+
+    try {
+        PipelineItem item;
+        while (!failed && pullRequestsQueue.pop(item)) {
+            bool budgetUsedUp = false;
+
+            if (!context.deadline.isExpired()) {
+                if (githubApiBudget.acquire()) {
+                    bool fetched = false;
+                    try {
+                        item.pullRequestInfo = getPullRequestInfo(item.pullRequestNumber,
+                                                                  context.deadline.remainingMilliseconds(requestTimeoutMilliseconds), context);
+                        fetched = true;
+                    }
+                    catch (const GithubApiTimeoutError&) {
+                    }
+                    catch (...) {
+                        githubApiBudget.release();
+                        throw;
+                    }
+                    githubApiBudget.release();
+
+                    if (fetched) {
+                        submitFormatting(move(item));
+                        continue;
+                    }
+                }
+                else {
+                    budgetUsedUp = true;
+                }
+            }
+
+            item.note = formatCommitSubjectNote(item, config);
+            item.hasNote = true;
+            if (budgetUsedUp) {
+                exceededRequestBudget = true;
+            }
+            else {
+                usedCommitSubjects = true;
+            }
+            notesQueue.push(move(item));
+        }
+    }
+    catch (...) {
+        stopWithError(current_exception());
+    }
+}
+
+/**
+ * @brief Submits a commit to be formatted on the formatters thread pool, counting it in the formatting tasks of this pipeline
+ * @param item The commit to format
+ */
+void ReleaseNotesPipeline::submitFormatting(PipelineItem item) {
+    formattingTasks.add();
+    formatters.submit([this, item = move(item)]() mutable {
+        formatNote(move(item));
+        formattingTasks.finish();
+    });
+}
+
+/**
+ * @brief Stage 4: Formats a single commit or pull request into its markdown release note, runs on the formatters thread pool
+ * @param item The commit to format
+ */
+void ReleaseNotesPipeline::formatNote(PipelineItem item) {
+    if (failed) {
+        return;
+    }
+
+    try {
+        item.note = formatCommitNote(item, releaseNoteSource, releaseNoteMode, context);
+        item.hasNote = true;
+        notesQueue.push(move(item));
+    }
+    catch (...) {
+        stopWithError(current_exception());
+    }
+}
+
+/**
+ * @brief Stage 5: Puts the formatted notes back in the order they were read in from git log
+ * Notes are added in their sections as soon as all the notes before them are ready
+ * @return The complete release notes
+ */
+ReleaseNotes ReleaseNotesPipeline::writeNotes() {
+    ReleaseNotes releaseNotes;
+    map<size_t, PipelineItem> itemsWaitingForPreviousItems;
+    size_t nextSequenceNumber = 0;
+
+    PipelineItem item;
+    while (notesQueue.pop(item)) {
+        size_t sequenceNumber = item.sequenceNumber;
+        itemsWaitingForPreviousItems[sequenceNumber] = move(item);
+
+        auto nextItem = itemsWaitingForPreviousItems.begin();
+        while (nextItem != itemsWaitingForPreviousItems.end() && nextItem->first == nextSequenceNumber) {
+            // The section title of a commit type is always read before its commits
+            if (nextItem->second.isSectionTitle) {
+                releaseNotes.sections.push_back(createReleaseNotesSection(nextItem->second.commitTypeIndex, config));
+            }
+            else if (nextItem->second.hasNote) {
+                releaseNotes.sections.back().notes.push_back(move(nextItem->second.note));
+                if (context.notesStream) {
+                    context.notesStream->write(releaseNotes.sections.back(), releaseNotes.sections.back().notes.back());
+                }
+            }
+            nextItem = itemsWaitingForPreviousItems.erase(nextItem);
+            nextSequenceNumber++;
+        }
+    }
+
+    // All the fetchers finished before the notes queue was closed, so no more notes can be generated from commit subjects
+    releaseNotes.usedCommitSubjects = usedCommitSubjects;
+    releaseNotes.exceededRequestBudget = exceededRequestBudget;
+
+    return releaseNotes;
+}
+
+/**
+ * @brief Creates the arguments of the git log command that reads the commits of one commit type between the start and end references
+ * @param releaseNoteSource The source to generate release notes from, only commits referencing a pull request are read for pull requests
+ * @param releaseStartRef The git reference of the commit directly before the release
+ * @param releaseEndRef The git reference of the end of the release
+ * @param commitTypeIndex Index of the commit type in the commit types 2d array
+ * @param config The loaded config
+ * @return The git log arguments (without "git" itself)
+ */
+vector<string> createGitLogArguments(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                     int commitTypeIndex, const Config& config) {
+    // The range is passed before "--" (after it, git log would read it as a path), so a reference must not be read as an option
+    for (const string& reference : {releaseStartRef, releaseEndRef}) {
+        if (!reference.empty() && reference[0] == '-') {
+            throw invalid_argument("Git references can't start with '-': " + reference);
+        }
+    }
+
+    vector<string> gitLogArguments = {"log", releaseStartRef + ".." + releaseEndRef, "-z", gitLogRecordFormat,
+        "--grep=^" + config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::ConventionalName] + "[:(]"};
+
+    // Only commits that reference a pull request (#number) can be used when pull requests are the source
+    if (releaseNoteSource == ReleaseNoteSources::PullRequests) {
+        gitLogArguments.push_back("--grep=#[0-9]");
+        gitLogArguments.push_back("--all-match");
+    }
+
+    return gitLogArguments;
+}
+
+/**
+ * @brief Matches a commit subject against its commit type and finds the pull request number or title that its note needs
+ * @param item The commit, its match result, pull request number and local pull request title are set
+ * @param releaseNoteSource The source to generate release notes from (commit messages or pull requests)
+ * @param releaseNoteMode The release notes mode when the source is pull requests
+ * @param config The loaded config
+ * @return The stage that the commit goes to next
+ */
+CommitNextStages classifyCommit(PipelineItem& item, ReleaseNoteSources releaseNoteSource, ReleaseNoteModes releaseNoteMode,
+                                const Config& config) {
+    // Regular expression to match # followed by one or more digits, created once for all commits
+    static const regex pullRequestNumberPattern(R"(#(\d+))");
+
+    // Short mode only needs the pull request title, which can be taken from the commit message, full mode always fetches the pull request
+    bool hasLocalPullRequestTitle = releaseNoteSource == ReleaseNoteSources::PullRequests && releaseNoteMode == ReleaseNoteModes::Short
+        && extractLocalPullRequestTitle(item.subject, item.body, item.localPullRequestTitle, item.pullRequestNumber);
+
+    // In short mode, merge commits are classified using the pull request title in their body, since their subject has no commit type
+    item.matchResult = checkCommitTypeMatch(hasLocalPullRequestTitle ? item.localPullRequestTitle : item.subject,
+                                            item.commitTypeIndex, config);
+    PROBE_COMMIT_CLASSIFY(item.sha.c_str(), item.commitTypeIndex, (int)item.matchResult);
+
+    if (item.matchResult == CommitTypeMatchResults::NoMatch) {
+        return CommitNextStages::Writer;
+    }
+    if (releaseNoteSource == ReleaseNoteSources::CommitMessages || hasLocalPullRequestTitle) {
+        return CommitNextStages::Formatter;
+    }
+
+    smatch match;
+
+    // Validating that a hashtag exists
+    if (regex_search(item.subject, match, pullRequestNumberPattern)) {
+        // Extracting the PR number associated with the commit from the first capture group
+        item.pullRequestNumber = match.str(1);
+        return CommitNextStages::PullRequestFetcher;
+    }
+
+    return CommitNextStages::Writer;
+}
+
+/**
+ * @brief Formats the release note of a classified commit, using the info of its pull request if it was fetched
+ * @param item The commit
+ * @param releaseNoteSource The source to generate release notes from (commit messages or pull requests)
+ * @param releaseNoteMode The release notes mode when the source is pull requests
+ * @param context The context of the generation, which contains the config and the repository URLs that the notes link to
+ * @return The release note
+ */
+ReleaseNote formatCommitNote(const PipelineItem& item, ReleaseNoteSources releaseNoteSource, ReleaseNoteModes releaseNoteMode,
+                             const RunContext& context) {
+    ProfileScope formatTimer(ProfilePhases::FormatNote);
+    PROBE_FORMAT_START(item.sha.c_str(), item.commitTypeIndex, item.pullRequestInfo.size());
+    const Config& config = context.config;
+    ReleaseNote note;
+
+    if (releaseNoteSource == ReleaseNoteSources::CommitMessages) {
+        note = createReleaseNote(item.subject, item.matchResult, item.commitTypeIndex, config);
+    }
+    else if (item.pullRequestInfo.empty()) {
+        // Same as the short mode note of createPullRequestReleaseNote() but with the title from the commit message
+        note = createReleaseNote(item.localPullRequestTitle, item.matchResult, item.commitTypeIndex, config);
+    }
+    else {
+        note = createPullRequestReleaseNote(parsePullRequestInfo(item.pullRequestInfo), releaseNoteMode, item.commitTypeIndex, context);
+    }
+
+    if (!item.pullRequestNumber.empty()) {
+        note.pullRequestNumber = item.pullRequestNumber;
+    }
+    note.commitShas.push_back(item.sha);
+    PROBE_FORMAT_END(item.sha.c_str(), note.title.size(), note.body.size());
+    return note;
+}
+
+/**
+ * @brief Formats the release note of a commit whose pull request couldn't be fetched (time or request budget exhausted)
+ * from the pull request title in its commit message, or from its commit subject
+ * @param item The commit
+ * @param config The loaded config
+ * @return The release note
+ */
+ReleaseNote formatCommitSubjectNote(const PipelineItem& item, const Config& config) {
+    ReleaseNote note = createReleaseNote(item.localPullRequestTitle.empty() ? item.subject : item.localPullRequestTitle,
+                                         item.matchResult, item.commitTypeIndex, config);
+    note.pullRequestNumber = item.pullRequestNumber;
+    note.commitShas.push_back(item.sha);
+    return note;
+}
+
+/**
+ * @brief Creates the release note of a pull request from its information (title, body), based on the release notes mode
+ * @param pullRequestInfo JSON object containing raw pull request information
+ * @param releaseNotesMode The release notes mode that will decide if the pull request body will be included or not
+ * @param commitTypeIndex Index of the commit type in the commit types 2d array that this pull request belongs to
+ * @param context The context of the generation, which contains the config and the repository URLs that the notes link to
+ * @return The release note
+ */
+ReleaseNote createPullRequestReleaseNote(json pullRequestInfo, ReleaseNoteModes releaseNotesMode, int commitTypeIndex,
+                                         const RunContext& context) {
+    const Config& config = context.config;
+
+    string title = pullRequestInfo["title"].is_null() ? "" : pullRequestInfo["title"].get<string>();
+    ReleaseNote note = createReleaseNote(title, checkCommitTypeMatch(title, commitTypeIndex, config), commitTypeIndex, config);
+    note.source = ReleaseNoteSources::PullRequests;
+    note.isDetailed = releaseNotesMode == ReleaseNoteModes::Full;
+
+    if (pullRequestInfo.contains("number") && pullRequestInfo["number"].is_number()) {
+        note.pullRequestNumber = to_string(pullRequestInfo["number"].get<long>());
+    }
+
+    if (releaseNotesMode == ReleaseNoteModes::Full && !pullRequestInfo["body"].is_null()) {
+        string body = pullRequestInfo["body"];
+
+        // Capitalizing the first letter of the body
+        body[0] = toupper(body[0]);
+        note.body = formatPullRequestBody(body, context);
+        note.isBreaking = note.isBreaking || note.body.find("BREAKING CHANGE") != string::npos;
+    }
+
+    return note;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file Pipeline.h
+ * @author Ahmed Khaled
+ * @brief This file defines the ReleaseNotesPipeline class which generates release notes in stages that run at the same time
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <memory>
+
+#include <json.hpp>
+
+#include "Enums.h"
+#include "BoundedQueue.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+#include "RunContext.h"
+#include "ReleaseNotes.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief A commit (or a section title) travelling through the stages of the pipeline
+ */
+struct PipelineItem {
+    size_t sequenceNumber = 0; /**< Position of the item in the release notes, used by the writer to put the items back in order*/
+    int commitTypeIndex = 0;
+    bool isSectionTitle = false;
+    string sha;
+    string subject;
+    string body;
+    string localPullRequestTitle; /**< Pull request title taken from the commit message, used in short mode instead of the GitHub API*/
+    CommitTypeMatchResults matchResult = CommitTypeMatchResults::NoMatch;
+    string pullRequestNumber;
+    string pullRequestInfo; /**< Raw JSON response of the GitHub API for the pull request of the commit*/
+    ReleaseNote note; /**< The release note of the item, only used if hasNote is true*/
+    bool hasNote = false; /**< Whether the item has a release note (false for section titles and commits without notes)*/
+};
+
+/**
+ * @brief A class that generates release notes in 5 stages connected by bounded queues:
+ * git reader -> classifier -> pull requests fetchers -> formatters -> writer
+ * Each stage runs on its own thread(s), so pull requests start being fetched as soon as the first commit is classified,
+ * several pull requests are fetched at the same time, notes are formatted on worker threads, and the writer puts
+ * the notes back in section order, so the total time gets close to the slowest stage instead of the sum of all of them
+ * In short mode, pull request titles are taken from squash merge subjects or merge commit bodies when possible,
+ * and the GitHub API is only used for the commits that don't have them
+ * Generation is limited by the deadline of the context (generationTimeBudgetSeconds in the config), after which (or after
+ * a pull request request times out) the remaining notes are generated from their commit subjects like in short mode,
+ * and the notes are annotated with that, the same happens for the notes left after the GitHub API request budget is used up
+ * Formatting workers and the request budget can be shared between pipelines that run together through the run context
+ */
+class ReleaseNotesPipeline {
+public:
+    ReleaseNotesPipeline(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                         ReleaseNoteModes releaseNoteMode, const RunContext& context);
+    ReleaseNotes run();
+
+private:
+    ReleaseNoteSources releaseNoteSource;
+    string releaseStartRef;
+    string releaseEndRef;
+    ReleaseNoteModes releaseNoteMode;
+    const RunContext& context;
+    const Config& config;
+
+    BoundedQueue<PipelineItem> commitsQueue;
+    BoundedQueue<PipelineItem> pullRequestsQueue;
+    BoundedQueue<PipelineItem> notesQueue;
+    unique_ptr<ThreadPool> ownFormatters; /**< Only started when the context doesn't have shared workers*/
+    ThreadPool& formatters;
+    TaskGroup formattingTasks;
+
+    unique_ptr<GithubApiBudget> ownGithubApiBudget; /**< Only created when the context doesn't have a shared budget*/
+    GithubApiBudget& githubApiBudget;
+    atomic<bool> usedCommitSubjects{false}; /**< Whether any note was generated from its commit subject because of timeouts*/
+    atomic<bool> exceededRequestBudget{false}; /**< Whether any note was generated from its commit subject because of the request budget*/
+
+    atomic<bool> failed{false};
+    exception_ptr firstError;
+    mutex firstErrorMutex;
+
+    void readCommits();
+    void classifyCommits();
+    void fetchPullRequests();
+    void submitFormatting(PipelineItem item);
+    void formatNote(PipelineItem item);
+    ReleaseNotes writeNotes();
+    void stopWithError(exception_ptr error);
+};
+
+vector<string> createGitLogArguments(ReleaseNoteSources releaseNoteSource, string releaseStartRef, string releaseEndRef,
+                                     int commitTypeIndex, const Config& config);
+CommitNextStages classifyCommit(PipelineItem& item, ReleaseNoteSources releaseNoteSource, ReleaseNoteModes releaseNoteMode,
+                                const Config& config);
+ReleaseNote formatCommitNote(const PipelineItem& item, ReleaseNoteSources releaseNoteSource, ReleaseNoteModes releaseNoteMode,
+                             const RunContext& context);
+ReleaseNote formatCommitSubjectNote(const PipelineItem& item, const Config& config);
+ReleaseNote createPullRequestReleaseNote(json pullRequestInfo, ReleaseNoteModes releaseNotesMode, int commitTypeIndex,
+                                         const RunContext& context);
@@ -0,0 +1,67 @@
+/**
+ * @file Probes.h
+ * @author Ahmed Khaled
+ * @brief This file defines the USDT (user statically defined tracing) probes of the hot paths of the generator, which tracers
+ * like bpftrace can attach to in a running process without rebuilding it
+ *
+ * The probes are only compiled in when building with -DRELEASE_NOTES_USDT_PROBES, which needs sys/sdt.h (systemtap-sdt-dev
+ * on Debian/Ubuntu, systemtap-sdt-devel on Fedora), otherwise they are empty statements whose arguments are never evaluated
+ * A compiled in probe is a single nop instruction until a tracer attaches to it, so the probes can stay in production builds
+ *
+ * All the probes belong to the release_notes_generator provider, for example:
+ * bpftrace -e 'usdt:./release_notes_manager:release_notes_generator:pr_fetch_end { printf("%s %d\n", str(arg0), arg1); }'
+ *
+ * Probes and their arguments:
+ * - commit_read(const char* sha, size_t shaLength, size_t subjectLength, size_t bodyLength)
+ *   A commit record was read from the output of git log, sha isn't NUL terminated (use str(arg0, arg1) in bpftrace)
+ * - commit_classify(const char* sha, int commitTypeIndex, int matchResult)
+ *   A commit was matched against its commit type, matchResult is 0 (match without scope), 1 (match with scope) or 2 (no match)
+ * - pr_fetch_start(const char* url, const char* pullRequestNumber)
+ *   The request of the info of a pull request was created, it is sent right after
+ * - pr_fetch_end(const char* url, long httpCode, size_t bodyBytes)
+ *   The response of the info of a pull request was received, httpCode is 0 if the request failed before getting a response
+ * - format_start(const char* sha, int commitTypeIndex, size_t pullRequestInfoBytes)
+ *   The note of a commit started being formatted, pullRequestInfoBytes is 0 if the note doesn't use the info of its pull request
+ * - format_end(const char* sha, size_t titleLength, size_t bodyLength)
+ *   The note of a commit was formatted
+ * - render(const char* format, size_t sectionsCount, size_t outputBytes)
+ *   The release notes were rendered locally in an output format ("markdown", "html", "json" or "text")
+ * - output_write(const char* path, size_t bytes)
+ *   An output file was written
+ */
+
+#pragma once
+
+#ifdef RELEASE_NOTES_USDT_PROBES
+
+#include <sys/sdt.h>
+
+#define PROBE_COMMIT_READ(sha, shaLength, subjectLength, bodyLength) \
+    DTRACE_PROBE4(release_notes_generator, commit_read, sha, shaLength, subjectLength, bodyLength)
+#define PROBE_COMMIT_CLASSIFY(sha, commitTypeIndex, matchResult) \
+    DTRACE_PROBE3(release_notes_generator, commit_classify, sha, commitTypeIndex, matchResult)
+#define PROBE_PR_FETCH_START(url, pullRequestNumber) \
+    DTRACE_PROBE2(release_notes_generator, pr_fetch_start, url, pullRequestNumber)
+#define PROBE_PR_FETCH_END(url, httpCode, bodyBytes) \
+    DTRACE_PROBE3(release_notes_generator, pr_fetch_end, url, httpCode, bodyBytes)
+#define PROBE_FORMAT_START(sha, commitTypeIndex, pullRequestInfoBytes) \
+    DTRACE_PROBE3(release_notes_generator, format_start, sha, commitTypeIndex, pullRequestInfoBytes)
+#define PROBE_FORMAT_END(sha, titleLength, bodyLength) \
+    DTRACE_PROBE3(release_notes_generator, format_end, sha, titleLength, bodyLength)
+#define PROBE_RENDER(format, sectionsCount, outputBytes) \
+    DTRACE_PROBE3(release_notes_generator, render, format, sectionsCount, outputBytes)
+#define PROBE_OUTPUT_WRITE(path, bytes) \
+    DTRACE_PROBE2(release_notes_generator, output_write, path, bytes)
+
+#else
+
+#define PROBE_COMMIT_READ(sha, shaLength, subjectLength, bodyLength) ((void)0)
+#define PROBE_COMMIT_CLASSIFY(sha, commitTypeIndex, matchResult) ((void)0)
+#define PROBE_PR_FETCH_START(url, pullRequestNumber) ((void)0)
+#define PROBE_PR_FETCH_END(url, httpCode, bodyBytes) ((void)0)
+#define PROBE_FORMAT_START(sha, commitTypeIndex, pullRequestInfoBytes) ((void)0)
+#define PROBE_FORMAT_END(sha, titleLength, bodyLength) ((void)0)
+#define PROBE_RENDER(format, sectionsCount, outputBytes) ((void)0)
+#define PROBE_OUTPUT_WRITE(path, bytes) ((void)0)
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file Profiler.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the Profiler class defined in Profiler.h
+ */
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+#include <json.hpp>
+
+#include "Profiler.h"
+#include "Enums.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Names of the phases in the reports, in the order of ProfilePhases
+ */
+static const char* const profilePhaseNames[(int)ProfilePhases::PhasesCount] = {
+    "generation",
+    "git references lookup",
+    "git log",
+    "pull request request",
+    "json parse",
+    "format pull request body",
+    "format note",
+    "markdown to html",
+    "render notes",
+    "file write",
+    "git process",
+    "http request"
+};
+
+/**
+ * @brief The profiler of the process, shared by all the generations and threads
+ */
+Profiler& getProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+/**
+ * @brief Gets the name of a phase in the reports
+ */
+const char* Profiler::getPhaseName(ProfilePhases phase) {
+    return profilePhaseNames[(int)phase];
+}
+
+/**
+ * @brief Records one occurrence of a phase
+ * @param phase The phase
+ * @param duration How long the occurrence took
+ */
+void Profiler::record(ProfilePhases phase, chrono::nanoseconds duration) {
+    PhaseDurations& phaseDurations = phasesDurations[(int)phase];
+    lock_guard<mutex> lock(phaseDurations.durationsMutex);
+    phaseDurations.nanoseconds.push_back(duration.count());
+}
+
+/**
+ * @brief Starts keeping every occurrence of the phases in the trace, the thread that enables it is the first thread of the trace
+ */
+void Profiler::enableTracing() {
+    traceStart = chrono::steady_clock::now();
+    getTraceThreadId();
+    tracing.store(true, memory_order_relaxed);
+}
+
+/**
+ * @brief Records one occurrence of a phase in the statistics if the profiler is enabled and in the trace if the run is traced
+ * @param phase The phase
+ * @param start When the occurrence started
+ * @param duration How long the occurrence took
+ * @param traceArguments Details of the occurrence shown with its trace event (e.g., the URL and the status of a request)
+ * @param isOverlapping Whether other occurrences of the same thread may run at the same time, these are written as async events
+ * in the trace since the events of a thread must be nested
+ */
+void Profiler::recordOccurrence(ProfilePhases phase, chrono::steady_clock::time_point start, chrono::nanoseconds duration,
+                                json traceArguments, bool isOverlapping) {
+    if (isEnabled()) {
+        record(phase, duration);
+    }
+    if (!isTracing()) {
+        return;
+    }
+
+    TraceEvent traceEvent;
+    traceEvent.phase = phase;
+    traceEvent.startMicroseconds = max<long long>((start - traceStart).count(), 0) / 1e3;
+    traceEvent.durationMicroseconds = duration.count() / 1e3;
+    traceEvent.threadId = getTraceThreadId();
+    traceEvent.isOverlapping = isOverlapping;
+    traceEvent.arguments = move(traceArguments);
+
+    lock_guard<mutex> lock(traceEventsMutex);
+    traceEvents.push_back(move(traceEvent));
+}
+
+/**
+ * @brief Gets a small number that identifies the current thread in the trace, given to the threads in the order they record their first event
+ */
+int Profiler::getTraceThreadId() {
+    static atomic<int> nextThreadId{1};
+    thread_local int threadId = nextThreadId.fetch_add(1);
+    return threadId;
+}
+
+/**
+ * @brief Computes the statistics of the phases that occurred at least once
+ */
+vector<Profiler::PhaseSummary> Profiler::summarizePhases() {
+    vector<PhaseSummary> summaries;
+
+    for (int phase = 0; phase < (int)ProfilePhases::PhasesCount; phase++) {
+        vector<long long> nanoseconds;
+        {
+            lock_guard<mutex> lock(phasesDurations[phase].durationsMutex);
+            nanoseconds = phasesDurations[phase].nanoseconds;
+        }
+        if (nanoseconds.empty()) {
+            continue;
+        }
+
+        sort(nanoseconds.begin(), nanoseconds.end());
+        // Nearest rank percentiles, the p95 of less than 20 occurrences is their maximum
+        auto percentile = [&](size_t percent) {
+            size_t rank = (nanoseconds.size() * percent + 99) / 100;
+            return nanoseconds[max<size_t>(rank, 1) - 1] / 1e6;
+        };
+
+        long long totalNanoseconds = 0;
+        for (long long duration : nanoseconds) {
+            totalNanoseconds += duration;
+        }
+
+        summaries.push_back({profilePhaseNames[phase], nanoseconds.size(), totalNanoseconds / 1e6, percentile(50), percentile(95),
+                             nanoseconds.back() / 1e6});
+    }
+
+    return summaries;
+}
+
+/**
+ * @brief Creates a report of the phases as a table, one row for each phase that occurred
+ * @return The table, with the durations in milliseconds
+ */
+string Profiler::createTableReport() {
+    string report;
+    char row[160];
+
+    snprintf(row, sizeof(row), "%-26s %8s %12s %10s %10s %10s\n", "phase", "count", "total ms", "p50 ms", "p95 ms", "max ms");
+    report += row;
+    for (const PhaseSummary& summary : summarizePhases()) {
+        snprintf(row, sizeof(row), "%-26s %8zu %12.3f %10.3f %10.3f %10.3f\n", summary.name.c_str(), summary.count,
+                 summary.totalMilliseconds, summary.p50Milliseconds, summary.p95Milliseconds, summary.maxMilliseconds);
+        report += row;
+    }
+
+    return report;
+}
+
+/**
+ * @brief Creates a report of the phases in JSON, for other programs to use
+ * @return A JSON object with a "phases" array, with the durations in milliseconds
+ */
+string Profiler::createJsonReport() {
+    json report;
+    report["phases"] = json::array();
+
+    for (const PhaseSummary& summary : summarizePhases()) {
+        json phase;
+        phase["phase"] = summary.name;
+        phase["count"] = summary.count;
+        phase["totalMs"] = summary.totalMilliseconds;
+        phase["p50Ms"] = summary.p50Milliseconds;
+        phase["p95Ms"] = summary.p95Milliseconds;
+        phase["maxMs"] = summary.maxMilliseconds;
+        report["phases"].push_back(phase);
+    }
+
+    return report.dump(4) + "\n";
+}
+
+/**
+ * @brief Creates the trace of the run in the Chrome trace event format, which can be opened in Perfetto or chrome://tracing
+ * Each occurrence is a complete event on the track of its thread, except overlapping ones (the requests of a curl multi handle)
+ * which are pairs of async begin and end events, so that the requests that run at the same time are shown side by side
+ * @return A JSON object with a "traceEvents" array, with the times in microseconds since tracing was enabled
+ */
+string Profiler::createTrace() {
+    json trace;
+    trace["traceEvents"] = json::array();
+    trace["displayTimeUnit"] = "ms";
+
+    lock_guard<mutex> lock(traceEventsMutex);
+    set<int> threadIds;
+    size_t asyncEventId = 0;
+
+    for (const TraceEvent& traceEvent : traceEvents) {
+        json event;
+        event["name"] = profilePhaseNames[(int)traceEvent.phase];
+        event["cat"] = profilePhaseNames[(int)traceEvent.phase];
+        event["pid"] = 1;
+        event["tid"] = traceEvent.threadId;
+        event["ts"] = traceEvent.startMicroseconds;
+        event["args"] = traceEvent.arguments.is_null() ? json::object() : traceEvent.arguments;
+        threadIds.insert(traceEvent.threadId);
+
+        if (!traceEvent.isOverlapping) {
+            event["ph"] = "X";
+            event["dur"] = traceEvent.durationMicroseconds;
+            trace["traceEvents"].push_back(event);
+            continue;
+        }
+
+        asyncEventId++;
+        event["ph"] = "b";
+        event["id"] = asyncEventId;
+        trace["traceEvents"].push_back(event);
+
+        json endEvent;
+        endEvent["name"] = event["name"];
+        endEvent["cat"] = event["cat"];
+        endEvent["ph"] = "e";
+        endEvent["id"] = asyncEventId;
+        endEvent["pid"] = 1;
+        endEvent["tid"] = traceEvent.threadId;
+        endEvent["ts"] = traceEvent.startMicroseconds + traceEvent.durationMicroseconds;
+        trace["traceEvents"].push_back(endEvent);
+    }
+
+    for (int threadId : threadIds) {
+        json threadName;
+        threadName["name"] = "thread_name";
+        threadName["ph"] = "M";
+        threadName["pid"] = 1;
+        threadName["tid"] = threadId;
+        threadName["args"]["name"] = (threadId == 1) ? "main" : "thread " + to_string(threadId);
+        trace["traceEvents"].push_back(threadName);
+    }
+
+    return trace.dump() + "\n";
+}
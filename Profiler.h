@@ -0,0 +1,137 @@
+/**
+ * @file Profiler.h
+ * @author Ahmed Khaled
+ * @brief This file defines the Profiler class and the ProfileScope timer which measure where the time of a run goes (--profile)
+ * and record each occurrence of the phases as a Chrome trace event (--trace)
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <json.hpp>
+
+#include "Enums.h"
+#include "Memory.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Collects the durations of the phases of all the generations of the process, then reports their count, total,
+ * median (p50), 95th percentile (p95) and maximum for each phase
+ * It can also keep every occurrence with the thread that it happened on as a trace, to see in a trace viewer (like Perfetto)
+ * which threads wait for the network while others format
+ * Both are disabled by default, and while they are disabled timers only check two flags
+ */
+class Profiler {
+public:
+    void enable() { enabled.store(true, memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+    void enableTracing();
+    bool isTracing() const { return tracing.load(memory_order_relaxed); }
+    bool isActive() const { return isEnabled() || isTracing(); }
+    void record(ProfilePhases phase, chrono::nanoseconds duration);
+    void recordOccurrence(ProfilePhases phase, chrono::steady_clock::time_point start, chrono::nanoseconds duration,
+                          json traceArguments = json(), bool isOverlapping = false);
+    string createTableReport();
+    string createJsonReport();
+    string createTrace();
+    static const char* getPhaseName(ProfilePhases phase);
+
+private:
+    /**
+     * @brief The durations of a single phase, each phase has its own lock so that phases timed by different threads don't wait for each other
+     */
+    struct PhaseDurations {
+        mutex durationsMutex;
+        vector<long long> nanoseconds;
+    };
+
+    /**
+     * @brief The statistics of a single phase in milliseconds
+     */
+    struct PhaseSummary {
+        string name;
+        size_t count;
+        double totalMilliseconds;
+        double p50Milliseconds;
+        double p95Milliseconds;
+        double maxMilliseconds;
+    };
+
+    /**
+     * @brief A single occurrence of a phase in the trace, with its times in microseconds since tracing was enabled
+     */
+    struct TraceEvent {
+        ProfilePhases phase;
+        double startMicroseconds;
+        double durationMicroseconds;
+        int threadId;
+        bool isOverlapping; /**< Whether other occurrences of the same thread may run at the same time (like requests of a curl multi handle)*/
+        json arguments;
+    };
+
+    atomic<bool> enabled{false};
+    PhaseDurations phasesDurations[(int)ProfilePhases::PhasesCount];
+
+    atomic<bool> tracing{false};
+    chrono::steady_clock::time_point traceStart;
+    mutex traceEventsMutex;
+    vector<TraceEvent> traceEvents;
+
+    vector<PhaseSummary> summarizePhases();
+    static int getTraceThreadId();
+};
+
+Profiler& getProfiler();
+
+/**
+ * @brief Times the scope it is created in as one occurrence of a phase, if the profiler or the trace is enabled,
+ * and counts the allocations of the thread in the scope in the phase, if the memory accounting is enabled
+ * Example: { ProfileScope timer(ProfilePhases::GitLog); timer.addTraceArgument("type", "feat"); ...read git log... }
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhases phase) : phase(phase), profiler(getProfiler().isActive() ? &getProfiler() : nullptr) {
+        if (getMemoryAccounting().isEnabled()) {
+            previousMemoryPhase = MemoryAccounting::exchangeCurrentPhase((int)phase);
+        }
+        if (profiler) {
+            start = chrono::steady_clock::now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (profiler) {
+            profiler->recordOccurrence(phase, start, chrono::steady_clock::now() - start, move(traceArguments));
+        }
+        if (previousMemoryPhase != noMemoryPhase) {
+            MemoryAccounting::exchangeCurrentPhase(previousMemoryPhase);
+        }
+    }
+
+    /**
+     * @brief Adds a detail of this occurrence to its trace event (e.g., the URL of a request), it does nothing if the run isn't traced
+     */
+    void addTraceArgument(const char* name, const json& value) {
+        if (profiler && profiler->isTracing()) {
+            traceArguments[name] = value;
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfilePhases phase;
+    Profiler* profiler; /**< Null when the profiler and the trace are disabled*/
+    chrono::steady_clock::time_point start;
+    json traceArguments;
+    static constexpr int noMemoryPhase = -1;
+    int previousMemoryPhase = noMemoryPhase; /**< Phase of the allocations of the thread before this scope, if the memory accounting is enabled*/
+};
@@ -0,0 +1,597 @@
+/**
+ * @file ReleaseNotes.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the functions defined in ReleaseNotes.h
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <regex>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+
+#include <json.hpp>
+
+#include "ReleaseNotes.h"
+#include "Config.h"
+#include "Enums.h"
+#include "Format.h"
+#include "Utils.h"
+#include "RunContext.h"
+#include "Template.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "Probes.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Creates a release note from a conventional commit title (a commit subject or a pull request title)
+ * @param conventionalCommitTitle The conventional commit title
+ * @param matchResult CommitTypeMatchResult that this title got with it's conventional commit type (has subcategory or no)
+ * @param commitTypeIndex Index of the commit type in the commit types 2d array
+ * @param config The loaded config
+ * @return The release note, without a body, pull request number or commits
+ */
+ReleaseNote createReleaseNote(string conventionalCommitTitle, CommitTypeMatchResults matchResult, int commitTypeIndex, const Config& config) {
+    ReleaseNote note;
+    note.type = config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::ConventionalName];
+    splitConventionalCommitTitle(conventionalCommitTitle, matchResult, note.scope, note.title);
+
+    // Breaking changes are marked by "!" right before the colon (e.g., "feat(API)!: removed X")
+    size_t colonPosition = conventionalCommitTitle.find(":");
+    note.isBreaking = colonPosition != string::npos && colonPosition > 0 && conventionalCommitTitle[colonPosition - 1] == '!';
+
+    return note;
+}
+
+/**
+ * @brief Creates an empty section for the given commit type
+ * @param commitTypeIndex Index of the commit type in the commit types 2d array
+ * @param config The loaded config
+ * @return The section
+ */
+ReleaseNotesSection createReleaseNotesSection(int commitTypeIndex, const Config& config) {
+    ReleaseNotesSection section;
+    section.type = config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::ConventionalName];
+    section.markdownTitle = config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::MarkdownTitle];
+    return section;
+}
+
+/**
+ * @brief The title of a note as shown in the release notes, with its subcategory (e.g., "(GUI Related) Fixed bug X")
+ */
+string getReleaseNoteTitle(const ReleaseNote& note) {
+    return (note.scope.empty() ? "" : formatReleaseNoteScope(note.scope)) + note.title;
+}
+
+/**
+ * @brief Gets the level and the text of a markdown heading (e.g., "## 🐛 Bug Fixes" has level 2 and text "🐛 Bug Fixes")
+ */
+string getMarkdownHeadingText(const string& markdownHeading, int& level) {
+    size_t textStart = markdownHeading.find_first_not_of('#');
+    level = (textStart == string::npos) ? (int)markdownHeading.size() : (int)textStart;
+    textStart = markdownHeading.find_first_not_of(" \t", level);
+    return (textStart == string::npos) ? "" : markdownHeading.substr(textStart);
+}
+
+/**
+ * @brief Removes the markdown of a note from the config (e.g., timeBudgetExceededNote), keeping only its text lines
+ */
+static string getMarkdownNoteText(const string& markdownNote) {
+    string noteText;
+    istringstream lines(markdownNote);
+    string line;
+    while (getline(lines, line)) {
+        if (line.rfind("> ", 0) == 0) {
+            line.erase(0, 2);
+        }
+        if (line.empty() || line[0] == '>' || line.rfind("[!", 0) == 0) {
+            continue;
+        }
+        noteText += (noteText.empty() ? "" : " ") + line;
+    }
+    return noteText;
+}
+
+/**
+ * @brief The JSON object of a note, as written in the JSON release notes and in the notes stream
+ */
+static json createReleaseNoteJson(const ReleaseNote& note) {
+    json jsonNote;
+    jsonNote["type"] = note.type;
+    jsonNote["scope"] = note.scope;
+    jsonNote["title"] = note.title;
+    jsonNote["body"] = note.body;
+    jsonNote["pullRequest"] = note.pullRequestNumber;
+    jsonNote["commits"] = note.commitShas;
+    jsonNote["source"] = (note.source == ReleaseNoteSources::PullRequests) ? "pull_request" : "commit";
+    jsonNote["breaking"] = note.isBreaking;
+    return jsonNote;
+}
+
+/**
+ * @brief Renders the bodies of the detailed notes (e.g., indents them or converts them to HTML), each body on its own task of the
+ * given thread pool, so that the bodies of a big full mode release are rendered by all the workers, like they were formatted
+ * @param releaseNotes The release notes
+ * @param renderBody Renders a single body, it is called from the worker threads
+ * @param workers The thread pool, null renders the bodies on this thread, this mustn't be called from one of its tasks
+ * @return The rendered body of each note in the order of the notes in the sections, empty for the notes that aren't detailed
+ * or don't have a body
+ */
+static vector<string> renderNoteBodies(const ReleaseNotes& releaseNotes, const function<string(const string&)>& renderBody,
+                                       ThreadPool* workers) {
+    vector<const string*> bodies;
+    for (const ReleaseNotesSection& section : releaseNotes.sections) {
+        for (const ReleaseNote& note : section.notes) {
+            bodies.push_back(note.isDetailed && !note.body.empty() ? &note.body : nullptr);
+        }
+    }
+
+    vector<string> renderedBodies(bodies.size());
+    if (!workers) {
+        for (size_t i = 0; i < bodies.size(); i++) {
+            if (bodies[i]) {
+                renderedBodies[i] = renderBody(*bodies[i]);
+            }
+        }
+        return renderedBodies;
+    }
+
+    TaskGroup renderingTasks;
+    vector<exception_ptr> errors(bodies.size());
+    for (size_t i = 0; i < bodies.size(); i++) {
+        if (!bodies[i]) {
+            continue;
+        }
+        renderingTasks.add();
+        workers->submit([&, i]() {
+            try {
+                renderedBodies[i] = renderBody(*bodies[i]);
+            }
+            catch (...) {
+                errors[i] = current_exception();
+            }
+            renderingTasks.finish();
+        });
+    }
+    renderingTasks.wait();
+
+    for (const exception_ptr& error : errors) {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+    return renderedBodies;
+}
+
+/**
+ * @brief Renders release notes in markdown, this is the format of the notes used on GitHub releases
+ * @param releaseNotes The release notes
+ * @param config The loaded config, its markdown template is used if it has one
+ * @param workers The thread pool that indents the bodies of the notes, null indents them on this thread
+ * @return The markdown release notes, empty if there are no notes
+ */
+string renderMarkdownReleaseNotes(const ReleaseNotes& releaseNotes, const Config& config, ThreadPool* workers) {
+    string markdownReleaseNotes = "";
+
+    if (config.markdownTemplate) {
+        // Release notes without any notes stay empty whatever the template writes around them
+        if (!releaseNotes.sections.empty()) {
+            config.markdownTemplate->render(releaseNotes, config, markdownReleaseNotes);
+        }
+        return markdownReleaseNotes;
+    }
+
+    vector<string> indentedBodies = renderNoteBodies(releaseNotes, indentAllLinesInString, workers);
+    size_t noteIndex = 0;
+
+    for (const ReleaseNotesSection& section : releaseNotes.sections) {
+        markdownReleaseNotes += "\n" + section.markdownTitle + "\n";
+
+        for (const ReleaseNote& note : section.notes) {
+            string prefix = note.isDetailed ? config.markdownFullModeReleaseNotePrefix : config.markdownReleaseNotePrefix;
+            markdownReleaseNotes += prefix + getReleaseNoteTitle(note) + "\n";
+            if (note.isDetailed && !note.body.empty()) {
+                markdownReleaseNotes += indentedBodies[noteIndex] + "\n";
+            }
+            noteIndex++;
+            markdownReleaseNotes += "\n";
+        }
+    }
+
+    if (releaseNotes.usedCommitSubjects) {
+        markdownReleaseNotes += config.timeBudgetExceededNote;
+    }
+    if (releaseNotes.exceededRequestBudget) {
+        markdownReleaseNotes += config.requestBudgetExceededNote;
+    }
+
+    return markdownReleaseNotes;
+}
+
+/**
+ * @brief Escapes the characters of a text that have a meaning in HTML (&, <, > and ")
+ */
+string escapeHtml(const string& text) {
+    string escapedText;
+    for (char c : text) {
+        switch (c) {
+            case '&': escapedText += "&amp;"; break;
+            case '<': escapedText += "&lt;"; break;
+            case '>': escapedText += "&gt;"; break;
+            case '"': escapedText += "&quot;"; break;
+            default: escapedText += c;
+        }
+    }
+    return escapedText;
+}
+
+/**
+ * @brief Checks whether a link of a pull request body can be written as an href, the bodies are written by anyone who opens
+ * a pull request, so only http, https and mailto links and relative links are allowed (no javascript: or data: links)
+ * @param url The URL of the link, already escaped
+ */
+static bool isAllowedLinkUrl(const string& url) {
+    size_t schemeEnd = url.find(':');
+    if (schemeEnd == string::npos || url.find_first_of("/?#") < schemeEnd) {
+        return true;
+    }
+
+    string scheme = url.substr(0, schemeEnd);
+    transform(scheme.begin(), scheme.end(), scheme.begin(), [](unsigned char c) { return tolower(c); });
+    return scheme == "http" || scheme == "https" || scheme == "mailto";
+}
+
+/**
+ * @brief Renders the inline markdown of a single line (code spans, bold text and links) in HTML
+ * The links whose URL isn't allowed by isAllowedLinkUrl() are left as escaped text
+ */
+static string renderInlineMarkdownToHtml(const string& markdownText) {
+    static const regex codePattern(R"(`([^`]+)`)");
+    static const regex boldPattern(R"(\*\*([^*]+)\*\*)");
+    static const regex linkPattern(R"(\[([^\]]+)\]\(([^)\s]+)\))");
+
+    string htmlText = escapeHtml(markdownText);
+    htmlText = regex_replace(htmlText, codePattern, "<code>$1</code>");
+    htmlText = regex_replace(htmlText, boldPattern, "<strong>$1</strong>");
+
+    string linkedHtmlText;
+    size_t textStart = 0;
+    for (sregex_iterator link(htmlText.begin(), htmlText.end(), linkPattern), end; link != end; ++link) {
+        const smatch& match = *link;
+        linkedHtmlText += htmlText.substr(textStart, match.position() - textStart);
+        linkedHtmlText += isAllowedLinkUrl(match[2]) ? "<a href=\"" + match[2].str() + "\">" + match[1].str() + "</a>" : match.str();
+        textStart = match.position() + match.length();
+    }
+    linkedHtmlText += htmlText.substr(textStart);
+    return linkedHtmlText;
+}
+
+/**
+ * @brief Renders the markdown of a pull request body in HTML, supporting the markdown used in most pull request bodies
+ * (paragraphs, headings, lists, quotes, code blocks and the inline markdown of renderInlineMarkdownToHtml())
+ */
+string renderMarkdownBlocksToHtml(const string& markdownText) {
+    string htmlText;
+    string openBlock; // The HTML tag of the paragraph or list that the previous lines are in, empty if none
+    bool inCodeBlock = false;
+
+    auto closeOpenBlock = [&]() {
+        if (!openBlock.empty()) {
+            htmlText += "</" + openBlock + ">\n";
+            openBlock = "";
+        }
+    };
+
+    istringstream lines(markdownText);
+    string line;
+    while (getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t textStart = line.find_first_not_of(" \t");
+        string text = (textStart == string::npos) ? "" : line.substr(textStart);
+
+        if (text.rfind("```", 0) == 0) {
+            closeOpenBlock();
+            htmlText += inCodeBlock ? "</code></pre>\n" : "<pre><code>";
+            inCodeBlock = !inCodeBlock;
+        }
+        else if (inCodeBlock) {
+            htmlText += escapeHtml(line) + "\n";
+        }
+        else if (text.empty()) {
+            closeOpenBlock();
+        }
+        else if (text[0] == '#') {
+            closeOpenBlock();
+            int level;
+            string headingText = getMarkdownHeadingText(text, level);
+            string tag = "h" + to_string(min(max(level, 1), 6));
+            htmlText += "<" + tag + ">" + renderInlineMarkdownToHtml(headingText) + "</" + tag + ">\n";
+        }
+        else if (text.rfind("- ", 0) == 0 || text.rfind("* ", 0) == 0) {
+            if (openBlock != "ul") {
+                closeOpenBlock();
+                htmlText += "<ul>\n";
+                openBlock = "ul";
+            }
+            htmlText += "<li>" + renderInlineMarkdownToHtml(text.substr(2)) + "</li>\n";
+        }
+        else if (text[0] == '>') {
+            closeOpenBlock();
+            size_t quoteStart = min(text.find_first_not_of("> "), text.size());
+            htmlText += "<blockquote>" + renderInlineMarkdownToHtml(text.substr(quoteStart)) + "</blockquote>\n";
+        }
+        else {
+            if (openBlock != "p") {
+                closeOpenBlock();
+                htmlText += "<p>";
+                openBlock = "p";
+            }
+            else {
+                htmlText += "\n";
+            }
+            htmlText += renderInlineMarkdownToHtml(text);
+        }
+    }
+
+    if (inCodeBlock) {
+        htmlText += "</code></pre>\n";
+    }
+    closeOpenBlock();
+    return htmlText;
+}
+
+/**
+ * @brief Renders release notes in HTML without using the GitHub API
+ * @param releaseNotes The release notes
+ * @param config The loaded config, its HTML template is used if it has one
+ * @param workers The thread pool that converts the bodies of the notes to HTML, null converts them on this thread
+ * @return The HTML release notes, empty if there are no notes
+ */
+string renderHtmlReleaseNotes(const ReleaseNotes& releaseNotes, const Config& config, ThreadPool* workers) {
+    string htmlReleaseNotes = "";
+
+    if (config.htmlTemplate) {
+        if (!releaseNotes.sections.empty()) {
+            config.htmlTemplate->render(releaseNotes, config, htmlReleaseNotes);
+        }
+        return htmlReleaseNotes;
+    }
+
+    vector<string> htmlBodies = renderNoteBodies(releaseNotes, renderMarkdownBlocksToHtml, workers);
+    size_t noteIndex = 0;
+
+    for (const ReleaseNotesSection& section : releaseNotes.sections) {
+        int level;
+        string headingText = getMarkdownHeadingText(section.markdownTitle, level);
+        string tag = "h" + to_string(min(max(level, 1), 6));
+        htmlReleaseNotes += "<" + tag + ">" + escapeHtml(headingText) + "</" + tag + ">\n<ul>\n";
+
+        for (const ReleaseNote& note : section.notes) {
+            if (note.isDetailed) {
+                htmlReleaseNotes += "<li>\n<h3>" + renderInlineMarkdownToHtml(getReleaseNoteTitle(note)) + "</h3>\n"
+                    + htmlBodies[noteIndex] + "</li>\n";
+            }
+            else {
+                htmlReleaseNotes += "<li>" + renderInlineMarkdownToHtml(getReleaseNoteTitle(note)) + "</li>\n";
+            }
+            noteIndex++;
+        }
+
+        htmlReleaseNotes += "</ul>\n";
+    }
+
+    if (releaseNotes.usedCommitSubjects) {
+        htmlReleaseNotes += "<blockquote>" + escapeHtml(getMarkdownNoteText(config.timeBudgetExceededNote)) + "</blockquote>\n";
+    }
+    if (releaseNotes.exceededRequestBudget) {
+        htmlReleaseNotes += "<blockquote>" + escapeHtml(getMarkdownNoteText(config.requestBudgetExceededNote)) + "</blockquote>\n";
+    }
+
+    return htmlReleaseNotes;
+}
+
+/**
+ * @brief Renders release notes in JSON, with all the fields of the sections and the notes, for other programs to use
+ * @param releaseNotes The release notes
+ * @return The JSON release notes
+ */
+string renderJsonReleaseNotes(const ReleaseNotes& releaseNotes) {
+    json jsonReleaseNotes;
+    jsonReleaseNotes["sections"] = json::array();
+
+    for (const ReleaseNotesSection& section : releaseNotes.sections) {
+        int level;
+        json jsonSection;
+        jsonSection["type"] = section.type;
+        jsonSection["title"] = getMarkdownHeadingText(section.markdownTitle, level);
+        jsonSection["notes"] = json::array();
+
+        for (const ReleaseNote& note : section.notes) {
+            jsonSection["notes"].push_back(createReleaseNoteJson(note));
+        }
+
+        jsonReleaseNotes["sections"].push_back(jsonSection);
+    }
+
+    jsonReleaseNotes["usedCommitSubjects"] = releaseNotes.usedCommitSubjects;
+    jsonReleaseNotes["exceededRequestBudget"] = releaseNotes.exceededRequestBudget;
+
+    // Commit messages aren't always valid UTF-8, their invalid bytes are replaced instead of failing the whole output
+    return jsonReleaseNotes.dump(4, ' ', false, json::error_handler_t::replace) + "\n";
+}
+
+/**
+ * @brief Renders release notes in plain text, links are written as their text followed by their URL
+ * @param releaseNotes The release notes
+ * @param config The loaded config
+ * @param workers The thread pool that converts the bodies of the notes to text, null converts them on this thread
+ * @return The plain text release notes, empty if there are no notes
+ */
+string renderTextReleaseNotes(const ReleaseNotes& releaseNotes, const Config& config, ThreadPool* workers) {
+    static const regex linkPattern(R"(\[([^\]]+)\]\(([^)\s]+)\))");
+
+    string textReleaseNotes = "";
+
+    vector<string> textBodies = renderNoteBodies(releaseNotes, [](const string& body) {
+        return indentAllLinesInString(regex_replace(body, linkPattern, "$1 ($2)"));
+    }, workers);
+    size_t noteIndex = 0;
+
+    for (const ReleaseNotesSection& section : releaseNotes.sections) {
+        int level;
+        textReleaseNotes += (textReleaseNotes.empty() ? "" : "\n") + getMarkdownHeadingText(section.markdownTitle, level) + "\n";
+
+        for (const ReleaseNote& note : section.notes) {
+            textReleaseNotes += "- " + getReleaseNoteTitle(note) + "\n";
+            if (note.isDetailed && !note.body.empty()) {
+                textReleaseNotes += textBodies[noteIndex] + "\n";
+            }
+            noteIndex++;
+        }
+    }
+
+    if (releaseNotes.usedCommitSubjects) {
+        textReleaseNotes += "\n" + getMarkdownNoteText(config.timeBudgetExceededNote) + "\n";
+    }
+    if (releaseNotes.exceededRequestBudget) {
+        textReleaseNotes += "\n" + getMarkdownNoteText(config.requestBudgetExceededNote) + "\n";
+    }
+
+    return textReleaseNotes;
+}
+
+/**
+ * @brief Gets the file that the release notes of an output format are written in
+ * @param outputFormat The output format (markdown, html, json or text)
+ * @param config The loaded config
+ * @param fileName Set to the name of the output file of the format in the config
+ * @param fileError Set to the error message used if the file can't be written
+ * @return Whether the output format is known
+ */
+bool getOutputFile(const string& outputFormat, const Config& config, string& fileName, string& fileError) {
+    if (outputFormat == "markdown") {
+        fileName = config.markdownOutputFileName;
+        fileError = config.markdownFileError;
+    }
+    else if (outputFormat == "html") {
+        fileName = config.htmlOutputFileName;
+        fileError = config.htmlFileError;
+    }
+    else if (outputFormat == "json") {
+        fileName = config.jsonOutputFileName;
+        fileError = config.jsonFileError;
+    }
+    else if (outputFormat == "text") {
+        fileName = config.textOutputFileName;
+        fileError = config.textFileError;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Renders the release notes in one output format,
+ * HTML is rendered with the GitHub API or locally depending on htmlRenderer in the config, and it is rendered locally
+ * instead of with the GitHub API if the time budget of the context is exhausted or the conversion doesn't finish before it
+ * @param releaseNotes The release notes
+ * @param outputFormat The output format (markdown, html, json or text)
+ * @param context The context of the generation, which contains the config and the GitHub token
+ * @return The rendered release notes, empty for an unknown output format
+ */
+string renderReleaseNotes(const ReleaseNotes& releaseNotes, const string& outputFormat, const RunContext& context) {
+    const Config& config = context.config;
+
+    // An HTML template is rendered locally like the local renderer
+    if (outputFormat == "html" && !config.htmlTemplate && config.htmlRenderer != "local" && !context.deadline.isExpired()) {
+        try {
+            return convertMarkdownToHtml(renderReleaseNotes(releaseNotes, "markdown", context),
+                                         context.deadline.remainingMilliseconds(config.githubApiRequestTimeoutSeconds * 1000L), context);
+        }
+        catch (const GithubApiTimeoutError&) {
+        }
+    }
+
+    ProfileScope renderTimer(ProfilePhases::RenderNotes);
+    string renderedReleaseNotes;
+    if (outputFormat == "markdown") {
+        renderedReleaseNotes = renderMarkdownReleaseNotes(releaseNotes, config, context.workers);
+    }
+    else if (outputFormat == "html") {
+        renderedReleaseNotes = renderHtmlReleaseNotes(releaseNotes, config, context.workers);
+    }
+    else if (outputFormat == "json") {
+        renderedReleaseNotes = renderJsonReleaseNotes(releaseNotes);
+    }
+    else if (outputFormat == "text") {
+        renderedReleaseNotes = renderTextReleaseNotes(releaseNotes, config, context.workers);
+    }
+    PROBE_RENDER(outputFormat.c_str(), releaseNotes.sections.size(), renderedReleaseNotes.size());
+    return renderedReleaseNotes;
+}
+
+/**
+ * @brief Renders the release notes in each of the output formats of the config and writes them in their files
+ * @param releaseNotes The release notes
+ * @param outputDirectory The directory to write the files in (created if it doesn't exist), empty for the current directory
+ * @param fileNameSuffix Added to the output file names of the config (e.g., _13 for release_notes_13.md), can be empty
+ * @param context The context of the generation, which contains the config and the GitHub token
+ * @return The names of the written files
+ */
+vector<string> writeReleaseNotesInFiles(const ReleaseNotes& releaseNotes, string outputDirectory, string fileNameSuffix,
+                                        const RunContext& context) {
+    const Config& config = context.config;
+
+    string markdownReleaseNotes = renderReleaseNotes(releaseNotes, "markdown", context);
+    if (markdownReleaseNotes.empty()) {
+        throw runtime_error(config.emptyReleaseNotesMessage);
+    }
+
+    if (!outputDirectory.empty()) {
+        filesystem::create_directories(outputDirectory);
+    }
+
+    vector<string> fileNames;
+    for (const string& outputFormat : config.outputFormats) {
+        string fileName, fileError;
+        if (!getOutputFile(outputFormat, config, fileName, fileError)) {
+            continue;
+        }
+
+        string filePath = (filesystem::path(outputDirectory) / addSuffixToFileName(fileName, fileNameSuffix)).string();
+        writeNotesInFile(outputFormat == "markdown" ? markdownReleaseNotes : renderReleaseNotes(releaseNotes, outputFormat, context),
+                         filePath, fileError, config);
+        fileNames.push_back(filePath);
+    }
+
+    return fileNames;
+}
+
+ReleaseNotesStream::ReleaseNotesStream(ostream& output) : output(output) {}
+
+/**
+ * @brief Writes a note on its own line and flushes it, so that the reader of the stream gets it right away
+ * @param section The section of the note, its title is written in the "section" field of the note
+ * @param note The note
+ */
+void ReleaseNotesStream::write(const ReleaseNotesSection& section, const ReleaseNote& note) {
+    int level;
+    json jsonNote = createReleaseNoteJson(note);
+    jsonNote["section"] = getMarkdownHeadingText(section.markdownTitle, level);
+    // Commit messages aren't always valid UTF-8, their invalid bytes are replaced instead of failing the whole stream
+    string line = jsonNote.dump(-1, ' ', false, json::error_handler_t::replace) + "\n";
+
+    lock_guard<mutex> lock(outputMutex);
+    output << line << flush;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file ReleaseNotes.h
+ * @author Ahmed Khaled
+ * @brief This file defines the in-memory representation of generated release notes (sections of typed notes) and the renderers
+ * that turn it into markdown, HTML, JSON and plain text, all the output formats of a run are rendered from the same representation
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <mutex>
+
+#include "Config.h"
+#include "Enums.h"
+#include "RunContext.h"
+
+using namespace std;
+
+/**
+ * @brief A single release note, generated from a commit or from the pull request of a commit
+ */
+struct ReleaseNote {
+    string type; /**< Conventional name of the commit type (Ex: fix, feat, refactor, etc.)*/
+    string scope; /**< Subcategory of the commit type (Ex: GUI in "fix(GUI): fixed bug X"), empty if there is none*/
+    string title; /**< Title without the commit type and the scope, with its first letter capitalized*/
+    string body; /**< Markdown body of the pull request with its links added, only in full mode*/
+    string pullRequestNumber; /**< Empty if the note wasn't generated from a known pull request*/
+    vector<string> commitShas;
+    ReleaseNoteSources source = ReleaseNoteSources::CommitMessages; /**< Whether the note was generated from the pull request info fetched from GitHub*/
+    bool isBreaking = false; /**< Whether the title uses "!" before the colon or the body contains "BREAKING CHANGE"*/
+    bool isDetailed = false; /**< Whether the note was generated from the pull request info in full mode, so it is shown with its body*/
+};
+
+/**
+ * @brief The notes of a single commit type, in the order of the commits
+ */
+struct ReleaseNotesSection {
+    string type; /**< Conventional name of the commit type*/
+    string markdownTitle; /**< Markdown title of the section from the config (Ex: ## 🐛 Bug Fixes)*/
+    vector<ReleaseNote> notes;
+};
+
+/**
+ * @brief Generated release notes, with a section for each commit type that has commits (in the order of the commit types in the config)
+ */
+struct ReleaseNotes {
+    vector<ReleaseNotesSection> sections;
+    bool usedCommitSubjects = false; /**< Whether some notes were generated from commit subjects because of the time budget*/
+    bool exceededRequestBudget = false; /**< Whether some notes were generated from commit subjects because of the request budget*/
+};
+
+/**
+ * @brief Writes each release note as a JSON object on its own line (NDJSON) as soon as it is generated, so that other tools
+ * can process the notes while the rest are still being generated instead of parsing the markdown file at the end
+ * The notes of generations that run at the same time can be written in the same stream, each line is written whole
+ */
+class ReleaseNotesStream {
+public:
+    explicit ReleaseNotesStream(ostream& output);
+    void write(const ReleaseNotesSection& section, const ReleaseNote& note);
+
+private:
+    ostream& output;
+    mutex outputMutex;
+};
+
+ReleaseNote createReleaseNote(string conventionalCommitTitle, CommitTypeMatchResults matchResult, int commitTypeIndex, const Config& config);
+ReleaseNotesSection createReleaseNotesSection(int commitTypeIndex, const Config& config);
+string getReleaseNoteTitle(const ReleaseNote& note);
+string getMarkdownHeadingText(const string& markdownHeading, int& level);
+string escapeHtml(const string& text);
+string renderMarkdownBlocksToHtml(const string& markdownText);
+string renderMarkdownReleaseNotes(const ReleaseNotes& releaseNotes, const Config& config, ThreadPool* workers = nullptr);
+string renderHtmlReleaseNotes(const ReleaseNotes& releaseNotes, const Config& config, ThreadPool* workers = nullptr);
+string renderJsonReleaseNotes(const ReleaseNotes& releaseNotes);
+string renderTextReleaseNotes(const ReleaseNotes& releaseNotes, const Config& config, ThreadPool* workers = nullptr);
+bool getOutputFile(const string& outputFormat, const Config& config, string& fileName, string& fileError);
+string renderReleaseNotes(const ReleaseNotes& releaseNotes, const string& outputFormat, const RunContext& context);
+vector<string> writeReleaseNotesInFiles(const ReleaseNotes& releaseNotes, string outputDirectory, string fileNameSuffix,
+                                        const RunContext& context);
@@ -0,0 +1,28 @@
+/**
+ * @file RunContext.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the RunContext class defined in RunContext.h
+ */
+
+#include <string>
+
+#include "RunContext.h"
+#include "Config.h"
+
+using namespace std;
+
+/**
+ * @param config The loaded config, it must outlive the context
+ * @param githubRepository The GitHub repository in the form owner/repository (e.g., synfig/synfig), can be empty
+ * when the notes don't link to or retrieve anything from GitHub
+ * @param githubToken The GitHub token used to make authenticated requests to the GitHub API
+ * @param repositoryDirectory Directory of the local git repository, empty means the current working directory
+ */
+RunContext::RunContext(const Config& config, string githubRepository, string githubToken, string repositoryDirectory)
+    : config(config), githubToken(githubToken), repositoryDirectory(repositoryDirectory), deadline(config.generationTimeBudgetSeconds) {
+    if (!githubRepository.empty()) {
+        repoCommitsUrl = config.githubUrl + githubRepository + "/commit/";
+        repoIssuesUrl = config.githubUrl + githubRepository + "/issues/";
+        repoPullRequestsApiUrl = config.githubReposApiUrl + githubRepository + "/pulls/";
+    }
+}
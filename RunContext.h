@@ -0,0 +1,95 @@
+/**
+ * @file RunContext.h
+ * @author Ahmed Khaled
+ * @brief This file defines the RunContext class which holds everything that a single generation needs besides the config
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "Config.h"
+
+using namespace std;
+
+class ThreadPool;
+class GithubApiBudget;
+class ReleaseNotesStream;
+class GitCatFilePool;
+
+/**
+ * @brief A point in time by which some work must finish, used to limit the total time spent generating notes
+ */
+class Deadline {
+public:
+    /**
+     * @param budgetSeconds Seconds from now until the deadline, 0 or less means that there is no deadline
+     */
+    explicit Deadline(int budgetSeconds)
+        : unlimited(budgetSeconds <= 0), end(chrono::steady_clock::now() + chrono::seconds(budgetSeconds)) {}
+
+    bool isExpired() const { return !unlimited && chrono::steady_clock::now() >= end; }
+
+    /**
+     * @brief Milliseconds left until the deadline (at least 1 so it can be used as a timeout), or the given maximum if it is sooner
+     */
+    long remainingMilliseconds(long maximumMilliseconds) const {
+        if (unlimited) {
+            return maximumMilliseconds;
+        }
+        long remaining = (long)chrono::duration_cast<chrono::milliseconds>(end - chrono::steady_clock::now()).count();
+        return max(1L, min(remaining, maximumMilliseconds));
+    }
+
+private:
+    bool unlimited;
+    chrono::steady_clock::time_point end;
+};
+
+/**
+ * @brief Everything that a single generation needs besides the config: the GitHub repository and token it uses
+ * and the local git repository it reads
+ * Each generation has its own context while all of them share the same config, which is never changed after it is loaded,
+ * so many generations (of the same or different repositories) can run at the same time in one process
+ */
+class RunContext {
+public:
+    RunContext(const Config& config, string githubRepository, string githubToken, string repositoryDirectory = "");
+
+    const Config& config;
+    string githubToken;
+    string repoIssuesUrl;
+    string repoCommitsUrl;
+    string repoPullRequestsApiUrl;
+    /**
+     * @brief Directory of the local git repository that notes are generated from, empty means the current working directory
+     */
+    string repositoryDirectory;
+    /**
+     * @brief Worker threads that format the notes, shared by all the generations that run together (e.g., in manifest mode),
+     * null means that the generation starts its own
+     */
+    ThreadPool* workers = nullptr;
+    /**
+     * @brief Limits the pull requests retrieved by all the generations that run together (e.g., in manifest mode),
+     * null means that the generation has its own limits from the config
+     */
+    GithubApiBudget* githubApiBudget = nullptr;
+    /**
+     * @brief The git processes that look up the references of the generations of a long running process (e.g., the server),
+     * null means that the generation starts its own
+     */
+    GitCatFilePool* gitObjects = nullptr;
+    /**
+     * @brief Receives each note as soon as it is generated (in the order of the release notes), null means that notes aren't streamed
+     */
+    ReleaseNotesStream* notesStream = nullptr;
+    /**
+     * @brief The time budget of the generation (generationTimeBudgetSeconds in the config), which starts when the context is created,
+     * so it limits retrieving the pull requests and then converting the notes to HTML with the GitHub API
+     */
+    Deadline deadline;
+};
@@ -0,0 +1,476 @@
+/**
+ * @file Server.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the ReleaseNotesServer class and the sendRequestToServer function defined in Server.h
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+#include <json.hpp>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "Server.h"
+#include "Config.h"
+#include "Enums.h"
+#include "Utils.h"
+#include "Generator.h"
+#include "RunContext.h"
+#include "ReleaseNotes.h"
+
+using namespace std;
+using namespace nlohmann;
+
+#ifndef _WIN32
+
+/**
+ * @brief Creates the address of a Unix domain socket
+ * @param socketPath The path of the socket file
+ * @return The address
+ */
+static sockaddr_un createSocketAddress(const string& socketPath) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw invalid_argument("Socket path is too long: " + socketPath);
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+    return address;
+}
+
+#ifdef MSG_NOSIGNAL
+static const int sendFlags = MSG_NOSIGNAL;
+#else
+static const int sendFlags = 0;
+#endif
+
+/**
+ * @brief Makes writing to a socket whose other side was closed fail with EPIPE instead of raising SIGPIPE, without changing
+ * how the rest of the process handles SIGPIPE (Linux does it with the MSG_NOSIGNAL flag of each write instead)
+ */
+static void disableSigpipe(int socket) {
+#ifdef SO_NOSIGPIPE
+    int enabled = 1;
+    setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#else
+    (void)socket;
+#endif
+}
+
+/**
+ * @brief The result of reading a line from a socket
+ */
+enum class LineReadResults {
+    Read,
+    Closed, /**< The other side closed the connection (or didn't send anything before the receive timeout of the socket)*/
+    TooLong /**< The line is longer than the maximum, the rest of it wasn't read*/
+};
+
+/**
+ * @brief Reads the next line from a socket
+ * @param socket The socket to read from
+ * @param buffer Data read from the socket that wasn't returned yet, it must be kept between calls for the same socket
+ * @param line Set to the line without its newline
+ * @param maxLineBytes Maximum number of bytes of the line, so that a peer that never sends a newline can't use up the memory
+ * @return Whether a line was read, the connection was closed first, or the line is too long
+ */
+static LineReadResults readLine(int socket, string& buffer, string& line, size_t maxLineBytes) {
+    size_t lineEnd;
+    size_t scannedBytes = 0;
+    while ((lineEnd = buffer.find('\n', scannedBytes)) == string::npos) {
+        if (buffer.size() > maxLineBytes) {
+            return LineReadResults::TooLong;
+        }
+        scannedBytes = buffer.size();
+
+        char data[64 * 1024];
+        ssize_t bytesRead = read(socket, data, sizeof(data));
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            return LineReadResults::Closed;
+        }
+        buffer.append(data, bytesRead);
+    }
+    if (lineEnd > maxLineBytes) {
+        return LineReadResults::TooLong;
+    }
+
+    line = buffer.substr(0, lineEnd);
+    buffer.erase(0, lineEnd + 1);
+    return LineReadResults::Read;
+}
+
+/**
+ * @brief Writes a whole line to a socket
+ * @return Whether the line was written, false if the other side closed the connection
+ */
+static bool writeLine(int socket, const string& line) {
+    string data = line + "\n";
+    size_t bytesWritten = 0;
+    while (bytesWritten < data.size()) {
+        ssize_t result = send(socket, data.data() + bytesWritten, data.size() - bytesWritten, sendFlags);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        bytesWritten += result;
+    }
+    return true;
+}
+
+/**
+ * @brief Serializes a response or a request, the text of the notes comes from commits and pull requests that aren't always valid UTF-8,
+ * so the invalid bytes are replaced instead of failing
+ */
+static string dumpMessage(const json& message) {
+    return message.dump(-1, ' ', false, json::error_handler_t::replace);
+}
+
+/**
+ * @brief Removes the socket file left behind by a server that didn't stop cleanly
+ * @param socketPath The path of the socket file
+ * @param config The loaded config, which contains the error messages
+ * @throws runtime_error If the path is a file that isn't a socket, or a server still answers on it
+ */
+static void removeStaleSocket(const string& socketPath, const Config& config) {
+    struct stat fileStatus;
+    if (lstat(socketPath.c_str(), &fileStatus) != 0) {
+        return;
+    }
+    if (!S_ISSOCK(fileStatus.st_mode)) {
+        throw runtime_error(config.serverSocketPathError + socketPath);
+    }
+
+    sockaddr_un address = createSocketAddress(socketPath);
+    int probeSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probeSocket >= 0) {
+        bool isAnswered = connect(probeSocket, (sockaddr*)&address, sizeof(address)) == 0;
+        close(probeSocket);
+        if (isAnswered) {
+            throw runtime_error(config.serverAlreadyRunningError + socketPath);
+        }
+    }
+    unlink(socketPath.c_str());
+}
+
+/**
+ * @brief Starts listening on the socket, requests are only answered after run() is called
+ * @param socketPath The path of the socket file, a socket left behind by a server that is no longer running is replaced
+ * @param workers The thread pool that formats the notes of all the requests, it must outlive the server
+ * @param config The loaded config, it must outlive the server
+ */
+ReleaseNotesServer::ReleaseNotesServer(string socketPath, ThreadPool& workers, const Config& config)
+    : socketPath(socketPath), workers(workers), config(config), listeningSocket(-1),
+      gitObjects(config.gitProcessesMaxRepositories), connections(config.serverMaxConnections, config.serverMaxConnections) {
+    sockaddr_un address = createSocketAddress(socketPath);
+
+    removeStaleSocket(socketPath, config);
+
+    listeningSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listeningSocket < 0) {
+        throw runtime_error("Unable to create the server socket: " + string(strerror(errno)));
+    }
+
+    if (bind(listeningSocket, (sockaddr*)&address, sizeof(address)) < 0 || listen(listeningSocket, SOMAXCONN) < 0) {
+        string error = strerror(errno);
+        close(listeningSocket);
+        throw runtime_error("Unable to listen on " + socketPath + ": " + error);
+    }
+}
+
+ReleaseNotesServer::~ReleaseNotesServer() {
+    if (listeningSocket >= 0) {
+        stop();
+        close(listeningSocket);
+        unlink(socketPath.c_str());
+    }
+}
+
+/**
+ * @brief Accepts connections until stop() is called, at most serverMaxConnections connections are handled at the same time,
+ * when all of them are busy the next connection waits until one of them is closed
+ */
+void ReleaseNotesServer::run() {
+    cout << "Serving release notes on " + socketPath << endl;
+
+    while (!stopping) {
+        int connectionSocket = accept4(listeningSocket, NULL, NULL, SOCK_CLOEXEC);
+        if (connectionSocket < 0) {
+            if (stopping) {
+                break;
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            throw runtime_error("Unable to accept connections on " + socketPath + ": " + strerror(errno));
+        }
+        disableSigpipe(connectionSocket);
+
+        // A connection that doesn't send its next request in time is closed, so that it doesn't keep one of the connection threads
+        timeval idleTimeout = {config.serverIdleTimeoutSeconds, 0};
+        setsockopt(connectionSocket, SOL_SOCKET, SO_RCVTIMEO, &idleTimeout, sizeof(idleTimeout));
+
+        {
+            // A connection accepted while stop() was closing the others is closed too
+            lock_guard<mutex> lock(openConnectionsMutex);
+            if (stopping) {
+                close(connectionSocket);
+                break;
+            }
+            openConnections.insert(connectionSocket);
+        }
+        connections.submit([this, connectionSocket]() {
+            handleConnection(connectionSocket);
+        });
+    }
+}
+
+/**
+ * @brief Stops accepting connections and closes the open ones, run() returns once it notices it, it can be called from any thread
+ */
+void ReleaseNotesServer::stop() {
+    stopping = true;
+    shutdown(listeningSocket, SHUT_RDWR);
+
+    lock_guard<mutex> lock(openConnectionsMutex);
+    for (int connectionSocket : openConnections) {
+        shutdown(connectionSocket, SHUT_RDWR);
+    }
+}
+
+/**
+ * @brief Answers all the requests sent on a connection until the client closes it
+ * @param connectionSocket The socket of the connection
+ */
+void ReleaseNotesServer::handleConnection(int connectionSocket) {
+    // Nothing may leave the task, an exception thrown on a thread of the pool would end the whole server
+    try {
+        string buffer, line;
+        LineReadResults readResult;
+        while ((readResult = readLine(connectionSocket, buffer, line, config.serverMaxRequestBytes)) != LineReadResults::Closed) {
+            json response = json::object();
+            if (readResult == LineReadResults::TooLong) {
+                // The end of the request wasn't read, so the next request can't be found, the connection is closed after answering
+                response["error"] = config.serverRequestTooLongError;
+                writeLine(connectionSocket, dumpMessage(response));
+                break;
+            }
+
+            try {
+                response = handleRequest(json::parse(line));
+            }
+            catch (const exception& e) {
+                response = json::object();
+                response["error"] = e.what();
+            }
+
+            if (!writeLine(connectionSocket, dumpMessage(response))) {
+                break;
+            }
+        }
+    }
+    catch (...) {
+    }
+
+    {
+        lock_guard<mutex> lock(openConnectionsMutex);
+        openConnections.erase(connectionSocket);
+    }
+    close(connectionSocket);
+}
+
+/**
+ * @brief Generates the notes asked for by a single request
+ * @param request The request, see the ReleaseNotesServer class for its fields
+ * @return The response, containing the notes in each of the output formats of the config
+ */
+json ReleaseNotesServer::handleRequest(const json& request) {
+    if (!request.contains("source")) {
+        throw invalid_argument(config.noReleaseNotesSourceError);
+    }
+    if (!request.contains("token")) {
+        throw invalid_argument(config.noGithubTokenError);
+    }
+
+    string source = request["source"];
+    RunContext context(config, request.value("repo", ""), request["token"], request.value("directory", ""));
+    context.workers = &workers;
+    context.gitObjects = &gitObjects;
+    ReleaseNotes releaseNotes;
+
+    // Accepting the numbers both as JSON strings and as JSON numbers
+    auto readPullRequestNumber = [](const json& pullRequestNumber) {
+        return pullRequestNumber.is_string() ? pullRequestNumber.get<string>() : pullRequestNumber.dump();
+    };
+
+    if (source == config.singlePullRequestSourceCliInputName) {
+        if (!request.contains("pullRequest") && !request.contains("pullRequests")) {
+            throw invalid_argument(config.noPullRequestNumberError);
+        }
+        if (!request.contains("repo")) {
+            throw invalid_argument(config.noGithubRepositoryError);
+        }
+
+        if (!request.contains("pullRequests")) {
+            releaseNotes = fetchPullRequestChangeNote(readPullRequestNumber(request["pullRequest"]), context);
+        }
+        else {
+            // The pull requests are fetched at the same time, and a pull request that fails only fails its own answer
+            vector<string> pullRequestNumbers;
+            for (const json& pullRequestNumber : request["pullRequests"]) {
+                pullRequestNumbers.push_back(readPullRequestNumber(pullRequestNumber));
+            }
+
+            vector<string> errors;
+            vector<ReleaseNotes> pullRequestsChangeNotes = fetchPullRequestsChangeNotes(pullRequestNumbers, errors, context);
+
+            json response;
+            response["pullRequests"] = json::array();
+            for (size_t i = 0; i < pullRequestNumbers.size(); i++) {
+                json pullRequestResponse;
+                try {
+                    if (!errors[i].empty()) {
+                        throw runtime_error(errors[i]);
+                    }
+                    pullRequestResponse = renderResponse(pullRequestsChangeNotes[i], context);
+                }
+                catch (const exception& e) {
+                    pullRequestResponse = json::object();
+                    pullRequestResponse["error"] = e.what();
+                }
+                pullRequestResponse["pullRequest"] = pullRequestNumbers[i];
+                response["pullRequests"].push_back(pullRequestResponse);
+            }
+            return response;
+        }
+    }
+    else {
+        if (!request.contains("start")) {
+            throw invalid_argument(config.noReleaseStartReferenceError);
+        }
+        if (!request.contains("end")) {
+            throw invalid_argument(config.noReleaseEndReferenceError);
+        }
+
+        if (source == config.commitMessagesSourceCliInputName || source == config.commitMessagesSourceGithubActionsInputName) {
+            releaseNotes = buildReleaseNotes(ReleaseNoteSources::CommitMessages, request["start"], request["end"], ReleaseNoteModes::Short,
+                                             context);
+        }
+        else if (source == config.pullRequestsSourceCliInputName || source == config.pullRequestsSourceGithubActionsInputName) {
+            if (!request.contains("mode")) {
+                throw invalid_argument(config.noReleaseNotesModeError);
+            }
+            if (!request.contains("repo")) {
+                throw invalid_argument(config.noGithubRepositoryError);
+            }
+
+            ReleaseNoteModes releaseNoteMode;
+            string mode = request["mode"];
+            if (mode == config.fullModeCliInputName || mode == config.fullModeGithubActionsInputName) {
+                releaseNoteMode = ReleaseNoteModes::Full;
+            }
+            else if (mode == config.shortModeCliInputName || mode == config.shortModeGithubActionsInputName) {
+                releaseNoteMode = ReleaseNoteModes::Short;
+            }
+            else {
+                throw invalid_argument(config.incorrectReleaseNotesModeError);
+            }
+
+            releaseNotes = buildReleaseNotes(ReleaseNoteSources::PullRequests, request["start"], request["end"], releaseNoteMode, context);
+        }
+        else {
+            throw invalid_argument(config.incorrectReleaseNotesSourceError);
+        }
+    }
+
+    return renderResponse(releaseNotes, context);
+}
+
+/**
+ * @brief Renders notes in each of the output formats of the config, the same way the CLI writes them in their files
+ * (so htmlRenderer and the HTML template apply to the server too)
+ * @param releaseNotes The notes
+ * @param context The context of the request
+ * @return The response, with a field for each output format
+ */
+json ReleaseNotesServer::renderResponse(const ReleaseNotes& releaseNotes, const RunContext& context) {
+    string markdownNotes = renderReleaseNotes(releaseNotes, "markdown", context);
+    if (markdownNotes.empty()) {
+        throw runtime_error(config.emptyReleaseNotesMessage);
+    }
+
+    json response = json::object();
+    for (const string& outputFormat : config.outputFormats) {
+        string fileName, fileError;
+        if (getOutputFile(outputFormat, config, fileName, fileError)) {
+            response[outputFormat] = (outputFormat == "markdown") ? markdownNotes : renderReleaseNotes(releaseNotes, outputFormat, context);
+        }
+    }
+    return response;
+}
+
+/**
+ * @brief Sends a request to a running release notes server and waits for its response
+ * @param socketPath The path of the socket that the server listens on
+ * @param request The request, see the ReleaseNotesServer class for its fields
+ * @param config The loaded config, which contains the error messages
+ * @return The response of the server
+ */
+json sendRequestToServer(string socketPath, const json& request, const Config& config) {
+    sockaddr_un address = createSocketAddress(socketPath);
+
+    int connectionSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connectionSocket < 0 || connect(connectionSocket, (sockaddr*)&address, sizeof(address)) < 0) {
+        if (connectionSocket >= 0) {
+            close(connectionSocket);
+        }
+        throw runtime_error(config.serverConnectionError + socketPath);
+    }
+    disableSigpipe(connectionSocket);
+
+    string buffer, line;
+    bool answered = writeLine(connectionSocket, dumpMessage(request))
+        && readLine(connectionSocket, buffer, line, buffer.max_size()) == LineReadResults::Read;
+    close(connectionSocket);
+
+    if (!answered) {
+        throw runtime_error(config.serverClosedConnectionError + socketPath);
+    }
+    return json::parse(line);
+}
+
+#else
+
+ReleaseNotesServer::ReleaseNotesServer(string socketPath, ThreadPool& workers, const Config& config)
+    : socketPath(socketPath), workers(workers), config(config), listeningSocket(-1), gitObjects(1), connections(1) {
+    throw runtime_error("The release notes server is only supported on Unix-like systems");
+}
+
+ReleaseNotesServer::~ReleaseNotesServer() {}
+
+void ReleaseNotesServer::run() {}
+
+void ReleaseNotesServer::stop() {}
+
+json sendRequestToServer(string socketPath, const json& request, const Config& config) {
+    throw runtime_error("The release notes server is only supported on Unix-like systems");
+}
+
+#endif
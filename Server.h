@@ -0,0 +1,70 @@
+/**
+ * @file Server.h
+ * @author Ahmed Khaled
+ * @brief This file defines the ReleaseNotesServer class which keeps a warm process that generates notes for requests
+ * sent over a Unix domain socket, and the function used by the client mode to send these requests
+ */
+
+#pragma once
+
+#include <string>
+#include <set>
+#include <mutex>
+#include <atomic>
+
+#include <json.hpp>
+
+#include "Config.h"
+#include "ThreadPool.h"
+#include "GitObjects.h"
+#include "RunContext.h"
+#include "ReleaseNotes.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief A server that generates release notes and change notes for JSON requests sent over a Unix domain socket
+ * The config, the GitHub API connections and the cached GitHub API responses are kept between requests, so requests
+ * don't pay for loading the config, initializing libcurl, TLS handshakes and retrieving unchanged pull requests again
+ * Each connection is handled on one of serverMaxConnections threads and can send many requests, one JSON object per line, e.g.
+ * {"source": "prs", "start": "v1.0", "end": "v1.1", "token": "...", "mode": "full", "repo": "owner/repository"}
+ * {"source": "single_pr", "pullRequest": "13", "token": "...", "repo": "owner/repository"}
+ * {"source": "single_pr", "pullRequests": ["13", "144"], "token": "...", "repo": "owner/repository"}
+ * and each request is answered with one JSON object per line, either the notes rendered like the CLI renders them, one field
+ * for each of the outputFormats of the config (e.g., {"markdown": "...", "html": "..."}), or {"error": "..."}
+ * The notes of many pull requests are answered with {"pullRequests": [...]}, the notes or the error of each pull request
+ * with its "pullRequest" number
+ * Release notes are generated from the git repository in the "directory" field of the request, or the one that the server was started in
+ * Each request has its own RunContext, so requests run at the same time even when they are for different repositories,
+ * the notes of all the requests are formatted on the same thread pool, and the references of each repository are looked up
+ * by one git process kept for the life of the server
+ */
+class ReleaseNotesServer {
+public:
+    ReleaseNotesServer(string socketPath, ThreadPool& workers, const Config& config);
+    ~ReleaseNotesServer();
+
+    ReleaseNotesServer(const ReleaseNotesServer&) = delete;
+    ReleaseNotesServer& operator=(const ReleaseNotesServer&) = delete;
+
+    void run();
+    void stop();
+
+private:
+    string socketPath;
+    ThreadPool& workers;
+    const Config& config;
+    int listeningSocket;
+    atomic<bool> stopping{false};
+    set<int> openConnections; /**< Sockets of the accepted connections, which stop() shuts down*/
+    mutex openConnectionsMutex;
+    GitCatFilePool gitObjects;
+    ThreadPool connections; /**< Handles the accepted connections, it is the last member so that it is joined first*/
+
+    void handleConnection(int connectionSocket);
+    json handleRequest(const json& request);
+    json renderResponse(const ReleaseNotes& releaseNotes, const RunContext& context);
+};
+
+json sendRequestToServer(string socketPath, const json& request, const Config& config);
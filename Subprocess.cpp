@@ -0,0 +1,382 @@
+/**
+ * @file Subprocess.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the Subprocess class defined in Subprocess.h
+ */
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+// posix_spawn() isn't available with Microsoft's Visual C++ compiler, so on Windows the program is started
+// with _popen() using a quoted command line instead, which only supports reading the output of the program
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <csignal>
+#include <pthread.h>
+#include <mutex>
+extern char** environ;
+
+// pipe2() creates both ends of a pipe with close-on-exec set at once, without it the flag is set after the pipe is created,
+// so pipes are created and programs are started under a lock to keep the programs of other threads from inheriting them
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+#define RELEASE_NOTES_HAS_PIPE2
+#endif
+#endif
+
+#include "Subprocess.h"
+#include "Profiler.h"
+
+using namespace std;
+
+#ifdef _WIN32
+/**
+ * @brief Quotes an argument so that the C runtime of the started program parses it back as it is: the argument is put in quotes,
+ * its quotes are preceded by a backslash, and the backslashes followed by a quote (including the closing one) are doubled,
+ * other backslashes are kept as they are
+ * @param argument The argument
+ * @return The quoted argument
+ */
+static string quoteWindowsArgument(const string& argument) {
+    string quotedArgument = "\"";
+    size_t backslashes = 0;
+    for (char c : argument) {
+        if (c == '\\') {
+            backslashes++;
+            continue;
+        }
+        if (c == '"') {
+            quotedArgument.append(backslashes * 2 + 1, '\\');
+        }
+        else {
+            quotedArgument.append(backslashes, '\\');
+        }
+        backslashes = 0;
+        quotedArgument += c;
+    }
+    quotedArgument.append(backslashes * 2, '\\');
+    quotedArgument += "\"";
+    return quotedArgument;
+}
+#else
+/**
+ * @brief Creates a pipe whose file descriptors are not inherited by other programs started later
+ * @param pipeFileDescriptors The array that gets the reading end (index 0) and the writing end (index 1) of the pipe
+ */
+static void createPipe(int pipeFileDescriptors[2]) {
+#ifdef RELEASE_NOTES_HAS_PIPE2
+    if (pipe2(pipeFileDescriptors, O_CLOEXEC) != 0) {
+        throw runtime_error("Unable to create pipe: " + string(strerror(errno)));
+    }
+#else
+    if (pipe(pipeFileDescriptors) != 0) {
+        throw runtime_error("Unable to create pipe: " + string(strerror(errno)));
+    }
+    fcntl(pipeFileDescriptors[0], F_SETFD, FD_CLOEXEC);
+    fcntl(pipeFileDescriptors[1], F_SETFD, FD_CLOEXEC);
+#endif
+}
+
+#ifndef RELEASE_NOTES_HAS_PIPE2
+/**
+ * @brief The lock held from the creation of the pipes of a program until it is started, see RELEASE_NOTES_HAS_PIPE2
+ */
+static mutex spawnMutex;
+#endif
+
+/**
+ * @brief Blocks SIGPIPE in the calling thread while it writes to a program, so that writing to a program that exited fails with EPIPE
+ * instead of killing this whole process, without changing how SIGPIPE is handled by the rest of the process
+ * The SIGPIPE raised by the writes stays pending while it is blocked, so it is consumed before the thread's signal mask is restored
+ */
+class SigpipeBlocker {
+public:
+    SigpipeBlocker() {
+        sigemptyset(&sigpipeSet);
+        sigaddset(&sigpipeSet, SIGPIPE);
+        wasPending = isSigpipePending();
+        pthread_sigmask(SIG_BLOCK, &sigpipeSet, &previousMask);
+    }
+
+    ~SigpipeBlocker() {
+        if (!wasPending && isSigpipePending()) {
+            int signalNumber;
+            sigwait(&sigpipeSet, &signalNumber);
+        }
+        pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+    }
+
+private:
+    sigset_t sigpipeSet;
+    sigset_t previousMask;
+    bool wasPending;
+
+    static bool isSigpipePending() {
+        sigset_t pendingSignals;
+        sigpending(&pendingSignals);
+        return sigismember(&pendingSignals, SIGPIPE) == 1;
+    }
+};
+#endif
+
+/**
+ * @brief Starts the program in the first argument (searched for in PATH) with the rest of the arguments
+ * @param arguments The program name followed by its arguments (e.g., {"git", "log", "v1.0..v1.1"})
+ * @param withInputPipe Whether the standard input of the program should be connected to a pipe that can be written to
+ * @param withErrorPipe Whether the standard error of the program should be captured and read with readErrorOutput(),
+ * instead of being written to the standard error of this process
+ */
+Subprocess::Subprocess(const vector<string>& arguments, bool withInputPipe, bool withErrorPipe) {
+    if (getProfiler().isActive()) {
+        isProfiled = true;
+        startTime = chrono::steady_clock::now();
+        if (getProfiler().isTracing()) {
+            for (const string& argument : arguments) {
+                commandLine += (commandLine.empty() ? "" : " ") + argument;
+            }
+        }
+    }
+
+#ifdef _WIN32
+    if (withInputPipe || withErrorPipe) {
+        throw runtime_error("Writing to the input of programs and reading their errors are not supported on Windows");
+    }
+
+    // cmd.exe /c removes the first and the last quote of a command line that has more than two, so the quoted arguments are
+    // wrapped in one more pair of quotes that is removed instead
+    string commandLine = "\"";
+    for (const string& argument : arguments) {
+        commandLine += quoteWindowsArgument(argument) + " ";
+    }
+    commandLine += "\"";
+
+    pipe = _popen(commandLine.c_str(), "rb");
+    if (!pipe) {
+        throw runtime_error("Unable to start " + arguments[0]);
+    }
+    outputFd = _fileno(pipe);
+#else
+    int outputPipe[2];
+    int inputPipe[2] = {-1, -1};
+    int errorPipe[2] = {-1, -1};
+#ifndef RELEASE_NOTES_HAS_PIPE2
+    lock_guard<mutex> spawnLock(spawnMutex);
+#endif
+    createPipe(outputPipe);
+    if (withInputPipe) {
+        createPipe(inputPipe);
+    }
+    if (withErrorPipe) {
+        createPipe(errorPipe);
+    }
+
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_adddup2(&fileActions, outputPipe[1], STDOUT_FILENO);
+    if (withInputPipe) {
+        posix_spawn_file_actions_adddup2(&fileActions, inputPipe[0], STDIN_FILENO);
+    }
+    if (withErrorPipe) {
+        posix_spawn_file_actions_adddup2(&fileActions, errorPipe[1], STDERR_FILENO);
+    }
+
+    // Programs get the default handling of SIGPIPE even if this process ignores it, so that they stop when their output is closed
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t defaultSignals;
+    sigemptyset(&defaultSignals);
+    sigaddset(&defaultSignals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF);
+
+    vector<char*> argumentPointers;
+    for (const string& argument : arguments) {
+        argumentPointers.push_back(const_cast<char*>(argument.c_str()));
+    }
+    argumentPointers.push_back(nullptr);
+
+    int spawnResult = posix_spawnp(&processId, argumentPointers[0], &fileActions, &attributes, argumentPointers.data(), environ);
+    posix_spawn_file_actions_destroy(&fileActions);
+    posix_spawnattr_destroy(&attributes);
+
+    // Closing the ends of the pipes that now belong to the started program
+    close(outputPipe[1]);
+    if (withInputPipe) {
+        close(inputPipe[0]);
+    }
+    if (withErrorPipe) {
+        close(errorPipe[1]);
+    }
+
+    if (spawnResult != 0) {
+        close(outputPipe[0]);
+        if (withInputPipe) {
+            close(inputPipe[1]);
+        }
+        if (withErrorPipe) {
+            close(errorPipe[0]);
+        }
+        throw runtime_error("Unable to start " + arguments[0] + ": " + string(strerror(spawnResult)));
+    }
+
+    outputFd = outputPipe[0];
+    inputFd = inputPipe[1];
+    errorFd = errorPipe[0];
+#endif
+}
+
+Subprocess::~Subprocess() {
+    try {
+        wait();
+    }
+    catch (...) {
+    }
+}
+
+/**
+ * @brief Reads the available output of the program
+ * @param buffer The buffer to read the output into
+ * @param size Size of the buffer
+ * @return Number of bytes read, 0 when the program closed its output, or -1 if the output file descriptor was made non-blocking
+ * (like the event loop of Async.h does) and nothing is available yet
+ */
+long Subprocess::readOutput(char* buffer, size_t size) {
+    while (true) {
+#ifdef _WIN32
+        long bytesRead = _read(outputFd, buffer, (unsigned int)size);
+#else
+        long bytesRead = read(outputFd, buffer, size);
+#endif
+        if (bytesRead >= 0) {
+            return bytesRead;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return -1;
+        }
+        if (errno != EINTR) {
+            throw runtime_error("Unable to read program output: " + string(strerror(errno)));
+        }
+    }
+}
+
+/**
+ * @brief Reads all the standard error of the program, until it closes it (usually when it exits)
+ * The program must have been started with an error pipe, and since the errors are only read here, a program that writes more errors
+ * than the pipe holds (64 KiB on Linux) waits until this is called
+ * @return The standard error of the program
+ */
+string Subprocess::readErrorOutput() {
+    string errorOutput;
+#ifndef _WIN32
+    if (errorFd == -1) {
+        throw logic_error("The errors of the program aren't captured, it must be started with an error pipe");
+    }
+
+    char buffer[4096];
+    while (true) {
+        long bytesRead = read(errorFd, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            errorOutput.append(buffer, bytesRead);
+        }
+        else if (bytesRead == 0) {
+            break;
+        }
+        else if (errno != EINTR) {
+            throw runtime_error("Unable to read program errors: " + string(strerror(errno)));
+        }
+    }
+#endif
+    return errorOutput;
+}
+
+/**
+ * @brief Writes all the given data to the standard input of the program
+ * If the program exited (or closed its input) before reading all of it, runtime_error is thrown instead of this process getting SIGPIPE
+ * @param data The data to write
+ */
+void Subprocess::writeInput(const string& data) {
+#ifndef _WIN32
+    SigpipeBlocker sigpipeBlocker;
+    size_t bytesWritten = 0;
+    while (bytesWritten < data.size()) {
+        long result = write(inputFd, data.data() + bytesWritten, data.size() - bytesWritten);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw runtime_error("Unable to write program input: " + string(strerror(errno)));
+        }
+        bytesWritten += result;
+    }
+#endif
+}
+
+/**
+ * @brief Closes the standard input of the program, which tells it that there is no more input
+ */
+void Subprocess::closeInput() {
+#ifndef _WIN32
+    if (inputFd != -1) {
+        close(inputFd);
+        inputFd = -1;
+    }
+#endif
+}
+
+/**
+ * @brief Closes the pipes of the program and waits for it to finish
+ * @return The exit code of the program (-1 if it was killed by a signal)
+ */
+int Subprocess::wait() {
+#ifdef _WIN32
+    if (pipe) {
+        exitCode = _pclose(pipe);
+        pipe = nullptr;
+        recordRun();
+    }
+#else
+    closeInput();
+    if (outputFd != -1) {
+        close(outputFd);
+        outputFd = -1;
+    }
+    if (errorFd != -1) {
+        close(errorFd);
+        errorFd = -1;
+    }
+
+    if (processId != -1) {
+        int status;
+        pid_t result;
+        while ((result = waitpid(processId, &status, 0)) < 0 && errno == EINTR) {
+        }
+        exitCode = (result > 0 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+        processId = -1;
+        recordRun();
+    }
+#endif
+    return exitCode;
+}
+
+/**
+ * @brief Records the run of the program, from its start to its exit, in the profile and the trace of the run if they are enabled
+ */
+void Subprocess::recordRun() {
+    if (!isProfiled) {
+        return;
+    }
+
+    json traceArguments;
+    if (getProfiler().isTracing()) {
+        traceArguments["command"] = commandLine;
+        traceArguments["exitCode"] = exitCode;
+    }
+    getProfiler().recordOccurrence(ProfilePhases::GitProcess, startTime, chrono::steady_clock::now() - startTime, move(traceArguments));
+}
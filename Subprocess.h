@@ -0,0 +1,64 @@
+/**
+ * @file Subprocess.h
+ * @author Ahmed Khaled
+ * @brief This file defines the Subprocess class which is used for running external programs (like git) directly without a shell
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <chrono>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief A class for running a program from an argument list and communicating with it through pipes
+ * Arguments are passed to the program as they are, so ref names and patterns don't need any quoting or escaping,
+ * and no shell process is started in between
+ */
+class Subprocess {
+public:
+    Subprocess(const vector<string>& arguments, bool withInputPipe = false, bool withErrorPipe = false);
+    ~Subprocess();
+
+    Subprocess(const Subprocess&) = delete;
+    Subprocess& operator=(const Subprocess&) = delete;
+
+    /**
+     * @brief The file descriptor to read the standard output of the program from
+     * It can be given to poll() or to curl_multi_wait() as an extra file descriptor to consume the output together with network I/O
+     */
+    int outputFileDescriptor() const { return outputFd; }
+    /**
+     * @brief The file descriptor to write the standard input of the program to (-1 if the program was started without an input pipe)
+     */
+    int inputFileDescriptor() const { return inputFd; }
+
+    long readOutput(char* buffer, size_t size);
+    string readErrorOutput();
+    void writeInput(const string& data);
+    void closeInput();
+    int wait();
+
+private:
+    int outputFd = -1;
+    int inputFd = -1;
+    int errorFd = -1;
+    int exitCode = -1;
+    bool isProfiled = false; /**< Whether the run of the program is recorded in the profile and the trace of the run (--profile, --trace)*/
+    string commandLine; /**< Only kept when the run is traced*/
+    chrono::steady_clock::time_point startTime;
+#ifdef _WIN32
+    FILE* pipe = nullptr;
+#else
+    pid_t processId = -1;
+#endif
+
+    void recordRun();
+};
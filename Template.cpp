@@ -0,0 +1,375 @@
+/**
+ * @file Template.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the OutputTemplate class defined in Template.h
+ */
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Template.h"
+#include "Config.h"
+#include "Enums.h"
+#include "Format.h"
+#include "ReleaseNotes.h"
+
+using namespace std;
+
+/**
+ * @brief The levels of the rendered data that fields belong to, a field can only be used inside the lists of its level
+ */
+enum TemplateLevels {
+    ReleaseNotesLevel,
+    SectionLevel,
+    NoteLevel,
+    CommitLevel,
+    TemplateLevelsCount
+};
+
+/**
+ * @brief The name of a field in templates, the level it belongs to and, for list fields, the level of their items
+ */
+struct TemplateFieldInfo {
+    const char* name;
+    TemplateFields field;
+    int level;
+    int itemsLevel; /**< -1 for fields that aren't lists*/
+};
+
+static const TemplateFieldInfo templateFields[] = {
+    {"sections", TemplateFields::Sections, ReleaseNotesLevel, SectionLevel},
+    {"usedCommitSubjects", TemplateFields::UsedCommitSubjects, ReleaseNotesLevel, -1},
+    {"exceededRequestBudget", TemplateFields::ExceededRequestBudget, ReleaseNotesLevel, -1},
+    {"timeBudgetExceededNote", TemplateFields::TimeBudgetExceededNote, ReleaseNotesLevel, -1},
+    {"requestBudgetExceededNote", TemplateFields::RequestBudgetExceededNote, ReleaseNotesLevel, -1},
+    {"type", TemplateFields::SectionType, SectionLevel, -1},
+    {"title", TemplateFields::SectionTitle, SectionLevel, -1},
+    {"heading", TemplateFields::SectionHeading, SectionLevel, -1},
+    {"notes", TemplateFields::Notes, SectionLevel, NoteLevel},
+    {"type", TemplateFields::NoteType, NoteLevel, -1},
+    {"scope", TemplateFields::Scope, NoteLevel, -1},
+    {"title", TemplateFields::NoteTitle, NoteLevel, -1},
+    {"fullTitle", TemplateFields::FullTitle, NoteLevel, -1},
+    {"prefix", TemplateFields::Prefix, NoteLevel, -1},
+    {"body", TemplateFields::Body, NoteLevel, -1},
+    {"indentedBody", TemplateFields::IndentedBody, NoteLevel, -1},
+    {"bodyHtml", TemplateFields::BodyHtml, NoteLevel, -1},
+    {"pullRequest", TemplateFields::PullRequest, NoteLevel, -1},
+    {"commits", TemplateFields::Commits, NoteLevel, CommitLevel},
+    {"breaking", TemplateFields::Breaking, NoteLevel, -1},
+    {"detailed", TemplateFields::Detailed, NoteLevel, -1},
+    {"source", TemplateFields::Source, NoteLevel, -1},
+    {"sha", TemplateFields::Sha, CommitLevel, -1}
+};
+
+/**
+ * @brief Finds a field by its name in the innermost level that it can be used in
+ * @param name The name of the field in the template
+ * @param openLevels The number of open lists of each level (the release notes level is always open, the others are opened by their lists)
+ * @return The field, or null if there is no field with this name in the open levels
+ */
+static const TemplateFieldInfo* findTemplateField(const string& name, const int openLevels[TemplateLevelsCount]) {
+    for (int level = TemplateLevelsCount - 1; level >= 0; level--) {
+        if (openLevels[level] == 0) {
+            continue;
+        }
+        for (const TemplateFieldInfo& fieldInfo : templateFields) {
+            if (fieldInfo.level == level && name == fieldInfo.name) {
+                return &fieldInfo;
+            }
+        }
+    }
+    return nullptr;
+}
+
+static const TemplateFieldInfo& getTemplateFieldInfo(TemplateFields field) {
+    for (const TemplateFieldInfo& fieldInfo : templateFields) {
+        if (fieldInfo.field == field) {
+            return fieldInfo;
+        }
+    }
+    throw logic_error("Unknown template field");
+}
+
+static string trimSpaces(const string& text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == string::npos) {
+        return "";
+    }
+    return text.substr(start, text.find_last_not_of(" \t") - start + 1);
+}
+
+static bool isSpaces(const string& text, size_t start, size_t end) {
+    return all_of(text.begin() + start, text.begin() + end, [](char c) { return c == ' ' || c == '\t' || c == '\r'; });
+}
+
+/**
+ * @brief Compiles a template to its instructions
+ * @param templateText The text of the template
+ * @param escapeMode How the values written with {{name}} are escaped
+ * @throws runtime_error If the template has an unknown field, an unclosed tag or a section that isn't closed correctly,
+ * the message contains the line of the error
+ */
+OutputTemplate::OutputTemplate(const string& templateText, TemplateEscapes escapeMode) : escapeMode(escapeMode) {
+    int openLevels[TemplateLevelsCount] = {1, 0, 0, 0};
+    vector<size_t> openSections; // Indexes of the instructions of the sections that aren't closed yet
+    vector<string> openSectionNames;
+    size_t position = 0;
+
+    auto throwTemplateError = [&](size_t errorPosition, const string& message) {
+        int line = 1 + (int)count(templateText.begin(), templateText.begin() + errorPosition, '\n');
+        throw runtime_error("Template error at line " + to_string(line) + ": " + message);
+    };
+
+    while (position < templateText.size()) {
+        size_t tagStart = templateText.find("{{", position);
+        if (tagStart == string::npos) {
+            addText(templateText, position, templateText.size());
+            break;
+        }
+
+        bool isTripleTag = templateText.compare(tagStart, 3, "{{{") == 0;
+        string tagClose = isTripleTag ? "}}}" : "}}";
+        size_t contentStart = tagStart + (isTripleTag ? 3 : 2);
+        size_t tagEnd = templateText.find(tagClose, contentStart);
+        if (tagEnd == string::npos) {
+            throwTemplateError(tagStart, "'{{' is never closed");
+        }
+        string content = trimSpaces(templateText.substr(contentStart, tagEnd - contentStart));
+        tagEnd += tagClose.size();
+
+        char sigil = (!isTripleTag && !content.empty() && string("#^/!&").find(content[0]) != string::npos) ? content[0] : '\0';
+        string name = trimSpaces(sigil == '\0' ? content : content.substr(1));
+
+        // Section and comment tags alone on their line are removed with their line, so that they don't leave empty lines
+        size_t textEnd = tagStart;
+        size_t nextPosition = tagEnd;
+        if (sigil == '#' || sigil == '^' || sigil == '/' || sigil == '!') {
+            size_t lineStart = templateText.rfind('\n', tagStart);
+            lineStart = (lineStart == string::npos) ? 0 : lineStart + 1;
+            size_t lineEnd = min(templateText.find('\n', tagEnd), templateText.size());
+            if (lineStart >= position && isSpaces(templateText, lineStart, tagStart) && isSpaces(templateText, tagEnd, lineEnd)) {
+                textEnd = lineStart;
+                nextPosition = min(lineEnd + 1, templateText.size());
+            }
+        }
+        addText(templateText, position, textEnd);
+        position = nextPosition;
+
+        if (sigil == '!') {
+            continue;
+        }
+        if (name.empty()) {
+            throwTemplateError(tagStart, "a tag doesn't have a field name");
+        }
+
+        if (sigil == '/') {
+            if (openSectionNames.empty() || openSectionNames.back() != name) {
+                throwTemplateError(tagStart, "'{{/" + name + "}}' doesn't close the last opened section");
+            }
+            TemplateInstruction& section = instructions[openSections.back()];
+            const TemplateFieldInfo& fieldInfo = getTemplateFieldInfo(section.field);
+            if (section.type == TemplateInstructionTypes::Section && fieldInfo.itemsLevel != -1) {
+                openLevels[fieldInfo.itemsLevel]--;
+            }
+            section.sectionEnd = instructions.size();
+
+            TemplateInstruction sectionEnd{TemplateInstructionTypes::SectionEnd, section.field};
+            instructions.push_back(sectionEnd);
+            openSections.pop_back();
+            openSectionNames.pop_back();
+            continue;
+        }
+
+        const TemplateFieldInfo* fieldInfo = findTemplateField(name, openLevels);
+        if (fieldInfo == nullptr) {
+            throwTemplateError(tagStart, "unknown field '" + name + "' (or it is used outside of its list)");
+        }
+
+        TemplateInstruction instruction{TemplateInstructionTypes::Value, fieldInfo->field};
+        if (sigil == '#' || sigil == '^') {
+            instruction.type = (sigil == '#') ? TemplateInstructionTypes::Section : TemplateInstructionTypes::InvertedSection;
+            // The fields of the items of a list can only be used inside it
+            if (sigil == '#' && fieldInfo->itemsLevel != -1) {
+                openLevels[fieldInfo->itemsLevel]++;
+            }
+            openSections.push_back(instructions.size());
+            openSectionNames.push_back(name);
+        }
+        else if (fieldInfo->itemsLevel != -1) {
+            throwTemplateError(tagStart, "the list '" + name + "' can only be used as a section ({{#" + name + "}})");
+        }
+        else if (isTripleTag || sigil == '&') {
+            instruction.type = TemplateInstructionTypes::RawValue;
+        }
+        instructions.push_back(instruction);
+    }
+
+    if (!openSectionNames.empty()) {
+        throwTemplateError(templateText.size(), "the section '" + openSectionNames.back() + "' is never closed");
+    }
+}
+
+/**
+ * @brief Adds an instruction that writes a part of the template text, joined with the previous instruction if it is also a text
+ */
+void OutputTemplate::addText(const string& templateText, size_t start, size_t end) {
+    if (start >= end) {
+        return;
+    }
+
+    if (!instructions.empty() && instructions.back().type == TemplateInstructionTypes::Text) {
+        instructions.back().textLength += end - start;
+    }
+    else {
+        TemplateInstruction text{TemplateInstructionTypes::Text};
+        text.textStart = texts.size();
+        text.textLength = end - start;
+        instructions.push_back(text);
+    }
+    texts.append(templateText, start, end - start);
+}
+
+/**
+ * @brief Renders release notes with the template
+ * @param releaseNotes The release notes
+ * @param config The loaded config, which has the prefixes of the notes and the notes about the time and request budgets
+ * @param output The rendered text is added at its end
+ */
+void OutputTemplate::render(const ReleaseNotes& releaseNotes, const Config& config, string& output) const {
+    RenderScope scope;
+    scope.releaseNotes = &releaseNotes;
+    renderInstructions(0, instructions.size(), scope, config, output);
+}
+
+void OutputTemplate::renderInstructions(size_t begin, size_t end, const RenderScope& scope, const Config& config, string& output) const {
+    string computedValue;
+
+    for (size_t i = begin; i < end; i++) {
+        const TemplateInstruction& instruction = instructions[i];
+
+        switch (instruction.type) {
+            case TemplateInstructionTypes::Text:
+                output.append(texts, instruction.textStart, instruction.textLength);
+                break;
+
+            case TemplateInstructionTypes::Value:
+            case TemplateInstructionTypes::RawValue: {
+                const string& value = getFieldValue(instruction.field, scope, config, computedValue);
+                if (instruction.type == TemplateInstructionTypes::Value && escapeMode == TemplateEscapes::Html) {
+                    output += escapeHtml(value);
+                }
+                else {
+                    output += value;
+                }
+                break;
+            }
+
+            case TemplateInstructionTypes::Section: {
+                RenderScope itemScope = scope;
+                if (instruction.field == TemplateFields::Sections) {
+                    for (const ReleaseNotesSection& section : scope.releaseNotes->sections) {
+                        itemScope.section = &section;
+                        renderInstructions(i + 1, instruction.sectionEnd, itemScope, config, output);
+                    }
+                }
+                else if (instruction.field == TemplateFields::Notes) {
+                    for (const ReleaseNote& note : scope.section->notes) {
+                        itemScope.note = &note;
+                        renderInstructions(i + 1, instruction.sectionEnd, itemScope, config, output);
+                    }
+                }
+                else if (instruction.field == TemplateFields::Commits) {
+                    for (const string& commitSha : scope.note->commitShas) {
+                        itemScope.commitSha = &commitSha;
+                        renderInstructions(i + 1, instruction.sectionEnd, itemScope, config, output);
+                    }
+                }
+                else if (isFieldSet(instruction.field, scope)) {
+                    renderInstructions(i + 1, instruction.sectionEnd, scope, config, output);
+                }
+                i = instruction.sectionEnd;
+                break;
+            }
+
+            case TemplateInstructionTypes::InvertedSection:
+                if (!isFieldSet(instruction.field, scope)) {
+                    renderInstructions(i + 1, instruction.sectionEnd, scope, config, output);
+                }
+                i = instruction.sectionEnd;
+                break;
+
+            case TemplateInstructionTypes::SectionEnd:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Whether a field is true (flags), has items (lists) or isn't empty (values), used by sections and inverted sections
+ */
+bool OutputTemplate::isFieldSet(TemplateFields field, const RenderScope& scope) const {
+    switch (field) {
+        case TemplateFields::Sections: return !scope.releaseNotes->sections.empty();
+        case TemplateFields::UsedCommitSubjects: return scope.releaseNotes->usedCommitSubjects;
+        case TemplateFields::ExceededRequestBudget: return scope.releaseNotes->exceededRequestBudget;
+        case TemplateFields::Notes: return !scope.section->notes.empty();
+        case TemplateFields::Commits: return !scope.note->commitShas.empty();
+        case TemplateFields::Breaking: return scope.note->isBreaking;
+        case TemplateFields::Detailed: return scope.note->isDetailed;
+        case TemplateFields::Scope: return !scope.note->scope.empty();
+        case TemplateFields::Body:
+        case TemplateFields::IndentedBody:
+        case TemplateFields::BodyHtml: return !scope.note->body.empty();
+        case TemplateFields::PullRequest: return !scope.note->pullRequestNumber.empty();
+        default: return true; // The other fields are never empty
+    }
+}
+
+/**
+ * @brief Gets the value of a field, fields that are stored as they are written are returned without being copied
+ * @param computedValue Holds the value of fields that are computed (e.g., the indented body), the returned value may reference it
+ */
+const string& OutputTemplate::getFieldValue(TemplateFields field, const RenderScope& scope, const Config& config,
+                                            string& computedValue) const {
+    static const string trueValue = "true", falseValue = "false";
+    int level;
+
+    switch (field) {
+        case TemplateFields::UsedCommitSubjects: return scope.releaseNotes->usedCommitSubjects ? trueValue : falseValue;
+        case TemplateFields::ExceededRequestBudget: return scope.releaseNotes->exceededRequestBudget ? trueValue : falseValue;
+        case TemplateFields::TimeBudgetExceededNote: return config.timeBudgetExceededNote;
+        case TemplateFields::RequestBudgetExceededNote: return config.requestBudgetExceededNote;
+        case TemplateFields::SectionType: return scope.section->type;
+        case TemplateFields::SectionTitle: return scope.section->markdownTitle;
+        case TemplateFields::SectionHeading:
+            computedValue = getMarkdownHeadingText(scope.section->markdownTitle, level);
+            return computedValue;
+        case TemplateFields::NoteType: return scope.note->type;
+        case TemplateFields::Scope: return scope.note->scope;
+        case TemplateFields::NoteTitle: return scope.note->title;
+        case TemplateFields::FullTitle:
+            computedValue = getReleaseNoteTitle(*scope.note);
+            return computedValue;
+        case TemplateFields::Prefix:
+            return scope.note->isDetailed ? config.markdownFullModeReleaseNotePrefix : config.markdownReleaseNotePrefix;
+        case TemplateFields::Body: return scope.note->body;
+        case TemplateFields::IndentedBody:
+            computedValue = indentAllLinesInString(scope.note->body);
+            return computedValue;
+        case TemplateFields::BodyHtml:
+            computedValue = renderMarkdownBlocksToHtml(scope.note->body);
+            return computedValue;
+        case TemplateFields::PullRequest: return scope.note->pullRequestNumber;
+        case TemplateFields::Breaking: return scope.note->isBreaking ? trueValue : falseValue;
+        case TemplateFields::Detailed: return scope.note->isDetailed ? trueValue : falseValue;
+        case TemplateFields::Source:
+            computedValue = (scope.note->source == ReleaseNoteSources::PullRequests) ? "pull_request" : "commit";
+            return computedValue;
+        case TemplateFields::Sha: return *scope.commitSha;
+        default:
+            throw logic_error("Template lists don't have values");
+    }
+}
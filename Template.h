@@ -0,0 +1,67 @@
+/**
+ * @file Template.h
+ * @author Ahmed Khaled
+ * @brief This file defines the OutputTemplate class which renders release notes with a layout written by the user
+ *
+ * Templates use a small mustache-like language:
+ * {{name}} writes a field (HTML escaped in HTML templates), {{{name}}} or {{&name}} writes it without escaping,
+ * {{#name}}...{{/name}} repeats its content for each item of a list field (sections, notes, commits) or renders it once if the field
+ * is true or not empty, {{^name}}...{{/name}} renders its content if the field is false or empty and {{! text}} is a comment
+ * A section, inverted section or comment tag alone on its line doesn't leave an empty line in the output
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Enums.h"
+
+using namespace std;
+
+class Config;
+struct ReleaseNotes;
+struct ReleaseNotesSection;
+struct ReleaseNote;
+
+/**
+ * @brief A single instruction of a compiled template
+ */
+struct TemplateInstruction {
+    TemplateInstructionTypes type;
+    TemplateFields field = TemplateFields::Sections; /**< The field used by a value or a section*/
+    size_t textStart = 0; /**< Position of the text of a text instruction in the texts of the template*/
+    size_t textLength = 0;
+    size_t sectionEnd = 0; /**< Index of the end instruction of a section*/
+};
+
+/**
+ * @brief A template compiled once (when the config is loaded) to a list of instructions, the field names are resolved while compiling
+ * so rendering only runs the instructions and writes directly in the output, even for release notes with thousands of notes
+ */
+class OutputTemplate {
+public:
+    OutputTemplate(const string& templateText, TemplateEscapes escapeMode);
+    void render(const ReleaseNotes& releaseNotes, const Config& config, string& output) const;
+    const vector<TemplateInstruction>& getInstructions() const { return instructions; }
+
+private:
+    /**
+     * @brief The items of the lists that the rendered instructions are in, null when outside of the list
+     */
+    struct RenderScope {
+        const ReleaseNotes* releaseNotes = nullptr;
+        const ReleaseNotesSection* section = nullptr;
+        const ReleaseNote* note = nullptr;
+        const string* commitSha = nullptr;
+    };
+
+    vector<TemplateInstruction> instructions;
+    string texts; /**< The texts of all the text instructions*/
+    TemplateEscapes escapeMode;
+
+    void addText(const string& templateText, size_t start, size_t end);
+    void renderInstructions(size_t begin, size_t end, const RenderScope& scope, const Config& config, string& output) const;
+    bool isFieldSet(TemplateFields field, const RenderScope& scope) const;
+    const string& getFieldValue(TemplateFields field, const RenderScope& scope, const Config& config, string& computedValue) const;
+};
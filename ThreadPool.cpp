@@ -0,0 +1,192 @@
+/**
+ * @file ThreadPool.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the TaskGroup and ThreadPool classes defined in ThreadPool.h
+ */
+
+#include <thread>
+#include <functional>
+#include <atomic>
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local size_t ThreadPool::currentWorkerIndex = 0;
+
+/**
+ * @brief Counts a task that is about to be submitted
+ */
+void TaskGroup::add() {
+    unfinishedTasks++;
+}
+
+/**
+ * @brief Marks a task of the group as finished, it must be called once at the end of each added task
+ */
+void TaskGroup::finish() {
+    size_t unfinished = unfinishedTasks.load();
+    while (unfinished > 1) {
+        if (unfinishedTasks.compare_exchange_weak(unfinished, unfinished - 1)) {
+            return;
+        }
+    }
+
+    // The last task decrements under the lock, so wait() can't return and destroy the group before it is notified
+    lock_guard<mutex> lock(unfinishedTasksMutex);
+    if (--unfinishedTasks == 0) {
+        allTasksFinished.notify_all();
+    }
+}
+
+/**
+ * @brief Waits until all the tasks of the group are finished
+ */
+void TaskGroup::wait() {
+    unique_lock<mutex> lock(unfinishedTasksMutex);
+    allTasksFinished.wait(lock, [this]() { return unfinishedTasks == 0; });
+}
+
+/**
+ * @brief Starts the worker threads
+ * @param threadCount Number of worker threads (at least 1 thread is always started)
+ * @param maxUnfinishedTasks Maximum number of unfinished tasks before submitting from outside the pool waits
+ */
+ThreadPool::ThreadPool(size_t threadCount, size_t maxUnfinishedTasks) : maxUnfinishedTasks(max<size_t>(maxUnfinishedTasks, 1)) {
+    threadCount = max<size_t>(threadCount, 1);
+    for (size_t i = 0; i < threadCount; i++) {
+        workersTasks.push_back(make_unique<WorkerTasks>());
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::runWorker, this, i);
+    }
+}
+
+/**
+ * @brief Finishes the tasks that were already submitted then stops the worker threads
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(idleMutex);
+        stopping = true;
+    }
+    tasksAvailable.notify_all();
+
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Adds a task to be run by one of the worker threads, waits if too many tasks are unfinished
+ * (unless it is called from a task of this pool, since waiting there could wait for itself)
+ * @param task The task, it must not throw (tasks report their errors themselves)
+ */
+void ThreadPool::submit(function<void()> task) {
+    bool submittedByWorker = currentPool == this;
+
+    if (submittedByWorker) {
+        unfinishedTasks++;
+    }
+    else {
+        size_t unfinished = unfinishedTasks.load();
+        while (unfinished >= maxUnfinishedTasks || !unfinishedTasks.compare_exchange_weak(unfinished, unfinished + 1)) {
+            if (unfinished >= maxUnfinishedTasks) {
+                unique_lock<mutex> lock(finishedMutex);
+                taskFinished.wait(lock, [this]() { return unfinishedTasks < maxUnfinishedTasks; });
+                unfinished = unfinishedTasks.load();
+            }
+        }
+    }
+
+    WorkerTasks& workerTasks = *workersTasks[submittedByWorker ? currentWorkerIndex : nextWorkerTasks++ % workersTasks.size()];
+    {
+        lock_guard<mutex> lock(workerTasks.tasksMutex);
+        workerTasks.tasks.push_back(move(task));
+        queuedTasks++;
+    }
+
+    // A worker counts itself as sleeping before it checks queuedTasks, and this checks sleepingWorkers after counting the task,
+    // so either the worker sees the task or this sees the worker, and locking idleMutex waits until that worker is waiting
+    if (sleepingWorkers > 0) {
+        { lock_guard<mutex> lock(idleMutex); }
+        tasksAvailable.notify_one();
+    }
+}
+
+/**
+ * @brief Waits until all the submitted tasks are finished
+ */
+void ThreadPool::waitUntilIdle() {
+    unique_lock<mutex> lock(finishedMutex);
+    taskFinished.wait(lock, [this]() { return unfinishedTasks == 0; });
+}
+
+/**
+ * @brief Takes the newest task of the worker's own deque, or steals the oldest task of another worker's deque
+ * @param workerIndex Index of the worker taking the task
+ * @param task Set to the taken task
+ * @return Whether a task was found
+ */
+bool ThreadPool::takeTask(size_t workerIndex, function<void()>& task) {
+    {
+        WorkerTasks& ownTasks = *workersTasks[workerIndex];
+        lock_guard<mutex> lock(ownTasks.tasksMutex);
+        if (!ownTasks.tasks.empty()) {
+            task = move(ownTasks.tasks.back());
+            ownTasks.tasks.pop_back();
+            queuedTasks--;
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < workersTasks.size(); i++) {
+        WorkerTasks& otherTasks = *workersTasks[(workerIndex + i) % workersTasks.size()];
+        lock_guard<mutex> lock(otherTasks.tasksMutex);
+        if (!otherTasks.tasks.empty()) {
+            task = move(otherTasks.tasks.front());
+            otherTasks.tasks.pop_front();
+            queuedTasks--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Sleeps until a task is queued or the pool is stopping, it is called by a worker that found no task
+ * @return False if the pool is stopping and no task is left
+ */
+bool ThreadPool::waitForTasks() {
+    unique_lock<mutex> lock(idleMutex);
+    sleepingWorkers++;
+    tasksAvailable.wait(lock, [this]() { return queuedTasks > 0 || stopping; });
+    sleepingWorkers--;
+    return queuedTasks > 0 || !stopping;
+}
+
+void ThreadPool::runWorker(size_t workerIndex) {
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+
+    function<void()> task;
+    while (true) {
+        if (!takeTask(workerIndex, task)) {
+            if (!waitForTasks()) {
+                return;
+            }
+            continue;
+        }
+        task();
+        task = nullptr;
+
+        // Only the waiters need to know, waitUntilIdle() waits for 0 and the submitters wait for a task below the maximum
+        size_t unfinished = --unfinishedTasks;
+        if (unfinished == 0 || unfinished == maxUnfinishedTasks - 1) {
+            { lock_guard<mutex> lock(finishedMutex); }
+            taskFinished.notify_all();
+        }
+    }
+}
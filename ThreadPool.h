@@ -0,0 +1,86 @@
+/**
+ * @file ThreadPool.h
+ * @author Ahmed Khaled
+ * @brief This file defines the ThreadPool class which is used for running CPU work (like formatting notes) on worker threads
+ */
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+using namespace std;
+
+/**
+ * @brief Counts the unfinished tasks that one user of a shared thread pool submitted, so that it can wait for
+ * its own tasks only instead of waiting for the whole pool to become idle
+ */
+class TaskGroup {
+public:
+    void add();
+    void finish();
+    void wait();
+
+private:
+    atomic<size_t> unfinishedTasks{0};
+    mutex unfinishedTasksMutex; /**< Only locked by the last task to finish and by wait()*/
+    condition_variable allTasksFinished;
+};
+
+/**
+ * @brief A fixed number of worker threads that run submitted tasks using work stealing
+ * Each worker has its own deque of tasks, tasks submitted from outside the pool are spread over the deques
+ * and tasks submitted by a worker go to its own deque, a worker runs the newest task of its own deque
+ * and when it is empty it steals the oldest task of another worker's deque, so when tasks take very different times
+ * (e.g., formatting a 200 KB pull request body next to many 1 KB ones) no worker sits idle while others have waiting tasks
+ * The counters are atomic and only the deques have locks, so submitting and running a task doesn't go through a lock
+ * shared by all the workers, the idle mutex is only locked by workers that found no task and by submitters that must wake one
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = thread::hardware_concurrency(), size_t maxUnfinishedTasks = 1024);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> task);
+    void waitUntilIdle();
+    size_t threadCount() const { return workers.size(); }
+
+private:
+    struct WorkerTasks {
+        deque<function<void()>> tasks;
+        mutex tasksMutex;
+    };
+
+    vector<unique_ptr<WorkerTasks>> workersTasks;
+    vector<thread> workers;
+    atomic<size_t> nextWorkerTasks{0};
+
+    /**
+     * @brief Submitting from outside the pool waits while this many tasks are unfinished, so that memory stays bounded
+     */
+    size_t maxUnfinishedTasks;
+    atomic<size_t> unfinishedTasks{0};
+    atomic<size_t> queuedTasks{0}; /**< Tasks in the deques, only changed under the lock of the deque that they are in*/
+    atomic<size_t> sleepingWorkers{0}; /**< Workers waiting on tasksAvailable, submitters only wake one when it isn't 0*/
+    bool stopping = false; /**< Guarded by idleMutex*/
+    mutex idleMutex;
+    condition_variable tasksAvailable;
+    mutex finishedMutex; /**< Only locked by waiting submitters, waitUntilIdle() and the tasks that finish when they are waited for*/
+    condition_variable taskFinished;
+
+    static thread_local ThreadPool* currentPool;
+    static thread_local size_t currentWorkerIndex;
+
+    bool takeTask(size_t workerIndex, function<void()>& task);
+    bool waitForTasks();
+    void runWorker(size_t workerIndex);
+};
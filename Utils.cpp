@@ -7,6 +7,7 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <filesystem>
 
 #include <curl/curl.h> // Used to make API requests
 #include <json.hpp>
@@ -14,17 +15,20 @@
 #include "Utils.h"
 #include "Enums.h"
 #include "Config.h"
+#include "Http.h"
+#include "RunContext.h"
+#include "Profiler.h"
+#include "Probes.h"
 
 using namespace std;
 using namespace nlohmann;
 
-extern Config config;
-
 /**
  * @brief Prints error messages when user runs the script with incorrect parameters/input
  * @param inputError The type of input error
+ * @param config The loaded config, which contains the error messages
  */
-void printInputError(InputErrors inputError) {
+void printInputError(InputErrors inputError, const Config& config) {
     if (inputError == InputErrors::NoReleaseNotesSource) {
         cerr << config.noReleaseNotesSourceError << endl;
     }
@@ -52,6 +56,33 @@ void printInputError(InputErrors inputError) {
     else if(inputError == InputErrors::NoGithubRepository) {
         cerr << config.noGithubRepositoryError << endl;
     }
+    else if (inputError == InputErrors::NoSocketPath) {
+        cerr << config.noSocketPathError << endl;
+    }
+    else if (inputError == InputErrors::NoManifest) {
+        cerr << config.noManifestError << endl;
+    }
+    else if (inputError == InputErrors::IncorrectThreads) {
+        cerr << config.incorrectThreadsError << endl;
+    }
+    else if (inputError == InputErrors::NoNotesStreamPath) {
+        cerr << config.noNotesStreamPathError << endl;
+    }
+    else if (inputError == InputErrors::NoTracePath) {
+        cerr << config.noTracePathError << endl;
+    }
+    else if (inputError == InputErrors::NoNetworkStatsPath) {
+        cerr << config.noNetworkStatsPathError << endl;
+    }
+    else if (inputError == InputErrors::NoRecordPath) {
+        cerr << config.noRecordPathError << endl;
+    }
+    else if (inputError == InputErrors::NoReplayPath) {
+        cerr << config.noReplayPathError << endl;
+    }
+    else if (inputError == InputErrors::RecordAndReplay) {
+        cerr << config.recordAndReplayError << endl;
+    }
     cerr << config.expectedSyntaxMessage << endl;
 }
 
@@ -74,8 +105,9 @@ size_t handleApiCallBack(char* data, size_t size, size_t numOfBytes, string* buf
  * All info obtained from https://docs.github.com/en/rest/using-the-rest-api/troubleshooting-the-rest-api?apiVersion=2022-11-28
  * @param errorCode The GitHub API error code that occurred
  * @param apiResponse The GitHub API response
+ * @param config The loaded config, which contains the error messages
  */
-void handleGithubApiErrorCodes(long errorCode, string apiResponse) {
+void handleGithubApiErrorCodes(long errorCode, string apiResponse, const Config& config) {
     if (errorCode == 429 || errorCode == 403) {
         throw runtime_error(config.githubApiRateLimitExceededError + apiResponse);
     }
@@ -91,9 +123,10 @@ void handleGithubApiErrorCodes(long errorCode, string apiResponse) {
  * @brief Checks how the given commit message matches the expected conventional commit type
  * @param commitMessage The commit message
  * @param commitTypeIndex Index of the commit type to check against in the commit types 2d array
+ * @param config The loaded config, which contains the commit types
  * @return The type of match that happened between the two commit types
  */
-CommitTypeMatchResults checkCommitTypeMatch(string commitMessage, int commitTypeIndex) {
+CommitTypeMatchResults checkCommitTypeMatch(string commitMessage, int commitTypeIndex, const Config& config) {
     string correctCommitType = config.commitTypes[commitTypeIndex][(int)CommitTypeInfo::ConventionalName];
 
     if (commitMessage.substr(0, commitMessage.find(":")) == correctCommitType) {
@@ -108,88 +141,335 @@ CommitTypeMatchResults checkCommitTypeMatch(string commitMessage, int commitType
 }
 
 /**
- * @brief Converts markdown to HTML using the GitHub API markdown endpoint
- * @param markdownText The markdown text to be converted to HTML
- * @param githubToken The GitHub token used to make authenticated requests to the GitHub API
- * @return The HTML text containing the exact same content as the given markdown
+ * @param maxConcurrentRequests Maximum number of requests running at the same time
+ * @param maxRequests Maximum number of requests in total, 0 or less means that there is no limit
  */
-string convertMarkdownToHtml(string markdownText, string githubToken) {
-    // Initializing libcurl
-    CURL* curl = curl_easy_init();
-    CURLcode resultCode;
-    string htmlText;
-    struct curl_slist* headers = NULL;
-    headers = curl_slist_append(headers, ((const string)"Accept: application/vnd.github+json").c_str());
-    headers = curl_slist_append(headers, ("Authorization: token " + githubToken).c_str());
-
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, config.githubMarkdownApiUrl.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, handleApiCallBack);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &htmlText);
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, "Ahmed-Khaled-dev");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-        json postData;
-        postData["text"] = markdownText;
-        string postDataString = postData.dump();
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postDataString.c_str());
-
-        resultCode = curl_easy_perform(curl);
-
-        if (resultCode == CURLE_OK) {
-            // Get the HTTP response code
-            long httpCode;
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-
-            if (httpCode == 200) {
-                return htmlText;
-            }
-            else if (httpCode == 404) {
-                throw runtime_error("Markdown API url not found");
+GithubApiBudget::GithubApiBudget(int maxConcurrentRequests, int maxRequests)
+    : maxConcurrentRequests(max(maxConcurrentRequests, 1)), maxRequests(maxRequests) {}
+
+/**
+ * @brief Takes a request from the budget, waits while too many requests are running,
+ * release() must be called after the request finishes
+ * @return False if the total budget is used up, in that case the request must not be made
+ */
+bool GithubApiBudget::acquire() {
+    unique_lock<mutex> lock(requestsMutex);
+    requestFinished.wait(lock, [this]() {
+        return runningRequests < maxConcurrentRequests || (maxRequests > 0 && startedRequests >= maxRequests);
+    });
+
+    if (maxRequests > 0 && startedRequests >= maxRequests) {
+        return false;
+    }
+
+    startedRequests++;
+    runningRequests++;
+    return true;
+}
+
+/**
+ * @brief Takes a request from the total budget without waiting, for callers that limit the requests running at the same time
+ * themselves (like the event loop of Async.h), so release() must not be called after the request finishes
+ * @return False if the total budget is used up, in that case the request must not be made
+ */
+bool GithubApiBudget::tryAcquire() {
+    lock_guard<mutex> lock(requestsMutex);
+    if (maxRequests > 0 && startedRequests >= maxRequests) {
+        return false;
+    }
+
+    startedRequests++;
+    return true;
+}
+
+void GithubApiBudget::release() {
+    {
+        lock_guard<mutex> lock(requestsMutex);
+        runningRequests--;
+    }
+    requestFinished.notify_all();
+}
+
+/**
+ * @brief Looks up a cached response
+ * @param key The key of the response (the URL of a pull request or the text of a markdown conversion)
+ * @param etag Set to the ETag of the cached response
+ * @param body Set to the body of the cached response
+ * @return Whether the response was found
+ */
+bool GithubApiCache::find(const string& key, string& etag, string& body) {
+    lock_guard<mutex> lock(responsesMutex);
+    auto response = responses.find(key);
+    if (response == responses.end()) {
+        return false;
+    }
+
+    etag = response->second.etag;
+    body = response->second.body;
+    return true;
+}
+
+void GithubApiCache::store(const string& key, const string& etag, const string& body) {
+    lock_guard<mutex> lock(responsesMutex);
+    auto response = responses.find(key);
+    if (response != responses.end()) {
+        response->second = {etag, body};
+        return;
+    }
+
+    responses[key] = {etag, body};
+    keysInsertionOrder.push_back(key);
+    while (keysInsertionOrder.size() > maxEntries) {
+        responses.erase(keysInsertionOrder.front());
+        keysInsertionOrder.pop_front();
+    }
+}
+
+/**
+ * @brief Gets the cache of GitHub API responses shared by all the generations made by the process
+ * @param config The loaded config, its githubApiCacheMaxEntries is used when the cache is created by the first call
+ */
+GithubApiCache& getGithubApiCache(const Config& config) {
+    static GithubApiCache githubApiCache(config.githubApiCacheMaxEntries);
+    return githubApiCache;
+}
+
+/**
+ * @brief Gets the HTTP client that all GitHub API requests are made with, so that they all share the same connections
+ */
+HttpClient& getGithubApiClient() {
+    static HttpClient githubApiClient;
+    return githubApiClient;
+}
+
+/**
+ * @brief Creates the GitHub API request that retrieves pull request info
+ * @param pullRequestNumber The number of the pull request (e.g., 13, 144, 3722, etc.)
+ * @param timeoutMilliseconds Maximum time the whole request can take
+ * @param context The context of the generation, which contains the GitHub repository and token
+ * @return The request
+ */
+HttpRequest createPullRequestInfoRequest(string pullRequestNumber, long timeoutMilliseconds, const RunContext& context) {
+    string pullRequestUrl = context.repoPullRequestsApiUrl + pullRequestNumber;
+
+    HttpRequest request;
+    request.url = pullRequestUrl;
+    request.headers.push_back("Authorization: token " + context.githubToken);
+    request.timeoutMilliseconds = timeoutMilliseconds;
+
+    // If the pull request was retrieved before, GitHub only sends it again if it changed
+    string cachedEtag, cachedBody;
+    if (getGithubApiCache(context.config).find(pullRequestUrl, cachedEtag, cachedBody) && !cachedEtag.empty()) {
+        request.headers.push_back("If-None-Match: " + cachedEtag);
+    }
+    PROBE_PR_FETCH_START(request.url.c_str(), pullRequestNumber.c_str());
+    return request;
+}
+
+/**
+ * @brief Checks the GitHub API response of a pull request info request and throws an exception describing any error
+ * @param response The response of the request created by createPullRequestInfoRequest()
+ * @param pullRequestUrl The GitHub API URL of the pull request
+ * @param config The loaded config, which contains the error messages
+ * @return The pull request info in JSON
+ */
+string checkPullRequestInfoResponse(const HttpResponse& response, string pullRequestUrl, const Config& config) {
+    PROBE_PR_FETCH_END(pullRequestUrl.c_str(), response.httpCode, response.body.size());
+    if (response.resultCode == CURLE_OK) {
+        // All info obtained from https://docs.github.com/en/rest/using-the-rest-api/troubleshooting-the-rest-api?apiVersion=2022-11-28
+        // and https://docs.github.com/en/rest/pulls/pulls?apiVersion=2022-11-28#get-a-pull-request
+        if (response.httpCode == 200) {
+            if (!response.etag.empty()) {
+                getGithubApiCache(config).store(pullRequestUrl, response.etag, response.body);
             }
-            else {
-                handleGithubApiErrorCodes(httpCode, htmlText);
+            return response.body;
+        }
+        else if (response.httpCode == 304) {
+            string cachedEtag, cachedBody;
+            if (getGithubApiCache(config).find(pullRequestUrl, cachedEtag, cachedBody)) {
+                return cachedBody;
             }
+            throw runtime_error("GitHub API request could not be processed to retrieve pull request " + pullRequestUrl
+                + " Additional information : the pull request was not modified but it is no longer cached");
+        }
+        else if (response.httpCode >= 500 || response.httpCode == 422 || response.httpCode == 406) {
+            throw runtime_error("GitHub API request could not be processed to retrieve pull request " + pullRequestUrl
+                + " Additional information : " + response.body);
+        }
+        else if (response.httpCode == 404) {
+            throw runtime_error("Pull request " + pullRequestUrl + " not found "
+                + "or you are accessing a private repository and the GitHub token used doesn't have permissions to access pull requests info. "
+                +  "Additional information : " + response.body);
         }
         else {
-            throw runtime_error(config.githubApiUnableToMakeRequestError);
+            handleGithubApiErrorCodes(response.httpCode, response.body, config);
         }
-
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
     }
-    else {
+    else if (response.resultCode == CURLE_OPERATION_TIMEDOUT) {
+        throw GithubApiTimeoutError(config.githubApiTimeoutError + pullRequestUrl);
+    }
+    else if (response.resultCode == CURLE_FAILED_INIT) {
         throw runtime_error(config.githubApiLibcurlError);
     }
+    else {
+        throw runtime_error(config.githubApiUnableToMakeRequestError);
+    }
 
-    return htmlText;
+    return response.body;
 }
 
 /**
- * @brief Writes the generated markdown notes in the markdown file
- * and converts these markdown notes to HTML and writes them in the HTML file
- * @param markdownGeneratedNotes The generated markdown notes to be written
- * @param githubToken The GitHub token used to make authenticated requests to the GitHub API
+ * @brief Retrieves pull request info from the GitHub API using libcurl
+ * @param pullRequestNumber The number of the pull request (e.g., 13, 144, 3722, etc.)
+ * @param timeoutMilliseconds Maximum time the whole request can take, GithubApiTimeoutError is thrown when it is reached
+ * @param context The context of the generation, which contains the GitHub repository and token
+ * @return The pull request info in JSON 
  */
-void writeGeneratedNotesInFiles(string markdownGeneratedNotes, string githubToken) {
-    ofstream markdownFileOutput(config.markdownOutputFileName);
+string getPullRequestInfo(string pullRequestNumber, long timeoutMilliseconds, const RunContext& context) {
+    ProfileScope requestTimer(ProfilePhases::PullRequestRequest);
+    requestTimer.addTraceArgument("pullRequest", pullRequestNumber);
+    HttpRequest request = createPullRequestInfoRequest(pullRequestNumber, timeoutMilliseconds, context);
+    return checkPullRequestInfoResponse(getGithubApiClient().perform(request), request.url, context.config);
+}
+
+/**
+ * @brief Parses the pull request info retrieved from the GitHub API
+ * @param pullRequestInfo The pull request info in JSON
+ * @return The parsed pull request info
+ */
+json parsePullRequestInfo(const string& pullRequestInfo) {
+    ProfileScope parseTimer(ProfilePhases::JsonParse);
+    parseTimer.addTraceArgument("bytes", pullRequestInfo.size());
+    return json::parse(pullRequestInfo);
+}
+
+/**
+ * @brief Creates the GitHub API request that converts markdown to HTML
+ * @param markdownText The markdown text to be converted to HTML
+ * @param timeoutMilliseconds Maximum time the whole request can take
+ * @param context The context of the generation, which contains the GitHub token
+ * @return The request
+ */
+HttpRequest createMarkdownToHtmlRequest(string markdownText, long timeoutMilliseconds, const RunContext& context) {
+    HttpRequest request;
+    request.url = context.config.githubMarkdownApiUrl;
+    request.headers.push_back("Accept: application/vnd.github+json");
+    request.headers.push_back("Authorization: token " + context.githubToken);
+    request.timeoutMilliseconds = timeoutMilliseconds;
+
+    json postData;
+    postData["text"] = markdownText;
+    request.postData = postData.dump();
+    return request;
+}
+
+/**
+ * @brief Checks the GitHub API response of a markdown to HTML request and throws an exception describing any error
+ * @param response The response of the request created by createMarkdownToHtmlRequest()
+ * @param config The loaded config, which contains the error messages
+ * @return The HTML text
+ */
+string checkMarkdownToHtmlResponse(const HttpResponse& response, const Config& config) {
+    if (response.resultCode == CURLE_OK) {
+        if (response.httpCode == 200) {
+            return response.body;
+        }
+        else if (response.httpCode == 404) {
+            throw runtime_error("Markdown API url not found");
+        }
+        else if (response.httpCode >= 500) {
+            throw runtime_error("GitHub API request could not be processed to convert markdown to HTML. Additional information : "
+                + response.body);
+        }
+        else {
+            handleGithubApiErrorCodes(response.httpCode, response.body, config);
+        }
+    }
+    else if (response.resultCode == CURLE_OPERATION_TIMEDOUT) {
+        throw GithubApiTimeoutError(config.githubApiTimeoutError + config.githubMarkdownApiUrl);
+    }
+    else if (response.resultCode == CURLE_FAILED_INIT) {
+        throw runtime_error(config.githubApiLibcurlError);
+    }
+    else {
+        throw runtime_error(config.githubApiUnableToMakeRequestError);
+    }
+
+    return response.body;
+}
 
-    if (!markdownFileOutput.is_open()) {
-        throw runtime_error(config.markdownFileError);
+/**
+ * @brief Converts markdown to HTML using the GitHub API markdown endpoint
+ * @param markdownText The markdown text to be converted to HTML
+ * @param timeoutMilliseconds Maximum time the whole request can take, GithubApiTimeoutError is thrown when it is reached
+ * @param context The context of the generation, which contains the GitHub token
+ * @return The HTML text containing the exact same content as the given markdown
+ */
+string convertMarkdownToHtml(string markdownText, long timeoutMilliseconds, const RunContext& context) {
+    ProfileScope conversionTimer(ProfilePhases::MarkdownToHtml);
+    const Config& config = context.config;
+    string cachedEtag, htmlText;
+    if (getGithubApiCache(config).find(config.githubMarkdownApiUrl + "\n" + markdownText, cachedEtag, htmlText)) {
+        conversionTimer.addTraceArgument("cacheHit", true);
+        return htmlText;
     }
 
-    if (markdownGeneratedNotes.size() == 0) {
-        throw runtime_error(config.emptyReleaseNotesMessage);
+    conversionTimer.addTraceArgument("cacheHit", false);
+    htmlText = checkMarkdownToHtmlResponse(getGithubApiClient().perform(createMarkdownToHtmlRequest(markdownText, timeoutMilliseconds, context)), config);
+    getGithubApiCache(config).store(config.githubMarkdownApiUrl + "\n" + markdownText, "", htmlText);
+    return htmlText;
+}
+
+/**
+ * @brief Joins file names to be shown in a message (e.g., "a.md, a.html and a.json")
+ * @param fileNames The file names
+ * @return The joined file names
+ */
+string joinFileNames(const vector<string>& fileNames) {
+    string joinedFileNames = "";
+    for (size_t i = 0; i < fileNames.size(); i++) {
+        if (i > 0) {
+            joinedFileNames += (i + 1 == fileNames.size()) ? " and " : ", ";
+        }
+        joinedFileNames += fileNames[i];
     }
+    return joinedFileNames;
+}
+
+/**
+ * @brief Adds a suffix to a file name before its extension (e.g., release_notes.md with suffix _13 becomes release_notes_13.md)
+ * @param fileName The file name
+ * @param suffix The suffix to add
+ * @return The file name with the suffix
+ */
+string addSuffixToFileName(string fileName, string suffix) {
+    // Only the last component of the path is split, so dots in its directories are left alone
+    filesystem::path filePath(fileName);
+    string suffixedName = filePath.stem().string() + suffix + filePath.extension().string();
+    return (filePath.parent_path() / suffixedName).string();
+}
 
-    markdownFileOutput << markdownGeneratedNotes;
-    markdownFileOutput.close();
+/**
+ * @brief Writes generated notes (markdown or HTML) in a file
+ * @param generatedNotes The generated notes to be written, they must not be empty
+ * @param fileName Name of the file to write the notes in
+ * @param fileError Error message to use if the file can't be created/opened
+ * @param config The loaded config, which contains the error messages
+ */
+void writeNotesInFile(string generatedNotes, string fileName, string fileError, const Config& config) {
+    ProfileScope writeTimer(ProfilePhases::FileWrite);
+    writeTimer.addTraceArgument("path", fileName);
+    writeTimer.addTraceArgument("bytes", generatedNotes.size());
+    PROBE_OUTPUT_WRITE(fileName.c_str(), generatedNotes.size());
+    ofstream fileOutput(fileName);
 
-    ofstream htmlFileOutput(config.htmlOutputFileName);
+    if (!fileOutput.is_open()) {
+        throw runtime_error(fileError);
+    }
 
-    if (!htmlFileOutput.is_open()) {
-        throw runtime_error(config.htmlFileError);
+    if (generatedNotes.size() == 0) {
+        throw runtime_error(config.emptyReleaseNotesMessage);
     }
 
-    htmlFileOutput << convertMarkdownToHtml(markdownGeneratedNotes, githubToken);
+    fileOutput << generatedNotes;
 }
\ No newline at end of file
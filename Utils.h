@@ -7,14 +7,91 @@
 #pragma once
 
 #include <string>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+#include <json.hpp>
 
 #include "Enums.h"
+#include "Http.h"
+#include "Config.h"
+#include "RunContext.h"
 
 using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Thrown when a GitHub API request doesn't finish before its timeout, so that callers can fall back instead of failing
+ */
+class GithubApiTimeoutError : public runtime_error {
+public:
+    using runtime_error::runtime_error;
+};
+
+/**
+ * @brief Limits the pull request requests made to the GitHub API, both how many run at the same time
+ * and how many are made in total, a single budget can be shared by many generations that run together
+ */
+class GithubApiBudget {
+public:
+    GithubApiBudget(int maxConcurrentRequests, int maxRequests);
+
+    bool acquire();
+    bool tryAcquire();
+    void release();
+
+private:
+    int maxConcurrentRequests;
+    int maxRequests; /**< 0 or less means that there is no limit*/
+    int runningRequests = 0;
+    int startedRequests = 0;
+    mutex requestsMutex;
+    condition_variable requestFinished;
+};
+
+/**
+ * @brief A cache of GitHub API responses that lives as long as the process, which matters when the process serves many
+ * generations (serve mode), pull request responses are kept with their ETag and are revalidated with conditional requests,
+ * which GitHub answers with 304 Not Modified and doesn't count against the rate limit, while markdown to HTML conversions
+ * are kept by their markdown text since they never change
+ * The oldest entries are dropped when the cache has more than its maximum number of entries
+ */
+class GithubApiCache {
+public:
+    explicit GithubApiCache(size_t maxEntries) : maxEntries(maxEntries) {}
+
+    bool find(const string& key, string& etag, string& body);
+    void store(const string& key, const string& etag, const string& body);
+
+private:
+    struct CachedResponse {
+        string etag;
+        string body;
+    };
+
+    size_t maxEntries;
+    unordered_map<string, CachedResponse> responses;
+    deque<string> keysInsertionOrder;
+    mutex responsesMutex;
+};
 
-void printInputError(InputErrors inputError);
+void printInputError(InputErrors inputError, const Config& config);
 size_t handleApiCallBack(char* data, size_t size, size_t numOfBytes, string* buffer);
-void handleGithubApiErrorCodes(long errorCode, string apiResponse);
-CommitTypeMatchResults checkCommitTypeMatch(string commitMessage, int commitTypeIndex);
-string convertMarkdownToHtml(string markdownText, string githubToken);
-void writeGeneratedNotesInFiles(string markdownGeneratedNotes, string githubToken);
\ No newline at end of file
+void handleGithubApiErrorCodes(long errorCode, string apiResponse, const Config& config);
+HttpClient& getGithubApiClient();
+GithubApiCache& getGithubApiCache(const Config& config);
+HttpRequest createPullRequestInfoRequest(string pullRequestNumber, long timeoutMilliseconds, const RunContext& context);
+string checkPullRequestInfoResponse(const HttpResponse& response, string pullRequestUrl, const Config& config);
+string getPullRequestInfo(string pullRequestNumber, long timeoutMilliseconds, const RunContext& context);
+json parsePullRequestInfo(const string& pullRequestInfo);
+CommitTypeMatchResults checkCommitTypeMatch(string commitMessage, int commitTypeIndex, const Config& config);
+HttpRequest createMarkdownToHtmlRequest(string markdownText, long timeoutMilliseconds, const RunContext& context);
+string checkMarkdownToHtmlResponse(const HttpResponse& response, const Config& config);
+string convertMarkdownToHtml(string markdownText, long timeoutMilliseconds, const RunContext& context);
+string addSuffixToFileName(string fileName, string suffix);
+string joinFileNames(const vector<string>& fileNames);
+void writeNotesInFile(string generatedNotes, string fileName, string fileError, const Config& config);
@@ -0,0 +1,143 @@
+/**
+ * @file Benchmark.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the BenchmarkRunner class defined in Benchmark.h and the reading of the memory allocations counts
+ */
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstdio>
+
+#include <json.hpp>
+
+#include "Benchmark.h"
+#include "../Memory.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Gets the number of allocations of the benchmarks program, counted by the memory accounting of the generator
+ * which the benchmarks enable when they start
+ */
+size_t getAllocationsCount() {
+    return getMemoryAccounting().getCounters().allocations;
+}
+
+/**
+ * @brief Gets the bytes allocated by the benchmarks program, in blocks given by malloc() (which may be bigger than requested)
+ */
+size_t getAllocatedBytes() {
+    return getMemoryAccounting().getCounters().allocatedBytes;
+}
+
+/**
+ * @param minSeconds Minimum time that each benchmark runs for
+ * @param filter Only the benchmarks whose name contains it are run, all of them if it is empty
+ * @param maxInputBytes Inputs bigger than it are skipped
+ */
+BenchmarkRunner::BenchmarkRunner(double minSeconds, const string& filter, size_t maxInputBytes)
+    : minSeconds(minSeconds), filter(filter), maxInputBytes(maxInputBytes) {}
+
+/**
+ * @brief Checks if a benchmark is run, so that its input is only created when it is needed
+ */
+bool BenchmarkRunner::isSelected(const string& name, size_t inputBytes) const {
+    return inputBytes <= maxInputBytes && (filter.empty() || name.find(filter) != string::npos);
+}
+
+/**
+ * @brief Measures a function on an input, if it is selected
+ * @param name Name of the benchmarked function
+ * @param input Name of the input
+ * @param inputBytes Size of the input processed by one call
+ * @param items Number of items processed by one call
+ * @param call Calls the function once, it returns a value that depends on the result (like its size) so that the call isn't optimized out
+ */
+void BenchmarkRunner::run(const string& name, const string& input, size_t inputBytes, size_t items, const function<size_t()>& call) {
+    if (!isSelected(name, inputBytes)) {
+        return;
+    }
+
+    // The first call warms up the static regular expressions and the caches of the CPU, it is only kept as the measurement
+    // if it already took the minimum time, since repeating calls that slow wouldn't make the measurement more precise
+    volatile size_t sink = 0;
+    size_t iterations = 1;
+    bool isWarmUp = true;
+    chrono::nanoseconds elapsed;
+    size_t allocations, bytes;
+    while (true) {
+        size_t allocationsBefore = getAllocationsCount();
+        size_t bytesBefore = getAllocatedBytes();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            sink = sink + call();
+        }
+        elapsed = chrono::steady_clock::now() - start;
+        allocations = getAllocationsCount() - allocationsBefore;
+        bytes = getAllocatedBytes() - bytesBefore;
+
+        if (elapsed.count() >= minSeconds * 1e9) {
+            break;
+        }
+        if (!isWarmUp) {
+            iterations *= 2;
+        }
+        isWarmUp = false;
+    }
+
+    double seconds = elapsed.count() / 1e9;
+    results.push_back({name, input, inputBytes, items, iterations, elapsed.count() / (double)iterations,
+                       inputBytes * iterations / seconds / 1e6, items * iterations / seconds,
+                       allocations / (double)iterations, bytes / (double)iterations});
+
+    const BenchmarkResult& result = results.back();
+    fprintf(stderr, "%s %s: %.0f ns/call\n", result.name.c_str(), result.input.c_str(), result.nanosecondsPerCall);
+}
+
+/**
+ * @brief Creates a table of the results for people to read
+ */
+string BenchmarkRunner::createTableReport() const {
+    string report;
+    char row[256];
+
+    snprintf(row, sizeof(row), "%-50s %-22s %10s %10s %14s %10s %14s %12s %14s\n", "benchmark", "input", "bytes", "iterations",
+             "ns/call", "MB/s", "items/s", "allocs/call", "alloc B/call");
+    report += row;
+    for (const BenchmarkResult& result : results) {
+        snprintf(row, sizeof(row), "%-50s %-22s %10zu %10zu %14.1f %10.2f %14.0f %12.1f %14.1f\n", result.name.c_str(),
+                 result.input.c_str(), result.inputBytes, result.iterations, result.nanosecondsPerCall, result.megabytesPerSecond,
+                 result.itemsPerSecond, result.allocationsPerCall, result.allocatedBytesPerCall);
+        report += row;
+    }
+
+    return report;
+}
+
+/**
+ * @brief Creates the results in JSON, to be kept and compared with the results of other commits
+ */
+string BenchmarkRunner::createJsonReport() const {
+    json report;
+    report["benchmarks"] = json::array();
+
+    for (const BenchmarkResult& result : results) {
+        json benchmark;
+        benchmark["name"] = result.name;
+        benchmark["input"] = result.input;
+        benchmark["inputBytes"] = result.inputBytes;
+        benchmark["items"] = result.items;
+        benchmark["iterations"] = result.iterations;
+        benchmark["nanosecondsPerCall"] = result.nanosecondsPerCall;
+        benchmark["megabytesPerSecond"] = result.megabytesPerSecond;
+        benchmark["itemsPerSecond"] = result.itemsPerSecond;
+        benchmark["allocationsPerCall"] = result.allocationsPerCall;
+        benchmark["allocatedBytesPerCall"] = result.allocatedBytesPerCall;
+        report["benchmarks"].push_back(benchmark);
+    }
+
+    return report.dump(4) + "\n";
+}
@@ -0,0 +1,80 @@
+/**
+ * @file Benchmark.h
+ * @author Ahmed Khaled
+ * @brief This file defines the BenchmarkRunner class which times small functions of the generator on fixed inputs and counts
+ * the memory allocations that they make, so that changes to them can be compared with numbers between commits
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief The measurements of one function on one input
+ */
+struct BenchmarkResult {
+    string name;
+    string input;
+    size_t inputBytes;
+    size_t items; /**< Items processed by one call (e.g., commit subjects), 1 for functions that process a single text*/
+    size_t iterations;
+    double nanosecondsPerCall;
+    double megabytesPerSecond; /**< Input bytes processed per second, in millions of bytes*/
+    double itemsPerSecond;
+    double allocationsPerCall;
+    double allocatedBytesPerCall;
+};
+
+/**
+ * @brief Runs each benchmark until it has been running for a minimum time, then keeps its measurements
+ * The number of calls is doubled until they take the minimum time, so that fast functions aren't dominated by the cost of the clock
+ */
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(double minSeconds, const string& filter, size_t maxInputBytes);
+
+    bool isSelected(const string& name, size_t inputBytes) const;
+    void run(const string& name, const string& input, size_t inputBytes, size_t items, const function<size_t()>& call);
+    const vector<BenchmarkResult>& getResults() const { return results; }
+    string createTableReport() const;
+    string createJsonReport() const;
+
+private:
+    double minSeconds;
+    string filter; /**< Only the benchmarks whose name contains it are run, all of them if it is empty*/
+    size_t maxInputBytes;
+    vector<BenchmarkResult> results;
+};
+
+/**
+ * @brief A small xorshift generator, its numbers are the same on every platform and standard library
+ */
+class BenchmarkRandom {
+public:
+    explicit BenchmarkRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    size_t below(size_t limit) { return (size_t)(next() % limit); }
+
+    /**
+     * @brief A number in [0, 1), used to draw events that happen at a rate
+     */
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+    uint64_t state;
+};
+
+size_t getAllocationsCount();
+size_t getAllocatedBytes();
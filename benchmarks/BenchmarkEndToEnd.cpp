@@ -0,0 +1,167 @@
+/**
+ * @file BenchmarkEndToEnd.cpp
+ * @author Ahmed Khaled
+ * @brief This file benchmarks whole generations (reading git log, classifying, formatting and rendering the notes) on synthetic
+ * repositories of growing sizes, and reports how the time grows with the number of commits to catch the paths that become quadratic
+ *
+ * The generations run in this process through buildReleaseNotes() like in the CLI, without the writing of the output files,
+ * so the time of each size doesn't include starting the program and loading the config
+ */
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <cmath>
+#include <cstdio>
+
+#include <json.hpp>
+
+#include "BenchmarkEndToEnd.h"
+#include "Benchmark.h"
+#include "SyntheticRepository.h"
+#include "../Generator.h"
+#include "../ReleaseNotes.h"
+#include "../RunContext.h"
+#include "../Utils.h"
+#include "../Config.h"
+#include "../Enums.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief The measurements of one generation mode on one size
+ */
+struct EndToEndMeasurement {
+    double milliseconds;
+    double allocations;
+    size_t notesCount;
+};
+
+/**
+ * @brief Generates the notes of a whole synthetic repository and renders them in markdown
+ * @return The median measurement of the repetitions
+ */
+static EndToEndMeasurement measureGeneration(ReleaseNoteSources releaseNoteSource, const string& repositoryDirectory,
+                                             const EndToEndOptions& options, const Config& config) {
+    vector<EndToEndMeasurement> measurements;
+
+    for (size_t i = 0; i < max(options.repetitions, (size_t)1); i++) {
+        RunContext context(config, "owner/repository", "", repositoryDirectory);
+
+        // A budget that already started its only request makes every pull request fall back to its commit subject
+        GithubApiBudget usedUpBudget(1, 1);
+        if (options.githubApiUrl.empty()) {
+            usedUpBudget.acquire();
+            usedUpBudget.release();
+            context.githubApiBudget = &usedUpBudget;
+        }
+
+        size_t allocationsBefore = getAllocationsCount();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        ReleaseNotes releaseNotes = buildReleaseNotes(releaseNoteSource, syntheticStartTag, syntheticEndTag, options.releaseNoteMode, context);
+        string markdown = renderMarkdownReleaseNotes(releaseNotes, config);
+
+        chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+        size_t notesCount = 0;
+        for (const ReleaseNotesSection& section : releaseNotes.sections) {
+            notesCount += section.notes.size();
+        }
+        measurements.push_back({elapsed.count(), (double)(getAllocationsCount() - allocationsBefore), notesCount});
+    }
+
+    sort(measurements.begin(), measurements.end(), [](const EndToEndMeasurement& a, const EndToEndMeasurement& b) {
+        return a.milliseconds < b.milliseconds;
+    });
+    return measurements[measurements.size() / 2];
+}
+
+/**
+ * @brief How the time grows between two sizes: about 1 when it is linear, about 2 when it is quadratic
+ */
+static double computeScalingExponent(double previousMilliseconds, size_t previousSize, double milliseconds, size_t size) {
+    if (previousMilliseconds <= 0 || milliseconds <= 0 || previousSize == size) {
+        return 0;
+    }
+    return log(milliseconds / previousMilliseconds) / log((double)size / previousSize);
+}
+
+/**
+ * @brief Creates a synthetic repository of each size, times the commit messages mode and the pull requests mode on it
+ * and prints the scaling curves
+ * @param options The sizes, the repetitions and the shape of the repositories
+ * @param config The loaded config
+ * @param report Receives the results in JSON
+ * @return The table of the results for people to read
+ */
+string runEndToEndBenchmarks(const EndToEndOptions& options, const Config& config, json& report) {
+    // Exponents of the small sizes are noisy, so only clearly superlinear growth is flagged
+    const double superlinearExponent = 1.3;
+
+    Config endToEndConfig = config;
+    if (!options.githubApiUrl.empty()) {
+        endToEndConfig.githubReposApiUrl = options.githubApiUrl;
+    }
+
+    filesystem::path workDirectory = options.workDirectory.empty()
+        ? filesystem::temp_directory_path() / "release_notes_synthetic_repositories" : filesystem::path(options.workDirectory);
+
+    string table;
+    char row[256];
+    snprintf(row, sizeof(row), "%10s %10s %14s %12s %10s %14s %12s %10s %14s\n", "commits", "create s", "messages ms", "ns/commit",
+             "exponent", "prs ms", "ns/commit", "exponent", "allocs/commit");
+    table += row;
+
+    report["endToEnd"] = json::array();
+    EndToEndMeasurement previousMessages = {0, 0, 0}, previousPullRequests = {0, 0, 0};
+    size_t previousSize = 0;
+
+    for (size_t size : options.sizes) {
+        SyntheticRepositoryOptions repositoryOptions = options.repository;
+        repositoryOptions.commitsCount = size;
+        string repositoryDirectory = (workDirectory / ("commits-" + to_string(size) + "-seed-" + to_string(repositoryOptions.seed))).string();
+
+        fprintf(stderr, "Creating a synthetic repository of %zu commits in %s\n", size, repositoryDirectory.c_str());
+        filesystem::remove_all(repositoryDirectory);
+        chrono::steady_clock::time_point createStart = chrono::steady_clock::now();
+        createSyntheticRepository(repositoryDirectory, repositoryOptions, endToEndConfig);
+        chrono::duration<double> createElapsed = chrono::steady_clock::now() - createStart;
+
+        fprintf(stderr, "Generating the notes of %zu commits\n", size);
+        EndToEndMeasurement messages = measureGeneration(ReleaseNoteSources::CommitMessages, repositoryDirectory, options, endToEndConfig);
+        EndToEndMeasurement pullRequests = measureGeneration(ReleaseNoteSources::PullRequests, repositoryDirectory, options, endToEndConfig);
+
+        double messagesExponent = computeScalingExponent(previousMessages.milliseconds, previousSize, messages.milliseconds, size);
+        double pullRequestsExponent = computeScalingExponent(previousPullRequests.milliseconds, previousSize, pullRequests.milliseconds, size);
+        bool isSuperlinear = messagesExponent > superlinearExponent || pullRequestsExponent > superlinearExponent;
+
+        snprintf(row, sizeof(row), "%10zu %10.2f %14.1f %12.0f %10.2f %14.1f %12.0f %10.2f %14.1f%s%s\n", size, createElapsed.count(),
+                 messages.milliseconds, messages.milliseconds * 1e6 / size, messagesExponent, pullRequests.milliseconds,
+                 pullRequests.milliseconds * 1e6 / size, pullRequestsExponent, messages.allocations / size,
+                 isSuperlinear ? "  superlinear" : "", options.githubApiUrl.empty() ? "  prs from commit subjects" : "");
+        table += row;
+
+        json result;
+        result["commits"] = size;
+        result["createSeconds"] = createElapsed.count();
+        result["commitMessages"] = {{"milliseconds", messages.milliseconds}, {"nanosecondsPerCommit", messages.milliseconds * 1e6 / size},
+                                    {"allocationsPerCommit", messages.allocations / size}, {"notes", messages.notesCount},
+                                    {"scalingExponent", messagesExponent}};
+        result["pullRequests"] = {{"milliseconds", pullRequests.milliseconds},
+                                  {"nanosecondsPerCommit", pullRequests.milliseconds * 1e6 / size},
+                                  {"allocationsPerCommit", pullRequests.allocations / size}, {"notes", pullRequests.notesCount},
+                                  {"scalingExponent", pullRequestsExponent}, {"fetched", !options.githubApiUrl.empty()},
+                                  {"source", options.githubApiUrl.empty() ? "commit subjects" : "github api"}};
+        result["superlinear"] = isSuperlinear;
+        report["endToEnd"].push_back(result);
+
+        previousMessages = messages;
+        previousPullRequests = pullRequests;
+        previousSize = size;
+    }
+
+    return table;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file BenchmarkEndToEnd.h
+ * @author Ahmed Khaled
+ * @brief This file defines the end-to-end benchmarks, which time whole generations on synthetic repositories of growing sizes
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include "SyntheticRepository.h"
+#include "../Config.h"
+#include "../Enums.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Options of the end-to-end benchmarks
+ */
+struct EndToEndOptions {
+    vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+    string workDirectory; /**< Where the synthetic repositories are created, empty means a directory in the temporary directory*/
+    size_t repetitions = 3; /**< Each generation is repeated and the median time is kept*/
+    ReleaseNoteModes releaseNoteMode = ReleaseNoteModes::Full;
+    /**
+     * @brief GitHub API that the pull requests are retrieved from (the mock of the API that the command starts by default), empty
+     * means that no request is sent and the notes of the pull request mode are made from the commit subjects like when the request
+     * budget is used up, the rows of the pull request mode are then marked as made from the commit subjects
+     */
+    string githubApiUrl;
+    SyntheticRepositoryOptions repository;
+};
+
+string runEndToEndBenchmarks(const EndToEndOptions& options, const Config& config, json& report);
@@ -0,0 +1,243 @@
+/**
+ * @file BenchmarkFormat.cpp
+ * @author Ahmed Khaled
+ * @brief This file benchmarks the formatting of pull request bodies (Format.h) and the matching and conversion of commit subjects,
+ * on realistic and pathological inputs from 1 KB to 10 MB
+ *
+ * The inputs are made by a seeded generator that doesn't depend on the standard library, so every commit is measured on the same bytes
+ */
+
+#include <string>
+#include <vector>
+
+#include "BenchmarkFormat.h"
+#include "Benchmark.h"
+#include "../Format.h"
+#include "../Utils.h"
+#include "../Config.h"
+#include "../RunContext.h"
+#include "../Enums.h"
+
+using namespace std;
+
+static const vector<string> benchmarkWords = {
+    "the", "release", "notes", "fixed", "crash", "when", "opening", "a", "file", "with", "layers", "renderer", "now", "uses",
+    "less", "memory", "added", "support", "for", "exporting", "animations", "to", "the", "new", "format", "canvas", "toolbox",
+    "refactored", "parameter", "handling", "in", "and", "of", "is", "this", "pull", "request", "changes", "tests"
+};
+
+static string createRandomHex(BenchmarkRandom& random, size_t length) {
+    static const char hexDigits[] = "0123456789abcdef";
+    string hex;
+    for (size_t i = 0; i < length; i++) {
+        hex += hexDigits[random.below(16)];
+    }
+    return hex;
+}
+
+/**
+ * @brief Creates a pull request body like the ones returned by the GitHub API: paragraphs, lists and code blocks with "\r\n" line endings,
+ * with an issue reference or a commit SHA every few lines
+ */
+string createRealisticPullRequestBody(size_t size) {
+    BenchmarkRandom random(13);
+    string body;
+
+    while (body.size() < size) {
+        size_t block = random.below(10);
+        if (block < 6) {
+            size_t wordsCount = 20 + random.below(40);
+            for (size_t i = 0; i < wordsCount; i++) {
+                size_t token = random.below(40);
+                if (token == 0) {
+                    body += "#" + to_string(1 + random.below(5000));
+                }
+                else if (token == 1) {
+                    body += createRandomHex(random, 7 + random.below(34));
+                }
+                else {
+                    body += benchmarkWords[random.below(benchmarkWords.size())];
+                }
+                body += (i + 1 < wordsCount) ? " " : ".\r\n\r\n";
+            }
+        }
+        else if (block < 9) {
+            size_t itemsCount = 2 + random.below(6);
+            for (size_t i = 0; i < itemsCount; i++) {
+                body += "- " + benchmarkWords[random.below(benchmarkWords.size())] + " " + benchmarkWords[random.below(benchmarkWords.size())]
+                    + " (#" + to_string(1 + random.below(5000)) + ")\r\n";
+            }
+            body += "\r\n";
+        }
+        else {
+            body += "```cpp\r\nint value = computeValue(layer, 0x" + createRandomHex(random, 8) + ");\r\nreturn value;\r\n```\r\n\r\n";
+        }
+    }
+
+    body.resize(size);
+    return body;
+}
+
+/**
+ * @brief Creates a body made only of issue references, every one of them is replaced by a link
+ */
+static string createHashIdsPullRequestBody(size_t size) {
+    BenchmarkRandom random(17);
+    string body;
+    while (body.size() < size) {
+        body += "#" + to_string(random.below(100000)) + " ";
+    }
+    body.resize(size);
+    return body;
+}
+
+/**
+ * @brief Creates a body made only of hexadecimal words, most of them look like commit SHAs
+ */
+static string createCommitShasPullRequestBody(size_t size) {
+    BenchmarkRandom random(19);
+    string body;
+    while (body.size() < size) {
+        body += createRandomHex(random, 4 + random.below(40)) + (random.below(8) == 0 ? "\r\n" : " ");
+    }
+    body.resize(size);
+    return body;
+}
+
+/**
+ * @brief Creates a body of short lines that end with many carriage returns, like bodies edited on several platforms
+ */
+static string createCarriageReturnsPullRequestBody(size_t size) {
+    string body;
+    while (body.size() < size) {
+        body += "line\r\r\r\n\r\n";
+    }
+    body.resize(size);
+    return body;
+}
+
+/**
+ * @brief Creates a body that is a single line without any reference, which the regular expressions scan without finding anything
+ */
+static string createSingleLinePullRequestBody(size_t size) {
+    string body;
+    while (body.size() < size) {
+        body += "nothing-to-replace_here ";
+    }
+    body.resize(size);
+    return body;
+}
+
+/**
+ * @brief Creates commit subjects of all the commit types of the config, with and without scopes, breaking changes and merge commits
+ */
+vector<string> createCommitSubjects(size_t count, const Config& config) {
+    BenchmarkRandom random(23);
+    vector<string> subjects;
+
+    for (size_t i = 0; i < count; i++) {
+        string type = config.commitTypes[random.below(config.commitTypesCount)][(int)CommitTypeInfo::ConventionalName];
+        size_t kind = random.below(10);
+        string description;
+        size_t wordsCount = 3 + random.below(12);
+        for (size_t j = 0; j < wordsCount; j++) {
+            description += (j ? " " : "") + benchmarkWords[random.below(benchmarkWords.size())];
+        }
+
+        if (kind < 4) {
+            subjects.push_back(type + ": " + description);
+        }
+        else if (kind < 8) {
+            subjects.push_back(type + "(" + benchmarkWords[random.below(benchmarkWords.size())] + "): " + description);
+        }
+        else if (kind < 9) {
+            subjects.push_back(type + "!: " + description + " (#" + to_string(random.below(5000)) + ")");
+        }
+        else {
+            subjects.push_back("Merge pull request #" + to_string(random.below(5000)) + " from user/branch");
+        }
+    }
+
+    return subjects;
+}
+
+/**
+ * @brief Runs the benchmarks of the formatting functions
+ * @param runner The runner that measures and keeps the results
+ * @param config The loaded config, which contains the commit types
+ */
+void runFormatBenchmarks(BenchmarkRunner& runner, const Config& config) {
+    RunContext context(config, "owner/repository", "");
+
+    const vector<size_t> sizes = {1 << 10, 64 << 10, 1 << 20, 10 << 20};
+    const vector<pair<string, string (*)(size_t)>> bodies = {
+        {"realistic", createRealisticPullRequestBody},
+        {"hash ids", createHashIdsPullRequestBody},
+        {"commit shas", createCommitShasPullRequestBody},
+        {"carriage returns", createCarriageReturnsPullRequestBody},
+        {"single line", createSingleLinePullRequestBody}
+    };
+    const vector<pair<string, function<string(const string&)>>> functions = {
+        {"indentAllLinesInString", [](const string& body) { return indentAllLinesInString(body); }},
+        {"replaceHashIdsWithLinks", [&](const string& body) { return replaceHashIdsWithLinks(body, context); }},
+        {"replaceCommitShasWithLinks", [&](const string& body) { return replaceCommitShasWithLinks(body, context); }},
+        {"removeExtraNewLines", [](const string& body) { return removeExtraNewLines(body); }},
+        {"formatPullRequestBody", [&](const string& body) { return formatPullRequestBody(body, context); }}
+    };
+
+    for (size_t size : sizes) {
+        for (const auto& body : bodies) {
+            string inputName = body.first + " " + (size < (1 << 20) ? to_string(size >> 10) + " KB" : to_string(size >> 20) + " MB");
+
+            bool isInputNeeded = false;
+            for (const auto& function : functions) {
+                isInputNeeded = isInputNeeded || runner.isSelected(function.first, size);
+            }
+            if (!isInputNeeded) {
+                continue;
+            }
+
+            string input = body.second(size);
+            for (const auto& function : functions) {
+                runner.run(function.first, inputName, size, 1, [&]() { return function.second(input).size(); });
+            }
+        }
+    }
+
+    const size_t subjectsCount = 10000;
+    vector<string> subjects = createCommitSubjects(subjectsCount, config);
+    size_t subjectsBytes = 0;
+    for (const string& subject : subjects) {
+        subjectsBytes += subject.size();
+    }
+
+    runner.run("checkCommitTypeMatch", "10000 subjects", subjectsBytes, subjectsCount, [&]() {
+        size_t matches = 0;
+        for (size_t i = 0; i < subjects.size(); i++) {
+            matches += checkCommitTypeMatch(subjects[i], (int)(i % config.commitTypesCount), config) != CommitTypeMatchResults::NoMatch;
+        }
+        return matches;
+    });
+
+    // Only the subjects that match their commit type are converted by the generator, so merge commits are left out
+    vector<string> titles;
+    vector<CommitTypeMatchResults> matchResults;
+    size_t titlesBytes = 0;
+    for (const string& subject : subjects) {
+        if (subject.find(':') == string::npos) {
+            continue;
+        }
+        titles.push_back(subject);
+        titlesBytes += subject.size();
+        matchResults.push_back(subject.find('(') < subject.find(':') ? CommitTypeMatchResults::MatchWithSubCategory
+                                                                     : CommitTypeMatchResults::MatchWithoutSubCategory);
+    }
+    runner.run("convertConventionalCommitTitleToReleaseNoteTitle", to_string(titles.size()) + " subjects", titlesBytes, titles.size(), [&]() {
+        size_t releaseNoteTitlesBytes = 0;
+        for (size_t i = 0; i < titles.size(); i++) {
+            releaseNoteTitlesBytes += convertConventionalCommitTitleToReleaseNoteTitle(titles[i], matchResults[i],
+                                                                                       config.markdownReleaseNotePrefix).size();
+        }
+        return releaseNoteTitlesBytes;
+    });
+}
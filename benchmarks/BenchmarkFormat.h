@@ -0,0 +1,20 @@
+/**
+ * @file BenchmarkFormat.h
+ * @author Ahmed Khaled
+ * @brief This file defines the benchmarks of the formatting functions and the seeded inputs that they run on,
+ * which the performance regression gate of the tests reuses
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "../Config.h"
+
+using namespace std;
+
+string createRealisticPullRequestBody(size_t size);
+vector<string> createCommitSubjects(size_t count, const Config& config);
+void runFormatBenchmarks(BenchmarkRunner& runner, const Config& config);
@@ -0,0 +1,89 @@
+/**
+ * @file BenchmarkGitObjects.cpp
+ * @author Ahmed Khaled
+ * @brief This file benchmarks the lookups of the commits of a synthetic repository through GitCatFile, in batches, one at a time
+ * and with their contents, next to starting a git cat-file process for each lookup, which is what GitCatFile replaces
+ */
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "BenchmarkGitObjects.h"
+#include "Benchmark.h"
+#include "SyntheticRepository.h"
+#include "../GitObjects.h"
+#include "../Subprocess.h"
+
+using namespace std;
+
+/**
+ * @brief Lists the SHAs of all the commits of the synthetic repository
+ */
+static vector<string> listCommitShas(const string& repositoryDirectory) {
+    Subprocess git(createGitCommand({"rev-list", syntheticEndTag}, repositoryDirectory));
+    string output;
+    char buffer[64 * 1024];
+    long bytesRead;
+    while ((bytesRead = git.readOutput(buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, bytesRead);
+    }
+    if (git.wait() != 0) {
+        throw runtime_error("git rev-list failed in " + repositoryDirectory);
+    }
+
+    vector<string> shas;
+    for (size_t lineStart = 0; lineStart + 40 <= output.size(); lineStart += 41) {
+        shas.push_back(output.substr(lineStart, 40));
+    }
+    return shas;
+}
+
+/**
+ * @brief Runs the benchmarks of the lookups, their items per second are lookups per second
+ * @param runner The runner of the benchmarks
+ * @param repositoryDirectory A synthetic repository (SyntheticRepository.h)
+ */
+void runGitObjectsBenchmarks(BenchmarkRunner& runner, const string& repositoryDirectory) {
+    vector<string> shas = listCommitShas(repositoryDirectory);
+    size_t shasBytes = shas.size() * 41;
+    string input = to_string(shas.size()) + " commits";
+
+    GitCatFile gitObjects(false, repositoryDirectory);
+    runner.run("GitCatFile::lookup", input, shasBytes, shas.size(), [&]() {
+        size_t existingObjects = 0;
+        for (const GitObjectInfo& object : gitObjects.lookup(shas)) {
+            existingObjects += object.exists;
+        }
+        return existingObjects;
+    });
+
+    runner.run("GitCatFile::lookup one at a time", input, shasBytes, shas.size(), [&]() {
+        size_t existingObjects = 0;
+        for (const string& sha : shas) {
+            existingObjects += gitObjects.lookup(sha).exists;
+        }
+        return existingObjects;
+    });
+
+    GitCatFile gitObjectsWithContents(true, repositoryDirectory);
+    runner.run("GitCatFile::lookup with contents", input, shasBytes, shas.size(), [&]() {
+        size_t contentsBytes = 0;
+        for (const GitObjectInfo& object : gitObjectsWithContents.lookup(shas)) {
+            contentsBytes += object.contents.size();
+        }
+        return contentsBytes;
+    });
+
+    // A process for each lookup is much slower, so only the first 100 commits are looked up
+    vector<string> firstShas(shas.begin(), shas.begin() + min<size_t>(shas.size(), 100));
+    runner.run("git cat-file process per lookup", to_string(firstShas.size()) + " commits", firstShas.size() * 41, firstShas.size(), [&]() {
+        size_t existingObjects = 0;
+        for (const string& sha : firstShas) {
+            Subprocess git(createGitCommand({"cat-file", "-e", sha}, repositoryDirectory));
+            existingObjects += git.wait() == 0;
+        }
+        return existingObjects;
+    });
+}
@@ -0,0 +1,15 @@
+/**
+ * @file BenchmarkGitObjects.h
+ * @author Ahmed Khaled
+ * @brief This file defines the benchmarks of the lookups of git objects through the long running git cat-file process (GitObjects.h)
+ */
+
+#pragma once
+
+#include <string>
+
+#include "Benchmark.h"
+
+using namespace std;
+
+void runGitObjectsBenchmarks(BenchmarkRunner& runner, const string& repositoryDirectory);
@@ -0,0 +1,96 @@
+/**
+ * @file BenchmarkThreadPool.cpp
+ * @author Ahmed Khaled
+ * @brief This file benchmarks how the task throughput of the thread pool grows with its number of worker threads,
+ * on empty tasks (the cost of scheduling alone), on small CPU tasks like the formatting of short pull request bodies,
+ * and on tasks that submit their own tasks from the workers
+ */
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+#include "BenchmarkThreadPool.h"
+#include "Benchmark.h"
+#include "../ThreadPool.h"
+
+using namespace std;
+
+static const size_t tasksCount = 10000;
+
+/**
+ * @brief A few microseconds of work that the compiler can't remove
+ */
+static uint64_t spin(uint64_t seed) {
+    BenchmarkRandom random(seed | 1);
+    uint64_t sum = 0;
+    for (int i = 0; i < 1000; i++) {
+        sum += random.next();
+    }
+    return sum;
+}
+
+/**
+ * @brief Runs the benchmarks with 1, 2, 4, ... worker threads up to maxThreads, their items per second are tasks per second
+ * @param runner The runner of the benchmarks
+ * @param maxThreads The largest number of worker threads, the number of hardware threads by default
+ */
+void runThreadPoolBenchmarks(BenchmarkRunner& runner, size_t maxThreads) {
+    vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (size_t threads : threadCounts) {
+        ThreadPool workers(threads);
+        string input = to_string(threads) + (threads == 1 ? " thread" : " threads");
+
+        runner.run("ThreadPool empty tasks", input, 0, tasksCount, [&]() {
+            TaskGroup tasks;
+            for (size_t i = 0; i < tasksCount; i++) {
+                tasks.add();
+                workers.submit([&]() { tasks.finish(); });
+            }
+            tasks.wait();
+            return tasksCount;
+        });
+
+        runner.run("ThreadPool small tasks", input, 0, tasksCount, [&]() {
+            atomic<uint64_t> checksum{0};
+            TaskGroup tasks;
+            for (size_t i = 0; i < tasksCount; i++) {
+                tasks.add();
+                workers.submit([&, i]() {
+                    checksum += spin(i);
+                    tasks.finish();
+                });
+            }
+            tasks.wait();
+            return (size_t)(checksum & 1) + tasksCount;
+        });
+
+        // Each task submitted from outside submits 99 more from its worker, so the other workers must steal them
+        runner.run("ThreadPool nested tasks", input, 0, tasksCount, [&]() {
+            atomic<uint64_t> checksum{0};
+            TaskGroup tasks;
+            for (size_t i = 0; i < tasksCount / 100; i++) {
+                tasks.add();
+                workers.submit([&, i]() {
+                    for (size_t j = 1; j < 100; j++) {
+                        tasks.add();
+                        workers.submit([&, j]() {
+                            checksum += spin(i * 100 + j);
+                            tasks.finish();
+                        });
+                    }
+                    checksum += spin(i * 100);
+                    tasks.finish();
+                });
+            }
+            tasks.wait();
+            return (size_t)(checksum & 1) + tasksCount;
+        });
+    }
+}
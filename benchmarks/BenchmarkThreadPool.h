@@ -0,0 +1,13 @@
+/**
+ * @file BenchmarkThreadPool.h
+ * @author Ahmed Khaled
+ * @brief This file defines the benchmarks of the scaling of the thread pool (ThreadPool.h) with its number of worker threads
+ */
+
+#pragma once
+
+#include "Benchmark.h"
+
+using namespace std;
+
+void runThreadPoolBenchmarks(BenchmarkRunner& runner, size_t maxThreads);
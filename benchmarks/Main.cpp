@@ -0,0 +1,276 @@
+/**
+ * @file Main.cpp
+ * @author Ahmed Khaled
+ * @brief The entry point of the benchmarks, it runs them and prints their results, or creates a synthetic repository
+ * or runs a mock of the GitHub API
+ *
+ * Commands:
+ * release_notes_benchmarks [format] [options]
+ *   Runs the benchmarks of the formatting functions
+ *   --filter text             Only runs the benchmarks whose name contains the text
+ *   --min-time seconds        Minimum time that each benchmark runs for (0.5 by default)
+ *   --max-input-bytes bytes   Skips the inputs bigger than this size (1 MB by default, 10485760 also runs the 10 MB inputs)
+ * release_notes_benchmarks git-objects [--filter text] [--min-time seconds] [--work-directory dir] [repository options]
+ *   Times the lookups of the commits of a synthetic repository through the long running git cat-file process
+ * release_notes_benchmarks thread-pool [--filter text] [--min-time seconds] [--threads n]
+ *   Times the tasks of the thread pool with 1, 2, 4, ... worker threads up to n (the number of hardware threads by default)
+ * release_notes_benchmarks create-repository directory [repository options]
+ *   Creates a synthetic repository, tagged synthetic-start and synthetic-end, to run the generator on
+ * release_notes_benchmarks end-to-end [options] [repository options]
+ *   Times whole generations on synthetic repositories of growing sizes and prints how the time grows with the number of commits
+ *   --sizes n,n,...           Numbers of commits of the repositories (1000,10000,100000,1000000 by default)
+ *   --work-directory dir      Where the repositories are created (a directory in the temporary directory by default)
+ *   --repetitions n           Each generation is repeated and the median time is kept (3 by default)
+ *   --mode short|full         The mode of the notes (full by default)
+ *   --github-api-url url      Retrieves the pull requests from this API instead of the mock of the GitHub API
+ *   --mock-github-api 0|1     Retrieves the pull requests from a mock of the GitHub API started in this process (mock options),
+ *                             1 by default, with 0 and no --github-api-url no request is sent and the notes are made from the commit subjects
+ * release_notes_benchmarks mock-github-api [mock options]
+ *   Runs a mock of the GitHub API until it is stopped, the generator is pointed at it with the environment variables that it prints
+ *   --corpus file             The pull requests and the markdown answered by the mock (tests/fixtures/github_api_corpus.json by default)
+ *
+ * Options of all the commands:
+ * --json file               Also writes the results in JSON in the file, to compare them with the results of other commits
+ * --config file             The config that has the commit types (release_notes_config.json by default)
+ *
+ * Mock options (tests/MockGithubApi.h), missing pull requests are made up from their number:
+ * --latency ms, --jitter ms, --server-error-rate r, --rate-limit-rate r, --mock-seed n
+ *
+ * Repository options (SyntheticRepository.h):
+ * --commits n, --commit-types feat=5,fix=3, --non-conventional-rate r, --breaking-change-rate r, --scope-rate r, --scopes n,
+ * --pr-reference-rate r, --subject-words min-max, --long-subject-rate r, --body-rate r, --merge-rate r, --max-branch-commits n, --seed n
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <filesystem>
+#include <algorithm>
+
+#include <curl/curl.h>
+#include <json.hpp>
+
+#include "Benchmark.h"
+#include "BenchmarkFormat.h"
+#include "BenchmarkEndToEnd.h"
+#include "BenchmarkGitObjects.h"
+#include "BenchmarkThreadPool.h"
+#include "SyntheticRepository.h"
+#include "../tests/MockGithubApi.h"
+#include "../Memory.h"
+#include "../Config.h"
+#include "../Enums.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Reads an option of the mock of the GitHub API
+ * @return False if the option isn't an option of the mock
+ */
+static bool readMockGithubApiOption(const string& option, const string& value, MockGithubApiOptions& options) {
+    if (option == "--latency") {
+        options.latencyMilliseconds = atoi(value.c_str());
+    }
+    else if (option == "--jitter") {
+        options.jitterMilliseconds = atoi(value.c_str());
+    }
+    else if (option == "--server-error-rate") {
+        options.serverErrorRate = atof(value.c_str());
+    }
+    else if (option == "--rate-limit-rate") {
+        options.rateLimitRate = atof(value.c_str());
+    }
+    else if (option == "--mock-seed") {
+        options.seed = strtoull(value.c_str(), NULL, 10);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // The allocations of each benchmark are counted by the replaced operator new of MemoryHooks.cpp
+    getMemoryAccounting().enable();
+
+    string command = "format";
+    int firstOption = 1;
+    if (argc > 1 && argv[1][0] != '-') {
+        command = argv[1];
+        firstOption = 2;
+    }
+    if (command != "format" && command != "git-objects" && command != "thread-pool" && command != "create-repository"
+        && command != "end-to-end" && command != "mock-github-api") {
+        cerr << "Unknown command " << command << endl;
+        return 1;
+    }
+
+    string filter, jsonFileName, repositoryDirectory;
+    string corpusFileName = "tests/fixtures/github_api_corpus.json";
+    bool isUsingMockGithubApi = true;
+    MockGithubApiOptions mockGithubApiOptions;
+    mockGithubApiOptions.isGeneratingMissingPullRequests = true;
+    string configFileName = "release_notes_config.json";
+    double minSeconds = 0.5;
+    // The 10 MB inputs take minutes while the links of pull request bodies are inserted one at a time, so they are only run when asked for
+    size_t maxInputBytes = 1 << 20;
+    size_t maxThreads = max<size_t>(thread::hardware_concurrency(), 1);
+    EndToEndOptions endToEndOptions;
+    SyntheticRepositoryOptions& repositoryOptions = endToEndOptions.repository;
+
+    if (command == "create-repository") {
+        if (firstOption >= argc) {
+            cerr << "Missing the directory of the repository" << endl;
+            return 1;
+        }
+        repositoryDirectory = argv[firstOption++];
+    }
+
+    for (int i = firstOption; i < argc; i++) {
+        if (i + 1 >= argc) {
+            cerr << "Missing value after " << argv[i] << endl;
+            return 1;
+        }
+        if (strcmp(argv[i], "--json") == 0) {
+            jsonFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--config") == 0) {
+            configFileName = argv[++i];
+        }
+        else if ((command == "format" || command == "git-objects" || command == "thread-pool") && strcmp(argv[i], "--filter") == 0) {
+            filter = argv[++i];
+        }
+        else if ((command == "format" || command == "git-objects" || command == "thread-pool") && strcmp(argv[i], "--min-time") == 0) {
+            minSeconds = atof(argv[++i]);
+        }
+        else if (command == "format" && strcmp(argv[i], "--max-input-bytes") == 0) {
+            maxInputBytes = strtoull(argv[++i], NULL, 10);
+        }
+        else if (command == "thread-pool" && strcmp(argv[i], "--threads") == 0) {
+            maxThreads = max<size_t>(strtoull(argv[++i], NULL, 10), 1);
+        }
+        else if (command == "end-to-end" && strcmp(argv[i], "--sizes") == 0) {
+            endToEndOptions.sizes.clear();
+            char* size = argv[++i];
+            while (*size) {
+                endToEndOptions.sizes.push_back(strtoull(size, &size, 10));
+                if (*size == ',') {
+                    size++;
+                }
+                else if (*size) {
+                    cerr << "Incorrect sizes " << argv[i] << endl;
+                    return 1;
+                }
+            }
+        }
+        else if ((command == "end-to-end" || command == "git-objects") && strcmp(argv[i], "--work-directory") == 0) {
+            endToEndOptions.workDirectory = argv[++i];
+        }
+        else if (command == "end-to-end" && strcmp(argv[i], "--repetitions") == 0) {
+            endToEndOptions.repetitions = strtoull(argv[++i], NULL, 10);
+        }
+        else if (command == "end-to-end" && strcmp(argv[i], "--mode") == 0) {
+            endToEndOptions.releaseNoteMode = strcmp(argv[++i], "short") == 0 ? ReleaseNoteModes::Short : ReleaseNoteModes::Full;
+        }
+        else if (command == "end-to-end" && strcmp(argv[i], "--github-api-url") == 0) {
+            endToEndOptions.githubApiUrl = argv[++i];
+        }
+        else if (command == "end-to-end" && strcmp(argv[i], "--mock-github-api") == 0) {
+            isUsingMockGithubApi = strcmp(argv[++i], "0") != 0;
+        }
+        else if (command == "mock-github-api" && strcmp(argv[i], "--corpus") == 0) {
+            corpusFileName = argv[++i];
+        }
+        else if ((command == "end-to-end" || command == "mock-github-api")
+                 && readMockGithubApiOption(argv[i], argv[i + 1], mockGithubApiOptions)) {
+            i++;
+        }
+        else if ((command == "end-to-end" || command == "create-repository" || command == "git-objects")
+                 && readSyntheticRepositoryOption(argv[i], argv[i + 1], repositoryOptions)) {
+            i++;
+        }
+        else {
+            cerr << "Unknown option " << argv[i] << endl;
+            return 1;
+        }
+    }
+
+    try {
+        Config config;
+        config.load(configFileName);
+
+        string jsonReport;
+        if (command == "create-repository") {
+            createSyntheticRepository(repositoryDirectory, repositoryOptions, config);
+            cout << "Created " << repositoryOptions.commitsCount << " commits in " << repositoryDirectory << " ("
+                 << syntheticStartTag << ".." << syntheticEndTag << ")" << endl;
+        }
+        else if (command == "mock-github-api") {
+            MockGithubApi mockGithubApi(MockGithubApi::loadCorpus(corpusFileName), mockGithubApiOptions);
+            cout << "Mock GitHub API listening on port " << mockGithubApi.getPort() << ", point the generator at it with:" << endl
+                 << "export RELEASE_NOTES_GITHUB_REPOS_API_URL=" << mockGithubApi.getReposApiUrl() << endl
+                 << "export RELEASE_NOTES_GITHUB_MARKDOWN_API_URL=" << mockGithubApi.getMarkdownApiUrl() << endl;
+            while (true) {
+                this_thread::sleep_for(chrono::hours(1));
+            }
+        }
+        else if (command == "end-to-end") {
+            curl_global_init(CURL_GLOBAL_DEFAULT);
+            unique_ptr<MockGithubApi> mockGithubApi;
+            if (isUsingMockGithubApi && endToEndOptions.githubApiUrl.empty()) {
+                mockGithubApi = make_unique<MockGithubApi>(json::object(), mockGithubApiOptions);
+                endToEndOptions.githubApiUrl = mockGithubApi->getReposApiUrl();
+            }
+            json report;
+            cout << runEndToEndBenchmarks(endToEndOptions, config, report);
+            jsonReport = report.dump(4) + "\n";
+            curl_global_cleanup();
+        }
+        else if (command == "git-objects") {
+            filesystem::path workDirectory = endToEndOptions.workDirectory.empty()
+                ? filesystem::temp_directory_path() / "release_notes_synthetic_repositories" : filesystem::path(endToEndOptions.workDirectory);
+            string gitObjectsRepositoryDirectory = (workDirectory / ("git-objects-" + to_string(repositoryOptions.commitsCount))).string();
+            filesystem::remove_all(gitObjectsRepositoryDirectory);
+            createSyntheticRepository(gitObjectsRepositoryDirectory, repositoryOptions, config);
+
+            BenchmarkRunner runner(minSeconds, filter, maxInputBytes);
+            runGitObjectsBenchmarks(runner, gitObjectsRepositoryDirectory);
+            cout << runner.createTableReport();
+            jsonReport = runner.createJsonReport();
+            filesystem::remove_all(gitObjectsRepositoryDirectory);
+        }
+        else if (command == "thread-pool") {
+            BenchmarkRunner runner(minSeconds, filter, maxInputBytes);
+            runThreadPoolBenchmarks(runner, maxThreads);
+            cout << runner.createTableReport();
+            jsonReport = runner.createJsonReport();
+        }
+        else {
+            BenchmarkRunner runner(minSeconds, filter, maxInputBytes);
+            runFormatBenchmarks(runner, config);
+            cout << runner.createTableReport();
+            jsonReport = runner.createJsonReport();
+        }
+
+        if (!jsonFileName.empty() && !jsonReport.empty()) {
+            ofstream jsonFile(jsonFileName);
+            if (!jsonFile.is_open()) {
+                throw runtime_error("Unable to create/open " + jsonFileName);
+            }
+            jsonFile << jsonReport;
+        }
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,323 @@
+/**
+ * @file SyntheticRepository.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the creation of synthetic git repositories defined in SyntheticRepository.h
+ *
+ * The history is streamed to git fast-import, which writes the commits directly into a pack, so even a history of a million
+ * commits is created in seconds instead of running git commit for each of them
+ * All the commits have the empty tree since the generator only reads commit messages
+ */
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <filesystem>
+#include <cstdlib>
+#include <cctype>
+
+#include "SyntheticRepository.h"
+#include "Benchmark.h"
+#include "../Subprocess.h"
+#include "../GitObjects.h"
+#include "../Config.h"
+#include "../Enums.h"
+
+using namespace std;
+
+static const vector<string> subjectWords = {
+    "add", "support", "for", "the", "new", "renderer", "fix", "crash", "when", "opening", "files", "with", "layers", "update",
+    "dependencies", "remove", "unused", "code", "in", "parser", "improve", "performance", "of", "canvas", "export", "handle",
+    "empty", "input", "correctly", "use", "less", "memory", "while", "loading", "animations", "rename", "toolbox", "options"
+};
+
+static const vector<string> scopeNames = {
+    "core", "gui", "renderer", "build", "docs", "ci", "parser", "export", "import", "canvas", "toolbox", "layers", "audio",
+    "plugins", "i18n", "tests", "config", "api", "cli", "server"
+};
+
+/**
+ * @brief Creates the commit messages of the history and writes them in the input format of git fast-import
+ */
+class SyntheticHistoryWriter {
+public:
+    SyntheticHistoryWriter(const SyntheticRepositoryOptions& options, const Config& config, Subprocess& fastImport);
+
+    void writeHistory();
+
+private:
+    const SyntheticRepositoryOptions& options;
+    const Config& config;
+    Subprocess& fastImport;
+    BenchmarkRandom random;
+    vector<pair<string, double>> commitTypeWeights;
+    double commitTypeWeightsSum = 0;
+    string input; /**< Input that wasn't written to git fast-import yet, it is written in chunks of about 1 MB*/
+    size_t commitsCount = 0;
+    size_t pullRequestsCount = 0;
+
+    string createDescription();
+    string createConventionalTitle();
+    string createSubject();
+    string createBody();
+    void writeCommit(const string& branch, const string& message, size_t fromMark, size_t mergeMark);
+    void flushInput(bool isLast);
+};
+
+SyntheticHistoryWriter::SyntheticHistoryWriter(const SyntheticRepositoryOptions& options, const Config& config, Subprocess& fastImport)
+    : options(options), config(config), fastImport(fastImport), random(options.seed == 0 ? 1 : options.seed),
+      commitTypeWeights(options.commitTypeWeights) {
+    if (commitTypeWeights.empty()) {
+        for (int i = 0; i < config.commitTypesCount; i++) {
+            commitTypeWeights.push_back({config.commitTypes[i][(int)CommitTypeInfo::ConventionalName], 1});
+        }
+    }
+    for (const auto& commitTypeWeight : commitTypeWeights) {
+        commitTypeWeightsSum += commitTypeWeight.second;
+    }
+    if (commitTypeWeightsSum <= 0) {
+        throw runtime_error("The weights of the commit types of the synthetic repository must add up to more than 0");
+    }
+}
+
+string SyntheticHistoryWriter::createDescription() {
+    size_t wordsCount = random.uniform() < options.longSubjectRate
+        ? 200 : options.minSubjectWords + random.below(options.maxSubjectWords - options.minSubjectWords + 1);
+
+    string description;
+    for (size_t i = 0; i < wordsCount; i++) {
+        description += (i ? " " : "") + subjectWords[random.below(subjectWords.size())];
+    }
+    return description;
+}
+
+/**
+ * @brief Creates a conventional commit title: type, optional scope, optional "!" and description
+ */
+string SyntheticHistoryWriter::createConventionalTitle() {
+    double weight = random.uniform() * commitTypeWeightsSum;
+    size_t typeIndex = 0;
+    while (typeIndex + 1 < commitTypeWeights.size() && weight >= commitTypeWeights[typeIndex].second) {
+        weight -= commitTypeWeights[typeIndex].second;
+        typeIndex++;
+    }
+
+    string title = commitTypeWeights[typeIndex].first;
+    if (options.scopesCount > 0 && random.uniform() < options.scopeRate) {
+        // Squaring the uniform number makes the first scopes the most frequent ones
+        double skewed = random.uniform();
+        size_t scopeIndex = (size_t)(skewed * skewed * options.scopesCount);
+        title += "(" + (scopeIndex < scopeNames.size() ? scopeNames[scopeIndex] : "scope" + to_string(scopeIndex)) + ")";
+    }
+    if (random.uniform() < options.breakingChangeRate) {
+        title += "!";
+    }
+    return title + ": " + createDescription();
+}
+
+string SyntheticHistoryWriter::createSubject() {
+    string subject;
+    if (random.uniform() < options.nonConventionalRate) {
+        subject = createDescription();
+        subject[0] = toupper(subject[0]);
+    }
+    else {
+        subject = createConventionalTitle();
+    }
+
+    if (random.uniform() < options.pullRequestReferenceRate) {
+        subject += " (#" + to_string(++pullRequestsCount) + ")";
+    }
+    return subject;
+}
+
+string SyntheticHistoryWriter::createBody() {
+    if (random.uniform() >= options.bodyRate) {
+        return "";
+    }
+
+    string body;
+    size_t linesCount = 1 + random.below(5);
+    for (size_t i = 0; i < linesCount; i++) {
+        body += "- " + createDescription() + "\n";
+    }
+    return "\n" + body;
+}
+
+/**
+ * @brief Writes a commit of the empty tree
+ * @param branch The branch that the commit is added to
+ * @param fromMark Mark of the parent commit if it isn't the last commit of the branch (0 otherwise)
+ * @param mergeMark Mark of the second parent of a merge commit (0 otherwise)
+ */
+void SyntheticHistoryWriter::writeCommit(const string& branch, const string& message, size_t fromMark, size_t mergeMark) {
+    commitsCount++;
+    string timestamp = to_string(1600000000 + commitsCount * 60);
+
+    input += "commit refs/heads/" + branch + "\nmark :" + to_string(commitsCount) + "\n";
+    input += "author Synthetic Author <author@example.com> " + timestamp + " +0000\n";
+    input += "committer Synthetic Author <author@example.com> " + timestamp + " +0000\n";
+    input += "data " + to_string(message.size()) + "\n" + message + "\n";
+    if (fromMark) {
+        input += "from :" + to_string(fromMark) + "\n";
+    }
+    if (mergeMark) {
+        input += "merge :" + to_string(mergeMark) + "\n";
+    }
+    input += "\n";
+
+    flushInput(false);
+}
+
+void SyntheticHistoryWriter::flushInput(bool isLast) {
+    if (isLast || input.size() >= (1 << 20)) {
+        fastImport.writeInput(input);
+        input.clear();
+    }
+}
+
+/**
+ * @brief Writes the whole history: the main branch, the merged branches and the tags of its first and last commits
+ */
+void SyntheticHistoryWriter::writeHistory() {
+    size_t mainMark = 0;
+
+    while (commitsCount < options.commitsCount) {
+        size_t remainingCommits = options.commitsCount - commitsCount;
+
+        // A merged branch needs at least one commit and the merge commit, and it never starts from the root commit
+        if (mainMark != 0 && remainingCommits >= 2 && random.uniform() < options.mergeRate) {
+            size_t branchCommits = 1 + random.below(min(max(options.maxBranchCommits, (size_t)1), remainingCommits - 1));
+            size_t pullRequestNumber = ++pullRequestsCount;
+            string branch = "topic-" + to_string(pullRequestNumber);
+
+            for (size_t i = 0; i < branchCommits; i++) {
+                writeCommit("topic", createConventionalTitle() + "\n" + createBody(), i == 0 ? mainMark : 0, 0);
+            }
+            writeCommit("main", "Merge pull request #" + to_string(pullRequestNumber) + " from user/" + branch + "\n\n"
+                        + createConventionalTitle() + "\n", 0, commitsCount);
+        }
+        else {
+            writeCommit("main", createSubject() + "\n" + createBody(), 0, 0);
+        }
+        mainMark = commitsCount;
+    }
+
+    input += "reset refs/tags/" + syntheticStartTag + "\nfrom :1\n\n";
+    input += "reset refs/tags/" + syntheticEndTag + "\nfrom :" + to_string(mainMark) + "\n\n";
+    flushInput(true);
+}
+
+/**
+ * @brief Runs git and fails if it doesn't succeed
+ */
+static void runGit(const vector<string>& gitArguments, const string& directory) {
+    Subprocess git(createGitCommand(gitArguments, directory));
+    if (git.wait() != 0) {
+        throw runtime_error("git " + gitArguments[0] + " failed in " + directory);
+    }
+}
+
+/**
+ * @brief Creates a git repository with a synthetic history, tagged synthetic-start (first commit) and synthetic-end (last commit)
+ * @param directory Directory of the new repository, it must not exist or be empty
+ * @param options The size and the shape of the history
+ * @param config The loaded config, which contains the commit types
+ */
+void createSyntheticRepository(const string& directory, const SyntheticRepositoryOptions& options, const Config& config) {
+    if (options.commitsCount == 0) {
+        throw runtime_error("A synthetic repository needs at least one commit");
+    }
+    if (options.minSubjectWords == 0 || options.maxSubjectWords < options.minSubjectWords) {
+        throw runtime_error("The subjects of a synthetic repository need at least one word, and no more than the maximum");
+    }
+    if (filesystem::exists(directory) && !filesystem::is_empty(directory)) {
+        throw runtime_error(directory + " already exists and isn't empty");
+    }
+
+    filesystem::create_directories(directory);
+    runGit({"init", "-q"}, directory);
+
+    {
+        Subprocess fastImport(createGitCommand({"fast-import", "--quiet"}, directory), true);
+        SyntheticHistoryWriter writer(options, config, fastImport);
+        writer.writeHistory();
+        fastImport.closeInput();
+        if (fastImport.wait() != 0) {
+            throw runtime_error("git fast-import failed in " + directory);
+        }
+    }
+
+    runGit({"symbolic-ref", "HEAD", "refs/heads/main"}, directory);
+}
+
+/**
+ * @brief Reads an option of the shape of synthetic repositories (e.g., --commits 1000), shared by the commands of the benchmarks
+ * @param option The name of the option
+ * @param value The value after the name
+ * @return False if the option isn't an option of synthetic repositories
+ */
+bool readSyntheticRepositoryOption(const string& option, const string& value, SyntheticRepositoryOptions& options) {
+    if (option == "--commits") {
+        options.commitsCount = strtoull(value.c_str(), NULL, 10);
+    }
+    else if (option == "--commit-types") {
+        // e.g., feat=5,fix=3,docs=1
+        options.commitTypeWeights.clear();
+        size_t start = 0;
+        while (start < value.size()) {
+            size_t end = value.find(',', start);
+            if (end == string::npos) {
+                end = value.size();
+            }
+            string commitTypeWeight = value.substr(start, end - start);
+            size_t separator = commitTypeWeight.find('=');
+            if (separator == string::npos) {
+                options.commitTypeWeights.push_back({commitTypeWeight, 1});
+            }
+            else {
+                options.commitTypeWeights.push_back({commitTypeWeight.substr(0, separator), atof(commitTypeWeight.c_str() + separator + 1)});
+            }
+            start = end + 1;
+        }
+    }
+    else if (option == "--non-conventional-rate") {
+        options.nonConventionalRate = atof(value.c_str());
+    }
+    else if (option == "--breaking-change-rate") {
+        options.breakingChangeRate = atof(value.c_str());
+    }
+    else if (option == "--scope-rate") {
+        options.scopeRate = atof(value.c_str());
+    }
+    else if (option == "--scopes") {
+        options.scopesCount = strtoull(value.c_str(), NULL, 10);
+    }
+    else if (option == "--pr-reference-rate") {
+        options.pullRequestReferenceRate = atof(value.c_str());
+    }
+    else if (option == "--subject-words") {
+        // e.g., 3-12
+        options.minSubjectWords = strtoull(value.c_str(), NULL, 10);
+        size_t separator = value.find('-');
+        options.maxSubjectWords = separator == string::npos ? options.minSubjectWords : strtoull(value.c_str() + separator + 1, NULL, 10);
+    }
+    else if (option == "--long-subject-rate") {
+        options.longSubjectRate = atof(value.c_str());
+    }
+    else if (option == "--body-rate") {
+        options.bodyRate = atof(value.c_str());
+    }
+    else if (option == "--merge-rate") {
+        options.mergeRate = atof(value.c_str());
+    }
+    else if (option == "--max-branch-commits") {
+        options.maxBranchCommits = strtoull(value.c_str(), NULL, 10);
+    }
+    else if (option == "--seed") {
+        options.seed = strtoull(value.c_str(), NULL, 10);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
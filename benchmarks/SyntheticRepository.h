@@ -0,0 +1,60 @@
+/**
+ * @file SyntheticRepository.h
+ * @author Ahmed Khaled
+ * @brief This file defines the creation of synthetic git repositories, whose histories have the size and the shape (commit types,
+ * scopes, pull request references, subject lengths and merges) given by the options, to run the whole generator on them
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "../Config.h"
+
+using namespace std;
+
+/**
+ * @brief The size and the shape of the history of a synthetic repository
+ * The same options and seed always create the same commit messages, so the results of different commits can be compared
+ */
+struct SyntheticRepositoryOptions {
+    size_t commitsCount = 1000; /**< All the commits of the history, including the commits of merged branches and the merge commits*/
+    /**
+     * @brief Weights of the conventional names of the commit types (e.g., {"feat", 5}, {"fix", 3}), empty means that all the
+     * commit types of the config are equally likely
+     */
+    vector<pair<string, double>> commitTypeWeights;
+    double nonConventionalRate = 0.2; /**< Rate of the subjects that don't start with a commit type (e.g., "Update README")*/
+    double breakingChangeRate = 0.02; /**< Rate of the conventional subjects marked as breaking changes with "!"*/
+    double scopeRate = 0.5; /**< Rate of the conventional subjects that have a scope*/
+    /**
+     * @brief Number of different scopes, the first scopes are used much more often than the last ones like in real projects
+     */
+    size_t scopesCount = 20;
+    double pullRequestReferenceRate = 0.3; /**< Rate of the subjects that end with " (#number)" like squash merges*/
+    size_t minSubjectWords = 3;
+    size_t maxSubjectWords = 12;
+    double longSubjectRate = 0.001; /**< Rate of the subjects of 200 words, to catch costs that grow with the subject length*/
+    double bodyRate = 0.3; /**< Rate of the commits that have a body of a few lines*/
+    /**
+     * @brief Rate of the commits of the main branch that are followed by a merged branch, every merged branch ends with a
+     * "Merge pull request #number from user/branch" commit whose body is the title of the pull request
+     */
+    double mergeRate = 0.1;
+    size_t maxBranchCommits = 5; /**< Merged branches have 1 to this many commits*/
+    uint64_t seed = 1;
+};
+
+/**
+ * @brief The tag of the first commit of every synthetic repository
+ */
+const string syntheticStartTag = "synthetic-start";
+/**
+ * @brief The tag of the last commit of every synthetic repository
+ */
+const string syntheticEndTag = "synthetic-end";
+
+void createSyntheticRepository(const string& directory, const SyntheticRepositoryOptions& options, const Config& config);
+bool readSyntheticRepositoryOption(const string& option, const string& value, SyntheticRepositoryOptions& options);
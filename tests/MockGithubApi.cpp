@@ -0,0 +1,407 @@
+/**
+ * @file MockGithubApi.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the MockGithubApi class defined in MockGithubApi.h
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+
+#include <json.hpp>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include "MockGithubApi.h"
+#include "../ReleaseNotes.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Starts listening on a free port of 127.0.0.1
+ * @param corpus The pull requests and the markdown conversions answered by the mock
+ * @param options The faults and the delays added to the responses
+ */
+MockGithubApi::MockGithubApi(const json& corpus, const MockGithubApiOptions& options)
+    : corpus(corpus), options(options), random(options.seed) {
+    listeningSocket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listeningSocket < 0) {
+        throw runtime_error("Unable to create the mock GitHub API socket: " + string(strerror(errno)));
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    socklen_t addressSize = sizeof(address);
+    if (bind(listeningSocket, (sockaddr*)&address, sizeof(address)) < 0 || listen(listeningSocket, SOMAXCONN) < 0
+        || getsockname(listeningSocket, (sockaddr*)&address, &addressSize) < 0) {
+        string error = strerror(errno);
+        close(listeningSocket);
+        throw runtime_error("Unable to listen for the mock GitHub API: " + error);
+    }
+    port = ntohs(address.sin_port);
+
+    // Clients that disconnect before reading their response must not stop the tests
+    signal(SIGPIPE, SIG_IGN);
+    acceptThread = thread(&MockGithubApi::acceptConnections, this);
+}
+
+/**
+ * @brief Stops listening, disconnects the clients and waits for all the threads of the mock
+ */
+MockGithubApi::~MockGithubApi() {
+    isStopping = true;
+    shutdown(listeningSocket, SHUT_RDWR);
+    acceptThread.join();
+    close(listeningSocket);
+
+    vector<thread> threads;
+    {
+        lock_guard<mutex> lock(stateMutex);
+        for (int connectionSocket : connectionSockets) {
+            shutdown(connectionSocket, SHUT_RDWR);
+        }
+        threads.swap(connectionThreads);
+    }
+    for (thread& connectionThread : threads) {
+        connectionThread.join();
+    }
+}
+
+/**
+ * @brief Reads a corpus file, e.g. {"pulls": {"13": {"title": "feat: added X", "body": "..."}}, "markdown": {"**X**": "<p><strong>X</strong></p>"}}
+ */
+json MockGithubApi::loadCorpus(const string& corpusFileName) {
+    ifstream corpusFile(corpusFileName);
+    if (!corpusFile.is_open()) {
+        throw runtime_error("Unable to open the mock GitHub API corpus " + corpusFileName);
+    }
+    return json::parse(corpusFile);
+}
+
+/**
+ * @brief The URL to use as githubReposApiUrl in the config (or RELEASE_NOTES_GITHUB_REPOS_API_URL)
+ */
+string MockGithubApi::getReposApiUrl() const {
+    return "http://127.0.0.1:" + to_string(port) + "/repos/";
+}
+
+/**
+ * @brief The URL to use as githubMarkdownApiUrl in the config (or RELEASE_NOTES_GITHUB_MARKDOWN_API_URL)
+ */
+string MockGithubApi::getMarkdownApiUrl() const {
+    return "http://127.0.0.1:" + to_string(port) + "/markdown";
+}
+
+MockGithubApiCounters MockGithubApi::getCounters() {
+    lock_guard<mutex> lock(stateMutex);
+    return counters;
+}
+
+/**
+ * @brief The threads of the connections that are open or that closed since the last accepted connection
+ */
+size_t MockGithubApi::getConnectionThreadsCount() {
+    lock_guard<mutex> lock(stateMutex);
+    return connectionThreads.size();
+}
+
+void MockGithubApi::acceptConnections() {
+    while (!isStopping) {
+        int connectionSocket = accept4(listeningSocket, NULL, NULL, SOCK_CLOEXEC);
+        if (connectionSocket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;
+        }
+
+        // The threads of the closed connections are joined here, so a long load test doesn't keep thousands of them
+        vector<thread> finishedThreads;
+        {
+            lock_guard<mutex> lock(stateMutex);
+            counters.connections++;
+            for (thread::id finishedThreadId : finishedConnectionThreads) {
+                auto finishedThread = find_if(connectionThreads.begin(), connectionThreads.end(),
+                                              [&](const thread& connectionThread) { return connectionThread.get_id() == finishedThreadId; });
+                finishedThreads.push_back(move(*finishedThread));
+                connectionThreads.erase(finishedThread);
+            }
+            finishedConnectionThreads.clear();
+            connectionSockets.push_back(connectionSocket);
+            connectionThreads.emplace_back(&MockGithubApi::handleConnection, this, connectionSocket);
+        }
+        for (thread& finishedThread : finishedThreads) {
+            finishedThread.join();
+        }
+    }
+}
+
+/**
+ * @brief Writes the whole data to a socket
+ * @return Whether the data was written, false if the other side closed the connection
+ */
+static bool writeAll(int socket, const string& data) {
+    size_t bytesWritten = 0;
+    while (bytesWritten < data.size()) {
+        ssize_t result = write(socket, data.data() + bytesWritten, data.size() - bytesWritten);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        bytesWritten += result;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads from a socket until the buffer has at least the given number of bytes
+ * @return Whether they were read, false if the other side closed the connection first
+ */
+static bool readAtLeast(int socket, string& buffer, size_t size) {
+    while (buffer.size() < size) {
+        char data[64 * 1024];
+        ssize_t bytesRead = read(socket, data, sizeof(data));
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead <= 0) {
+            return false;
+        }
+        buffer.append(data, bytesRead);
+    }
+    return true;
+}
+
+/**
+ * @brief Creates a whole HTTP response
+ */
+static string createHttpResponse(int statusCode, const string& reason, const string& contentType, const string& body,
+                                 const string& extraHeaders = "") {
+    return "HTTP/1.1 " + to_string(statusCode) + " " + reason + "\r\nContent-Type: " + contentType + "\r\nContent-Length: "
+        + to_string(body.size()) + "\r\n" + extraHeaders + "\r\n" + body;
+}
+
+/**
+ * @brief Creates a 400 response with a GitHub-like JSON error
+ */
+static string createBadRequestResponse(const string& message, const string& extraHeaders = "") {
+    return createHttpResponse(400, "Bad Request", "application/json", json({{"message", message}}).dump(), extraHeaders);
+}
+
+/**
+ * @brief Parses the value of a Content-Length header without throwing
+ * @return False if it isn't a decimal number that fits in a size_t
+ */
+static bool parseContentLength(const string& value, size_t& contentLength) {
+    if (value.empty() || value.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    errno = 0;
+    unsigned long long length = strtoull(value.c_str(), NULL, 10);
+    if (errno == ERANGE || length > SIZE_MAX) {
+        return false;
+    }
+    contentLength = (size_t)length;
+    return true;
+}
+
+/**
+ * @brief Answers the requests of a connection until the client closes it, connections are kept alive like on GitHub
+ */
+void MockGithubApi::handleConnection(int connectionSocket) {
+    string buffer;
+
+    while (!isStopping) {
+        size_t headersEnd;
+        while ((headersEnd = buffer.find("\r\n\r\n")) == string::npos) {
+            if (!readAtLeast(connectionSocket, buffer, buffer.size() + 1)) {
+                headersEnd = string::npos;
+                break;
+            }
+        }
+        if (headersEnd == string::npos) {
+            break;
+        }
+
+        // Request line then headers, header names are case insensitive so they are kept in lowercase
+        string requestHead = buffer.substr(0, headersEnd);
+        buffer.erase(0, headersEnd + 4);
+        size_t lineEnd = requestHead.find("\r\n");
+        string requestLine = requestHead.substr(0, lineEnd);
+        map<string, string> headers;
+        while (lineEnd != string::npos) {
+            size_t lineStart = lineEnd + 2;
+            lineEnd = requestHead.find("\r\n", lineStart);
+            string line = requestHead.substr(lineStart, lineEnd == string::npos ? string::npos : lineEnd - lineStart);
+            size_t separator = line.find(':');
+            if (separator == string::npos) {
+                continue;
+            }
+            string name = line.substr(0, separator);
+            transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return (char)tolower(c); });
+            size_t valueStart = line.find_first_not_of(' ', separator + 1);
+            headers[name] = valueStart == string::npos ? "" : line.substr(valueStart);
+        }
+
+        size_t methodEnd = requestLine.find(' ');
+        size_t pathEnd = requestLine.find(' ', methodEnd + 1);
+        if (methodEnd == string::npos || pathEnd == string::npos) {
+            break;
+        }
+        string method = requestLine.substr(0, methodEnd);
+        string path = requestLine.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+
+        // The end of the body can't be found without a valid length, so the connection is closed after the error
+        size_t contentLength = 0;
+        if (headers.count("content-length") && !parseContentLength(headers["content-length"], contentLength)) {
+            {
+                lock_guard<mutex> lock(stateMutex);
+                counters.requests++;
+                counters.badRequests++;
+            }
+            writeAll(connectionSocket, createBadRequestResponse("Invalid Content-Length", "Connection: close\r\n"));
+            break;
+        }
+        if (contentLength > 0 && headers["expect"] == "100-continue" && !writeAll(connectionSocket, "HTTP/1.1 100 Continue\r\n\r\n")) {
+            break;
+        }
+        if (!readAtLeast(connectionSocket, buffer, contentLength)) {
+            break;
+        }
+        string body = buffer.substr(0, contentLength);
+        buffer.erase(0, contentLength);
+
+        if (!writeAll(connectionSocket, createResponse(method, path, headers, body)) || headers["connection"] == "close") {
+            break;
+        }
+    }
+
+    lock_guard<mutex> lock(stateMutex);
+    connectionSockets.erase(find(connectionSockets.begin(), connectionSockets.end(), connectionSocket));
+    close(connectionSocket);
+    finishedConnectionThreads.push_back(this_thread::get_id());
+}
+
+/**
+ * @brief Answers a request after the configured delay, with a fault or with the pull request or the HTML from the corpus
+ */
+string MockGithubApi::createResponse(const string& method, const string& path, const map<string, string>& headers, const string& body) {
+    int delayMilliseconds = options.latencyMilliseconds;
+    bool isServerError, isRateLimited;
+    int serverErrorCode;
+    {
+        lock_guard<mutex> lock(stateMutex);
+        counters.requests++;
+        if (options.jitterMilliseconds > 0) {
+            delayMilliseconds += (int)(random() % (options.jitterMilliseconds + 1));
+        }
+        uniform_real_distribution<double> rate(0, 1);
+        isServerError = rate(random) < options.serverErrorRate;
+        serverErrorCode = random() % 2 ? 502 : 503;
+        isRateLimited = !isServerError && rate(random) < options.rateLimitRate;
+        counters.serverErrors += isServerError;
+        counters.rateLimited += isRateLimited;
+    }
+    if (delayMilliseconds > 0) {
+        this_thread::sleep_for(chrono::milliseconds(delayMilliseconds));
+    }
+
+    if (isServerError) {
+        return createHttpResponse(serverErrorCode, "Server Error", "application/json", "{\"message\":\"Server Error\"}");
+    }
+    if (isRateLimited) {
+        return createHttpResponse(403, "Forbidden", "application/json",
+            "{\"message\":\"API rate limit exceeded\",\"documentation_url\":\"https://docs.github.com/rest/overview/rate-limits-for-the-rest-api\"}",
+            "X-RateLimit-Limit: 5000\r\nX-RateLimit-Remaining: 0\r\nX-RateLimit-Reset: " + to_string(time(NULL) + 60) + "\r\n");
+    }
+
+    string responseBody, contentType;
+    string resourcePath = path.substr(0, path.find('?'));
+    const string reposPrefix = "/repos/", pullsInfix = "/pulls/";
+    size_t pullsStart = resourcePath.find(pullsInfix);
+
+    if (method == "GET" && resourcePath.compare(0, reposPrefix.size(), reposPrefix) == 0 && pullsStart != string::npos) {
+        string number = resourcePath.substr(pullsStart + pullsInfix.size());
+        // Longer numbers don't fit in the number of the pull request
+        if (number.empty() || number.size() > 18 || number.find_first_not_of("0123456789") != string::npos) {
+            lock_guard<mutex> lock(stateMutex);
+            counters.notFound++;
+            return createHttpResponse(404, "Not Found", "application/json", "{\"message\":\"Not Found\"}");
+        }
+
+        json pullRequest;
+        if (corpus.contains("pulls") && corpus["pulls"].contains(number)) {
+            pullRequest = corpus["pulls"][number];
+        }
+        else if (options.isGeneratingMissingPullRequests) {
+            pullRequest["title"] = "feat: synthetic pull request " + number;
+            pullRequest["body"] = "Synthetic pull request #" + number + ", follows up 3f2a9c1.\r\n\r\n- first change\r\n- second change";
+        }
+        else {
+            lock_guard<mutex> lock(stateMutex);
+            counters.notFound++;
+            return createHttpResponse(404, "Not Found", "application/json", "{\"message\":\"Not Found\"}");
+        }
+        pullRequest["number"] = stoll(number);
+        responseBody = pullRequest.dump();
+        contentType = "application/json";
+    }
+    else if (method == "POST" && resourcePath == "/markdown") {
+        json markdownRequest = json::parse(body, nullptr, false);
+        if (!markdownRequest.is_object() || !markdownRequest.contains("text") || !markdownRequest["text"].is_string()) {
+            lock_guard<mutex> lock(stateMutex);
+            counters.badRequests++;
+            return createBadRequestResponse("Problems parsing JSON");
+        }
+        string markdownText = markdownRequest["text"];
+        if (corpus.contains("markdown") && corpus["markdown"].contains(markdownText)) {
+            responseBody = corpus["markdown"][markdownText];
+        }
+        else {
+            responseBody = renderMarkdownBlocksToHtml(markdownText);
+        }
+        contentType = "text/html;charset=utf-8";
+    }
+    else {
+        lock_guard<mutex> lock(stateMutex);
+        counters.notFound++;
+        return createHttpResponse(404, "Not Found", "application/json", "{\"message\":\"Not Found\"}");
+    }
+
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"%016zx\"", hash<string>()(responseBody));
+    auto ifNoneMatch = headers.find("if-none-match");
+
+    lock_guard<mutex> lock(stateMutex);
+    if (ifNoneMatch != headers.end() && ifNoneMatch->second == etag) {
+        counters.notModified++;
+        return createHttpResponse(304, "Not Modified", contentType, "", "ETag: " + string(etag) + "\r\n");
+    }
+    (method == "GET" ? counters.pullRequests : counters.markdown)++;
+    return createHttpResponse(200, "OK", contentType, responseBody, "ETag: " + string(etag) + "\r\nX-RateLimit-Remaining: 4999\r\n");
+}
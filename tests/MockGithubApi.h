@@ -0,0 +1,95 @@
+/**
+ * @file MockGithubApi.h
+ * @author Ahmed Khaled
+ * @brief This file defines the MockGithubApi class, a local HTTP server that answers the GitHub API requests of the generator
+ * from a corpus, so that the pull requests mode and the HTML rendering can be tested and benchmarked without api.github.com
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <random>
+#include <atomic>
+#include <cstdint>
+
+#include <json.hpp>
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief The faults and the delays that the mock adds to its responses
+ */
+struct MockGithubApiOptions {
+    int latencyMilliseconds = 0; /**< Delay before every response*/
+    int jitterMilliseconds = 0; /**< Random extra delay from 0 to this, added to the latency*/
+    double serverErrorRate = 0; /**< Rate of the responses that are 502 or 503 errors*/
+    double rateLimitRate = 0; /**< Rate of the responses that are 403 errors with X-RateLimit-Remaining: 0*/
+    /**
+     * @brief Whether the pull requests that aren't in the corpus are made up from their number (e.g., for synthetic repositories),
+     * otherwise they are answered with 404
+     */
+    bool isGeneratingMissingPullRequests = false;
+    uint64_t seed = 1; /**< Seed of the delays and the faults*/
+};
+
+/**
+ * @brief Counts of the requests answered by the mock, by kind of response
+ */
+struct MockGithubApiCounters {
+    size_t connections = 0; /**< Connections accepted, a client that reuses its connections opens one per concurrent request*/
+    size_t requests = 0;
+    size_t pullRequests = 0; /**< 200 responses with the info of a pull request*/
+    size_t markdown = 0; /**< 200 responses with markdown converted to HTML*/
+    size_t notModified = 0; /**< 304 responses to requests with the ETag of the current response*/
+    size_t notFound = 0;
+    size_t badRequests = 0; /**< 400 responses to requests with an invalid Content-Length or markdown body*/
+    size_t serverErrors = 0;
+    size_t rateLimited = 0;
+};
+
+/**
+ * @brief A local HTTP/1.1 server that answers GET /repos/{owner}/{repository}/pulls/{number} and POST /markdown like the GitHub API
+ * Pull requests come from the "pulls" object of the corpus (pull request number -> {"title", "body"}), markdown texts are converted
+ * with the "markdown" object of the corpus (markdown text -> HTML) or with the local HTML renderer when they aren't in it
+ * Every response has an ETag that only depends on its body, so conditional requests are answered with 304 like on GitHub
+ * It listens on a free port of 127.0.0.1 from its creation until its destruction, each connection is handled on its own thread
+ */
+class MockGithubApi {
+public:
+    explicit MockGithubApi(const json& corpus, const MockGithubApiOptions& options = MockGithubApiOptions());
+    ~MockGithubApi();
+
+    MockGithubApi(const MockGithubApi&) = delete;
+    MockGithubApi& operator=(const MockGithubApi&) = delete;
+
+    static json loadCorpus(const string& corpusFileName);
+
+    int getPort() const { return port; }
+    string getReposApiUrl() const;
+    string getMarkdownApiUrl() const;
+    MockGithubApiCounters getCounters();
+    size_t getConnectionThreadsCount();
+
+private:
+    json corpus;
+    MockGithubApiOptions options;
+    int listeningSocket = -1;
+    int port = 0;
+    atomic<bool> isStopping{false};
+    thread acceptThread;
+    mutex stateMutex; /**< Guards the connections, the random generator and the counters*/
+    vector<thread> connectionThreads;
+    vector<thread::id> finishedConnectionThreads; /**< Joined and removed from connectionThreads on the next accepted connection*/
+    vector<int> connectionSockets;
+    mt19937_64 random;
+    MockGithubApiCounters counters;
+
+    void acceptConnections();
+    void handleConnection(int connectionSocket);
+    string createResponse(const string& method, const string& path, const map<string, string>& headers, const string& body);
+};
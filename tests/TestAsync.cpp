@@ -0,0 +1,201 @@
+#include "doctest.h"
+
+#include "../Async.h"
+
+// The coroutine API is only built with coroutines support (e.g., -std=c++20)
+#if defined(__cpp_impl_coroutine) && !defined(_WIN32)
+
+#include <stdexcept>
+#include <chrono>
+#include <filesystem>
+
+#include <curl/curl.h>
+#include <json.hpp>
+
+#include "TestRepository.h"
+#include "MockGithubApi.h"
+#include "../Subprocess.h"
+#include "../Generator.h"
+#include "../Utils.h"
+#include "../RunContext.h"
+#include "../Config.h"
+
+using namespace nlohmann;
+
+AsyncTask<string> readProgramOutput(vector<string> arguments, EventLoop& loop) {
+    Subprocess program(arguments);
+    setOutputNonBlocking(program.outputFileDescriptor());
+
+    string output;
+    char buffer[64];
+    while (true) {
+        long bytesRead = program.readOutput(buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            output.append(buffer, bytesRead);
+        }
+        else if (bytesRead == 0) {
+            break;
+        }
+        else {
+            co_await loop.waitForOutput(program.outputFileDescriptor());
+        }
+    }
+
+    program.wait();
+    co_return output;
+}
+
+AsyncTask<string> failAfterOutput(EventLoop& loop) {
+    vector<string> arguments = {"sh", "-c", "echo done"};
+    string output = co_await readProgramOutput(arguments, loop);
+    if (!output.empty()) {
+        throw runtime_error("failed after " + output);
+    }
+    co_return output;
+}
+
+TEST_CASE("Testing running coroutines on the event loop") {
+    EventLoop loop(4);
+
+    // The slower program is first, its output must still come first
+    vector<AsyncTask<string>> tasks;
+    tasks.push_back(readProgramOutput({"sh", "-c", "sleep 0.2; echo first"}, loop));
+    tasks.push_back(readProgramOutput({"sh", "-c", "echo second"}, loop));
+    tasks.push_back(readProgramOutput({"sh", "-c", "true"}, loop));
+
+    vector<string> outputs = loop.run(whenAll(move(tasks)));
+    REQUIRE(outputs.size() == 3);
+    CHECK(outputs[0] == "first\n");
+    CHECK(outputs[1] == "second\n");
+    CHECK(outputs[2] == "");
+
+    vector<AsyncTask<string>> failingTasks;
+    failingTasks.push_back(failAfterOutput(loop));
+    failingTasks.push_back(readProgramOutput({"sh", "-c", "echo other"}, loop));
+    CHECK_THROWS_AS(loop.run(whenAll(move(failingTasks))), runtime_error);
+}
+
+TEST_CASE("Testing that the coroutine API generates the same notes as the synchronous API") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    Config config = loadTestConfig();
+    string repositoryDirectory = createTestRepository("release_notes_test_async", {
+        "feat: added X (#1)",
+        "Merge pull request #2 from owner/branch\n\nfeat: added Y",
+        "fix(auth): fixed Z (#3)",
+        "fix: fixed W without a pull request",
+        "Not a conventional commit (#5)"
+    });
+
+    json corpus;
+    for (int i = 1; i <= 5; i++) {
+        corpus["pulls"][to_string(i)] = {{"title", (i % 2 == 0 ? "feat: pull request " : "fix: pull request ") + to_string(i)},
+                                         {"body", "Body of **" + to_string(i) + "** for #" + to_string(i)}};
+    }
+    MockGithubApi mockGithubApi(corpus);
+    config.githubReposApiUrl = mockGithubApi.getReposApiUrl();
+    config.githubMarkdownApiUrl = mockGithubApi.getMarkdownApiUrl();
+    RunContext context(config, "owner/repository", "token", repositoryDirectory);
+    EventLoop loop(4);
+
+    CHECK(loop.run(getPullRequestInfoAsync("3", 10000, loop, context)) == getPullRequestInfo("3", 10000, context));
+    CHECK(loop.run(convertMarkdownToHtmlAsync("**X**", 10000, loop, context)) == convertMarkdownToHtml("**X**", 10000, context));
+    CHECK(loop.run(generateMarkdownPullRequestChangeNoteAsync("2", loop, context)) == generateMarkdownPullRequestChangeNote("2", context));
+
+    for (ReleaseNoteModes mode : {ReleaseNoteModes::Short, ReleaseNoteModes::Full}) {
+        string releaseNotes = renderMarkdownReleaseNotes(buildReleaseNotes(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                                           mode, context), config);
+        ReleaseNotes asyncReleaseNotes = loop.run(buildReleaseNotesAsync(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                                         mode, loop, context));
+        CHECK_FALSE(asyncReleaseNotes.usedCommitSubjects);
+        CHECK_FALSE(asyncReleaseNotes.exceededRequestBudget);
+        CHECK(renderMarkdownReleaseNotes(asyncReleaseNotes, config) == releaseNotes);
+        CHECK(loop.run(generateMarkdownReleaseNotesAsync(ReleaseNoteSources::PullRequests, testStartTag, testEndTag, mode, loop, context))
+              == releaseNotes);
+    }
+    CHECK(loop.run(generateMarkdownReleaseNotesAsync(ReleaseNoteSources::CommitMessages, testStartTag, testEndTag,
+                                                     ReleaseNoteModes::Short, loop, context))
+          == generateMarkdownReleaseNotes(ReleaseNoteSources::CommitMessages, testStartTag, testEndTag, ReleaseNoteModes::Short, context));
+
+    // Replayed responses are complete before they are started, so the event loop resumes their coroutines without libcurl
+    string recordingDirectory = (filesystem::temp_directory_path() / "release_notes_test_async_recording").string();
+    filesystem::remove_all(recordingDirectory);
+    getHttpRecording().startRecording(recordingDirectory);
+    string fullReleaseNotes = generateMarkdownReleaseNotes(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                           ReleaseNoteModes::Full, context);
+    getHttpRecording().stop();
+
+    size_t requestsBeforeReplay = mockGithubApi.getCounters().requests;
+    getHttpRecording().startReplaying(recordingDirectory, true);
+    CHECK(loop.run(generateMarkdownReleaseNotesAsync(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                     ReleaseNoteModes::Full, loop, context)) == fullReleaseNotes);
+    getHttpRecording().stop();
+    CHECK(mockGithubApi.getCounters().requests == requestsBeforeReplay);
+    filesystem::remove_all(recordingDirectory);
+}
+
+TEST_CASE("Testing that the coroutine API generates notes from commit subjects after the time budget or the request budget is used up") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    Config config = loadTestConfig();
+    string repositoryDirectory = createTestRepository("release_notes_test_async_budgets", {
+        "feat: added X (#1)",
+        "feat: added Y (#2)",
+        "fix: fixed Z (#3)"
+    });
+
+    json corpus;
+    for (int i = 1; i <= 3; i++) {
+        corpus["pulls"][to_string(i)] = {{"title", "feat: pull request " + to_string(i)}, {"body", "Body"}};
+    }
+
+    // Every response comes after the deadline, so the requests time out when it is reached and the notes use their commit subjects
+    MockGithubApiOptions slowOptions;
+    slowOptions.latencyMilliseconds = 3000;
+    MockGithubApi slowGithubApi(corpus, slowOptions);
+    Config slowConfig = config;
+    slowConfig.githubReposApiUrl = slowGithubApi.getReposApiUrl();
+    slowConfig.githubMarkdownApiUrl = slowGithubApi.getMarkdownApiUrl();
+    slowConfig.generationTimeBudgetSeconds = 1;
+    RunContext slowContext(slowConfig, "owner/repository", "token", repositoryDirectory);
+    EventLoop loop(4);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ReleaseNotes releaseNotes = loop.run(buildReleaseNotesAsync(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                                ReleaseNoteModes::Full, loop, slowContext));
+    CHECK(chrono::steady_clock::now() - start < chrono::milliseconds(2500));
+    CHECK(releaseNotes.usedCommitSubjects);
+    CHECK_FALSE(releaseNotes.exceededRequestBudget);
+    REQUIRE(releaseNotes.sections.size() == 2);
+    REQUIRE(releaseNotes.sections[0].notes.size() == 2);
+    CHECK(releaseNotes.sections[0].notes[0].title == "Added Y (#2)");
+    CHECK(releaseNotes.sections[0].notes[1].title == "Added X (#1)");
+    CHECK(releaseNotes.sections[1].notes[0].title == "Fixed Z (#3)");
+
+    // Once the deadline is reached no request is sent at all
+    size_t requestsAfterDeadline = slowGithubApi.getCounters().requests;
+    releaseNotes = loop.run(buildReleaseNotesAsync(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                   ReleaseNoteModes::Full, loop, slowContext));
+    CHECK(releaseNotes.usedCommitSubjects);
+    CHECK(slowGithubApi.getCounters().requests == requestsAfterDeadline);
+
+    // The request budget is checked without waiting, so only the first pull request is fetched and the notes come in the same order
+    MockGithubApi githubApi(corpus);
+    Config budgetConfig = config;
+    budgetConfig.githubReposApiUrl = githubApi.getReposApiUrl();
+    budgetConfig.githubMarkdownApiUrl = githubApi.getMarkdownApiUrl();
+    budgetConfig.githubApiRequestBudget = 1;
+    RunContext budgetContext(budgetConfig, "owner/repository", "token", repositoryDirectory);
+
+    releaseNotes = loop.run(buildReleaseNotesAsync(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                   ReleaseNoteModes::Full, loop, budgetContext));
+    CHECK(releaseNotes.exceededRequestBudget);
+    CHECK_FALSE(releaseNotes.usedCommitSubjects);
+    CHECK(githubApi.getCounters().requests == 1);
+    REQUIRE(releaseNotes.sections.size() == 2);
+    REQUIRE(releaseNotes.sections[0].notes.size() == 2);
+    CHECK(releaseNotes.sections[0].notes[0].title == "Pull request 2");
+    CHECK(releaseNotes.sections[0].notes[1].title == "Added X (#1)");
+    REQUIRE(releaseNotes.sections[1].notes.size() == 1);
+    CHECK(releaseNotes.sections[1].notes[0].title == "Fixed Z (#3)");
+}
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "../Format.h"
 #include "../Config.h"
+#include "../RunContext.h"
 
 Config config;
 
@@ -19,41 +20,43 @@ TEST_CASE("Testing the string indenting function") {
 // but in return will decrease the speed of the script, since this will add multiple API requests
 // so I should later on consider if it would be worth it
 TEST_CASE("Testing replacing hash-ids with markdown links function") {
-    config.repoIssuesUrl = "https://github.com/user/repo/issues/";
+    config.githubUrl = "https://github.com/";
+    RunContext context(config, "user/repo", "");
 
-    CHECK(replaceHashIdsWithLinks("") == "");
-    CHECK(replaceHashIdsWithLinks("No issue id here") == "No issue id here");
-    CHECK(replaceHashIdsWithLinks("#1234") == "[#1234](https://github.com/user/repo/issues/1234)");
-    CHECK(replaceHashIdsWithLinks("Fixes #1234 and closes #5678") == "Fixes [#1234](https://github.com/user/repo/issues/1234) and closes [#5678](https://github.com/user/repo/issues/5678)");
-    CHECK(replaceHashIdsWithLinks("Related to #1") == "Related to [#1](https://github.com/user/repo/issues/1)");
-    CHECK(replaceHashIdsWithLinks("Multiple issues: #123, #456, and #789") == "Multiple issues: [#123](https://github.com/user/repo/issues/123), [#456](https://github.com/user/repo/issues/456), and [#789](https://github.com/user/repo/issues/789)");
-    CHECK(replaceHashIdsWithLinks("Not a hash id: #abcd") == "Not a hash id: #abcd");
-    CHECK(replaceHashIdsWithLinks("Very large id #12345678901234567890") == "Very large id [#12345678901234567890](https://github.com/user/repo/issues/12345678901234567890)");
-    CHECK(replaceHashIdsWithLinks("#1234!") == "[#1234](https://github.com/user/repo/issues/1234)!");
-    CHECK(replaceHashIdsWithLinks("Multiple, spaced: #12, #34, #56") == "Multiple, spaced: [#12](https://github.com/user/repo/issues/12), [#34](https://github.com/user/repo/issues/34), [#56](https://github.com/user/repo/issues/56)");
+    CHECK(replaceHashIdsWithLinks("", context) == "");
+    CHECK(replaceHashIdsWithLinks("No issue id here", context) == "No issue id here");
+    CHECK(replaceHashIdsWithLinks("#1234", context) == "[#1234](https://github.com/user/repo/issues/1234)");
+    CHECK(replaceHashIdsWithLinks("Fixes #1234 and closes #5678", context) == "Fixes [#1234](https://github.com/user/repo/issues/1234) and closes [#5678](https://github.com/user/repo/issues/5678)");
+    CHECK(replaceHashIdsWithLinks("Related to #1", context) == "Related to [#1](https://github.com/user/repo/issues/1)");
+    CHECK(replaceHashIdsWithLinks("Multiple issues: #123, #456, and #789", context) == "Multiple issues: [#123](https://github.com/user/repo/issues/123), [#456](https://github.com/user/repo/issues/456), and [#789](https://github.com/user/repo/issues/789)");
+    CHECK(replaceHashIdsWithLinks("Not a hash id: #abcd", context) == "Not a hash id: #abcd");
+    CHECK(replaceHashIdsWithLinks("Very large id #12345678901234567890", context) == "Very large id [#12345678901234567890](https://github.com/user/repo/issues/12345678901234567890)");
+    CHECK(replaceHashIdsWithLinks("#1234!", context) == "[#1234](https://github.com/user/repo/issues/1234)!");
+    CHECK(replaceHashIdsWithLinks("Multiple, spaced: #12, #34, #56", context) == "Multiple, spaced: [#12](https://github.com/user/repo/issues/12), [#34](https://github.com/user/repo/issues/34), [#56](https://github.com/user/repo/issues/56)");
     // The below edge cases my script fails in them, they are very minor cases so I will leave them commented for now
-    //CHECK(replaceHashIdsWithLinks("Mixed #12abc") == "Mixed #12abc");
-    //CHECK(replaceHashIdsWithLinks("#1234#5678") == "[#1234](https://github.com/user/repo/issues/1234)#5678");
-    //CHECK(replaceHashIdsWithLinks("Already linked [#1234](https://github.com/user/repo/issues/1234) and #5678") == "Already linked [#1234](https://github.com/user/repo/issues/1234) and [#5678](https://github.com/user/repo/issues/5678)");
+    //CHECK(replaceHashIdsWithLinks("Mixed #12abc", context) == "Mixed #12abc");
+    //CHECK(replaceHashIdsWithLinks("#1234#5678", context) == "[#1234](https://github.com/user/repo/issues/1234)#5678");
+    //CHECK(replaceHashIdsWithLinks("Already linked [#1234](https://github.com/user/repo/issues/1234) and #5678", context) == "Already linked [#1234](https://github.com/user/repo/issues/1234) and [#5678](https://github.com/user/repo/issues/5678)");
 }
 
 TEST_CASE("Testing replacing commit SHAs with markdown links function") {
-    config.repoCommitsUrl = "https://github.com/user/repo/commit/";
+    config.githubUrl = "https://github.com/";
+    RunContext context(config, "user/repo", "");
 
-    CHECK(replaceCommitShasWithLinks("") == "");
-    CHECK(replaceCommitShasWithLinks("No commit sha here") == "No commit sha here");
-    CHECK(replaceCommitShasWithLinks("Commit 219c2149 fixed the issue") == "Commit [219c21](https://github.com/user/repo/commit/219c2149) fixed the issue");
-    CHECK(replaceCommitShasWithLinks("Fixed by 1234567890abcdef") == "Fixed by [123456](https://github.com/user/repo/commit/1234567890abcdef)");
-    CHECK(replaceCommitShasWithLinks("See commit 1234567 and 89abcdef") == "See commit [123456](https://github.com/user/repo/commit/1234567) and [89abcd](https://github.com/user/repo/commit/89abcdef)");
-    CHECK(replaceCommitShasWithLinks("Multiple commits: 1234567, 89abcdef, and abcdef0123456789") == "Multiple commits: [123456](https://github.com/user/repo/commit/1234567), [89abcd](https://github.com/user/repo/commit/89abcdef), and [abcdef](https://github.com/user/repo/commit/abcdef0123456789)");
-    CHECK(replaceCommitShasWithLinks("(219c2149)") == "([219c21](https://github.com/user/repo/commit/219c2149))");
-    CHECK(replaceCommitShasWithLinks("Commit at start 219c2149 and end abcdef0123456789") == "Commit at start [219c21](https://github.com/user/repo/commit/219c2149) and end [abcdef](https://github.com/user/repo/commit/abcdef0123456789)");
-    CHECK(replaceCommitShasWithLinks("Mix of valid and invalid shas: 12345, 67890abcdef12345") == "Mix of valid and invalid shas: 12345, [67890a](https://github.com/user/repo/commit/67890abcdef12345)");
-    CHECK(replaceCommitShasWithLinks("Already linked [219c2149](https://github.com/user/repo/commit/219c2149) and 89abcdef") == "Already linked [219c2149](https://github.com/user/repo/commit/219c2149) and [89abcd](https://github.com/user/repo/commit/89abcdef)");
-    CHECK(replaceCommitShasWithLinks("Very large SHA 1234567890123456789012345678901234567890") == "Very large SHA [123456](https://github.com/user/repo/commit/1234567890123456789012345678901234567890)");
-    CHECK(replaceCommitShasWithLinks("123456 ") == "[123456](https://github.com/user/repo/commit/123456) ");
-    CHECK(replaceCommitShasWithLinks(" commit 1234567 ") == " commit [123456](https://github.com/user/repo/commit/1234567) ");
-    CHECK(replaceCommitShasWithLinks("219c2149\nAnother line with sha 89abcdef") == "[219c21](https://github.com/user/repo/commit/219c2149)\nAnother line with sha [89abcd](https://github.com/user/repo/commit/89abcdef)");
+    CHECK(replaceCommitShasWithLinks("", context) == "");
+    CHECK(replaceCommitShasWithLinks("No commit sha here", context) == "No commit sha here");
+    CHECK(replaceCommitShasWithLinks("Commit 219c2149 fixed the issue", context) == "Commit [219c21](https://github.com/user/repo/commit/219c2149) fixed the issue");
+    CHECK(replaceCommitShasWithLinks("Fixed by 1234567890abcdef", context) == "Fixed by [123456](https://github.com/user/repo/commit/1234567890abcdef)");
+    CHECK(replaceCommitShasWithLinks("See commit 1234567 and 89abcdef", context) == "See commit [123456](https://github.com/user/repo/commit/1234567) and [89abcd](https://github.com/user/repo/commit/89abcdef)");
+    CHECK(replaceCommitShasWithLinks("Multiple commits: 1234567, 89abcdef, and abcdef0123456789", context) == "Multiple commits: [123456](https://github.com/user/repo/commit/1234567), [89abcd](https://github.com/user/repo/commit/89abcdef), and [abcdef](https://github.com/user/repo/commit/abcdef0123456789)");
+    CHECK(replaceCommitShasWithLinks("(219c2149)", context) == "([219c21](https://github.com/user/repo/commit/219c2149))");
+    CHECK(replaceCommitShasWithLinks("Commit at start 219c2149 and end abcdef0123456789", context) == "Commit at start [219c21](https://github.com/user/repo/commit/219c2149) and end [abcdef](https://github.com/user/repo/commit/abcdef0123456789)");
+    CHECK(replaceCommitShasWithLinks("Mix of valid and invalid shas: 12345, 67890abcdef12345", context) == "Mix of valid and invalid shas: 12345, [67890a](https://github.com/user/repo/commit/67890abcdef12345)");
+    CHECK(replaceCommitShasWithLinks("Already linked [219c2149](https://github.com/user/repo/commit/219c2149) and 89abcdef", context) == "Already linked [219c2149](https://github.com/user/repo/commit/219c2149) and [89abcd](https://github.com/user/repo/commit/89abcdef)");
+    CHECK(replaceCommitShasWithLinks("Very large SHA 1234567890123456789012345678901234567890", context) == "Very large SHA [123456](https://github.com/user/repo/commit/1234567890123456789012345678901234567890)");
+    CHECK(replaceCommitShasWithLinks("123456 ", context) == "[123456](https://github.com/user/repo/commit/123456) ");
+    CHECK(replaceCommitShasWithLinks(" commit 1234567 ", context) == " commit [123456](https://github.com/user/repo/commit/1234567) ");
+    CHECK(replaceCommitShasWithLinks("219c2149\nAnother line with sha 89abcdef", context) == "[219c21](https://github.com/user/repo/commit/219c2149)\nAnother line with sha [89abcd](https://github.com/user/repo/commit/89abcdef)");
 }
 
 TEST_CASE("Testing converting conventional commit title to release note title function") {
@@ -70,4 +73,37 @@ TEST_CASE("Testing converting conventional commit title to release note title fu
     // Edge cases
     CHECK(convertConventionalCommitTitleToReleaseNoteTitle("", CommitTypeMatchResults::MatchWithoutSubCategory, "### ") == "### \n");
     CHECK(convertConventionalCommitTitleToReleaseNoteTitle("fix: ", CommitTypeMatchResults::MatchWithoutSubCategory, "### ") == "### \n");
-}
\ No newline at end of file
+    CHECK(convertConventionalCommitTitleToReleaseNoteTitle("fix:", CommitTypeMatchResults::MatchWithoutSubCategory, "### ") == "### \n");
+    CHECK(convertConventionalCommitTitleToReleaseNoteTitle("fix(auth):", CommitTypeMatchResults::MatchWithSubCategory, "### ") == "### (Auth Related) \n");
+}
+
+TEST_CASE("Testing extracting the pull request title and number from a commit message function") {
+    string title, number;
+
+    // Squash merges
+    CHECK(extractLocalPullRequestTitle("fix: fixed bug X (#123)", "", title, number));
+    CHECK(title == "fix: fixed bug X");
+    CHECK(number == "123");
+    CHECK(extractLocalPullRequestTitle("feat(UI): added (new) button (#7)", "Body", title, number));
+    CHECK(title == "feat(UI): added (new) button");
+    CHECK(number == "7");
+
+    // Merge commits
+    CHECK(extractLocalPullRequestTitle("Merge pull request #3722 from user/branch", "fix(auth): fixed bug X\r", title, number));
+    CHECK(title == "fix(auth): fixed bug X");
+    CHECK(number == "3722");
+
+    // Merge commits without a body still give the number
+    number = "";
+    CHECK_FALSE(extractLocalPullRequestTitle("Merge pull request #44 from user/branch", "", title, number));
+    CHECK(number == "44");
+
+    // Commits that don't have a pull request title
+    CHECK_FALSE(extractLocalPullRequestTitle("fix: fixed bug X", "", title, number));
+    CHECK_FALSE(extractLocalPullRequestTitle("fix: fixed bug #123", "", title, number));
+    CHECK_FALSE(extractLocalPullRequestTitle("fix: fixed bug X (#12a)", "", title, number));
+    CHECK_FALSE(extractLocalPullRequestTitle("fix: fixed bug X (#)", "", title, number));
+    CHECK_FALSE(extractLocalPullRequestTitle(" (#12)", "", title, number));
+    CHECK_FALSE(extractLocalPullRequestTitle("Merge pull request from user/branch", "fix: fixed bug X", title, number));
+    CHECK_FALSE(extractLocalPullRequestTitle("", "", title, number));
+}
@@ -0,0 +1,67 @@
+#include "doctest.h"
+
+#include <string>
+#include <unistd.h>
+
+#include "../GitLog.h"
+
+// Writes the given git log output in a pipe and returns the reading end of it
+int createGitLogOutputPipe(const string& gitLogOutput) {
+    int pipeFileDescriptors[2];
+    REQUIRE(pipe(pipeFileDescriptors) == 0);
+    REQUIRE(write(pipeFileDescriptors[1], gitLogOutput.data(), gitLogOutput.size()) == (long)gitLogOutput.size());
+    close(pipeFileDescriptors[1]);
+    return pipeFileDescriptors[0];
+}
+
+TEST_CASE("Testing parsing a single git log commit record") {
+    CommitRecord record = parseCommitRecord("219c2149\nfix: fixed bug X\n\nLonger description\nSecond line\n");
+    CHECK(record.sha == "219c2149");
+    CHECK(record.subject == "fix: fixed bug X");
+    CHECK(record.body == "Longer description\nSecond line");
+
+    record = parseCommitRecord("219c2149\nfeat: added feature Y\n");
+    CHECK(record.subject == "feat: added feature Y");
+    CHECK(record.body == "");
+
+    record = parseCommitRecord("219c2149");
+    CHECK(record.sha == "219c2149");
+    CHECK(record.subject == "");
+    CHECK(record.body == "");
+}
+
+TEST_CASE("Testing reading git log commit records that are longer than a block") {
+    string longSubject = "fix: " + string(500, 'x');
+    int fileDescriptor = createGitLogOutputPipe("aaa\n" + longSubject + "\n\nBody\n" + '\0' + "bbb\nfeat: added feature Y\n" + '\0');
+
+    // Using a tiny block size to force records to be split between reads
+    GitLogReader reader(fileDescriptor, 16);
+    CommitRecord record;
+
+    REQUIRE(reader.nextRecord(record));
+    CHECK(record.sha == "aaa");
+    CHECK(record.subject == longSubject);
+    CHECK(record.body == "Body");
+
+    REQUIRE(reader.nextRecord(record));
+    CHECK(record.sha == "bbb");
+    CHECK(record.subject == "feat: added feature Y");
+
+    CHECK_FALSE(reader.nextRecord(record));
+    close(fileDescriptor);
+}
+
+TEST_CASE("Testing reading git log output that has no records or an unterminated last record") {
+    int fileDescriptor = createGitLogOutputPipe("");
+    GitLogReader emptyReader(fileDescriptor);
+    CommitRecord record;
+    CHECK_FALSE(emptyReader.nextRecord(record));
+    close(fileDescriptor);
+
+    fileDescriptor = createGitLogOutputPipe("ccc\ndocs: updated README");
+    GitLogReader reader(fileDescriptor);
+    REQUIRE(reader.nextRecord(record));
+    CHECK(record.subject == "docs: updated README");
+    CHECK_FALSE(reader.nextRecord(record));
+    close(fileDescriptor);
+}
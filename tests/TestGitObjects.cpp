@@ -0,0 +1,86 @@
+#include "doctest.h"
+
+#include "TestRepository.h"
+#include "../GitObjects.h"
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+TEST_CASE("Testing looking up git objects through git cat-file") {
+    string repositoryDirectory = createTestRepository("release_notes_test_git_objects", {"feat: added X", "fix: fixed Y"});
+    GitCatFile gitObjects(false, repositoryDirectory);
+
+    vector<GitObjectInfo> objects = gitObjects.lookup({testStartTag, "missing-tag", "a b missing", "x commit 12", testEndTag});
+    REQUIRE(objects.size() == 5);
+    CHECK(objects[0].exists);
+    CHECK(objects[0].type == "commit");
+    CHECK(objects[0].sha.size() == 40);
+    CHECK(objects[0].name == testStartTag);
+
+    // Names with spaces, even ones that look like a response, are answered with "<name> missing"
+    CHECK_FALSE(objects[1].exists);
+    CHECK_FALSE(objects[2].exists);
+    CHECK(objects[2].name == "a b missing");
+    CHECK_FALSE(objects[3].exists);
+    CHECK(objects[4].exists);
+    CHECK(objects[4].sha != objects[0].sha);
+    string endSha = objects[4].sha;
+
+    // The lookups of a single process answer many names, more than fit in a chunk written to git
+    vector<string> objectNames;
+    for (int i = 0; i < 2000; i++) {
+        objectNames.push_back(i % 2 ? testEndTag + "~1" : "missing-object-with-a-long-name-" + to_string(i));
+    }
+    objects = gitObjects.lookup(objectNames);
+    REQUIRE(objects.size() == 2000);
+    CHECK_FALSE(objects[0].exists);
+    CHECK(objects[1].exists);
+    CHECK(objects[1999].sha == objects[1].sha);
+
+    CHECK(gitObjects.lookup(testEndTag).sha == endSha);
+    CHECK_THROWS_AS(gitObjects.lookup("a\nb"), invalid_argument);
+}
+
+TEST_CASE("Testing looking up the contents of git objects") {
+    string repositoryDirectory = createTestRepository("release_notes_test_git_objects_contents", {"feat: added X"});
+    GitCatFile gitObjects(true, repositoryDirectory);
+
+    vector<GitObjectInfo> objects = gitObjects.lookup({testEndTag, "missing-tag", testEndTag + "^{tree}"});
+    REQUIRE(objects.size() == 3);
+    CHECK(objects[0].contents.size() == objects[0].size);
+    CHECK(objects[0].contents.find("\n\nfeat: added X") != string::npos);
+    CHECK_FALSE(objects[1].exists);
+    CHECK(objects[1].contents.empty());
+    CHECK(objects[2].type == "tree");
+}
+
+TEST_CASE("Testing looking up git objects through the git processes kept for each repository") {
+    string firstRepositoryDirectory = createTestRepository("release_notes_test_git_objects_pool_first", {"feat: added X"});
+    string secondRepositoryDirectory = createTestRepository("release_notes_test_git_objects_pool_second", {"fix: fixed Y"});
+    GitCatFilePool gitObjects(2);
+
+    vector<GitObjectInfo> firstObjects = gitObjects.lookup(firstRepositoryDirectory, {testEndTag, "missing-tag"});
+    vector<GitObjectInfo> secondObjects = gitObjects.lookup(secondRepositoryDirectory, {testEndTag});
+    REQUIRE(firstObjects.size() == 2);
+    CHECK(firstObjects[0].exists);
+    CHECK_FALSE(firstObjects[1].exists);
+    CHECK(secondObjects[0].exists);
+    CHECK(secondObjects[0].sha != firstObjects[0].sha);
+    CHECK(gitObjects.lookup(firstRepositoryDirectory, {testEndTag})[0].sha == firstObjects[0].sha);
+
+    // A repository created again in the same directory isn't seen by the process that was started before, so it is replaced
+    createTestRepository("release_notes_test_git_objects_pool_first", {"feat: added Z"});
+    vector<GitObjectInfo> recreatedObjects = gitObjects.lookup(firstRepositoryDirectory, {testEndTag});
+    CHECK(recreatedObjects[0].exists);
+    CHECK(recreatedObjects[0].sha != firstObjects[0].sha);
+
+    // Only the processes of the last two repositories are kept, the least recently used one is closed for a third repository
+    string thirdRepositoryDirectory = createTestRepository("release_notes_test_git_objects_pool_third", {"docs: documented W"});
+    CHECK(gitObjects.getRepositoriesCount() == 2);
+    CHECK(gitObjects.lookup(thirdRepositoryDirectory, {testEndTag})[0].exists);
+    CHECK(gitObjects.getRepositoriesCount() == 2);
+    CHECK(gitObjects.lookup(secondRepositoryDirectory, {testEndTag})[0].sha == secondObjects[0].sha);
+    CHECK(gitObjects.lookup(firstRepositoryDirectory, {testEndTag})[0].sha == recreatedObjects[0].sha);
+    CHECK(gitObjects.getRepositoriesCount() == 2);
+}
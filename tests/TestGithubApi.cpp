@@ -0,0 +1,200 @@
+#include "doctest.h"
+
+#include "MockGithubApi.h"
+#include "../Utils.h"
+#include "../Config.h"
+#include "../RunContext.h"
+#include "../Http.h"
+
+#include <stdexcept>
+#include <filesystem>
+#include <memory>
+#include <chrono>
+#include <cstring>
+
+#include <curl/curl.h>
+#include <json.hpp>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+using namespace nlohmann;
+
+static Config createGithubApiConfig(const MockGithubApi& mockGithubApi) {
+    Config config;
+    config.githubUrl = "https://github.com/";
+    config.githubReposApiUrl = mockGithubApi.getReposApiUrl();
+    config.githubMarkdownApiUrl = mockGithubApi.getMarkdownApiUrl();
+    config.githubApiRequestTimeoutSeconds = 10;
+    config.githubApiCacheMaxEntries = 100;
+    config.githubApiRateLimitExceededError = "rate limit exceeded: ";
+    return config;
+}
+
+static json createGithubApiCorpus() {
+    json corpus;
+    corpus["pulls"]["13"] = {{"title", "feat: added X"}, {"body", "Fixes #12"}};
+    corpus["markdown"]["**X**"] = "<p><strong>X</strong></p>";
+    return corpus;
+}
+
+/**
+ * @brief Sends a raw request to the mock on a new connection and reads the response until the mock closes the connection
+ */
+static string sendRawRequest(const MockGithubApi& mockGithubApi, const string& request) {
+    int connectionSocket = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(mockGithubApi.getPort());
+    string response;
+    if (connect(connectionSocket, (sockaddr*)&address, sizeof(address)) == 0
+        && write(connectionSocket, request.data(), request.size()) == (ssize_t)request.size()) {
+        char buffer[4096];
+        ssize_t bytesRead;
+        while ((bytesRead = read(connectionSocket, buffer, sizeof(buffer))) > 0) {
+            response.append(buffer, bytesRead);
+        }
+    }
+    close(connectionSocket);
+    return response;
+}
+
+TEST_CASE("Testing retrieving pull requests from the mock GitHub API") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    MockGithubApi mockGithubApi(createGithubApiCorpus());
+    Config config = createGithubApiConfig(mockGithubApi);
+    RunContext context(config, "owner/repository", "token");
+
+    json pullRequestInfo = parsePullRequestInfo(getPullRequestInfo("13", 10000, context));
+    CHECK(pullRequestInfo["title"] == "feat: added X");
+    CHECK(pullRequestInfo["body"] == "Fixes #12");
+    CHECK(pullRequestInfo["number"] == 13);
+
+    // The second request sends the ETag of the first response, so it is answered with 304 and the cached body is used
+    CHECK(parsePullRequestInfo(getPullRequestInfo("13", 10000, context))["title"] == "feat: added X");
+    MockGithubApiCounters counters = mockGithubApi.getCounters();
+    CHECK(counters.connections == 1);
+    CHECK(counters.requests == 2);
+    CHECK(counters.pullRequests == 1);
+    CHECK(counters.notModified == 1);
+
+    CHECK_THROWS_AS(getPullRequestInfo("14", 10000, context), runtime_error);
+    CHECK(mockGithubApi.getCounters().notFound == 1);
+}
+
+TEST_CASE("Testing converting markdown to HTML with the mock GitHub API") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    MockGithubApi mockGithubApi(createGithubApiCorpus());
+    Config config = createGithubApiConfig(mockGithubApi);
+    RunContext context(config, "owner/repository", "token");
+
+    CHECK(convertMarkdownToHtml("**X**", 1000, context) == "<p><strong>X</strong></p>");
+    CHECK(convertMarkdownToHtml("Not in the corpus", 1000, context).find("Not in the corpus") != string::npos);
+    CHECK(mockGithubApi.getCounters().markdown == 2);
+}
+
+TEST_CASE("Testing the faults injected by the mock GitHub API") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    MockGithubApiOptions rateLimitedOptions;
+    rateLimitedOptions.rateLimitRate = 1;
+    MockGithubApi rateLimitedGithubApi(createGithubApiCorpus(), rateLimitedOptions);
+    Config rateLimitedConfig = createGithubApiConfig(rateLimitedGithubApi);
+    RunContext rateLimitedContext(rateLimitedConfig, "owner/repository", "token");
+    string rateLimitError;
+    try {
+        getPullRequestInfo("13", 10000, rateLimitedContext);
+    }
+    catch (const runtime_error& e) {
+        rateLimitError = e.what();
+    }
+    CHECK(rateLimitError.find("rate limit exceeded") == 0);
+    CHECK(rateLimitedGithubApi.getCounters().rateLimited == 1);
+
+    MockGithubApiOptions serverErrorOptions;
+    serverErrorOptions.serverErrorRate = 1;
+    MockGithubApi failingGithubApi(createGithubApiCorpus(), serverErrorOptions);
+    Config failingConfig = createGithubApiConfig(failingGithubApi);
+    RunContext failingContext(failingConfig, "owner/repository", "token");
+    for (int i = 0; i < 4; i++) {
+        CHECK_THROWS_AS(getPullRequestInfo("13", 10000, failingContext), runtime_error);
+    }
+    CHECK(failingGithubApi.getCounters().serverErrors == 4);
+
+    MockGithubApiOptions generatingOptions;
+    generatingOptions.isGeneratingMissingPullRequests = true;
+    generatingOptions.latencyMilliseconds = 20;
+    generatingOptions.jitterMilliseconds = 10;
+    MockGithubApi generatingGithubApi(json::object(), generatingOptions);
+    Config generatingConfig = createGithubApiConfig(generatingGithubApi);
+    RunContext generatingContext(generatingConfig, "owner/repository", "token");
+    CHECK(parsePullRequestInfo(getPullRequestInfo("123456", 10000, generatingContext))["title"] == "feat: synthetic pull request 123456");
+}
+
+TEST_CASE("Testing recording and replaying the GitHub API requests") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    string recordingDirectory = (filesystem::temp_directory_path() / "release_notes_test_recording").string();
+    filesystem::remove_all(recordingDirectory);
+
+    MockGithubApiOptions options;
+    options.latencyMilliseconds = 50;
+    unique_ptr<MockGithubApi> mockGithubApi = make_unique<MockGithubApi>(createGithubApiCorpus(), options);
+    Config config = createGithubApiConfig(*mockGithubApi);
+    RunContext context(config, "owner/repository", "token");
+
+    getHttpRecording().startRecording(recordingDirectory);
+    string pullRequestInfo = getPullRequestInfo("13", 10000, context);
+    string html = convertMarkdownToHtml("**X**", 1000, context);
+    getHttpRecording().stop();
+    CHECK(mockGithubApi->getCounters().requests == 2);
+
+    // The replayed responses can't come from the mock once it is stopped
+    mockGithubApi.reset();
+    getHttpRecording().startReplaying(recordingDirectory, true);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    CHECK(getPullRequestInfo("13", 10000, context) == pullRequestInfo);
+    CHECK(chrono::steady_clock::now() - start < chrono::milliseconds(50));
+    CHECK_THROWS_AS(getPullRequestInfo("14", 10000, context), runtime_error);
+    getHttpRecording().stop();
+
+    // Without the instant replay, replayed requests take as long as the recorded ones
+    getHttpRecording().startReplaying(recordingDirectory, false);
+    start = chrono::steady_clock::now();
+    CHECK(getGithubApiClient().perform(createMarkdownToHtmlRequest("**X**", 1000, context)).body == html);
+    CHECK(chrono::steady_clock::now() - start >= chrono::milliseconds(50));
+    getHttpRecording().stop();
+
+    filesystem::remove_all(recordingDirectory);
+}
+
+TEST_CASE("Testing that the mock GitHub API answers invalid requests with errors and joins the threads of closed connections") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    MockGithubApi mockGithubApi(createGithubApiCorpus());
+
+    auto createMarkdownRequest = [](const string& contentLength, const string& body) {
+        return "POST /markdown HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\nContent-Length: " + contentLength + "\r\n\r\n" + body;
+    };
+    CHECK(sendRawRequest(mockGithubApi, createMarkdownRequest("12abc", "")).compare(0, 12, "HTTP/1.1 400") == 0);
+    CHECK(sendRawRequest(mockGithubApi, createMarkdownRequest("99999999999999999999999", "")).compare(0, 12, "HTTP/1.1 400") == 0);
+    CHECK(sendRawRequest(mockGithubApi, createMarkdownRequest("3", "[1]")).compare(0, 12, "HTTP/1.1 400") == 0);
+    CHECK(sendRawRequest(mockGithubApi, createMarkdownRequest("10", "{\"text\":5}")).compare(0, 12, "HTTP/1.1 400") == 0);
+    CHECK(sendRawRequest(mockGithubApi, "GET /repos/owner/repository/pulls/99999999999999999999999 HTTP/1.1\r\nConnection: close\r\n\r\n")
+              .compare(0, 12, "HTTP/1.1 404") == 0);
+    CHECK(mockGithubApi.getCounters().badRequests == 4);
+
+    // The mock still answers after the invalid requests
+    Config config = createGithubApiConfig(mockGithubApi);
+    RunContext context(config, "owner/repository", "token");
+    CHECK(convertMarkdownToHtml("**X**", 1000, context) == "<p><strong>X</strong></p>");
+
+    // Each accepted connection joins the threads of the connections closed before it, so only the last one
+    // and the connection that the GitHub API client keeps alive are left
+    for (int i = 0; i < 20; i++) {
+        sendRawRequest(mockGithubApi, "GET /repos/owner/repository/pulls/13 HTTP/1.1\r\nConnection: close\r\n\r\n");
+    }
+    CHECK(mockGithubApi.getConnectionThreadsCount() <= 2);
+}
@@ -0,0 +1,44 @@
+#include "doctest.h"
+
+#include "../Http.h"
+
+#include <string>
+
+#include <json.hpp>
+
+using namespace nlohmann;
+
+TEST_CASE("Testing the summary of the network metrics") {
+    HttpTelemetry telemetry;
+    for (int i = 1; i <= 20; i++) {
+        HttpRequestMetrics metrics;
+        metrics.url = "https://api.github.com/repos/o/r/pulls/" + to_string(i);
+        metrics.httpCode = (i == 20) ? 304 : 200;
+        metrics.httpVersion = "2";
+        metrics.isConnectionReused = (i > 1);
+        metrics.totalMilliseconds = i;
+        metrics.responseBytes = 100;
+        metrics.rateLimitRemaining = 5000 - i;
+        telemetry.record(metrics);
+    }
+
+    json stats = json::parse(telemetry.createJsonStats());
+    CHECK(stats["summary"]["requests"] == 20);
+    CHECK(stats["summary"]["reusedConnections"] == 19);
+    CHECK(stats["summary"]["cacheHits"] == 1);
+    CHECK(stats["summary"]["responseBytes"] == 2000);
+    CHECK(stats["summary"]["lowestRateLimitRemaining"] == 4980);
+    CHECK(stats["summary"]["httpVersions"]["2"] == 20);
+    CHECK(stats["summary"]["statuses"]["304"] == 1);
+    CHECK(stats["summary"]["timings"]["totalMs"]["p50"] == 10.0);
+    CHECK(stats["summary"]["timings"]["totalMs"]["p95"] == 19.0);
+    CHECK(stats["requests"].size() == 20);
+    CHECK(stats["requests"][0]["connectionReused"] == false);
+
+    string summary = telemetry.createSummary();
+    CHECK(summary.find("20 requests, 19 on reused connections, 1 answered from the cache (304)") != string::npos);
+    CHECK(summary.find("Lowest rate limit remaining: 4980") != string::npos);
+
+    // Without any request only the counts are printed
+    CHECK(HttpTelemetry().createSummary() == "0 requests, 0 on reused connections, 0 answered from the cache (304), 0 bytes received\n");
+}
@@ -0,0 +1,134 @@
+#include "doctest.h"
+
+#include "TestRepository.h"
+#include "MockGithubApi.h"
+#include "../Manifest.h"
+#include "../ThreadPool.h"
+#include "../Config.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <stdexcept>
+
+#include <curl/curl.h>
+#include <json.hpp>
+
+using namespace nlohmann;
+
+// Writes the given manifest in the temporary directory and returns its path
+static string writeTestManifest(const string& name, const string& manifestText) {
+    string manifestFileName = (filesystem::temp_directory_path() / name).string();
+    ofstream manifestFile(manifestFileName);
+    manifestFile << manifestText;
+    return manifestFileName;
+}
+
+static string readTestFile(const string& fileName) {
+    ifstream file(fileName);
+    stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE("Testing loading a manifest") {
+    Config config = loadTestConfig();
+    json manifestData = {
+        {"concurrentRepositories", 2},
+        {"repositories", {
+            {{"directory", "../a"}, {"start", "v1.0"}, {"end", "v1.1"}, {"source", "message"}},
+            {{"directory", "../b"}, {"repo", "owner/b"}, {"start", "v2.0"}, {"end", "HEAD"}, {"source", "Pull Requests"},
+             {"mode", "Full"}, {"outputDirectory", "notes/b"}}
+        }}
+    };
+    Manifest manifest = loadManifest(writeTestManifest("release_notes_test_manifest.json", manifestData.dump()), config);
+
+    CHECK(manifest.concurrentRepositories == 2);
+    REQUIRE(manifest.entries.size() == 2);
+    CHECK(manifest.entries[0].directory == "../a");
+    CHECK(manifest.entries[0].releaseStartRef == "v1.0");
+    CHECK(manifest.entries[0].releaseEndRef == "v1.1");
+    CHECK(manifest.entries[0].releaseNoteSource == ReleaseNoteSources::CommitMessages);
+    CHECK(manifest.entries[0].githubRepository.empty());
+    CHECK(manifest.entries[0].outputDirectory == "../a"); // The notes are written in the repository by default
+    CHECK(manifest.entries[1].githubRepository == "owner/b");
+    CHECK(manifest.entries[1].releaseNoteSource == ReleaseNoteSources::PullRequests);
+    CHECK(manifest.entries[1].releaseNoteMode == ReleaseNoteModes::Full);
+    CHECK(manifest.entries[1].outputDirectory == "notes/b");
+
+    manifestData.erase("concurrentRepositories");
+    CHECK(loadManifest(writeTestManifest("release_notes_test_manifest.json", manifestData.dump()), config).concurrentRepositories == 8);
+}
+
+TEST_CASE("Testing loading malformed manifests") {
+    Config config = loadTestConfig();
+    json entry = {{"directory", "../b"}, {"repo", "owner/b"}, {"start", "v2.0"}, {"end", "HEAD"}, {"source", "prs"}, {"mode", "short"}};
+    auto loadEntry = [&](const json& repository) {
+        return loadManifest(writeTestManifest("release_notes_test_manifest_malformed.json",
+                                              json({{"repositories", {repository}}}).dump()), config);
+    };
+    CHECK_NOTHROW(loadEntry(entry));
+
+    for (const char* key : {"directory", "start", "end", "source", "mode", "repo"}) {
+        json incompleteEntry = entry;
+        incompleteEntry.erase(key);
+        CHECK_THROWS_AS(loadEntry(incompleteEntry), runtime_error);
+    }
+
+    json wrongSourceEntry = entry;
+    wrongSourceEntry["source"] = "issues";
+    CHECK_THROWS_AS(loadEntry(wrongSourceEntry), invalid_argument);
+    json wrongModeEntry = entry;
+    wrongModeEntry["mode"] = "long";
+    CHECK_THROWS_AS(loadEntry(wrongModeEntry), invalid_argument);
+
+    CHECK_THROWS_AS(loadManifest(writeTestManifest("release_notes_test_manifest_malformed.json",
+                                                   json({{"concurrentRepositories", 0}, {"repositories", {entry}}}).dump()), config),
+                    invalid_argument);
+    CHECK_THROWS_AS(loadManifest(writeTestManifest("release_notes_test_manifest_malformed.json", "{\"repositories\": ["), config),
+                    runtime_error);
+    CHECK_THROWS_AS(loadManifest(writeTestManifest("release_notes_test_manifest_malformed.json", "{}"), config), runtime_error);
+    CHECK_THROWS_AS(loadManifest("release_notes_test_missing_manifest.json", config), runtime_error);
+}
+
+TEST_CASE("Testing that the repositories of a manifest share one request budget") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    Config config = loadTestConfig();
+
+    json corpus;
+    json repositories = json::array();
+    for (string name : {"a", "b"}) {
+        vector<string> commitMessages;
+        for (int i = 1; i <= 3; i++) {
+            string pullRequestNumber = to_string(name == "a" ? i : 10 + i);
+            commitMessages.push_back("feat: added " + name + to_string(i) + " (#" + pullRequestNumber + ")");
+            corpus["pulls"][pullRequestNumber] = {{"title", "feat: added " + name + to_string(i)}, {"body", "Body"}};
+        }
+        string repositoryDirectory = createTestRepository("release_notes_test_manifest_" + name, commitMessages);
+        repositories.push_back({{"directory", repositoryDirectory}, {"repo", "owner/" + name}, {"start", testStartTag},
+                                {"end", testEndTag}, {"source", "prs"}, {"mode", "full"}});
+    }
+
+    MockGithubApi mockGithubApi(corpus);
+    config.githubReposApiUrl = mockGithubApi.getReposApiUrl();
+    config.githubMarkdownApiUrl = mockGithubApi.getMarkdownApiUrl();
+    config.outputFormats = {"markdown"};
+    config.githubApiRequestBudget = 4;
+
+    Manifest manifest = loadManifest(writeTestManifest("release_notes_test_manifest_budget.json",
+                                                       json({{"repositories", repositories}}).dump()), config);
+    ThreadPool workers(2);
+    CHECK(generateManifestReleaseNotes(manifest, "token", workers, config));
+
+    // The 6 pull requests of both repositories only get the 4 requests of the budget, the other notes use their commit subjects
+    CHECK(mockGithubApi.getCounters().requests == 4);
+    for (const ManifestEntry& entry : manifest.entries) {
+        string releaseNotes = readTestFile((filesystem::path(entry.outputDirectory) / config.markdownOutputFileName).string());
+        string name = entry.githubRepository.substr(entry.githubRepository.size() - 1);
+        for (int i = 1; i <= 3; i++) {
+            CHECK(releaseNotes.find("Added " + name + to_string(i)) != string::npos);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#include "doctest.h"
+
+#include "../Memory.h"
+#include "../Profiler.h"
+
+#include <vector>
+
+TEST_CASE("Testing the memory accounting of the phases") {
+    MemoryAccounting& memoryAccounting = getMemoryAccounting();
+    memoryAccounting.enable();
+    MemoryCounters jsonParseBefore = memoryAccounting.getPhaseCounters((int)ProfilePhases::JsonParse);
+    MemoryCounters formatNoteBefore = memoryAccounting.getPhaseCounters((int)ProfilePhases::FormatNote);
+
+    vector<char>* block;
+    {
+        ProfileScope formatTimer(ProfilePhases::FormatNote);
+        block = new vector<char>(100000);
+        {
+            // Allocations of nested phases are only counted in the innermost one
+            ProfileScope parseTimer(ProfilePhases::JsonParse);
+            json pullRequestInfo = json::parse(R"({"title": "feat: added X", "body": "Fixes #12", "labels": ["a", "b"]})");
+        }
+    }
+    long long liveBytes = memoryAccounting.getLiveBytes();
+    delete block;
+
+    MemoryCounters jsonParse = memoryAccounting.getPhaseCounters((int)ProfilePhases::JsonParse);
+    MemoryCounters formatNote = memoryAccounting.getPhaseCounters((int)ProfilePhases::FormatNote);
+    CHECK(jsonParse.allocations > jsonParseBefore.allocations);
+    CHECK(jsonParse.freedBytes - jsonParseBefore.freedBytes == jsonParse.allocatedBytes - jsonParseBefore.allocatedBytes);
+    CHECK(formatNote.allocations - formatNoteBefore.allocations == 2);
+    CHECK(formatNote.allocatedBytes - formatNoteBefore.allocatedBytes >= 100000);
+    CHECK(memoryAccounting.getLiveBytes() <= liveBytes - 100000);
+    CHECK(memoryAccounting.getPeakLiveBytes() >= liveBytes);
+
+    json report = json::parse(memoryAccounting.createJsonReport());
+    CHECK(report["peakResidentBytes"] > 0);
+    CHECK(report["allocations"] >= jsonParse.allocations + formatNote.allocations);
+    CHECK(memoryAccounting.createTableReport().find("json parse") != string::npos);
+}
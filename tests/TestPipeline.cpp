@@ -0,0 +1,251 @@
+#include "doctest.h"
+
+#include "TestRepository.h"
+#include "MockGithubApi.h"
+#include "../BoundedQueue.h"
+#include "../Pipeline.h"
+#include "../RunContext.h"
+#include "../ReleaseNotes.h"
+#include "../Config.h"
+
+#include <atomic>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+#include <curl/curl.h>
+#include <json.hpp>
+
+using namespace nlohmann;
+
+TEST_CASE("Testing the order and the capacity of the bounded queue") {
+    BoundedQueue<int> queue(2);
+    atomic<int> pushedItems{0};
+
+    thread producer([&]() {
+        for (int i = 1; i <= 3; i++) {
+            queue.push(i);
+            pushedItems++;
+        }
+    });
+
+    // The third item waits until there is room for it
+    this_thread::sleep_for(chrono::milliseconds(50));
+    CHECK(pushedItems == 2);
+
+    int item = 0;
+    REQUIRE(queue.pop(item));
+    CHECK(item == 1);
+    producer.join();
+    CHECK(pushedItems == 3);
+
+    // Items pushed before closing can still be popped, in order
+    queue.close();
+    CHECK_FALSE(queue.push(4));
+    REQUIRE(queue.pop(item));
+    CHECK(item == 2);
+    REQUIRE(queue.pop(item));
+    CHECK(item == 3);
+    CHECK_FALSE(queue.pop(item));
+
+    // Canceling drops the items that weren't popped
+    BoundedQueue<int> canceledQueue(4);
+    canceledQueue.push(1);
+    canceledQueue.push(2);
+    canceledQueue.cancel();
+    CHECK_FALSE(canceledQueue.pop(item));
+}
+
+TEST_CASE("Testing that the pipeline keeps the notes in the order of git log") {
+    Config config = loadTestConfig();
+    vector<string> commitMessages;
+    for (int i = 1; i <= 30; i++) {
+        commitMessages.push_back((i % 3 == 0 ? "fix: fixed bug " : "feat: added feature ") + to_string(i));
+    }
+    commitMessages.push_back("Not a conventional commit");
+    string repositoryDirectory = createTestRepository("release_notes_test_pipeline_order", commitMessages);
+
+    RunContext context(config, "owner/repository", "", repositoryDirectory);
+    ReleaseNotes releaseNotes = ReleaseNotesPipeline(ReleaseNoteSources::CommitMessages, testStartTag, testEndTag,
+                                                     ReleaseNoteModes::Short, context).run();
+
+    REQUIRE(releaseNotes.sections.size() == 2);
+    CHECK(releaseNotes.sections[0].type == "feat");
+    CHECK(releaseNotes.sections[1].type == "fix");
+    REQUIRE(releaseNotes.sections[0].notes.size() == 20);
+    REQUIRE(releaseNotes.sections[1].notes.size() == 10);
+
+    // git log lists the newest commits first
+    CHECK(releaseNotes.sections[0].notes[0].title == "Added feature 29");
+    CHECK(releaseNotes.sections[0].notes[19].title == "Added feature 1");
+    for (size_t i = 0; i < 10; i++) {
+        CHECK(releaseNotes.sections[1].notes[i].title == "Fixed bug " + to_string(30 - 3 * i));
+    }
+
+    // References that git log would read as options are rejected
+    CHECK_THROWS_AS(createGitLogArguments(ReleaseNoteSources::CommitMessages, "--output=notes", testEndTag, 0, config), invalid_argument);
+    CHECK_THROWS_AS(createGitLogArguments(ReleaseNoteSources::CommitMessages, testStartTag, "-p", 0, config), invalid_argument);
+}
+
+TEST_CASE("Testing that the pipeline stops sending requests after an error") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    Config config = loadTestConfig();
+    vector<string> commitMessages;
+    for (int i = 1; i <= 200; i++) {
+        commitMessages.push_back("feat: added feature " + to_string(i) + " (#" + to_string(i) + ")");
+    }
+    string repositoryDirectory = createTestRepository("release_notes_test_pipeline_error", commitMessages);
+
+    // The newest pull request isn't in the corpus, so the first request fails with 404 while the other fetcher succeeds
+    json corpus;
+    for (int i = 1; i < 200; i++) {
+        corpus["pulls"][to_string(i)] = {{"title", "feat: added feature " + to_string(i)}, {"body", ""}};
+    }
+    MockGithubApiOptions options;
+    options.latencyMilliseconds = 5;
+    MockGithubApi mockGithubApi(corpus, options);
+    config.githubReposApiUrl = mockGithubApi.getReposApiUrl();
+    config.githubMarkdownApiUrl = mockGithubApi.getMarkdownApiUrl();
+    config.githubApiConcurrentRequests = 2;
+    RunContext context(config, "owner/repository", "token", repositoryDirectory);
+
+    ReleaseNotesPipeline pipeline(ReleaseNoteSources::PullRequests, testStartTag, testEndTag, ReleaseNoteModes::Full, context);
+    CHECK_THROWS_AS(pipeline.run(), runtime_error);
+
+    // The other fetcher stops after the requests it already started instead of going through the 199 queued pull requests
+    CHECK(mockGithubApi.getCounters().notFound == 1);
+    CHECK(mockGithubApi.getCounters().requests < 10);
+}
+
+TEST_CASE("Testing that an error of the writer stage is thrown from the pipeline") {
+    Config config = loadTestConfig();
+    vector<string> commitMessages;
+    for (int i = 1; i <= 2000; i++) {
+        commitMessages.push_back("feat: added feature " + to_string(i));
+    }
+    string repositoryDirectory = createTestRepository("release_notes_test_pipeline_writer_error", commitMessages);
+
+    // Writing a note to a stream that was never opened throws, since the stream throws on failures
+    ofstream closedOutput;
+    closedOutput.exceptions(ios::failbit | ios::badbit);
+    ReleaseNotesStream notesStream(closedOutput);
+    RunContext context(config, "owner/repository", "", repositoryDirectory);
+    context.notesStream = &notesStream;
+
+    ReleaseNotesPipeline pipeline(ReleaseNoteSources::CommitMessages, testStartTag, testEndTag, ReleaseNoteModes::Short, context);
+    CHECK_THROWS_AS(pipeline.run(), ios::failure);
+}
+
+TEST_CASE("Testing that only short mode takes pull request titles from commit messages") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    Config config = loadTestConfig();
+    string repositoryDirectory = createTestRepository("release_notes_test_pipeline_modes", {
+        "feat: added X (#1)",
+        "Merge pull request #2 from owner/branch\n\nfeat: added Y",
+        "feat: added Z for #3 (#4)"
+    });
+
+    json corpus;
+    for (int i = 1; i <= 4; i++) {
+        corpus["pulls"][to_string(i)] = {{"title", "feat: pull request " + to_string(i)}, {"body", "Body " + to_string(i)}};
+    }
+    MockGithubApi mockGithubApi(corpus);
+    config.githubReposApiUrl = mockGithubApi.getReposApiUrl();
+    config.githubMarkdownApiUrl = mockGithubApi.getMarkdownApiUrl();
+    RunContext context(config, "owner/repository", "token", repositoryDirectory);
+
+    // Full mode is unchanged: merge commits are left out and the pull request is the first one referenced by the subject
+    ReleaseNotes fullReleaseNotes = ReleaseNotesPipeline(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                         ReleaseNoteModes::Full, context).run();
+    REQUIRE(fullReleaseNotes.sections.size() == 1);
+    REQUIRE(fullReleaseNotes.sections[0].notes.size() == 2);
+    CHECK(fullReleaseNotes.sections[0].notes[0].title == "Pull request 3");
+    CHECK(fullReleaseNotes.sections[0].notes[0].pullRequestNumber == "3");
+    CHECK(fullReleaseNotes.sections[0].notes[0].body == "Body 3");
+    CHECK(fullReleaseNotes.sections[0].notes[1].title == "Pull request 1");
+    CHECK(mockGithubApi.getCounters().requests == 2);
+
+    // Short mode takes the titles and the pull request numbers from the squash merge subjects and the merge commits
+    ReleaseNotes shortReleaseNotes = ReleaseNotesPipeline(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                          ReleaseNoteModes::Short, context).run();
+    REQUIRE(shortReleaseNotes.sections.size() == 1);
+    REQUIRE(shortReleaseNotes.sections[0].notes.size() == 3);
+    CHECK(shortReleaseNotes.sections[0].notes[0].title == "Added Z for #3");
+    CHECK(shortReleaseNotes.sections[0].notes[0].pullRequestNumber == "4");
+    CHECK(shortReleaseNotes.sections[0].notes[1].title == "Added Y");
+    CHECK(shortReleaseNotes.sections[0].notes[1].pullRequestNumber == "2");
+    CHECK(shortReleaseNotes.sections[0].notes[2].title == "Added X");
+    CHECK(mockGithubApi.getCounters().requests == 2);
+}
+
+TEST_CASE("Testing that notes are generated from commit subjects after the time budget or the request budget is used up") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    Config config = loadTestConfig();
+    string repositoryDirectory = createTestRepository("release_notes_test_pipeline_budgets", {
+        "feat: added X (#1)",
+        "feat: added Y (#2)",
+        "fix: fixed Z (#3)"
+    });
+
+    json corpus;
+    for (int i = 1; i <= 3; i++) {
+        corpus["pulls"][to_string(i)] = {{"title", "feat: pull request " + to_string(i)}, {"body", "Body"}};
+    }
+
+    // Every response comes after the deadline, so the requests time out when it is reached and no note is lost
+    MockGithubApiOptions slowOptions;
+    slowOptions.latencyMilliseconds = 3000;
+    MockGithubApi slowGithubApi(corpus, slowOptions);
+    Config slowConfig = config;
+    slowConfig.githubReposApiUrl = slowGithubApi.getReposApiUrl();
+    slowConfig.githubMarkdownApiUrl = slowGithubApi.getMarkdownApiUrl();
+    slowConfig.generationTimeBudgetSeconds = 1;
+    RunContext slowContext(slowConfig, "owner/repository", "token", repositoryDirectory);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ReleaseNotes releaseNotes = ReleaseNotesPipeline(ReleaseNoteSources::PullRequests, testStartTag, testEndTag,
+                                                     ReleaseNoteModes::Full, slowContext).run();
+    CHECK(chrono::steady_clock::now() - start < chrono::milliseconds(2500));
+    CHECK(releaseNotes.usedCommitSubjects);
+    CHECK_FALSE(releaseNotes.exceededRequestBudget);
+    REQUIRE(releaseNotes.sections.size() == 2);
+    REQUIRE(releaseNotes.sections[0].notes.size() == 2);
+    CHECK(releaseNotes.sections[0].notes[0].title == "Added Y (#2)");
+    CHECK(releaseNotes.sections[0].notes[0].pullRequestNumber == "2");
+    CHECK(releaseNotes.sections[0].notes[1].title == "Added X (#1)");
+    CHECK(releaseNotes.sections[1].notes[0].title == "Fixed Z (#3)");
+
+    // After the deadline, HTML is rendered locally instead of with the markdown API
+    string htmlReleaseNotes = renderReleaseNotes(releaseNotes, "html", slowContext);
+    CHECK(htmlReleaseNotes == renderHtmlReleaseNotes(releaseNotes, slowConfig));
+    CHECK(slowGithubApi.getCounters().markdown == 0);
+
+    // Only the first request fits in the request budget, the other notes use their commit subjects
+    MockGithubApi githubApi(corpus);
+    Config budgetConfig = config;
+    budgetConfig.githubReposApiUrl = githubApi.getReposApiUrl();
+    budgetConfig.githubMarkdownApiUrl = githubApi.getMarkdownApiUrl();
+    budgetConfig.githubApiRequestBudget = 1;
+    budgetConfig.githubApiConcurrentRequests = 1;
+    RunContext budgetContext(budgetConfig, "owner/repository", "token", repositoryDirectory);
+
+    releaseNotes = ReleaseNotesPipeline(ReleaseNoteSources::PullRequests, testStartTag, testEndTag, ReleaseNoteModes::Full,
+                                        budgetContext).run();
+    CHECK(releaseNotes.exceededRequestBudget);
+    CHECK_FALSE(releaseNotes.usedCommitSubjects);
+    CHECK(githubApi.getCounters().requests == 1);
+    REQUIRE(releaseNotes.sections.size() == 2);
+    REQUIRE(releaseNotes.sections[0].notes.size() == 2);
+    REQUIRE(releaseNotes.sections[1].notes.size() == 1);
+
+    // Whichever commit is fetched first, a single note comes from its pull request
+    size_t notesFromPullRequests = 0;
+    for (const ReleaseNotesSection& section : releaseNotes.sections) {
+        for (const ReleaseNote& note : section.notes) {
+            notesFromPullRequests += note.source == ReleaseNoteSources::PullRequests;
+        }
+    }
+    CHECK(notesFromPullRequests == 1);
+}
@@ -0,0 +1,59 @@
+#include "doctest.h"
+
+#include "../Profiler.h"
+
+#include <chrono>
+#include <thread>
+
+TEST_CASE("Testing the profiler reports") {
+    Profiler profiler;
+    for (int milliseconds = 1; milliseconds <= 20; milliseconds++) {
+        profiler.record(ProfilePhases::GitLog, chrono::milliseconds(milliseconds));
+    }
+    profiler.record(ProfilePhases::FileWrite, chrono::milliseconds(5));
+
+    json report = json::parse(profiler.createJsonReport());
+    REQUIRE(report["phases"].size() == 2);
+    CHECK(report["phases"][0]["phase"] == "git log");
+    CHECK(report["phases"][0]["count"] == 20);
+    CHECK(report["phases"][0]["totalMs"] == 210.0);
+    CHECK(report["phases"][0]["p50Ms"] == 10.0);
+    CHECK(report["phases"][0]["p95Ms"] == 19.0);
+    CHECK(report["phases"][0]["maxMs"] == 20.0);
+    CHECK(report["phases"][1]["phase"] == "file write");
+
+    string tableReport = profiler.createTableReport();
+    CHECK(tableReport.find("git log") != string::npos);
+    CHECK(tableReport.find("json parse") == string::npos); // Phases that didn't occur aren't reported
+
+    // Timers don't record anything while the profiler is disabled
+    { ProfileScope timer(ProfilePhases::JsonParse); }
+    CHECK(getProfiler().createTableReport().find("json parse") == string::npos);
+}
+
+TEST_CASE("Testing the Chrome trace of the profiler") {
+    Profiler profiler;
+    profiler.enableTracing();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    profiler.recordOccurrence(ProfilePhases::GitProcess, start, chrono::microseconds(1500), {{"command", "git log"}});
+    thread([&]() {
+        profiler.recordOccurrence(ProfilePhases::HttpRequest, start, chrono::microseconds(700), {{"status", 200}}, true);
+    }).join();
+
+    // Statistics are only recorded when the profiler itself is enabled
+    CHECK(json::parse(profiler.createJsonReport())["phases"].empty());
+
+    json trace = json::parse(profiler.createTrace());
+    json events = trace["traceEvents"];
+    REQUIRE(events.size() == 5); // A complete event, an async begin and end pair and the names of the two threads
+    CHECK(events[0]["name"] == "git process");
+    CHECK(events[0]["ph"] == "X");
+    CHECK(events[0]["dur"] == 1500.0);
+    CHECK(events[0]["args"]["command"] == "git log");
+    CHECK(events[1]["ph"] == "b");
+    CHECK(events[2]["ph"] == "e");
+    CHECK(events[1]["id"] == events[2]["id"]);
+    CHECK(events[2]["ts"].get<double>() - events[1]["ts"].get<double>() == 700.0);
+    CHECK(events[1]["tid"] != events[0]["tid"]);
+    CHECK(events[3]["ph"] == "M");
+}
@@ -0,0 +1,150 @@
+#include "doctest.h"
+
+#include "../ReleaseNotes.h"
+#include "../Config.h"
+#include "../ThreadPool.h"
+
+#include <sstream>
+
+#include <json.hpp>
+
+using namespace nlohmann;
+
+static Config createReleaseNotesConfig() {
+    Config config;
+    config.commitTypes[0][0] = "feat";
+    config.commitTypes[0][1] = "## ✨ New Features";
+    config.commitTypes[1][0] = "fix";
+    config.commitTypes[1][1] = "## 🐛 Bug Fixes";
+    config.markdownReleaseNotePrefix = "- ";
+    config.markdownFullModeReleaseNotePrefix = "- ### ";
+    config.timeBudgetExceededNote = "\n> [!NOTE]\n> Some notes were generated from commit subjects\n";
+    config.requestBudgetExceededNote = "";
+    return config;
+}
+
+static ReleaseNotes createTestReleaseNotes(const Config& config) {
+    ReleaseNotes releaseNotes;
+
+    releaseNotes.sections.push_back(createReleaseNotesSection(0, config));
+    ReleaseNote detailedNote = createReleaseNote("feat(API)!: added X", CommitTypeMatchResults::MatchWithSubCategory, 0, config);
+    detailedNote.isDetailed = true;
+    detailedNote.body = "Body with **bold** & <tags>";
+    detailedNote.pullRequestNumber = "13";
+    detailedNote.commitShas.push_back("abc123");
+    releaseNotes.sections.back().notes.push_back(detailedNote);
+
+    releaseNotes.sections.push_back(createReleaseNotesSection(1, config));
+    releaseNotes.sections.back().notes.push_back(createReleaseNote("fix: fixed Y", CommitTypeMatchResults::MatchWithoutSubCategory, 1, config));
+
+    return releaseNotes;
+}
+
+TEST_CASE("Testing creating release notes from conventional commit titles") {
+    Config config = createReleaseNotesConfig();
+
+    ReleaseNote note = createReleaseNote("fix(GUI): fixed bug X", CommitTypeMatchResults::MatchWithSubCategory, 1, config);
+    CHECK(note.type == "fix");
+    CHECK(note.scope == "GUI");
+    CHECK(note.title == "Fixed bug X");
+    CHECK_FALSE(note.isBreaking);
+
+    note = createReleaseNote("feat!: removed Y", CommitTypeMatchResults::MatchWithoutSubCategory, 0, config);
+    CHECK(note.scope == "");
+    CHECK(note.title == "Removed Y");
+    CHECK(note.isBreaking);
+}
+
+TEST_CASE("Testing rendering release notes in every output format") {
+    Config config = createReleaseNotesConfig();
+    ReleaseNotes releaseNotes = createTestReleaseNotes(config);
+
+    CHECK(renderMarkdownReleaseNotes(releaseNotes, config) ==
+          "\n## ✨ New Features\n- ### (API Related) Added X\n    Body with **bold** & <tags>\n\n"
+          "\n## 🐛 Bug Fixes\n- Fixed Y\n\n");
+    CHECK(renderTextReleaseNotes(releaseNotes, config).find("- (API Related) Added X\n") != string::npos);
+
+    string htmlReleaseNotes = renderHtmlReleaseNotes(releaseNotes, config);
+    CHECK(htmlReleaseNotes.find("<h2>✨ New Features</h2>") != string::npos);
+    CHECK(htmlReleaseNotes.find("<strong>bold</strong> &amp; &lt;tags&gt;") != string::npos);
+
+    json jsonReleaseNotes = json::parse(renderJsonReleaseNotes(releaseNotes));
+    CHECK(jsonReleaseNotes["sections"].size() == 2);
+    CHECK(jsonReleaseNotes["sections"][0]["notes"][0]["scope"] == "API");
+    CHECK(jsonReleaseNotes["sections"][0]["notes"][0]["breaking"] == true);
+    CHECK(jsonReleaseNotes["sections"][0]["notes"][0]["pullRequest"] == "13");
+    CHECK(jsonReleaseNotes["sections"][1]["notes"][0]["title"] == "Fixed Y");
+
+    ReleaseNotes invalidReleaseNotes = releaseNotes;
+    invalidReleaseNotes.sections[1].notes[0].title = "Caf\xe9 raw";
+    json invalidJsonReleaseNotes = json::parse(renderJsonReleaseNotes(invalidReleaseNotes));
+    CHECK(invalidJsonReleaseNotes["sections"][1]["notes"][0]["title"] == "Caf\xEF\xBF\xBD raw");
+
+    releaseNotes.usedCommitSubjects = true;
+    CHECK(renderMarkdownReleaseNotes(releaseNotes, config).find(config.timeBudgetExceededNote) != string::npos);
+    CHECK(renderTextReleaseNotes(releaseNotes, config).find("Some notes were generated from commit subjects") != string::npos);
+
+    CHECK(renderMarkdownReleaseNotes(ReleaseNotes(), config) == "");
+}
+
+TEST_CASE("Testing rendering the bodies of the notes on a thread pool") {
+    Config config = createReleaseNotesConfig();
+    ReleaseNotes releaseNotes = createTestReleaseNotes(config);
+    for (int i = 0; i < 200; i++) {
+        ReleaseNote note = createReleaseNote("feat: added " + to_string(i), CommitTypeMatchResults::MatchWithoutSubCategory, 0, config);
+        note.isDetailed = i % 3 != 0;
+        note.body = (i % 5 == 0) ? "" : "Line " + to_string(i) + " with [a link](https://example.com/" + to_string(i) + ")\n- item";
+        releaseNotes.sections[i % 2].notes.push_back(note);
+    }
+
+    // The bodies are rendered on the workers and put back in the order of their notes
+    ThreadPool workers(4);
+    CHECK(renderMarkdownReleaseNotes(releaseNotes, config, &workers) == renderMarkdownReleaseNotes(releaseNotes, config));
+    CHECK(renderHtmlReleaseNotes(releaseNotes, config, &workers) == renderHtmlReleaseNotes(releaseNotes, config));
+    CHECK(renderTextReleaseNotes(releaseNotes, config, &workers) == renderTextReleaseNotes(releaseNotes, config));
+}
+
+TEST_CASE("Testing that only safe links of pull request bodies are rendered in HTML") {
+    CHECK(renderMarkdownBlocksToHtml("[docs](https://example.com/docs)") == "<p><a href=\"https://example.com/docs\">docs</a></p>\n");
+    CHECK(renderMarkdownBlocksToHtml("[mail](mailto:a@example.com)").find("<a href=\"mailto:a@example.com\">mail</a>") != string::npos);
+    CHECK(renderMarkdownBlocksToHtml("[file](docs/a:b.md)").find("<a href=\"docs/a:b.md\">file</a>") != string::npos);
+
+    CHECK(renderMarkdownBlocksToHtml("[x](javascript:alert(1))") == "<p>[x](javascript:alert(1))</p>\n");
+    CHECK(renderMarkdownBlocksToHtml("- [x](JavaScript:alert(1))").find("href") == string::npos);
+    CHECK(renderMarkdownBlocksToHtml("[x](data:text/html,<script>)").find("href") == string::npos);
+    CHECK(renderMarkdownBlocksToHtml("[x](https://a.com\"onclick=\"alert(1))").find("\"onclick") == string::npos);
+}
+
+TEST_CASE("Testing streaming release notes as JSON lines") {
+    Config config = createReleaseNotesConfig();
+    ReleaseNotes releaseNotes = createTestReleaseNotes(config);
+
+    ostringstream output;
+    ReleaseNotesStream notesStream(output);
+    for (const ReleaseNotesSection& section : releaseNotes.sections) {
+        for (const ReleaseNote& note : section.notes) {
+            notesStream.write(section, note);
+        }
+    }
+
+    istringstream lines(output.str());
+    string line;
+    vector<json> jsonNotes;
+    while (getline(lines, line)) {
+        jsonNotes.push_back(json::parse(line));
+    }
+
+    REQUIRE(jsonNotes.size() == 2);
+    CHECK(jsonNotes[0]["section"] == "✨ New Features");
+    CHECK(jsonNotes[0]["commits"][0] == "abc123");
+    CHECK(jsonNotes[0]["source"] == "commit");
+    CHECK(jsonNotes[1]["section"] == "🐛 Bug Fixes");
+    CHECK(jsonNotes[1]["title"] == "Fixed Y");
+
+    // The bytes of a note that aren't valid UTF-8 are replaced
+    ostringstream invalidOutput;
+    ReleaseNotesStream invalidNotesStream(invalidOutput);
+    ReleaseNote invalidNote = createReleaseNote("feat: caf\xe9 raw", CommitTypeMatchResults::MatchWithoutSubCategory, 0, config);
+    invalidNotesStream.write(releaseNotes.sections[0], invalidNote);
+    CHECK(json::parse(invalidOutput.str())["title"] == "Caf\xEF\xBF\xBD raw");
+}
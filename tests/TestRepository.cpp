@@ -0,0 +1,90 @@
+/**
+ * @file TestRepository.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the helpers defined in TestRepository.h
+ */
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <stdexcept>
+
+#include "TestRepository.h"
+#include "../Subprocess.h"
+#include "../GitObjects.h"
+#include "../Config.h"
+
+using namespace std;
+
+/**
+ * @brief Runs git in a test repository with a fixed identity and fails if it doesn't succeed
+ */
+static void runTestGit(vector<string> gitArguments, const string& directory) {
+    gitArguments.insert(gitArguments.begin(), {"-c", "user.name=Test", "-c", "user.email=test@example.com", "-c", "commit.gpgsign=false"});
+    Subprocess git(createGitCommand(gitArguments, directory));
+    if (git.wait() != 0) {
+        throw runtime_error("git " + gitArguments[6] + " failed in " + directory);
+    }
+}
+
+/**
+ * @brief Creates a git repository in the temporary directory with an empty commit for each message (in the given order),
+ * the commit before them is tagged testStartTag and the last one testEndTag
+ * @param name Name of the directory of the repository, it is replaced if it exists
+ * @param commitMessages The messages of the commits, the first line is the subject
+ * @return The directory of the repository
+ */
+string createTestRepository(const string& name, const vector<string>& commitMessages) {
+    string directory = (filesystem::temp_directory_path() / name).string();
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory);
+
+    runTestGit({"init", "-q"}, directory);
+    runTestGit({"commit", "-q", "--allow-empty", "-m", "chore: initial commit"}, directory);
+    runTestGit({"tag", testStartTag}, directory);
+    for (const string& commitMessage : commitMessages) {
+        runTestGit({"commit", "-q", "--allow-empty", "-m", commitMessage}, directory);
+    }
+    runTestGit({"tag", testEndTag}, directory);
+
+    return directory;
+}
+
+/**
+ * @brief Adds a commit whose message is written in the repository exactly as it is given, git commit would convert a message that
+ * isn't valid UTF-8, and moves testEndTag to it
+ * @param directory The directory of a repository created by createTestRepository()
+ * @param commitMessage The message of the commit, its bytes don't have to be valid UTF-8
+ */
+void addRawTestCommit(const string& directory, const string& commitMessage) {
+    GitCatFile gitObjects(false, directory);
+    GitObjectInfo parent = gitObjects.lookup(testEndTag + "^{commit}");
+    GitObjectInfo tree = gitObjects.lookup(testEndTag + "^{tree}");
+
+    string commit = "tree " + tree.sha + "\nparent " + parent.sha + "\n"
+        "author Test <test@example.com> 1700000000 +0000\ncommitter Test <test@example.com> 1700000000 +0000\n\n" + commitMessage + "\n";
+    Subprocess hashObject(createGitCommand({"hash-object", "-t", "commit", "-w", "--literally", "--stdin"}, directory), true);
+    hashObject.writeInput(commit);
+    hashObject.closeInput();
+
+    string sha;
+    char output[128];
+    long bytesRead;
+    while ((bytesRead = hashObject.readOutput(output, sizeof(output))) > 0) {
+        sha.append(output, bytesRead);
+    }
+    if (hashObject.wait() != 0 || sha.size() < 40) {
+        throw runtime_error("git hash-object failed in " + directory);
+    }
+
+    runTestGit({"update-ref", "refs/tags/" + testEndTag, sha.substr(0, 40)}, directory);
+}
+
+/**
+ * @brief Loads the config of the repository, the tests are run from the root of the repository
+ */
+Config loadTestConfig() {
+    Config config;
+    config.load("release_notes_config.json");
+    return config;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file TestRepository.h
+ * @author Ahmed Khaled
+ * @brief This file defines the helpers that create the small git repositories and the config used by the tests of the generation
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../Config.h"
+
+using namespace std;
+
+/**
+ * @brief Tag of the commit before the commits of a test repository
+ */
+const string testStartTag = "test-start";
+
+/**
+ * @brief Tag of the last commit of a test repository
+ */
+const string testEndTag = "test-end";
+
+string createTestRepository(const string& name, const vector<string>& commitMessages);
+void addRawTestCommit(const string& directory, const string& commitMessage);
+Config loadTestConfig();
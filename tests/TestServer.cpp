@@ -0,0 +1,183 @@
+#include "doctest.h"
+
+#include "TestRepository.h"
+#include "MockGithubApi.h"
+#include "../Server.h"
+#include "../Generator.h"
+#include "../ReleaseNotes.h"
+#include "../ThreadPool.h"
+#include "../RunContext.h"
+#include "../Config.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <curl/curl.h>
+#include <json.hpp>
+
+using namespace nlohmann;
+
+TEST_CASE("Testing that the server answers with the notes rendered like the CLI renders them") {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    json corpus;
+    corpus["pulls"]["13"] = {{"title", "feat(api): added X"}, {"body", "Uses **Y**, see [docs](https://example.com)"}};
+    corpus["pulls"]["14"] = {{"title", "fix: fixed Z"}, {"body", ""}};
+    MockGithubApi mockGithubApi(corpus);
+
+    Config config = loadTestConfig();
+    config.githubReposApiUrl = mockGithubApi.getReposApiUrl();
+    config.githubMarkdownApiUrl = mockGithubApi.getMarkdownApiUrl();
+    config.outputFormats = {"markdown", "html", "json"};
+    config.htmlRenderer = "local";
+    string repositoryDirectory = createTestRepository("release_notes_test_server", {"feat: added W"});
+
+    string socketPath = (filesystem::temp_directory_path() / "release_notes_test_server.sock").string();
+    ThreadPool workers(2);
+    ReleaseNotesServer server(socketPath, workers, config);
+    thread serverThread([&]() { server.run(); });
+
+    json request = {{"source", config.singlePullRequestSourceCliInputName}, {"pullRequest", "13"}, {"token", "token"},
+                    {"repo", "owner/repository"}};
+    json response = sendRequestToServer(socketPath, request, config);
+
+    RunContext context(config, "owner/repository", "token");
+    ReleaseNotes changeNote = fetchPullRequestChangeNote("13", context);
+    CHECK(response["markdown"] == renderMarkdownReleaseNotes(changeNote, config));
+    CHECK(response["html"] == renderHtmlReleaseNotes(changeNote, config));
+    CHECK(response["json"] == renderJsonReleaseNotes(changeNote));
+    CHECK_FALSE(response.contains("text"));
+
+    // The pull requests of a single request are answered together, and the missing one only fails its own answer
+    request.erase("pullRequest");
+    request["pullRequests"] = {"13", "15", 14};
+    response = sendRequestToServer(socketPath, request, config);
+    REQUIRE(response["pullRequests"].size() == 3);
+    CHECK(response["pullRequests"][0]["pullRequest"] == "13");
+    CHECK(response["pullRequests"][0]["markdown"] == renderMarkdownReleaseNotes(changeNote, config));
+    CHECK(response["pullRequests"][1]["pullRequest"] == "15");
+    CHECK(response["pullRequests"][1].contains("error"));
+    CHECK(response["pullRequests"][2]["pullRequest"] == "14");
+    CHECK(response["pullRequests"][2]["markdown"].get<string>().find("Fixed Z") != string::npos);
+
+    json messageRequest = {{"source", config.commitMessagesSourceCliInputName}, {"start", testStartTag}, {"end", testEndTag},
+                           {"token", ""}, {"directory", repositoryDirectory}};
+    response = sendRequestToServer(socketPath, messageRequest, config);
+    CHECK(response["markdown"].get<string>().find("Added W") != string::npos);
+
+    CHECK(sendRequestToServer(socketPath, {{"source", "unknown"}, {"token", ""}, {"start", "a"}, {"end", "b"}}, config).contains("error"));
+
+    server.stop();
+    serverThread.join();
+}
+
+TEST_CASE("Testing that the server answers notes that aren't valid UTF-8 and keeps serving") {
+    Config config = loadTestConfig();
+    config.outputFormats = {"markdown", "json"};
+    string repositoryDirectory = createTestRepository("release_notes_test_server_raw", {"fix: fixed Y"});
+    addRawTestCommit(repositoryDirectory, "feat: caf\xe9 raw");
+
+    string socketPath = (filesystem::temp_directory_path() / "release_notes_test_server_raw.sock").string();
+    ThreadPool workers(2);
+    ReleaseNotesServer server(socketPath, workers, config);
+    thread serverThread([&]() { server.run(); });
+
+    json request = {{"source", config.commitMessagesSourceCliInputName}, {"start", testStartTag}, {"end", testEndTag},
+                    {"token", ""}, {"directory", repositoryDirectory}};
+    json response = sendRequestToServer(socketPath, request, config);
+    CHECK(response["markdown"].get<string>().find("Caf\xEF\xBF\xBD raw") != string::npos);
+    CHECK(response["markdown"].get<string>().find("Fixed Y") != string::npos);
+    CHECK(sendRequestToServer(socketPath, request, config).contains("json"));
+
+    server.stop();
+    serverThread.join();
+}
+
+/**
+ * @brief Connects to a Unix domain socket of a test, -1 if nothing listens on it
+ */
+static int connectTestSocket(const string& socketPath) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath.c_str());
+
+    int connectionSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(connectionSocket, (sockaddr*)&address, sizeof(address)) != 0) {
+        close(connectionSocket);
+        return -1;
+    }
+    return connectionSocket;
+}
+
+/**
+ * @brief Reads from a socket of a test until the other side closes it
+ */
+static string readTestSocketUntilClosed(int connectionSocket) {
+    string data;
+    char buffer[4096];
+    ssize_t bytesRead;
+    while ((bytesRead = read(connectionSocket, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, bytesRead);
+    }
+    return data;
+}
+
+TEST_CASE("Testing the limits of the server on its socket path and its connections") {
+    Config config = loadTestConfig();
+    config.serverMaxRequestBytes = 1024;
+    config.serverIdleTimeoutSeconds = 1;
+    string socketPath = (filesystem::temp_directory_path() / "release_notes_test_server_limits.sock").string();
+    ThreadPool workers(1);
+
+    // A file that isn't a socket is never replaced
+    filesystem::remove(socketPath);
+    { ofstream(socketPath) << "keep"; }
+    CHECK_THROWS_AS(ReleaseNotesServer(socketPath, workers, config), runtime_error);
+    CHECK(filesystem::is_regular_file(socketPath));
+    filesystem::remove(socketPath);
+
+    {
+        ReleaseNotesServer server(socketPath, workers, config);
+        thread serverThread([&]() { server.run(); });
+
+        // A second server doesn't take the socket of a running one
+        CHECK_THROWS_AS(ReleaseNotesServer(socketPath, workers, config), runtime_error);
+
+        // A request longer than the maximum is answered with an error and its connection is closed
+        int connectionSocket = connectTestSocket(socketPath);
+        REQUIRE(connectionSocket >= 0);
+        string longRequest(4096, 'x');
+        CHECK(write(connectionSocket, longRequest.data(), longRequest.size()) == (ssize_t)longRequest.size());
+        json response = json::parse(readTestSocketUntilClosed(connectionSocket));
+        CHECK(response["error"] == config.serverRequestTooLongError);
+        close(connectionSocket);
+
+        // A connection that sends nothing is closed after the idle timeout
+        connectionSocket = connectTestSocket(socketPath);
+        REQUIRE(connectionSocket >= 0);
+        CHECK(readTestSocketUntilClosed(connectionSocket).empty());
+        close(connectionSocket);
+
+        server.stop();
+        serverThread.join();
+    }
+
+    // The socket left behind by a server that isn't running anymore is replaced
+    int staleSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath.c_str());
+    REQUIRE(bind(staleSocket, (sockaddr*)&address, sizeof(address)) == 0);
+    close(staleSocket);
+    CHECK_NOTHROW(ReleaseNotesServer(socketPath, workers, config));
+}
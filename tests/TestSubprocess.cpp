@@ -0,0 +1,75 @@
+#include "doctest.h"
+
+#include "../Subprocess.h"
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <csignal>
+
+static string readAllOutput(Subprocess& program) {
+    string output;
+    char buffer[64];
+    long bytesRead;
+    while ((bytesRead = program.readOutput(buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, bytesRead);
+    }
+    return output;
+}
+
+TEST_CASE("Testing the output and the exit code of programs") {
+    // Arguments are passed as they are, without a shell in between
+    Subprocess echo({"echo", "a  b", "$HOME", "'c'"});
+    CHECK(readAllOutput(echo) == "a  b $HOME 'c'\n");
+    CHECK(echo.wait() == 0);
+    CHECK(echo.wait() == 0);
+
+    Subprocess failing({"sh", "-c", "exit 3"});
+    CHECK(failing.wait() == 3);
+
+    // Programs killed by a signal have no exit code
+    Subprocess killed({"sh", "-c", "kill -9 $$"});
+    CHECK(killed.wait() == -1);
+
+    CHECK_THROWS_AS(Subprocess({"release-notes-missing-program"}), runtime_error);
+}
+
+TEST_CASE("Testing capturing the errors of programs") {
+    Subprocess program({"sh", "-c", "echo output; echo error >&2; exit 1"}, false, true);
+    CHECK(readAllOutput(program) == "output\n");
+    CHECK(program.readErrorOutput() == "error\n");
+    CHECK(program.wait() == 1);
+
+    Subprocess notCaptured({"true"});
+    CHECK_THROWS_AS(notCaptured.readErrorOutput(), logic_error);
+}
+
+TEST_CASE("Testing programs that close their pipes before they are done with") {
+    // Writing to a program that exited without reading its input fails without killing this process with SIGPIPE
+    struct sigaction sigpipeActionBefore;
+    sigaction(SIGPIPE, nullptr, &sigpipeActionBefore);
+    Subprocess exited({"sh", "-c", "exec 0<&-; echo closed"}, true);
+    CHECK(readAllOutput(exited) == "closed\n");
+    CHECK_THROWS_AS(exited.writeInput(string(1 << 20, 'x')), runtime_error);
+    CHECK(exited.wait() == 0);
+
+    // SIGPIPE is only blocked while writing, so the handling of SIGPIPE by the rest of this process doesn't change
+    struct sigaction sigpipeAction;
+    sigaction(SIGPIPE, nullptr, &sigpipeAction);
+    CHECK(sigpipeAction.sa_handler == sigpipeActionBefore.sa_handler);
+    sigset_t pendingSignals;
+    sigpending(&pendingSignals);
+    CHECK_FALSE(sigismember(&pendingSignals, SIGPIPE));
+
+    // A program still writing when its output is closed gets SIGPIPE itself (even if this process ignores it), waiting for it doesn't hang
+    Subprocess writing({"yes"});
+    char buffer[16];
+    CHECK(writing.readOutput(buffer, sizeof(buffer)) > 0);
+    CHECK(writing.wait() == -1);
+
+    Subprocess reading({"cat"}, true);
+    reading.writeInput("input");
+    reading.closeInput();
+    CHECK(readAllOutput(reading) == "input");
+    CHECK(reading.wait() == 0);
+}
@@ -0,0 +1,87 @@
+#include "doctest.h"
+
+#include "../Template.h"
+#include "../ReleaseNotes.h"
+#include "../Config.h"
+
+#include <stdexcept>
+
+static ReleaseNotes createTemplateTestReleaseNotes(Config& config) {
+    config.commitTypes[0][0] = "feat";
+    config.commitTypes[0][1] = "## ✨ New Features";
+    config.markdownReleaseNotePrefix = "- ";
+    config.markdownFullModeReleaseNotePrefix = "- ### ";
+
+    ReleaseNotes releaseNotes;
+    releaseNotes.sections.push_back(createReleaseNotesSection(0, config));
+
+    ReleaseNote note = createReleaseNote("feat(GUI)!: added <X>", CommitTypeMatchResults::MatchWithSubCategory, 0, config);
+    note.pullRequestNumber = "13";
+    note.commitShas = {"abc", "def"};
+    releaseNotes.sections.back().notes.push_back(note);
+
+    note = createReleaseNote("feat: added Y", CommitTypeMatchResults::MatchWithoutSubCategory, 0, config);
+    note.isDetailed = true;
+    note.body = "Line1\nLine2";
+    releaseNotes.sections.back().notes.push_back(note);
+
+    return releaseNotes;
+}
+
+static string renderTemplate(const string& templateText, TemplateEscapes escapeMode, const ReleaseNotes& releaseNotes, const Config& config) {
+    string output;
+    OutputTemplate(templateText, escapeMode).render(releaseNotes, config, output);
+    return output;
+}
+
+TEST_CASE("Testing rendering release notes with templates") {
+    Config config;
+    ReleaseNotes releaseNotes = createTemplateTestReleaseNotes(config);
+
+    CHECK(renderTemplate("{{#sections}}[{{heading}}]{{#notes}}<{{title}}|{{scope}}>{{/notes}}{{/sections}}", TemplateEscapes::None,
+                         releaseNotes, config) == "[✨ New Features]<Added <X>|GUI><Added Y|>");
+    // The fields of the notes hide the fields of the sections that have the same names
+    CHECK(renderTemplate("{{#sections}}{{type}}:{{title}}{{#notes}} {{type}}:{{title}}{{/notes}}{{/sections}}", TemplateEscapes::None,
+                         releaseNotes, config) == "feat:## ✨ New Features feat:Added <X> feat:Added Y");
+    CHECK(renderTemplate("{{#sections}}{{#notes}}{{#breaking}}!{{/breaking}}{{^pullRequest}}none{{/pullRequest}}{{#commits}}{{sha}},{{/commits}};"
+                         "{{/notes}}{{/sections}}", TemplateEscapes::None, releaseNotes, config) == "!abc,def,;none;");
+    CHECK(renderTemplate("{{#sections}}{{#notes}}{{title}}|{{{title}}}|{{& title}};{{/notes}}{{/sections}}", TemplateEscapes::Html,
+                         releaseNotes, config) == "Added &lt;X&gt;|Added <X>|Added <X>;Added Y|Added Y|Added Y;");
+    CHECK(renderTemplate("{{#usedCommitSubjects}}used{{/usedCommitSubjects}}{{^usedCommitSubjects}}not used{{/usedCommitSubjects}}",
+                         TemplateEscapes::None, releaseNotes, config) == "not used");
+}
+
+TEST_CASE("Testing that section and comment tags alone on their lines don't leave empty lines") {
+    Config config;
+    ReleaseNotes releaseNotes = createTemplateTestReleaseNotes(config);
+
+    string templateText =
+        "{{! A comment}}\n"
+        "{{#sections}}\n"
+        "{{title}}\n"
+        "  {{#notes}}\n"
+        "{{prefix}}{{fullTitle}}\n"
+        "{{#detailed}}\n"
+        "{{indentedBody}}\n"
+        "{{/detailed}}\n"
+        "  {{/notes}}\n"
+        "{{/sections}}\n";
+    CHECK(renderTemplate(templateText, TemplateEscapes::None, releaseNotes, config) ==
+          "## ✨ New Features\n- (GUI Related) Added <X>\n- ### Added Y\n    Line1\n    Line2\n");
+
+    // The texts around a removed comment line are joined into a single instruction
+    OutputTemplate outputTemplate("a\n{{! comment}}\nb", TemplateEscapes::None);
+    REQUIRE(outputTemplate.getInstructions().size() == 1);
+    CHECK(outputTemplate.getInstructions()[0].textLength == 3);
+}
+
+TEST_CASE("Testing the errors of invalid templates") {
+    CHECK_THROWS_AS(OutputTemplate("{{unknown}}", TemplateEscapes::None), runtime_error);
+    CHECK_THROWS_AS(OutputTemplate("{{title}}", TemplateEscapes::None), runtime_error); // Used outside of the sections list
+    CHECK_THROWS_AS(OutputTemplate("{{#sections}}{{notes}}{{/sections}}", TemplateEscapes::None), runtime_error);
+    CHECK_THROWS_AS(OutputTemplate("{{#sections}}", TemplateEscapes::None), runtime_error);
+    CHECK_THROWS_AS(OutputTemplate("{{#sections}}{{#notes}}{{/sections}}{{/notes}}", TemplateEscapes::None), runtime_error);
+    CHECK_THROWS_AS(OutputTemplate("{{#sections}}{{/sections}}{{/sections}}", TemplateEscapes::None), runtime_error);
+    CHECK_THROWS_AS(OutputTemplate("{{#sections}}{{title", TemplateEscapes::None), runtime_error);
+    CHECK_NOTHROW(OutputTemplate("{{#sections}}{{#notes}}{{#commits}}{{sha}}{{/commits}}{{/notes}}{{/sections}}", TemplateEscapes::None));
+}
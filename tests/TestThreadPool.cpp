@@ -0,0 +1,81 @@
+#include "doctest.h"
+
+#include "../ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Testing the work stealing thread pool") {
+    ThreadPool workers(4, 2);
+    atomic<int> finishedTasks{0};
+
+    // A long task must not stop the tasks queued after it on the same worker from running on the other workers
+    TaskGroup tasks;
+    for (int i = 0; i < 40; i++) {
+        tasks.add();
+        workers.submit([&, i]() {
+            if (i == 0) {
+                this_thread::sleep_for(chrono::milliseconds(50));
+            }
+            finishedTasks++;
+            tasks.finish();
+        });
+    }
+    tasks.wait();
+    CHECK(finishedTasks == 40);
+
+    // Tasks can submit tasks even when the pool is full, without waiting for themselves
+    for (int i = 0; i < 4; i++) {
+        workers.submit([&]() {
+            for (int j = 0; j < 10; j++) {
+                workers.submit([&]() { finishedTasks++; });
+            }
+        });
+    }
+    workers.waitUntilIdle();
+    CHECK(finishedTasks == 80);
+    CHECK(workers.threadCount() == 4);
+}
+
+TEST_CASE("Testing that the thread pool wakes its idle workers and bounds the tasks of concurrent submitters") {
+    ThreadPool workers(4, 1);
+    atomic<int> finishedTasks{0};
+    atomic<int> runningTasks{0};
+    atomic<int> maxRunningTasks{0};
+
+    // The workers are asleep when the tasks arrive, and the submitters of 4 threads share a bound of 1 unfinished task
+    this_thread::sleep_for(chrono::milliseconds(20));
+    vector<thread> submitters;
+    for (int i = 0; i < 4; i++) {
+        submitters.emplace_back([&]() {
+            for (int j = 0; j < 250; j++) {
+                workers.submit([&]() {
+                    int running = ++runningTasks;
+                    int maxRunning = maxRunningTasks;
+                    while (running > maxRunning && !maxRunningTasks.compare_exchange_weak(maxRunning, running)) {}
+                    finishedTasks++;
+                    runningTasks--;
+                });
+            }
+        });
+    }
+    for (thread& submitter : submitters) {
+        submitter.join();
+    }
+    workers.waitUntilIdle();
+    CHECK(finishedTasks == 1000);
+    CHECK(maxRunningTasks == 1);
+
+    // A group is destroyed as soon as its wait returns, while the task that finished it may still be running
+    for (int i = 0; i < 200; i++) {
+        TaskGroup tasks;
+        for (int j = 0; j < 3; j++) {
+            tasks.add();
+            workers.submit([&]() { tasks.finish(); });
+        }
+        tasks.wait();
+    }
+    workers.waitUntilIdle();
+}
@@ -0,0 +1,91 @@
+#include "doctest.h"
+
+#include "../Utils.h"
+#include "../Config.h"
+#include "../RunContext.h"
+
+#include <vector>
+
+TEST_CASE("Testing adding suffixes to file names function") {
+    CHECK(addSuffixToFileName("release_notes.md", "_13") == "release_notes_13.md");
+    CHECK(addSuffixToFileName("release_notes.html", "") == "release_notes.html");
+    CHECK(addSuffixToFileName("notes.v2.md", "_7") == "notes.v2_7.md");
+    CHECK(addSuffixToFileName("./release_notes", "_13") == "./release_notes_13");
+    CHECK(addSuffixToFileName("out.d/notes", "_13") == "out.d/notes_13");
+    CHECK(addSuffixToFileName("release_notes", "_13") == "release_notes_13");
+}
+
+TEST_CASE("Testing the GitHub API responses cache") {
+    GithubApiCache cache(2);
+    string etag, body;
+
+    CHECK_FALSE(cache.find("pulls/1", etag, body));
+
+    cache.store("pulls/1", "\"e1\"", "first");
+    REQUIRE(cache.find("pulls/1", etag, body));
+    CHECK(etag == "\"e1\"");
+    CHECK(body == "first");
+
+    // Storing the same key again replaces its response without taking another entry
+    cache.store("pulls/1", "\"e2\"", "first changed");
+    cache.store("pulls/2", "\"e3\"", "second");
+    REQUIRE(cache.find("pulls/1", etag, body));
+    CHECK(etag == "\"e2\"");
+    CHECK(body == "first changed");
+
+    // The oldest entry is dropped when the cache is full
+    cache.store("pulls/3", "\"e4\"", "third");
+    CHECK_FALSE(cache.find("pulls/1", etag, body));
+    CHECK(cache.find("pulls/2", etag, body));
+    CHECK(cache.find("pulls/3", etag, body));
+}
+
+TEST_CASE("Testing the run context of a generation") {
+    Config runConfig;
+    runConfig.githubUrl = "https://github.com/";
+    runConfig.githubReposApiUrl = "https://api.github.com/repos/";
+
+    RunContext context(runConfig, "user/repo", "token", "/path/to/repo");
+    CHECK(context.repoIssuesUrl == "https://github.com/user/repo/issues/");
+    CHECK(context.repoCommitsUrl == "https://github.com/user/repo/commit/");
+    CHECK(context.repoPullRequestsApiUrl == "https://api.github.com/repos/user/repo/pulls/");
+    CHECK(context.githubToken == "token");
+    CHECK(context.repositoryDirectory == "/path/to/repo");
+
+    // Contexts of different repositories don't affect each other
+    RunContext otherContext(runConfig, "other/repo", "token");
+    CHECK(otherContext.repoIssuesUrl == "https://github.com/other/repo/issues/");
+    CHECK(context.repoIssuesUrl == "https://github.com/user/repo/issues/");
+
+    // Notes that don't link to GitHub don't need a repository
+    RunContext messagesContext(runConfig, "", "token");
+    CHECK(messagesContext.repoIssuesUrl == "");
+}
+
+TEST_CASE("Testing the GitHub API request budget") {
+    GithubApiBudget budget(2, 3);
+
+    CHECK(budget.acquire());
+    CHECK(budget.acquire());
+    budget.release();
+    CHECK(budget.acquire());
+    budget.release();
+    budget.release();
+
+    // All 3 requests of the budget were used
+    CHECK_FALSE(budget.acquire());
+
+    GithubApiBudget unlimitedBudget(1, 0);
+    for (int i = 0; i < 100; i++) {
+        REQUIRE(unlimitedBudget.acquire());
+        unlimitedBudget.release();
+    }
+
+    // Requests taken without waiting only count against the total budget, even while the running requests are at their maximum
+    GithubApiBudget countedBudget(1, 3);
+    CHECK(countedBudget.acquire());
+    CHECK(countedBudget.tryAcquire());
+    CHECK(countedBudget.tryAcquire());
+    CHECK_FALSE(countedBudget.tryAcquire());
+    countedBudget.release();
+}
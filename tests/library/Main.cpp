@@ -0,0 +1,48 @@
+/**
+ * @file Main.cpp
+ * @author Ahmed Khaled
+ * @brief This file contains a small program that embeds the release notes library (librelease_notes.a) through Generator.h only,
+ * it checks that the library links without the CLI, the server and the allocation hooks, and that its entry points work
+ *
+ * Usage (from the root of a repository that has release_notes_config.json):
+ *   release_notes_library_consumer release_start_reference release_end_reference
+ * It prints the notes of the commit messages between the references in markdown and in JSON
+ */
+
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+#include <curl/curl.h>
+
+#include "../../Generator.h"
+#include "../../Config.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cerr << "Usage: release_notes_library_consumer release_start_reference release_end_reference" << endl;
+        return 1;
+    }
+
+    try {
+        Config config;
+        config.load("release_notes_config.json");
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+
+        // The commit messages source never sends a request, so the GitHub repository and token are left empty
+        RunContext context(config, "", "");
+        ReleaseNotes releaseNotes = buildReleaseNotes(ReleaseNoteSources::CommitMessages, argv[1], argv[2], ReleaseNoteModes::Full, context);
+        cout << renderMarkdownReleaseNotes(releaseNotes, config) << endl;
+        cout << renderJsonReleaseNotes(releaseNotes) << endl;
+
+        curl_global_cleanup();
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file InstructionCounter.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the InstructionCounter class defined in InstructionCounter.h
+ */
+
+#include <string>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#include "InstructionCounter.h"
+
+using namespace std;
+
+InstructionCounter::InstructionCounter() {
+#ifdef __linux__
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attributes.inherit = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    fileDescriptor = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    if (fileDescriptor < 0) {
+        unavailableReason = string("perf_event_open failed: ") + strerror(errno);
+    }
+#else
+    unavailableReason = "perf events are only available on Linux";
+#endif
+}
+
+InstructionCounter::~InstructionCounter() {
+#ifdef __linux__
+    if (fileDescriptor >= 0) {
+        close(fileDescriptor);
+    }
+#endif
+}
+
+/**
+ * @brief Reads the instructions counted since the counter was created, which include the ones of the threads that exited
+ * @return The count, or -1 if the counter is unavailable
+ */
+long long InstructionCounter::read() const {
+#ifdef __linux__
+    long long count = 0;
+    if (fileDescriptor < 0 || ::read(fileDescriptor, &count, sizeof(count)) != (ssize_t)sizeof(count)) {
+        return -1;
+    }
+    return count;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Starts a measurement
+ */
+void InstructionCounter::start() {
+    startCount = read();
+}
+
+/**
+ * @brief Ends a measurement
+ * @return The instructions counted since start(), or -1 if the counter is unavailable
+ */
+long long InstructionCounter::stop() const {
+    long long count = read();
+    return (count < 0 || startCount < 0) ? -1 : count - startCount;
+}
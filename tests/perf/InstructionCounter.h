@@ -0,0 +1,41 @@
+/**
+ * @file InstructionCounter.h
+ * @author Ahmed Khaled
+ * @brief This file defines the InstructionCounter class which counts the instructions retired by the process with perf_event_open(),
+ * a measure of the work done that barely changes between runs, unlike the wall-clock time
+ */
+
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief Counts the user space instructions of the thread that creates it and of the threads that it starts afterwards
+ * (like the threads of the pipeline), the threads that already exist (like the ones of the mock GitHub API) aren't counted
+ * The counter runs from its creation, a measurement is the difference between two reads of it, and the threads that are started
+ * are only added to it once they exit, so they must be joined before the end of the measurement
+ * It is unavailable on systems without hardware counters (like most virtual machines) or where perf events aren't allowed
+ * (kernel.perf_event_paranoid above 2), the reason is then given by getUnavailableReason()
+ */
+class InstructionCounter {
+public:
+    InstructionCounter();
+    ~InstructionCounter();
+
+    InstructionCounter(const InstructionCounter&) = delete;
+    InstructionCounter& operator=(const InstructionCounter&) = delete;
+
+    bool isAvailable() const { return fileDescriptor >= 0; }
+    const string& getUnavailableReason() const { return unavailableReason; }
+    void start();
+    long long stop() const;
+
+private:
+    int fileDescriptor = -1;
+    string unavailableReason;
+    long long startCount = -1;
+
+    long long read() const;
+};
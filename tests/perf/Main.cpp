@@ -0,0 +1,135 @@
+/**
+ * @file Main.cpp
+ * @author Ahmed Khaled
+ * @brief This file contains the main function of the performance regression gate, which exits with 1 when a workload regressed
+ *
+ * Usage (from the root of the repository):
+ *   release_notes_perf_gate [--baseline file] [--update-baseline] [--json file] [--filter text] [--repetitions count]
+ *                           [--commits count] [--pull-requests count] [--work-directory directory] [--config file]
+ * --update-baseline replaces the build and the metrics of the baseline with the ones of this run and keeps its tolerances,
+ * it is run on the machine that runs the gate, with the gate built with -O2, after a change that is expected to change the metrics
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <curl/curl.h>
+#include <json.hpp>
+
+#include "PerfGate.h"
+#include "../../Memory.h"
+#include "../../Config.h"
+
+using namespace std;
+using namespace nlohmann;
+
+int main(int argc, char* argv[]) {
+    // The allocations of each workload are counted by the replaced operator new of MemoryHooks.cpp
+    getMemoryAccounting().enable();
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    string baselineFileName = "tests/perf/baseline.json";
+    string jsonFileName, configFileName = "release_notes_config.json";
+    bool isUpdatingBaseline = false;
+    PerfGateOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update-baseline") == 0) {
+            isUpdatingBaseline = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value of " << argv[i] << endl;
+            return 1;
+        }
+
+        string option = argv[i], value = argv[++i];
+        if (option == "--baseline") {
+            baselineFileName = value;
+        }
+        else if (option == "--json") {
+            jsonFileName = value;
+        }
+        else if (option == "--config") {
+            configFileName = value;
+        }
+        else if (option == "--filter") {
+            options.filter = value;
+        }
+        else if (option == "--repetitions") {
+            options.repetitions = strtoull(value.c_str(), NULL, 10);
+        }
+        else if (option == "--commits") {
+            options.classificationCommits = strtoull(value.c_str(), NULL, 10);
+        }
+        else if (option == "--pull-requests") {
+            options.fetchedPullRequests = strtoull(value.c_str(), NULL, 10);
+        }
+        else if (option == "--work-directory") {
+            options.workDirectory = value;
+        }
+        else {
+            cerr << "Unknown option " << option << endl;
+            return 1;
+        }
+    }
+
+    json baseline = json::object();
+    json results;
+    try {
+        Config config;
+        config.load(configFileName);
+
+        ifstream baselineFile(baselineFileName);
+        if (baselineFile.is_open()) {
+            baseline = json::parse(baselineFile);
+        }
+        else if (!isUpdatingBaseline) {
+            throw runtime_error("Couldn't open the baseline " + baselineFileName + ", create it with --update-baseline");
+        }
+
+        results = runPerfWorkloads(options, config);
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    if (!jsonFileName.empty()) {
+        ofstream jsonFile(jsonFileName);
+        jsonFile << results.dump(4) << "\n";
+        if (!jsonFile) {
+            cerr << "Couldn't write " << jsonFileName << endl;
+            return 1;
+        }
+    }
+
+    if (isUpdatingBaseline) {
+        if (!baseline.contains("tolerances")) {
+            baseline["tolerances"] = createDefaultPerfTolerances();
+        }
+        if (!baseline.contains("workloads")) {
+            baseline["workloads"] = json::object();
+        }
+        baseline["build"] = results["build"];
+        baseline["workloads"].update(results["workloads"]);
+
+        ofstream baselineFile(baselineFileName);
+        baselineFile << baseline.dump(4) << "\n";
+        if (!baselineFile) {
+            cerr << "Couldn't write " << baselineFileName << endl;
+            return 1;
+        }
+        cout << "Updated " << baselineFileName << endl;
+        return 0;
+    }
+
+    string report;
+    bool isPassing = comparePerfResults(baseline, results, report);
+    cout << report << (isPassing ? "No regression\n" : "Some metrics regressed beyond their tolerance\n") << flush;
+    return isPassing ? 0 : 1;
+}
@@ -0,0 +1,355 @@
+/**
+ * @file PerfGate.cpp
+ * @author Ahmed Khaled
+ * @brief This file implements the workloads of the performance regression gate and their comparison with the baseline
+ *
+ * The workloads are the formatting of a corpus of pull request bodies and commit subjects, the classification of the commits
+ * of a synthetic repository, and the retrieval of pull requests from the mock GitHub API
+ * Their inputs are made by the seeded generators of the benchmarks, so every commit is measured on the same bytes
+ */
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+#include <json.hpp>
+
+#include "PerfGate.h"
+#include "InstructionCounter.h"
+#include "../MockGithubApi.h"
+#include "../../benchmarks/BenchmarkFormat.h"
+#include "../../benchmarks/SyntheticRepository.h"
+#include "../../Generator.h"
+#include "../../Format.h"
+#include "../../Utils.h"
+#include "../../RunContext.h"
+#include "../../Memory.h"
+#include "../../Config.h"
+#include "../../Enums.h"
+
+using namespace std;
+using namespace nlohmann;
+
+// The workloads that take a few milliseconds are repeated until they ran this long, so that their shortest time is stable
+static const double minimumMeasuredMilliseconds = 2000;
+static const size_t maximumRepetitions = 200;
+
+/**
+ * @brief The metrics of a workload, the metrics that weren't measured are null
+ * @param counter The instruction counter, it may be unavailable
+ * @param repetitions How many times at least the workload is measured after it warms up, it is measured again while
+ * the repetitions took less than minimumMeasuredMilliseconds
+ * @param workload The workload
+ * @return The fewest instructions, allocations and allocated bytes, and the shortest wall-clock time of the repetitions,
+ * the shortest time is the one least slowed down by the other processes of the machine
+ */
+static json measureWorkload(InstructionCounter& counter, size_t repetitions, const function<void()>& workload) {
+    workload();
+
+    vector<long long> instructions;
+    vector<size_t> allocations;
+    vector<size_t> allocatedBytes;
+    vector<double> milliseconds;
+    double measuredMilliseconds = 0;
+    for (size_t i = 0; i < max(repetitions, (size_t)1)
+         || (measuredMilliseconds < minimumMeasuredMilliseconds && i < maximumRepetitions); i++) {
+        MemoryCounters memoryBefore = getMemoryAccounting().getCounters();
+        counter.start();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        workload();
+
+        chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+        instructions.push_back(counter.stop());
+        MemoryCounters memoryAfter = getMemoryAccounting().getCounters();
+        allocations.push_back(memoryAfter.allocations - memoryBefore.allocations);
+        allocatedBytes.push_back(memoryAfter.allocatedBytes - memoryBefore.allocatedBytes);
+        milliseconds.push_back(elapsed.count());
+        measuredMilliseconds += elapsed.count();
+    }
+
+    json metrics;
+    long long fewestInstructions = *min_element(instructions.begin(), instructions.end());
+    metrics["instructions"] = fewestInstructions < 0 ? json() : json(fewestInstructions);
+    metrics["allocations"] = *min_element(allocations.begin(), allocations.end());
+    metrics["allocatedBytes"] = *min_element(allocatedBytes.begin(), allocatedBytes.end());
+    metrics["milliseconds"] = *min_element(milliseconds.begin(), milliseconds.end());
+    return metrics;
+}
+
+/**
+ * @brief Measures the formatting of pull request bodies (links of issues and commit SHAs, extra new lines) and the conversion
+ * of commit subjects to release note titles
+ */
+static json measureFormatCorpus(InstructionCounter& counter, const PerfGateOptions& options, const Config& config) {
+    RunContext context(config, "owner/repository", "");
+
+    vector<string> bodies;
+    json corpus = MockGithubApi::loadCorpus("tests/fixtures/github_api_corpus.json");
+    for (const auto& pullRequest : corpus["pulls"].items()) {
+        if (pullRequest.value()["body"].is_string()) {
+            bodies.push_back(pullRequest.value()["body"]);
+        }
+    }
+    for (size_t size : {1 << 10, 4 << 10, 16 << 10, 64 << 10}) {
+        bodies.push_back(createRealisticPullRequestBody(size));
+    }
+
+    // Only the subjects that match their commit type are converted by the generator, so merge commits are left out
+    vector<string> titles;
+    vector<CommitTypeMatchResults> matchResults;
+    for (const string& subject : createCommitSubjects(10000, config)) {
+        if (subject.find(':') == string::npos) {
+            continue;
+        }
+        titles.push_back(subject);
+        matchResults.push_back(subject.find('(') < subject.find(':') ? CommitTypeMatchResults::MatchWithSubCategory
+                                                                     : CommitTypeMatchResults::MatchWithoutSubCategory);
+    }
+
+    return measureWorkload(counter, options.repetitions, [&]() {
+        for (const string& body : bodies) {
+            formatPullRequestBody(body, context);
+        }
+        for (size_t i = 0; i < titles.size(); i++) {
+            convertConventionalCommitTitleToReleaseNoteTitle(titles[i], matchResults[i], config.markdownReleaseNotePrefix);
+        }
+    });
+}
+
+/**
+ * @brief Measures the generation of the notes of a synthetic repository from its commit messages: reading git log, classifying
+ * the commits and formatting their notes
+ */
+static json measureClassification(InstructionCounter& counter, const PerfGateOptions& options, const Config& config) {
+    SyntheticRepositoryOptions repositoryOptions;
+    repositoryOptions.commitsCount = options.classificationCommits;
+    filesystem::path workDirectory = options.workDirectory.empty()
+        ? filesystem::temp_directory_path() / "release_notes_perf_gate" : filesystem::path(options.workDirectory);
+    string repositoryDirectory = (workDirectory / ("commits-" + to_string(repositoryOptions.commitsCount))).string();
+
+    fprintf(stderr, "Creating a synthetic repository of %zu commits in %s\n", repositoryOptions.commitsCount, repositoryDirectory.c_str());
+    filesystem::remove_all(repositoryDirectory);
+    createSyntheticRepository(repositoryDirectory, repositoryOptions, config);
+
+    size_t notesCount = 0;
+    json metrics = measureWorkload(counter, options.repetitions, [&]() {
+        RunContext context(config, "owner/repository", "", repositoryDirectory);
+        ReleaseNotes releaseNotes = buildReleaseNotes(ReleaseNoteSources::CommitMessages, syntheticStartTag, syntheticEndTag,
+                                                      ReleaseNoteModes::Short, context);
+        notesCount = 0;
+        for (const ReleaseNotesSection& section : releaseNotes.sections) {
+            notesCount += section.notes.size();
+        }
+    });
+    metrics["notes"] = notesCount;
+
+    filesystem::remove_all(repositoryDirectory);
+    return metrics;
+}
+
+/**
+ * @brief Measures the retrieval and the parsing of pull requests from the mock GitHub API, one after the other like a fetcher
+ * of the pipeline, each repetition retrieves pull requests that weren't retrieved before so that none is answered from the cache
+ */
+static json measurePullRequestsFetch(InstructionCounter& counter, const PerfGateOptions& options, const Config& config) {
+    MockGithubApiOptions mockGithubApiOptions;
+    mockGithubApiOptions.isGeneratingMissingPullRequests = true;
+    MockGithubApi mockGithubApi(json::object(), mockGithubApiOptions);
+
+    Config fetchConfig = config;
+    fetchConfig.githubReposApiUrl = mockGithubApi.getReposApiUrl();
+    fetchConfig.githubMarkdownApiUrl = mockGithubApi.getMarkdownApiUrl();
+    RunContext context(fetchConfig, "owner/repository", "token");
+
+    // The warm up opens the connection that the other repetitions are expected to reuse
+    size_t nextPullRequestNumber = 1;
+    size_t fewestConnections = SIZE_MAX;
+    json metrics = measureWorkload(counter, options.repetitions, [&]() {
+        size_t connectionsBefore = mockGithubApi.getCounters().connections;
+        for (size_t i = 0; i < options.fetchedPullRequests; i++) {
+            string pullRequestNumber = to_string(nextPullRequestNumber++);
+            parsePullRequestInfo(getPullRequestInfo(pullRequestNumber, fetchConfig.githubApiRequestTimeoutSeconds * 1000L, context));
+        }
+        fewestConnections = min(fewestConnections, mockGithubApi.getCounters().connections - connectionsBefore);
+    });
+    metrics["connections"] = fewestConnections;
+    return metrics;
+}
+
+/**
+ * @brief The default tolerances of the metrics, as fractions of their baseline values, used when the baseline doesn't have them
+ * The wall-clock time has no tolerance, it is only reported
+ */
+json createDefaultPerfTolerances() {
+    json tolerances;
+    tolerances["instructions"] = 0.03;
+    tolerances["allocations"] = 0.05;
+    tolerances["allocatedBytes"] = 0.05;
+    tolerances["milliseconds"] = nullptr;
+    tolerances["connections"] = 0.0;
+    return tolerances;
+}
+
+/**
+ * @brief The build of the gate, the wall-clock time and the instructions of an unoptimized build aren't comparable with
+ * the ones of an optimized build, GCC and Clang only tell whether the code is optimized, not the level it was built with
+ * @return A JSON object with the "compiler" and the "optimization" ("speed", "size" or "none")
+ */
+json getPerfBuildInfo() {
+    json build;
+#if defined(__VERSION__)
+    build["compiler"] = __VERSION__;
+#else
+    build["compiler"] = "unknown";
+#endif
+#if defined(__OPTIMIZE_SIZE__)
+    build["optimization"] = "size";
+#elif defined(__OPTIMIZE__)
+    build["optimization"] = "speed";
+#else
+    build["optimization"] = "none";
+#endif
+    return build;
+}
+
+/**
+ * @brief Runs the workloads of the gate
+ * @param options The sizes and the repetitions of the workloads
+ * @param config The loaded config
+ * @return A JSON object with the "build" of the gate and a "workloads" object (workload name -> metrics)
+ */
+json runPerfWorkloads(const PerfGateOptions& options, const Config& config) {
+    const vector<pair<string, function<json(InstructionCounter&, const PerfGateOptions&, const Config&)>>> workloads = {
+        {"format corpus", measureFormatCorpus},
+        {"classification " + to_string(options.classificationCommits / 1000) + "k commits", measureClassification},
+        {"pull requests fetch", measurePullRequestsFetch}
+    };
+
+    InstructionCounter counter;
+    if (!counter.isAvailable()) {
+        fprintf(stderr, "Instructions aren't counted (%s)\n", counter.getUnavailableReason().c_str());
+    }
+
+    json results;
+    results["build"] = getPerfBuildInfo();
+    results["workloads"] = json::object();
+    for (const auto& workload : workloads) {
+        if (!options.filter.empty() && workload.first.find(options.filter) == string::npos) {
+            continue;
+        }
+        fprintf(stderr, "Running %s\n", workload.first.c_str());
+        results["workloads"][workload.first] = workload.second(counter, options, config);
+    }
+    return results;
+}
+
+/**
+ * @brief Compares the results of the workloads with the baseline, a metric regresses when it is bigger than its baseline value
+ * by more than its tolerance, the metrics and the workloads that aren't in both are reported but never fail the gate, and neither
+ * do the metrics whose tolerance is null (the wall-clock time, which changes with the machine and its load)
+ * The results of a build with another optimization than the baseline fail without being compared, and with a different compiler
+ * the instructions are only reported
+ * @param baseline The baseline, with the "build", the "workloads" and the "tolerances" of the metrics
+ * @param results The results of runPerfWorkloads()
+ * @param report Receives a table of the comparison for people to read
+ * @return Whether no metric regressed
+ */
+bool comparePerfResults(const json& baseline, const json& results, string& report) {
+    json tolerances = createDefaultPerfTolerances();
+    if (baseline.contains("tolerances")) {
+        tolerances.update(baseline["tolerances"]);
+    }
+
+    const json& build = results["build"];
+    if (!baseline.contains("build")) {
+        report = "The baseline doesn't have its build, update it with --update-baseline\n";
+        return false;
+    }
+    if (baseline["build"]["optimization"] != build["optimization"]) {
+        report = "The baseline was measured with optimization " + baseline["build"]["optimization"].get<string>()
+            + " and the gate was built with optimization " + build["optimization"].get<string>() + ", build the gate with -O2\n";
+        return false;
+    }
+    report.clear();
+    if (baseline["build"]["compiler"] != build["compiler"]) {
+        report = "The baseline was measured with compiler " + baseline["build"]["compiler"].get<string>() + " and the gate was built with "
+            + build["compiler"].get<string>() + ", the instructions are only reported\n";
+        tolerances["instructions"] = nullptr;
+    }
+
+    bool isPassing = true;
+    char row[256];
+    snprintf(row, sizeof(row), "%-30s %-14s %16s %16s %9s %9s  %s\n", "workload", "metric", "baseline", "current", "change", "limit", "status");
+    report += row;
+
+    for (const auto& workload : results["workloads"].items()) {
+        const json* baselineMetrics = baseline.contains("workloads") && baseline["workloads"].contains(workload.key())
+            ? &baseline["workloads"][workload.key()] : nullptr;
+
+        for (const auto& metric : workload.value().items()) {
+            if (!tolerances.contains(metric.key())) {
+                continue;
+            }
+            bool isGated = tolerances[metric.key()].is_number();
+            double tolerance = isGated ? tolerances[metric.key()].get<double>() : 0;
+            bool isMeasured = metric.value().is_number();
+            bool isInBaseline = baselineMetrics && baselineMetrics->contains(metric.key()) && (*baselineMetrics)[metric.key()].is_number();
+
+            string status;
+            double baselineValue = isInBaseline ? (*baselineMetrics)[metric.key()].get<double>() : 0;
+            double currentValue = isMeasured ? metric.value().get<double>() : 0;
+            double change = baselineValue > 0 ? (currentValue - baselineValue) / baselineValue : 0;
+            if (!isMeasured) {
+                status = "not measured";
+            }
+            else if (!isInBaseline) {
+                status = "not in the baseline";
+            }
+            else if (!isGated) {
+                status = "reported only";
+            }
+            else if (currentValue > baselineValue * (1 + tolerance)) {
+                status = "REGRESSION";
+                isPassing = false;
+            }
+            else if (currentValue < baselineValue * (1 - tolerance)) {
+                status = "improved, update the baseline";
+            }
+            else {
+                status = "ok";
+            }
+
+            string baselineText = isInBaseline ? to_string((long long)baselineValue) : "-";
+            string currentText = isMeasured ? to_string((long long)currentValue) : "-";
+            if (metric.key() == "milliseconds") {
+                snprintf(row, sizeof(row), "%.1f", baselineValue);
+                baselineText = isInBaseline ? row : "-";
+                snprintf(row, sizeof(row), "%.1f", currentValue);
+                currentText = isMeasured ? row : "-";
+            }
+            string changeText = "-";
+            if (isMeasured && isInBaseline && baselineValue > 0) {
+                snprintf(row, sizeof(row), "%+.1f%%", change * 100);
+                changeText = row;
+            }
+
+            string limitText = "-";
+            if (isGated) {
+                snprintf(row, sizeof(row), "%.0f%%", tolerance * 100);
+                limitText = row;
+            }
+
+            snprintf(row, sizeof(row), "%-30s %-14s %16s %16s %9s %9s  %s\n", workload.key().c_str(), metric.key().c_str(),
+                     baselineText.c_str(), currentText.c_str(), changeText.c_str(), limitText.c_str(), status.c_str());
+            report += row;
+        }
+    }
+
+    return isPassing;
+}
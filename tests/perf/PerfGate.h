@@ -0,0 +1,39 @@
+/**
+ * @file PerfGate.h
+ * @author Ahmed Khaled
+ * @brief This file defines the performance regression gate, which runs fixed workloads of the generator and compares their
+ * instructions, allocations and wall-clock time with a checked-in baseline, so that a change that makes them slower fails like a test
+ */
+
+#pragma once
+
+#include <string>
+
+#include <json.hpp>
+
+#include "../../Config.h"
+
+using namespace std;
+using namespace nlohmann;
+
+/**
+ * @brief Options of the workloads of the gate, the baseline is only comparable with the results of the same options
+ */
+struct PerfGateOptions {
+    size_t repetitions = 5; /**< Each workload runs once to warm up, then this many times, and the best measurement is kept*/
+    size_t classificationCommits = 50000; /**< Size of the synthetic repository whose commits are classified*/
+    size_t fetchedPullRequests = 200; /**< Pull requests retrieved from the mock GitHub API in each repetition*/
+    string workDirectory; /**< Where the synthetic repository is created, empty means a directory in the temporary directory*/
+    string filter; /**< Only the workloads whose name contains it are run, all of them if it is empty*/
+};
+
+/**
+ * @brief The default tolerances of the metrics, as fractions of their baseline values, used when the baseline doesn't have them
+ * Instructions, allocations and allocated bytes barely change between runs, and a single extra connection means that the connections
+ * aren't reused anymore, the wall-clock time changes by tens of percents between runs and machines so its tolerance is null (reported only)
+ */
+json createDefaultPerfTolerances();
+
+json getPerfBuildInfo();
+json runPerfWorkloads(const PerfGateOptions& options, const Config& config);
+bool comparePerfResults(const json& baseline, const json& results, string& report);